@@ -37,6 +37,12 @@ int main(int argc, char** argv)
     parser.addVersionOption();
     QCommandLineOption excludePrefixOpt(QStringLiteral("exclude-prefix"), QStringLiteral("Exclude ELF files in this prefix."), QStringLiteral("exclude"));
     parser.addOption(excludePrefixOpt);
+    QCommandLineOption keepOpt(QStringLiteral("keep"), QStringLiteral("Never consider symbols matching this wildcard pattern as unused."), QStringLiteral("pattern"));
+    parser.addOption(keepOpt);
+    QCommandLineOption versionScriptOpt(QStringLiteral("version-script"), QStringLiteral("Write linker version scripts hiding unused symbols to this directory."), QStringLiteral("dir"));
+    parser.addOption(versionScriptOpt);
+    QCommandLineOption visibilityListOpt(QStringLiteral("visibility-list"), QStringLiteral("Write lists of unused symbols to annotate as hidden to this directory."), QStringLiteral("dir"));
+    parser.addOption(visibilityListOpt);
     parser.addPositionalArgument(QStringLiteral("elf"), QStringLiteral("ELF objects to analyze"), QStringLiteral("<elf>"));
     parser.process(app);
 
@@ -48,8 +54,14 @@ int main(int argc, char** argv)
     DeadCodeFinder finder;
     if (parser.isSet(excludePrefixOpt))
         finder.setExcludePrefixes(parser.values(excludePrefixOpt));
+    if (parser.isSet(keepOpt))
+        finder.setKeepPatterns(parser.values(keepOpt));
 
     finder.findUnusedSymbols(&set);
+    if (parser.isSet(versionScriptOpt))
+        return finder.writeResults(parser.value(versionScriptOpt), DeadCodeFinder::OutputFormat::VersionScript) ? 0 : 1;
+    if (parser.isSet(visibilityListOpt))
+        return finder.writeResults(parser.value(visibilityListOpt), DeadCodeFinder::OutputFormat::HiddenSymbolList) ? 0 : 1;
     finder.dumpResults();
 
     return 0;
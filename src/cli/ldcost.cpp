@@ -0,0 +1,62 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <config-elf-dissector-version.h>
+
+#include <checks/ldsimulator.h>
+
+#include <elf/elffileset.h>
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+
+#include <iostream>
+
+int main(int argc, char** argv)
+{
+    QCoreApplication::setApplicationName(QStringLiteral("ELF Dissector"));
+    QCoreApplication::setOrganizationName(QStringLiteral("KDE"));
+    QCoreApplication::setOrganizationDomain(QStringLiteral("kde.org"));
+    QCoreApplication::setApplicationVersion(QStringLiteral(ELF_DISSECTOR_VERSION_STRING));
+
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Estimate the dynamic linking cost of an ELF file and its dependencies, without loading them."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption totalOption(QStringList() << QStringLiteral("t") << QStringLiteral("total"), QStringLiteral("Only print the estimated total cost"));
+    parser.addOption(totalOption);
+    parser.addPositionalArgument(QStringLiteral("elf"), QStringLiteral("ELF executable or library to analyze"), QStringLiteral("<elf>"));
+    parser.process(app);
+
+    foreach (const auto &fileName, parser.positionalArguments()) {
+        ElfFileSet set;
+        set.addFile(fileName);
+        if (set.size() == 0)
+            continue;
+
+        LDSimulator sim;
+        sim.simulateFileSet(&set);
+        if (parser.isSet(totalOption))
+            std::cout << qPrintable(fileName) << '\t' << sim.totalCost() << std::endl;
+        else
+            sim.printResults();
+    }
+
+    return 0;
+}
@@ -18,6 +18,7 @@
 #include <config-elf-dissector-version.h>
 
 #include <optimizers/dependencysorter.h>
+#include <optimizers/gnuhashoptimizer.h>
 
 #include <elf/elffileset.h>
 
@@ -36,10 +37,35 @@ int main(int argc, char** argv)
     QCommandLineParser parser;
     parser.addHelpOption();
     parser.addVersionOption();
+    QCommandLineOption dryRunOption(QStringList() << QStringLiteral("n") << QStringLiteral("dry-run"), QStringLiteral("Only show the proposed changes and their effect, don't modify any file"));
+    parser.addOption(dryRunOption);
+    QCommandLineOption allOption(QStringList() << QStringLiteral("a") << QStringLiteral("all"), QStringLiteral("Optimize all dependencies as well, not just the given file"));
+    parser.addOption(allOption);
+    QCommandLineOption gnuHashOption(QStringLiteral("gnu-hash"), QStringLiteral("Rebuild .gnu.hash with optimal parameters, instead of sorting DT_NEEDED entries"));
+    parser.addOption(gnuHashOption);
     parser.addPositionalArgument(QStringLiteral("elf"), QStringLiteral("ELF library to optimize"), QStringLiteral("<elf>"));
     parser.process(app);
 
+    if (parser.isSet(gnuHashOption)) {
+        GnuHashOptimizer optimizer;
+        optimizer.setDryRun(parser.isSet(dryRunOption));
+        foreach (const auto &fileName, parser.positionalArguments()) {
+            QStringList fileNames;
+            {
+                ElfFileSet set;
+                set.addFile(fileName);
+                for (int i = 0; i < (parser.isSet(allOption) ? set.size() : std::min(set.size(), 1)); ++i)
+                    fileNames.push_back(set.file(i)->fileName());
+            }
+            foreach (const auto &f, fileNames)
+                optimizer.optimize(f);
+        }
+        return 0;
+    }
+
     DependencySorter optimizer;
+    optimizer.setDryRun(parser.isSet(dryRunOption));
+    optimizer.setProcessAllFiles(parser.isSet(allOption));
     foreach (const auto &fileName, parser.positionalArguments()) {
         ElfFileSet set;
         set.addFile(fileName);
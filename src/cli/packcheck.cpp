@@ -36,6 +36,8 @@ int main(int argc, char** argv)
     QCommandLineParser parser;
     parser.addHelpOption();
     parser.addVersionOption();
+    QCommandLineOption jobsOpt(QStringList() << QStringLiteral("j") << QStringLiteral("jobs"), QStringLiteral("Number of threads to use, defaults to one per core."), QStringLiteral("count"));
+    parser.addOption(jobsOpt);
     parser.addPositionalArgument(QStringLiteral("elf"), QStringLiteral("ELF library to open"), QStringLiteral("<elf>"));
     parser.process(app);
 
@@ -46,7 +48,7 @@ int main(int argc, char** argv)
         if (set.size() == 0)
             continue;
         checker.setElfFileSet(&set);
-        checker.checkAll(set.file(0)->dwarfInfo());
+        checker.checkAll(set.file(0)->dwarfInfo(), parser.value(jobsOpt).toInt());
     }
 
     return 0;
@@ -0,0 +1,137 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <config-elf-dissector-version.h>
+
+#include <demangle/symbolprefixtree.h>
+#include <elf/elffile.h>
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+// splits a qualified name at "::" separators outside of template arguments or parameter lists
+static QVector<QByteArray> splitQualifiedName(const QByteArray &name)
+{
+    QVector<QByteArray> parts;
+    int depth = 0;
+    int begin = 0;
+    for (int i = 0; i < name.size(); ++i) {
+        switch (name.at(i)) {
+            case '<':
+            case '(':
+                ++depth;
+                break;
+            case '>':
+            case ')':
+                --depth;
+                break;
+            case ':':
+                if (depth == 0 && i + 1 < name.size() && name.at(i + 1) == ':') {
+                    parts.push_back(name.mid(begin, i - begin));
+                    begin = i + 2;
+                    ++i;
+                }
+                break;
+        }
+    }
+    parts.push_back(name.mid(begin));
+    return parts;
+}
+
+static void printNode(const ElfFile *file, const SymbolPrefixTree *tree, int node, int indent, int depth, int limit, bool showSections)
+{
+    const auto stats = tree->statistics(node);
+    std::cout << std::setw(12) << stats.size << std::setw(10) << stats.symbolCount << std::setw(10) << stats.relocationCount << "  "
+              << std::string(indent * 2, ' ')
+              << (node == SymbolPrefixTree::RootNode ? qPrintable(file->displayName()) : (indent == 0 ? tree->qualifiedName(node) : tree->name(node)).constData())
+              << std::endl;
+
+    if (showSections) {
+        for (const auto sectionIndex : tree->sections(node)) {
+            const auto sectionStats = tree->statistics(node, sectionIndex);
+            std::cout << std::setw(12) << sectionStats.size << std::setw(10) << sectionStats.symbolCount << std::setw(10) << sectionStats.relocationCount << "  "
+                      << std::string(indent * 2 + 2, ' ') << "[" << file->sectionHeaders().at(sectionIndex)->name() << "]" << std::endl;
+        }
+    }
+
+    if (depth <= 0)
+        return;
+
+    QVector<int> children;
+    children.reserve(tree->childCount(node));
+    for (int i = 0; i < tree->childCount(node); ++i)
+        children.push_back(tree->child(node, i));
+    std::sort(children.begin(), children.end(), [tree](int lhs, int rhs) {
+        return tree->statistics(lhs).size > tree->statistics(rhs).size;
+    });
+    if (limit > 0 && children.size() > limit)
+        children.resize(limit);
+
+    for (const auto child : children)
+        printNode(file, tree, child, indent + 1, depth - 1, limit, showSections);
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication::setApplicationName(QStringLiteral("ELF Size Report"));
+    QCoreApplication::setOrganizationName(QStringLiteral("KDE"));
+    QCoreApplication::setOrganizationDomain(QStringLiteral("kde.org"));
+    QCoreApplication::setApplicationVersion(QStringLiteral(ELF_DISSECTOR_VERSION_STRING));
+
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption depthOpt(QStringLiteral("depth"), QStringLiteral("Number of namespace/class levels to show (default: 2)."), QStringLiteral("depth"));
+    parser.addOption(depthOpt);
+    QCommandLineOption limitOpt(QStringLiteral("limit"), QStringLiteral("Only show the largest <limit> entries per level."), QStringLiteral("limit"));
+    parser.addOption(limitOpt);
+    QCommandLineOption prefixOpt(QStringLiteral("prefix"), QStringLiteral("Only show symbols in this namespace or class."), QStringLiteral("prefix"));
+    parser.addOption(prefixOpt);
+    QCommandLineOption sectionsOpt(QStringLiteral("sections"), QStringLiteral("Show the per-section breakdown of each entry."));
+    parser.addOption(sectionsOpt);
+    parser.addPositionalArgument(QStringLiteral("elf"), QStringLiteral("ELF objects to analyze"), QStringLiteral("<elf>"));
+    parser.process(app);
+
+    const auto depth = parser.isSet(depthOpt) ? parser.value(depthOpt).toInt() : 2;
+    const auto limit = parser.isSet(limitOpt) ? parser.value(limitOpt).toInt() : 0;
+    const auto prefix = splitQualifiedName(parser.value(prefixOpt).toUtf8());
+
+    std::cout << std::setw(12) << "size" << std::setw(10) << "symbols" << std::setw(10) << "relocs" << "  name" << std::endl;
+    foreach (const auto &fileName, parser.positionalArguments()) {
+        ElfFile file(fileName);
+        if (!file.open(QFile::ReadOnly)) {
+            std::cerr << "Failed to open " << qPrintable(fileName) << std::endl;
+            continue;
+        }
+
+        const auto tree = file.symbolPrefixTree();
+        const auto node = parser.isSet(prefixOpt) ? tree->find(prefix) : static_cast<int>(SymbolPrefixTree::RootNode);
+        if (node < 0) {
+            std::cerr << "No symbols in " << qPrintable(parser.value(prefixOpt)) << " found in " << qPrintable(fileName) << std::endl;
+            continue;
+        }
+        printNode(&file, tree, node, 0, depth, limit, parser.isSet(sectionsOpt));
+    }
+
+    return 0;
+}
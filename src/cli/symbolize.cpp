@@ -0,0 +1,505 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <config-elf-dissector.h>
+#include <config-elf-dissector-version.h>
+
+#include <demangle/demanglecache.h>
+#include <demangle/demangler.h>
+#include <elf/elfdynamicsection.h>
+#include <elf/elffileset.h>
+#include <elf/elfsymboltableentry.h>
+#include <elf/elfsymboltablesection.h>
+
+#if HAVE_DWARF
+#include <dwarf/dwarfaddressindex.h>
+#include <dwarf/dwarfcudie.h>
+#include <dwarf/dwarfdie.h>
+#include <dwarf/dwarfinfo.h>
+#include <dwarf/dwarfline.h>
+
+#include <dwarf.h>
+#endif
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+
+#include <elf.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <numeric>
+
+namespace {
+
+struct Frame
+{
+    QByteArray function;
+    QByteArray file;
+    uint64_t line = 0;
+    uint64_t column = 0;
+};
+
+struct Location
+{
+    QByteArray symbol;
+    uint64_t symbolOffset = 0;
+    QVector<Frame> frames; // innermost first
+};
+
+struct Request
+{
+    QByteArray module;
+    ElfFile *file = nullptr;
+    uint64_t address = 0;
+    int location = -1;
+};
+
+class Symbolizer
+{
+public:
+    explicit Symbolizer(bool inlines);
+
+    void addFile(const QString &fileName);
+    /** Matches @p module by path, file name or SONAME, loading it on demand. */
+    ElfFile* fileForModule(const QByteArray &module);
+
+    /** Resolves @p requests into @p locations. Requests are processed sorted by file and address,
+     *  identical ones are only resolved once.
+     */
+    void symbolize(QVector<Request> &requests, QVector<Location> *locations);
+
+private:
+    void addModuleNames(int firstFileIndex);
+    void resolve(ElfFile *file, const QVector<uint64_t> &addrs, Location *locations);
+#if HAVE_DWARF
+    struct InlineInfo
+    {
+        QByteArray function;
+        QByteArray callFile;
+        uint64_t callLine = 0;
+        uint64_t callColumn = 0;
+    };
+    const InlineInfo& inlineInfo(DwarfDie *die);
+    void addFrames(Location *location, const DwarfCuDie *cu, DwarfLine line, DwarfDie *die);
+
+    QHash<DwarfDie*, InlineInfo> m_inlineInfos;
+#endif
+
+    ElfFileSet m_fileSet;
+    QHash<QByteArray, ElfFile*> m_modules;
+    bool m_inlines;
+};
+
+}
+
+Symbolizer::Symbolizer(bool inlines) :
+    m_inlines(inlines)
+{
+}
+
+void Symbolizer::addFile(const QString& fileName)
+{
+    const auto firstFileIndex = m_fileSet.size();
+    m_fileSet.addFile(fileName);
+    addModuleNames(firstFileIndex);
+}
+
+void Symbolizer::addModuleNames(int firstFileIndex)
+{
+    for (int i = firstFileIndex; i < m_fileSet.size(); ++i) {
+        const auto file = m_fileSet.file(i);
+        const QFileInfo fi(file->fileName());
+        QVector<QByteArray> names({ QFile::encodeName(file->fileName()), QFile::encodeName(fi.fileName()), QFile::encodeName(fi.canonicalFilePath()) });
+        if (file->dynamicSection())
+            names.push_back(file->dynamicSection()->soName());
+        // the first file claiming a name wins
+        for (const auto &name : names) {
+            if (!name.isEmpty() && !m_modules.contains(name))
+                m_modules.insert(name, file);
+        }
+    }
+}
+
+ElfFile* Symbolizer::fileForModule(const QByteArray& module)
+{
+    if (module.isEmpty())
+        return m_fileSet.size() > 0 ? m_fileSet.file(0) : nullptr;
+
+    auto it = m_modules.constFind(module);
+    if (it != m_modules.constEnd())
+        return it.value();
+
+    const auto fileName = QFile::decodeName(module);
+    if (QFileInfo::exists(fileName))
+        addFile(fileName);
+    // also remember failed lookups
+    it = m_modules.constFind(module);
+    if (it == m_modules.constEnd())
+        it = m_modules.insert(module, nullptr);
+    return it.value();
+}
+
+void Symbolizer::symbolize(QVector<Request>& requests, QVector<Location>* locations)
+{
+    locations->clear();
+
+    QVector<int> order(requests.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&requests](int lhs, int rhs) {
+        const auto &l = requests.at(lhs);
+        const auto &r = requests.at(rhs);
+        if (l.file != r.file)
+            return std::less<ElfFile*>()(l.file, r.file);
+        return l.address < r.address;
+    });
+
+    QVector<uint64_t> addrs;
+    for (int begin = 0; begin < order.size();) {
+        const auto file = requests.at(order.at(begin)).file;
+        addrs.clear();
+        int end = begin;
+        for (; end < order.size() && requests.at(order.at(end)).file == file; ++end) {
+            auto &request = requests[order.at(end)];
+            if (addrs.isEmpty() || addrs.last() != request.address)
+                addrs.push_back(request.address);
+            request.location = locations->size() + addrs.size() - 1;
+        }
+
+        const auto firstLocation = locations->size();
+        locations->resize(firstLocation + addrs.size());
+        if (file)
+            resolve(file, addrs, locations->data() + firstLocation);
+        begin = end;
+    }
+}
+
+void Symbolizer::resolve(ElfFile* file, const QVector<uint64_t>& addrs, Location* locations)
+{
+    // stripped files keep their full symbol table in the separate debug file
+    auto symtab = file->symbolTable();
+    if (file->indexOfSection(SHT_SYMTAB) < 0 && file->separateDebugFile() && file->separateDebugFile()->symbolTable())
+        symtab = file->separateDebugFile()->symbolTable();
+    if (symtab) {
+        for (int i = 0; i < addrs.size(); ++i) {
+            const auto entry = symtab->entryContainingValue(addrs.at(i));
+            if (!entry)
+                continue;
+            locations[i].symbol = symtab->file()->demangleCache()->demangleFull(entry->name());
+            locations[i].symbolOffset = addrs.at(i) - entry->value();
+        }
+    }
+
+#if HAVE_DWARF
+    const auto dwarf = file->dwarfInfo();
+    if (!dwarf)
+        return;
+
+    // line tables of split units stay with the skeleton unit, which is what DwarfInfo finds here
+    QVector<Dwarf_Addr> dwarfAddrs;
+    dwarfAddrs.reserve(addrs.size());
+    for (const auto addr : addrs)
+        dwarfAddrs.push_back(addr);
+    QVector<DwarfCuDie*> units;
+    const auto lines = dwarf->linesForAddresses(dwarfAddrs, &units);
+    const auto index = dwarf->addressIndex();
+    for (int i = 0; i < addrs.size(); ++i)
+        addFrames(&locations[i], units.at(i), lines.at(i), index->dieForAddress(addrs.at(i)));
+#endif
+}
+
+#if HAVE_DWARF
+static QByteArray functionName(DwarfDie *die)
+{
+    // attributes are inherited from the abstract origin and specification
+    auto linkageName = die->attributeString(DW_AT_linkage_name);
+    if (!linkageName)
+        linkageName = die->attributeString(DW_AT_MIPS_linkage_name);
+    if (linkageName)
+        return Demangler::demangleFull(linkageName);
+
+    // unmangled names, qualify them with the scopes of the declaration
+    while (die->inheritedFrom())
+        die = die->inheritedFrom();
+    QByteArray name = die->name();
+    for (auto parent = die->parentDie(); parent && !parent->isCompilationUnit(); parent = parent->parentDie()) {
+        switch (parent->tag()) {
+            case DW_TAG_namespace:
+            case DW_TAG_class_type:
+            case DW_TAG_structure_type:
+            case DW_TAG_union_type:
+                name = parent->name() + "::" + name;
+                break;
+        }
+    }
+    return name;
+}
+
+const Symbolizer::InlineInfo& Symbolizer::inlineInfo(DwarfDie* die)
+{
+    auto it = m_inlineInfos.constFind(die);
+    if (it != m_inlineInfos.constEnd())
+        return it.value();
+
+    InlineInfo info;
+    info.function = functionName(die);
+    if (die->tag() == DW_TAG_inlined_subroutine) {
+        info.callFile = die->attribute(DW_AT_call_file).toString().toUtf8();
+        info.callLine = die->attributeUnsigned(DW_AT_call_line);
+        info.callColumn = die->attributeUnsigned(DW_AT_call_column);
+    }
+    return m_inlineInfos.insert(die, info).value();
+}
+
+void Symbolizer::addFrames(Location* location, const DwarfCuDie* cu, DwarfLine line, DwarfDie* die)
+{
+    Frame frame;
+    if (!line.isNull()) {
+        frame.file = cu->sourceFileForLine(line).toUtf8();
+        frame.line = line.line();
+        frame.column = line.column();
+    }
+
+    if (!m_inlines) {
+        while (die && die->tag() != DW_TAG_subprogram)
+            die = die->parentDie();
+    }
+
+    // the location of each inlined frame is the call site in the next outer one
+    while (die) {
+        const auto &info = inlineInfo(die);
+        frame.function = info.function;
+        location->frames.push_back(frame);
+        if (die->tag() != DW_TAG_inlined_subroutine)
+            break;
+        frame.file = info.callFile;
+        frame.line = info.callLine;
+        frame.column = info.callColumn;
+        do {
+            die = die->parentDie();
+        } while (die && die->tag() != DW_TAG_subprogram && die->tag() != DW_TAG_inlined_subroutine);
+    }
+
+    if (location->frames.isEmpty() && !line.isNull()) {
+        frame.function = location->symbol;
+        location->frames.push_back(frame);
+    }
+}
+#endif
+
+static bool parseRequest(const QByteArray &input, QByteArray *module, uint64_t *address)
+{
+    // "<module> <offset>" or "<module>+<offset>", the offset alone refers to the first file
+    int separator = input.size() - 1;
+    while (separator >= 0 && input.at(separator) != ' ' && input.at(separator) != '\t' && input.at(separator) != '+')
+        --separator;
+    *module = input.left(std::max(separator, 0)).trimmed();
+
+    auto offset = input.mid(separator + 1);
+    if (offset.startsWith("0x") || offset.startsWith("0X"))
+        offset = offset.mid(2);
+    bool ok = false;
+    *address = offset.toULongLong(&ok, 16);
+    return ok;
+}
+
+static const char* valueOrUnknown(const QByteArray &value)
+{
+    return value.isEmpty() ? "??" : value.constData();
+}
+
+static void writeTsv(QByteArray &out, const Request &request, const Location &location)
+{
+    QByteArray prefix = request.module;
+    prefix += "\t0x" + QByteArray::number(quint64(request.address), 16);
+    prefix += '\t';
+    prefix += valueOrUnknown(location.symbol);
+    prefix += "\t0x" + QByteArray::number(quint64(location.symbolOffset), 16);
+    prefix += '\t';
+
+    if (location.frames.isEmpty()) {
+        out += prefix + "0\t??\t??\t0\t0\n";
+        return;
+    }
+    for (int i = 0; i < location.frames.size(); ++i) {
+        const auto &frame = location.frames.at(i);
+        out += prefix;
+        out += QByteArray::number(i);
+        out += '\t';
+        out += valueOrUnknown(frame.function);
+        out += '\t';
+        out += valueOrUnknown(frame.file);
+        out += '\t';
+        out += QByteArray::number(quint64(frame.line));
+        out += '\t';
+        out += QByteArray::number(quint64(frame.column));
+        out += '\n';
+    }
+}
+
+static void writeJsonString(QByteArray &out, const QByteArray &value)
+{
+    if (value.isEmpty()) {
+        out += "null";
+        return;
+    }
+    out += '"';
+    for (const char c : value) {
+        switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (uchar(c) < 0x20)
+                    out += "\\u00" + QByteArray::number(uchar(c), 16).rightJustified(2, '0');
+                else
+                    out += c;
+        }
+    }
+    out += '"';
+}
+
+static void writeJson(QByteArray &out, const Request &request, const Location &location)
+{
+    out += "{\"module\":";
+    writeJsonString(out, request.module);
+    out += ",\"offset\":\"0x" + QByteArray::number(quint64(request.address), 16);
+    out += "\",\"symbol\":";
+    writeJsonString(out, location.symbol);
+    out += ",\"symbolOffset\":\"0x" + QByteArray::number(quint64(location.symbolOffset), 16);
+    out += "\",\"frames\":[";
+    for (int i = 0; i < location.frames.size(); ++i) {
+        const auto &frame = location.frames.at(i);
+        if (i > 0)
+            out += ',';
+        out += "{\"function\":";
+        writeJsonString(out, frame.function);
+        out += ",\"file\":";
+        writeJsonString(out, frame.file);
+        out += ",\"line\":" + QByteArray::number(quint64(frame.line));
+        out += ",\"column\":" + QByteArray::number(quint64(frame.column));
+        out += '}';
+    }
+    out += "]}\n";
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication::setApplicationName(QStringLiteral("ELF Dissector"));
+    QCoreApplication::setOrganizationName(QStringLiteral("KDE"));
+    QCoreApplication::setOrganizationDomain(QStringLiteral("kde.org"));
+    QCoreApplication::setApplicationVersion(QStringLiteral(ELF_DISSECTOR_VERSION_STRING));
+
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral(
+        "Resolves module offsets to symbols, source locations and inlined call chains.\n"
+        "Input lines are \"<module> <offset>\" or \"<module>+<offset>\", with hexadecimal offsets "
+        "in the virtual address space of the module. Modules are matched by path, file name or SONAME "
+        "among the given files and their dependencies, a bare offset refers to the first file.\n"
+        "TSV output has one row per frame, innermost first, with the columns module, offset, symbol, "
+        "symbol offset, frame, function, file, line and column. JSON output has one object per line."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption inputOpt(QStringList() << QStringLiteral("i") << QStringLiteral("input"), QStringLiteral("Read input from <file> instead of stdin."), QStringLiteral("file"));
+    parser.addOption(inputOpt);
+    QCommandLineOption formatOpt(QStringList() << QStringLiteral("f") << QStringLiteral("format"), QStringLiteral("Output format, tsv (default) or json."), QStringLiteral("format"), QStringLiteral("tsv"));
+    parser.addOption(formatOpt);
+    QCommandLineOption noInlinesOpt(QStringLiteral("no-inlines"), QStringLiteral("Only report the outermost function, without inlined frames."));
+    parser.addOption(noInlinesOpt);
+    QCommandLineOption batchSizeOpt(QStringList() << QStringLiteral("b") << QStringLiteral("batch-size"), QStringLiteral("Number of input lines to resolve at once, defaults to 65536. Use 1 for interactive use."), QStringLiteral("count"), QStringLiteral("65536"));
+    parser.addOption(batchSizeOpt);
+    parser.addPositionalArgument(QStringLiteral("elf"), QStringLiteral("ELF executables or libraries to load upfront"), QStringLiteral("<elf>..."));
+    parser.process(app);
+
+    const auto json = parser.value(formatOpt) == QLatin1String("json");
+    if (!json && parser.value(formatOpt) != QLatin1String("tsv")) {
+        std::cerr << "Unsupported output format: " << qPrintable(parser.value(formatOpt)) << std::endl;
+        return 1;
+    }
+    const auto batchSize = std::max(1, parser.value(batchSizeOpt).toInt());
+
+    Symbolizer symbolizer(!parser.isSet(noInlinesOpt));
+    foreach (const auto &fileName, parser.positionalArguments())
+        symbolizer.addFile(fileName);
+
+    QFile in;
+    if (parser.isSet(inputOpt)) {
+        in.setFileName(parser.value(inputOpt));
+        if (!in.open(QFile::ReadOnly)) {
+            std::cerr << "Failed to open " << qPrintable(in.fileName()) << ": " << qPrintable(in.errorString()) << std::endl;
+            return 1;
+        }
+    } else {
+        in.open(stdin, QFile::ReadOnly);
+    }
+    QFile out;
+    out.open(stdout, QFile::WriteOnly);
+
+    QVector<Request> requests;
+    requests.reserve(batchSize);
+    QVector<Location> locations;
+    const Location unknownLocation;
+    QByteArray outBuffer;
+    const auto flush = [&]() {
+        symbolizer.symbolize(requests, &locations);
+        outBuffer.clear();
+        for (const auto &request : requests) {
+            const auto &location = request.location >= 0 ? locations.at(request.location) : unknownLocation;
+            if (json)
+                writeJson(outBuffer, request, location);
+            else
+                writeTsv(outBuffer, request, location);
+        }
+        out.write(outBuffer);
+        out.flush();
+        requests.clear();
+    };
+
+    while (true) {
+        const auto line = in.readLine().trimmed();
+        if (line.isEmpty() && in.atEnd())
+            break;
+        if (line.isEmpty() || line.startsWith('#'))
+            continue;
+
+        Request request;
+        if (parseRequest(line, &request.module, &request.address))
+            request.file = symbolizer.fileForModule(request.module);
+        requests.push_back(request);
+        if (requests.size() >= batchSize)
+            flush();
+    }
+    flush();
+
+    return 0;
+}
@@ -16,15 +16,25 @@
 */
 
 #include "deadcodefinder.h"
+#include "ldsimulator.h"
+
 #include <elf/elffileset.h>
+#include <elf/elfgnuhashsection.h>
+#include <elf/elfrelocationentry.h>
+#include <elf/elfrelocationsection.h>
 #include <elf/elfsymboltablesection.h>
 #include <elf/elfhashsection.h>
 #include <elf/elfheader.h>
 
 #include <demangle/demangler.h>
 
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+
 #include <elf.h>
 
+#include <cstring>
 #include <iostream>
 
 DeadCodeFinder::DeadCodeFinder() = default;
@@ -66,22 +76,32 @@ void DeadCodeFinder::setExcludePrefixes(const QStringList& excludePrefixes)
     m_excludePrefixes = excludePrefixes;
 }
 
+void DeadCodeFinder::setKeepPatterns(const QStringList& keepPatterns)
+{
+    m_keepPatterns.clear();
+    m_keepPatterns.reserve(keepPatterns.size());
+    foreach (const auto &pattern, keepPatterns)
+        m_keepPatterns.push_back(QRegularExpression(QRegularExpression::anchoredPattern(QRegularExpression::wildcardToRegularExpression(pattern))));
+}
+
+bool DeadCodeFinder::isExcluded(ElfFile* file) const
+{
+    // this only makes sense for libraries
+    if (file->header()->type() == ET_EXEC || !file->hash())
+        return true;
+
+    foreach (const auto &excludePrefix, m_excludePrefixes) {
+        if (file->fileName().startsWith(excludePrefix))
+            return true;
+    }
+    return false;
+}
+
 void DeadCodeFinder::dumpResults()
 {
     for (int i = 0; i < m_fileSet->size(); ++i) {
         auto file = m_fileSet->file(i);
-        // this only makes sense for libraries
-        if (file->header()->type() == ET_EXEC)
-            continue;
-
-        bool skip = false;
-        foreach (const auto &excludePrefix, m_excludePrefixes) {
-            if (file->fileName().startsWith(excludePrefix)) {
-                skip = true;
-                break;
-            }
-        }
-        if (skip)
+        if (isExcluded(file))
             continue;
 
         std::cout << "Unreferenced exported symbols in " << qPrintable(file->displayName()) << ":" << std::endl;
@@ -90,23 +110,211 @@ void DeadCodeFinder::dumpResults()
     }
 }
 
-void DeadCodeFinder::dumpResultsForFile(ElfFile* file)
+bool DeadCodeFinder::isKept(ElfSymbolTableEntry* symbol, const QByteArray& demangledName) const
 {
-    const auto usedSyms = m_usedSymbols.value(file);
-    const auto symTab = file->hash()->linkedSection<ElfSymbolTableSection>();
+    if (m_keepPatterns.isEmpty())
+        return false;
+
+    const auto name = QString::fromLatin1(symbol->name());
+    const auto demangled = QString::fromUtf8(demangledName);
+    foreach (const auto &rx, m_keepPatterns) {
+        if (rx.match(name).hasMatch() || rx.match(demangled).hasMatch())
+            return true;
+    }
+    return false;
+}
+
+QVector<ElfSymbolTableEntry*> DeadCodeFinder::unusedSymbols(ElfFile* file) const
+{
+    const auto symTab = file->hash() ? file->hash()->linkedSection<ElfSymbolTableSection>() : nullptr;
     if (!symTab)
-        return;
+        return {};
+    return unusedSymbols(file, Demangler::demangleAll(symTab));
+}
 
-    QVector<QByteArray> unusedSyms;
+QVector<ElfSymbolTableEntry*> DeadCodeFinder::unusedSymbols(ElfFile* file, const DemangledNameTable& demangledNames) const
+{
+    QVector<ElfSymbolTableEntry*> unusedSyms;
+    const auto symTab = file->hash() ? file->hash()->linkedSection<ElfSymbolTableSection>() : nullptr;
+    if (!symTab)
+        return unusedSyms;
+
+    const auto usedSyms = m_usedSymbols.value(file);
     for (uint i = 0; i < symTab->header()->entryCount(); ++i) {
         auto sym = symTab->entry(i);
         if (sym->size() == 0 || sym->bindType() != STB_GLOBAL || sym->visibility() != STV_DEFAULT)
             continue;
-        if (usedSyms.contains(sym))
+        if (usedSyms.contains(sym) || isKept(sym, demangledNames.fullName(i)))
             continue;
-        unusedSyms.push_back(Demangler::demangleFull(sym->name()).constData());
+        unusedSyms.push_back(sym);
     }
+    return unusedSyms;
+}
+
+void DeadCodeFinder::dumpResultsForFile(ElfFile* file)
+{
+    const auto symTab = file->hash()->linkedSection<ElfSymbolTableSection>();
+    if (!symTab)
+        return;
+
+    const auto demangledNames = Demangler::demangleAll(symTab);
+    QVector<QByteArray> unusedSyms;
+    foreach (const auto sym, unusedSymbols(file, demangledNames))
+        unusedSyms.push_back(demangledNames.fullName(sym->index()));
 
     std::sort(unusedSyms.begin(), unusedSyms.end());
     std::for_each(unusedSyms.constBegin(), unusedSyms.constEnd(), [](const QByteArray& sym) { std::cout << sym.constData() << std::endl; });
 }
+
+QHash<ElfFile*, DeadCodeFinder::Savings> DeadCodeFinder::estimateSavings() const
+{
+    QHash<ElfFile*, QVector<ElfSymbolTableEntry*>> unused;
+    for (int i = 0; i < m_fileSet->size(); ++i) {
+        const auto file = m_fileSet->file(i);
+        if (isExcluded(file) || !file->hash()->linkedSection<ElfSymbolTableSection>())
+            continue;
+        unused.insert(file, unusedSymbols(file));
+    }
+    return estimateSavings(unused);
+}
+
+QHash<ElfFile*, DeadCodeFinder::Savings> DeadCodeFinder::estimateSavings(const QHash<ElfFile*, QVector<ElfSymbolTableEntry*>> &unusedByFile) const
+{
+    QHash<ElfFile*, Savings> savings;
+    QSet<ElfSymbolTableEntry*> hiddenSymbols;
+
+    for (int i = 0; i < m_fileSet->size(); ++i) {
+        const auto file = m_fileSet->file(i);
+        if (!unusedByFile.contains(file))
+            continue;
+        const auto symTab = file->hash()->linkedSection<ElfSymbolTableSection>();
+
+        const auto unusedList = unusedByFile.value(file);
+        QSet<ElfSymbolTableEntry*> unused;
+        Savings s;
+        s.symbols = unusedList.size();
+        s.dynsymSize = unusedList.size() * symTab->header()->entrySize();
+        foreach (const auto sym, unusedList) {
+            s.dynstrSize += strlen(sym->name()) + 1;
+            unused.insert(sym);
+        }
+        hiddenSymbols.unite(unused);
+
+        // chain entries, and buckets and bloom filter shrinking proportionally when rebuilt
+        const auto gnuHashIndex = file->indexOfSection(SHT_GNU_HASH);
+        if (gnuHashIndex >= 0) {
+            const auto gnuHash = file->section<ElfGnuHashSection>(gnuHashIndex);
+            if (gnuHash->chainCount() > 0) {
+                const auto tableSize = gnuHash->header()->size() - 4 * sizeof(uint32_t) - gnuHash->chainCount() * sizeof(uint32_t);
+                s.hashSize += unused.size() * sizeof(uint32_t) + tableSize * unused.size() / gnuHash->chainCount();
+            }
+        }
+        if (file->indexOfSection(SHT_HASH) >= 0)
+            s.hashSize += unused.size() * sizeof(uint32_t);
+        if (file->indexOfSection(SHT_GNU_versym) >= 0)
+            s.versionSize = unused.size() * sizeof(uint16_t);
+
+        for (int j = 0; j < file->sectionCount(); ++j) {
+            const auto relocs = file->section<ElfRelocationSection>(j);
+            if (!relocs)
+                continue;
+            for (uint64_t k = 0; k < relocs->header()->entryCount(); ++k) {
+                if (unused.contains(relocs->entry(k)->symbol()))
+                    ++s.symbolRelocations;
+            }
+        }
+        savings.insert(file, s);
+    }
+
+    LDSimulator sim;
+    sim.simulateFileSet(m_fileSet);
+    for (auto it = savings.begin(); it != savings.end(); ++it) {
+        const auto index = sim.indexOf(it.key());
+        if (index >= 0)
+            it.value().lookupCostBefore = sim.result(index).cost;
+    }
+    sim.setHiddenSymbols(hiddenSymbols);
+    sim.simulateFileSet(m_fileSet);
+    for (auto it = savings.begin(); it != savings.end(); ++it) {
+        const auto index = sim.indexOf(it.key());
+        if (index >= 0)
+            it.value().lookupCostAfter = sim.result(index).cost;
+    }
+
+    return savings;
+}
+
+static QByteArray versionScript(ElfFile *file, const QVector<ElfSymbolTableEntry*> &symbols)
+{
+    QByteArray script = "/* generated by elf-deadcodefinder for " + file->displayName().toUtf8() + " */\n";
+    if (file->indexOfSection(SHT_GNU_verdef) >= 0)
+        script += "/* this library defines symbol versions, merge the local entries into its existing version script */\n";
+    script += "{\n    global:\n        *;\n    local:\n";
+    foreach (const auto sym, symbols)
+        script += "        " + QByteArray(sym->name()) + ";\n";
+    script += "};\n";
+    return script;
+}
+
+bool DeadCodeFinder::writeResults(const QString& directory, OutputFormat format) const
+{
+    if (!QDir().mkpath(directory)) {
+        qWarning() << "Failed to create" << directory;
+        return false;
+    }
+
+    // demangle each file only once, for the keep patterns and the output
+    QHash<ElfFile*, QVector<ElfSymbolTableEntry*>> unused;
+    QHash<ElfFile*, QVector<QByteArray>> unusedNames;
+    for (int i = 0; i < m_fileSet->size(); ++i) {
+        const auto file = m_fileSet->file(i);
+        if (isExcluded(file))
+            continue;
+        const auto symTab = file->hash()->linkedSection<ElfSymbolTableSection>();
+        if (!symTab)
+            continue;
+
+        const auto demangledNames = Demangler::demangleAll(symTab);
+        const auto syms = unusedSymbols(file, demangledNames);
+        unused.insert(file, syms);
+        if (format == OutputFormat::HiddenSymbolList) {
+            auto &names = unusedNames[file];
+            names.reserve(syms.size());
+            foreach (const auto sym, syms)
+                names.push_back(demangledNames.fullName(sym->index()));
+            std::sort(names.begin(), names.end());
+        }
+    }
+
+    const auto savings = estimateSavings(unused);
+    for (int i = 0; i < m_fileSet->size(); ++i) {
+        const auto file = m_fileSet->file(i);
+        if (!savings.contains(file))
+            continue;
+
+        QByteArray content;
+        if (format == OutputFormat::VersionScript) {
+            content = versionScript(file, unused.value(file));
+        } else {
+            foreach (const auto &name, unusedNames.value(file))
+                content += name + '\n';
+        }
+
+        const auto fileName = directory + QLatin1Char('/') + file->displayName()
+            + (format == OutputFormat::VersionScript ? QLatin1String(".map") : QLatin1String(".hidden"));
+        QFile f(fileName);
+        if (!f.open(QFile::WriteOnly | QFile::Truncate)) {
+            qWarning() << "Failed to open" << fileName;
+            return false;
+        }
+        f.write(content);
+
+        const auto &s = savings.value(file);
+        std::cout << qPrintable(file->displayName()) << ": " << s.symbols << " symbols, "
+                  << s.dynsymSize << " bytes .dynsym, up to " << s.dynstrSize << " bytes .dynstr, "
+                  << s.hashSize << " bytes hash tables, " << s.versionSize << " bytes .gnu.version, "
+                  << s.symbolRelocations << " symbol relocations, lookup cost "
+                  << s.lookupCostBefore << " -> " << s.lookupCostAfter << std::endl;
+    }
+    return true;
+}
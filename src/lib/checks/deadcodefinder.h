@@ -19,9 +19,12 @@
 #define DEADCODEFINDER_H
 
 #include <QHash>
+#include <QRegularExpression>
 #include <QSet>
 #include <QStringList>
+#include <QVector>
 
+class DemangledNameTable;
 class ElfFileSet;
 class ElfFile;
 class ElfSymbolTableEntry;
@@ -39,17 +42,50 @@ public:
 
     void findUnusedSymbols(ElfFileSet *fileSet);
     void setExcludePrefixes(const QStringList &excludePrefixes);
+    /** Symbols matching any of these wildcard patterns, mangled or demangled, are kept exported. */
+    void setKeepPatterns(const QStringList &keepPatterns);
 
     void dumpResults();
 
+    /** Unreferenced exported symbols of @p file, excluding those matching a keep pattern. */
+    QVector<ElfSymbolTableEntry*> unusedSymbols(ElfFile *file) const;
+
+    /** Expected effect of hiding the unused symbols of a file, estimated from its current tables. */
+    struct Savings {
+        int symbols = 0;
+        uint64_t dynsymSize = 0;
+        uint64_t dynstrSize = 0; ///< upper bound, ignoring suffix merging
+        uint64_t hashSize = 0; ///< .gnu.hash and .hash
+        uint64_t versionSize = 0;
+        int symbolRelocations = 0; ///< relocations that no longer need a symbol lookup
+        double lookupCostBefore = 0.0; ///< see LDSimulator
+        double lookupCostAfter = 0.0;
+    };
+    /** Savings for all libraries that aren't excluded. */
+    QHash<ElfFile*, Savings> estimateSavings() const;
+
+    enum class OutputFormat {
+        VersionScript, ///< linker version script hiding unused symbols
+        HiddenSymbolList ///< demangled names of unused symbols, for adding visibility annotations
+    };
+    /** Writes one file per library that isn't excluded to @p directory, and prints the estimated savings.
+     *  Returns @c false if writing failed.
+     */
+    bool writeResults(const QString &directory, OutputFormat format) const;
+
 private:
     void scanUsage(ElfFile *file);
+    bool isExcluded(ElfFile *file) const;
+    QVector<ElfSymbolTableEntry*> unusedSymbols(ElfFile *file, const DemangledNameTable &demangledNames) const;
+    bool isKept(ElfSymbolTableEntry *symbol, const QByteArray &demangledName) const;
+    QHash<ElfFile*, Savings> estimateSavings(const QHash<ElfFile*, QVector<ElfSymbolTableEntry*>> &unusedByFile) const;
 
     void dumpResultsForFile(ElfFile *file);
 
     ElfFileSet *m_fileSet = nullptr;
     QHash<ElfFile*, QSet<ElfSymbolTableEntry*>> m_usedSymbols;
     QStringList m_excludePrefixes;
+    QVector<QRegularExpression> m_keepPatterns;
 };
 
 #endif // DEADCODEFINDER_H
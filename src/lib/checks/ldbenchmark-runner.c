@@ -15,20 +15,301 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#define _GNU_SOURCE /* sched_setaffinity */
+
+#include "ldbenchmarkprotocol.h"
+
 #include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
 #include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
 
-int usage()
+static int usage()
 {
-    fprintf(stderr, "Usage: ldbenchark-runner [RTLD_LAZY|RTLD_NOW] <files>\n");
+    fprintf(stderr, "Usage: ldbenchark-runner [--cpu <n>] [--statistics] [--cold] [--evict <file>]... [RTLD_LAZY|RTLD_NOW] <iterations> <files>\n");
     return 1;
 }
 
+static int64_t elapsed_ns(const struct timespec *start, const struct timespec *end)
+{
+    return (int64_t)(end->tv_sec - start->tv_sec) * 1000000000 + (end->tv_nsec - start->tv_nsec);
+}
+
+static int write_record(int fd, const struct ldbenchmark_record *record)
+{
+    const char *data = (const char*)record;
+    size_t size = sizeof(*record);
+    while (size > 0) {
+        const ssize_t written = write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        data += written;
+        size -= written;
+    }
+    return 0;
+}
+
+struct counter_set {
+    int fds[LDBENCHMARK_COUNTER_COUNT];
+};
+
+#ifdef __linux__
+static int open_counter(uint32_t type, uint64_t config)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1; /* works with the default perf_event_paranoid setting */
+    attr.exclude_hv = 1;
+    return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+/* counters that aren't supported by the CPU or not permitted stay at -1 */
+static void open_counters(struct counter_set *counters)
+{
+    for (int i = 0; i < LDBENCHMARK_COUNTER_COUNT; ++i)
+        counters->fds[i] = -1;
+#ifdef __linux__
+    counters->fds[LDBENCHMARK_COUNTER_CYCLES] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    counters->fds[LDBENCHMARK_COUNTER_INSTRUCTIONS] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    counters->fds[LDBENCHMARK_COUNTER_PAGE_FAULTS] = open_counter(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS);
+    counters->fds[LDBENCHMARK_COUNTER_DTLB_MISSES] = open_counter(PERF_TYPE_HW_CACHE,
+        PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+#endif
+}
+
+static void start_counters(const struct counter_set *counters)
+{
+#ifdef __linux__
+    for (int i = 0; i < LDBENCHMARK_COUNTER_COUNT; ++i) {
+        if (counters->fds[i] < 0)
+            continue;
+        ioctl(counters->fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(counters->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#else
+    (void)counters;
+#endif
+}
+
+static void stop_counters(const struct counter_set *counters, struct ldbenchmark_record *record)
+{
+#ifdef __linux__
+    for (int i = 0; i < LDBENCHMARK_COUNTER_COUNT; ++i) {
+        if (counters->fds[i] >= 0)
+            ioctl(counters->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+    for (int i = 0; i < LDBENCHMARK_COUNTER_COUNT; ++i) {
+        uint64_t value;
+        if (counters->fds[i] >= 0 && read(counters->fds[i], &value, sizeof(value)) == sizeof(value)) {
+            record->counters[i] = value;
+            record->valid_counters |= 1u << i;
+        }
+    }
+#else
+    (void)counters;
+    (void)record;
+#endif
+}
+
+/* process-wide counters sampled before and after each dlopen() */
+struct process_stats {
+    uint64_t values[LDBENCHMARK_COUNTER_COUNT];
+    uint32_t valid;
+};
+
+static uint64_t parse_io_field(const char *buffer, const char *field)
+{
+    const char *s = strstr(buffer, field);
+    return s ? strtoull(s + strlen(field), NULL, 10) : 0;
+}
+
+static void sample_process(int io_fd, struct process_stats *stats)
+{
+    stats->valid = 0;
+
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        stats->values[LDBENCHMARK_COUNTER_MINOR_FAULTS] = usage.ru_minflt;
+        stats->values[LDBENCHMARK_COUNTER_MAJOR_FAULTS] = usage.ru_majflt;
+        stats->valid |= 1u << LDBENCHMARK_COUNTER_MINOR_FAULTS | 1u << LDBENCHMARK_COUNTER_MAJOR_FAULTS;
+    }
+
+    char buffer[512];
+    const ssize_t size = io_fd >= 0 ? pread(io_fd, buffer, sizeof(buffer) - 1, 0) : -1;
+    if (size > 0) {
+        buffer[size] = 0;
+        stats->values[LDBENCHMARK_COUNTER_READ_SYSCALLS] = parse_io_field(buffer, "syscr:");
+        stats->values[LDBENCHMARK_COUNTER_READ_BYTES] = parse_io_field(buffer, "read_bytes:");
+        stats->valid |= 1u << LDBENCHMARK_COUNTER_READ_SYSCALLS | 1u << LDBENCHMARK_COUNTER_READ_BYTES;
+    }
+}
+
+static void record_process_stats(const struct process_stats *before, const struct process_stats *after, const struct process_stats *overhead, struct ldbenchmark_record *record)
+{
+    for (int i = 0; i < LDBENCHMARK_COUNTER_COUNT; ++i) {
+        if (!(before->valid & after->valid & (1u << i)))
+            continue;
+        const uint64_t diff = after->values[i] - before->values[i];
+        record->counters[i] = diff > overhead->values[i] ? diff - overhead->values[i] : 0;
+        record->valid_counters |= 1u << i;
+    }
+}
+
+/* drops the page cache of @p file_name, returns the number of pages that stayed resident
+ * (mapped or dirty ones can't be dropped), or -1 on error */
+static long evict_file(const char *file_name)
+{
+    const int fd = open(file_name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return -1;
+
+    long resident = -1;
+    struct stat st;
+    if (posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0 && fstat(fd, &st) == 0) {
+        resident = 0;
+        void *map = st.st_size > 0 ? mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+        if (map != MAP_FAILED) {
+            const long page_size = sysconf(_SC_PAGESIZE);
+            const size_t page_count = (st.st_size + page_size - 1) / page_size;
+            unsigned char *pages = malloc(page_count);
+            if (pages && mincore(map, st.st_size, pages) == 0) {
+                for (size_t i = 0; i < page_count; ++i)
+                    resident += pages[i] & 1;
+            }
+            free(pages);
+            munmap(map, st.st_size);
+        }
+    }
+    close(fd);
+    return resident;
+}
+
+/* evicts all @p files, storing the number of pages that stayed resident in @p resident if not NULL */
+static void evict_files(int count, char **files, uint64_t *resident)
+{
+    for (int i = 0; i < count; ++i) {
+        const long pages = evict_file(files[i]);
+        if (pages < 0)
+            fprintf(stderr, "Failed to evict %s from the page cache: %s\n", files[i], strerror(errno));
+        if (resident)
+            resident[i] = pages > 0 ? pages : 0;
+    }
+}
+
+/* runs in a freshly forked child, so every iteration starts from the same clean process state */
+static int run_iteration(int out, uint32_t iteration, int flags, int fileCount, char **files, const uint64_t *resident)
+{
+    struct counter_set counters;
+    open_counters(&counters);
+
+    /* reading /proc/self/io is a read syscall itself, measure what sampling costs with nothing in between */
+    const int io_fd = open("/proc/self/io", O_RDONLY | O_CLOEXEC);
+    struct process_stats before, after, overhead;
+    sample_process(io_fd, &before);
+    sample_process(io_fd, &after);
+    memset(&overhead, 0, sizeof(overhead));
+    for (int i = 0; i < LDBENCHMARK_COUNTER_COUNT; ++i)
+        overhead.values[i] = after.values[i] - before.values[i];
+
+    for (int i = 0; i < fileCount; ++i) {
+        if (dlopen(files[i], flags | RTLD_NOLOAD) != NULL) {
+            fprintf(stderr, "%s is already loaded, check argument order!\n", files[i]);
+            continue;
+        }
+
+        struct ldbenchmark_record record;
+        memset(&record, 0, sizeof(record));
+        record.magic = LDBENCHMARK_RECORD_MAGIC;
+        record.iteration = iteration;
+        record.file_index = i;
+        record.resident_pages = resident[i];
+
+        struct timespec start, end;
+        sample_process(io_fd, &before);
+        start_counters(&counters);
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+        void* result = dlopen(files[i], flags);
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+        stop_counters(&counters, &record);
+        sample_process(io_fd, &after);
+        record_process_stats(&before, &after, &overhead, &record);
+
+        if (!result) {
+            fprintf(stderr, "Loading %s failed: %s\n", files[i], dlerror());
+            return 1;
+        }
+
+        record.time_ns = elapsed_ns(&start, &end);
+        if (write_record(out, &record) != 0)
+            return 1;
+    }
+
+    return 0;
+}
+
 int main(int argc, char **argv)
 {
-    if (argc < 3)
+    if (argc > 2 && strcmp(argv[1], "--cpu") == 0) {
+#ifdef __linux__
+        /* pin parent and thus all forked children to one core, so parallel runners don't migrate into each other */
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(atoi(argv[2]), &cpus);
+        if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0)
+            perror("sched_setaffinity");
+#endif
+        argc -= 2;
+        argv += 2;
+    }
+
+    /* exit children normally, so LD_DEBUG=statistics output of the dynamic linker is printed */
+    int statistics = 0;
+    if (argc > 1 && strcmp(argv[1], "--statistics") == 0) {
+        statistics = 1;
+        --argc;
+        ++argv;
+    }
+
+    /* drop the loaded files and any additional ones (such as separate debug files) from the page cache before each iteration */
+    int cold = 0;
+    if (argc > 1 && strcmp(argv[1], "--cold") == 0) {
+        cold = 1;
+        --argc;
+        ++argv;
+    }
+    char **evict = argv + 1;
+    int evict_count = 0;
+    while (argc > 2 && strcmp(argv[1], "--evict") == 0) {
+        evict[evict_count++] = argv[2]; /* compacts the option values in place */
+        argc -= 2;
+        argv += 2;
+    }
+
+    if (argc < 4)
         return usage();
 
     int flags = 0;
@@ -39,31 +320,58 @@ int main(int argc, char **argv)
     else
         return usage();
 
-    for (int i = 2; i < argc; ++i) {
-        if (dlopen(argv[i], flags | RTLD_NOLOAD) != NULL) {
-            fprintf(stderr, "%s is already loaded, check argument order!\n", argv[i]);
-            continue;
-        }
+    const int iterations = atoi(argv[2]);
+    if (iterations <= 0)
+        return usage();
 
-        struct timespec start, end;
-        clock_gettime(CLOCK_REALTIME, &start);
-        void* result = dlopen(argv[i], flags);
-        clock_gettime(CLOCK_REALTIME, &end);
+    /* keep stdout for the binary results, and route whatever the loaded code prints to stderr */
+    const int out = dup(STDOUT_FILENO);
+    dup2(STDERR_FILENO, STDOUT_FILENO);
 
-        if (!result) {
-            fprintf(stderr, "Loading %s failed: %s\n", argv[i], dlerror());
+    /* warm up everything the measurement code needs before the first fork,
+     * so children don't pay for resolving it on their first use */
+    struct timespec warmup;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &warmup);
+    dlerror();
+    fflush(stderr);
+
+    /* reported with each result, so eviction failures are visible where the cold results are shown */
+    uint64_t *resident = calloc(argc - 3, sizeof(uint64_t));
+    if (!resident)
+        return 1;
+
+    for (int i = 0; i < iterations; ++i) {
+        if (cold) {
+            evict_files(argc - 3, argv + 3, resident);
+            evict_files(evict_count, evict, NULL);
+            fflush(stderr);
+        }
+
+        const pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
             return 1;
         }
+        if (pid == 0) {
+            const int rc = run_iteration(out, i, flags, argc - 3, argv + 3, resident);
+            if (statistics)
+                exit(rc);
+            _exit(rc);
+        }
 
-        long long diff = (end.tv_sec - start.tv_sec) * 1000000000;
-        if (diff == 0)
-            diff = end.tv_nsec - start.tv_nsec;
-        else {
-            diff += end.tv_nsec;
-            diff += 1000000000 - start.tv_nsec;
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0) {
+            if (errno != EINTR) {
+                perror("waitpid");
+                return 1;
+            }
+        }
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "Benchmark iteration %d failed.\n", i);
+            return 1;
         }
-        fprintf(stdout, "LDBENCHMARKRUNNER\t%s\t%.2f\n", argv[i], diff/1000.0);
     }
 
+    free(resident);
     return 0;
 }
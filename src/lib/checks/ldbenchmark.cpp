@@ -16,17 +16,37 @@
 */
 
 #include "ldbenchmark.h"
+#include "ldbenchmarkprotocol.h"
 
 #include <elf/elffile.h>
 #include <elf/elffileset.h>
+#include <elf/elfhashsection.h>
+#include <elf/elfrelocationsection.h>
+#include <elf/elfsectionheader.h>
 
 #include <QDebug>
 #include <QProcess>
+#include <QProcessEnvironment>
+#include <QRegularExpression>
+#include <QThread>
 
 #include <algorithm>
 #include <iostream>
 
 #include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+
+#ifdef Q_OS_LINUX
+#include <sched.h>
+#endif
+
+static const int MinAdaptiveIterations = 20;
+static const int MaxAdaptiveIterations = 500;
+static const int AdaptiveBatchSize = 10;
+static const double AdaptiveTargetPrecision = 0.05; // relative width of the p50 confidence interval
 
 static double median(QVector<double> data)
 {
@@ -51,69 +71,427 @@ static double max(const QVector<double> &data)
 }
 
 
+// least squares solution of @p x * coeffs = @p y restricted to the columns in @p mask, via the normal equations
+static bool solveLeastSquares(const QVector<QVector<double>> &x, const QVector<double> &y, unsigned int mask, QVector<double> &coeffs)
+{
+    QVector<int> cols;
+    for (int j = 0; j < x.at(0).size(); ++j) {
+        if (mask & (1u << j))
+            cols.push_back(j);
+    }
+    const int p = cols.size();
+
+    // augmented matrix [X^T X | X^T y]
+    QVector<QVector<double>> a(p, QVector<double>(p + 1, 0.0));
+    for (int row = 0; row < x.size(); ++row) {
+        for (int i = 0; i < p; ++i) {
+            for (int j = 0; j < p; ++j)
+                a[i][j] += x.at(row).at(cols.at(i)) * x.at(row).at(cols.at(j));
+            a[i][p] += x.at(row).at(cols.at(i)) * y.at(row);
+        }
+    }
+
+    // Gaussian elimination with partial pivoting
+    for (int i = 0; i < p; ++i) {
+        int pivot = i;
+        for (int k = i + 1; k < p; ++k) {
+            if (std::abs(a.at(k).at(i)) > std::abs(a.at(pivot).at(i)))
+                pivot = k;
+        }
+        if (std::abs(a.at(pivot).at(i)) < 1e-12)
+            return false;
+        std::swap(a[i], a[pivot]);
+        for (int k = i + 1; k < p; ++k) {
+            const auto f = a.at(k).at(i) / a.at(i).at(i);
+            for (int j = i; j <= p; ++j)
+                a[k][j] -= f * a.at(i).at(j);
+        }
+    }
+    coeffs.fill(0.0, x.at(0).size());
+    for (int i = p - 1; i >= 0; --i) {
+        auto v = a.at(i).at(p);
+        for (int j = i + 1; j < p; ++j)
+            v -= a.at(i).at(j) * coeffs.at(cols.at(j));
+        coeffs[cols.at(i)] = v / a.at(i).at(i);
+    }
+    return true;
+}
+
+// non-negative least squares by exhaustive search over the active set, fine for a handful of variables
+static QVector<double> nonNegativeLeastSquares(const QVector<QVector<double>> &x, const QVector<double> &y)
+{
+    const int varCount = x.isEmpty() ? 0 : x.at(0).size();
+    QVector<double> best(varCount, 0.0);
+    if (varCount == 0)
+        return best;
+
+    // scale columns to a comparable range to keep the normal equations well-conditioned
+    QVector<double> scale(varCount, 0.0);
+    for (const auto &row : x) {
+        for (int j = 0; j < varCount; ++j)
+            scale[j] = std::max(scale.at(j), std::abs(row.at(j)));
+    }
+    auto scaled = x;
+    for (auto &row : scaled) {
+        for (int j = 0; j < varCount; ++j)
+            row[j] = scale.at(j) > 0.0 ? row.at(j) / scale.at(j) : 0.0;
+    }
+
+    auto bestError = std::numeric_limits<double>::max();
+    QVector<double> coeffs;
+    for (unsigned int mask = 1; mask < (1u << varCount); ++mask) {
+        if (!solveLeastSquares(scaled, y, mask, coeffs))
+            continue;
+        if (std::any_of(coeffs.constBegin(), coeffs.constEnd(), [](double c) { return c < 0.0; }))
+            continue;
+        double error = 0.0;
+        for (int row = 0; row < scaled.size(); ++row) {
+            double v = 0.0;
+            for (int j = 0; j < varCount; ++j)
+                v += scaled.at(row).at(j) * coeffs.at(j);
+            error += (v - y.at(row)) * (v - y.at(row));
+        }
+        if (error < bestError) {
+            bestError = error;
+            best = coeffs;
+        }
+    }
+
+    for (int j = 0; j < varCount; ++j)
+        best[j] = scale.at(j) > 0.0 ? best.at(j) / scale.at(j) : 0.0;
+    return best;
+}
+
+// number of relocations referring to a symbol, ie. those needing a symbol lookup
+static int symbolRelocationCount(const ElfFile *file)
+{
+    int count = 0;
+    for (int i = 0; i < file->sectionCount(); ++i) {
+        const auto section = file->section<ElfRelocationSection>(i);
+        if (!section)
+            continue;
+        for (uint32_t j = 0; j < section->header()->entryCount(); ++j) {
+            if (section->entry(j)->symbolIndex() != 0)
+                ++count;
+        }
+    }
+    return count;
+}
+
+// average number of hash chain entries compared per symbol lookup
+static double averageHashChainLength(const ElfFile *file)
+{
+    if (!file->hash())
+        return 1.0;
+    const auto hist = file->hash()->histogram();
+    uint64_t buckets = 0;
+    uint64_t entries = 0;
+    for (int i = 1; i < hist.size(); ++i) {
+        buckets += hist.at(i);
+        entries += (uint64_t)i * hist.at(i);
+    }
+    return buckets > 0 ? 1.0 + (double)entries / buckets : 1.0;
+}
+
+// CPUs we may run on, leaving out the first one if possible as that tends to get most interrupts
+static QVector<int> availableCpus()
+{
+    QVector<int> cpus;
+#ifdef Q_OS_LINUX
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int i = 0; i < CPU_SETSIZE; ++i) {
+            if (CPU_ISSET(i, &set))
+                cpus.push_back(i);
+        }
+    }
+#endif
+    if (cpus.size() > 1)
+        cpus.removeFirst();
+    return cpus;
+}
+
+void LDBenchmark::setStrategy(Strategy strategy)
+{
+    m_strategy = strategy;
+}
+
+void LDBenchmark::setColdCache(bool enabled)
+{
+    m_coldCache = enabled;
+}
+
+bool LDBenchmark::coldCache() const
+{
+    return m_coldCache;
+}
+
 void LDBenchmark::measureFileSet(ElfFileSet* fileSet)
 {
     m_fileSet = fileSet;
 
     m_results.clear();
     m_results.reserve(fileSet->size());
+    m_validCounters = 0;
 
-    m_args.reserve(fileSet->size() + 1);
-    m_args.push_back(QString()); // placeholder for mode argument
+    m_args.clear();
+    m_args.reserve(fileSet->size());
+    m_evictArgs.clear();
 
     for (int i = fileSet->size() - 1; i >= 0; --i) {
         const auto fileName = fileSet->file(i)->fileName();
         m_args.push_back(fileName);
+        if (const auto debugFile = fileSet->file(i)->separateDebugFile())
+            m_evictArgs << QStringLiteral("--evict") << debugFile->fileName();
         Result r;
         r.fileName = fileName.toUtf8();
         m_results.push_back(r);
     }
 
-    measure(LoadMode::None, 1); // avoid cold cache skewing the results
-    measure(LoadMode::Lazy, 5);
-    measure(LoadMode::Now, 5);
+    measureLinkerStatistics(); // also avoids cold cache skewing the results
+    for (const auto mode : { LoadMode::Lazy, LoadMode::Now, LoadMode::Cold }) {
+        if (mode == LoadMode::Cold && !m_coldCache)
+            continue;
+        if (mode == LoadMode::Cold) {
+            // our own mappings would keep the pages in the page cache otherwise
+            for (int i = 0; i < fileSet->size(); ++i) {
+                fileSet->file(i)->releaseMappedPages();
+                if (const auto debugFile = fileSet->file(i)->separateDebugFile())
+                    debugFile->releaseMappedPages();
+            }
+        }
+        if (m_strategy == Strategy::Adaptive)
+            measureAdaptive(mode);
+        else
+            measure(mode, 20);
+        updateStatistics(mode);
+    }
+    computeBreakdown();
+}
+
+void LDBenchmark::measureLinkerStatistics()
+{
+    m_linkerRelocations = -1;
+    m_linkerCachedRelocations = -1;
+
+    QStringList args;
+    args.reserve(m_args.size() + 3);
+    args << QStringLiteral("--statistics") << QStringLiteral("RTLD_NOW") << QStringLiteral("1");
+    args += m_args;
+
+    QProcess proc;
+    auto env = QProcessEnvironment::systemEnvironment();
+    env.insert(QStringLiteral("LD_DEBUG"), QStringLiteral("statistics"));
+    proc.setProcessEnvironment(env);
+    proc.start(QStringLiteral("ldbenchmark-runner"), args); // TODO find in libexec
+    proc.waitForFinished(-1);
+
+    // the runner reports its own startup statistics first, then the final statistics of the child
+    // that loaded the entire file set, and finally its own final statistics again. The child inherits
+    // the counters of the runner when forked, so everything the runner relocated itself has to be
+    // subtracted, which is its final rather than its startup count.
+    // Anything else on stderr is output of the loaded libraries, which we are not interested in.
+    static const QRegularExpression statsRegExp(QStringLiteral("^\\s*(\\d+):\\s*(final )?number of relocations( from cache)?:\\s*(\\d+)"));
+    QByteArray runnerPid;
+    int runnerCount[2] = { 0, 0 };
+    int childCount[2] = { -1, -1 };
+    const auto errors = proc.readAllStandardError();
+    foreach (const auto &line, errors.split('\n')) {
+        const auto match = statsRegExp.match(QString::fromLocal8Bit(line));
+        if (!match.hasMatch())
+            continue;
+        const auto pid = match.captured(1).toLatin1();
+        if (runnerPid.isEmpty())
+            runnerPid = pid; // the startup statistics are always the runner's
+        const auto cached = match.capturedLength(3) > 0 ? 1 : 0;
+        const auto value = match.captured(4).toInt();
+        if (pid == runnerPid)
+            runnerCount[cached] = std::max(runnerCount[cached], value);
+        else if (match.capturedLength(2) > 0)
+            childCount[cached] = std::max(childCount[cached], value);
+    }
+
+    if (childCount[0] >= 0)
+        m_linkerRelocations = std::max(0, childCount[0] - runnerCount[0]);
+    if (childCount[1] >= 0)
+        m_linkerCachedRelocations = std::max(0, childCount[1] - runnerCount[1]);
+}
+
+void LDBenchmark::startRunner(QProcess *proc, LoadMode mode, int iterations, int cpu) const
+{
+    // the runner forks a fresh child from a single warmed up process for each iteration
+    QStringList args;
+    args.reserve(m_args.size() + m_evictArgs.size() + 5);
+    if (cpu >= 0)
+        args << QStringLiteral("--cpu") << QString::number(cpu);
+    if (mode == LoadMode::Cold) {
+        args.push_back(QStringLiteral("--cold"));
+        args += m_evictArgs;
+    }
+    args.push_back(mode == LoadMode::Lazy ? QStringLiteral("RTLD_LAZY") : QStringLiteral("RTLD_NOW"));
+    args.push_back(QString::number(iterations));
+    args += m_args;
+
+    proc->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    proc->start(QStringLiteral("ldbenchmark-runner"), args); // TODO find in libexec
 }
 
 void LDBenchmark::measure(LDBenchmark::LoadMode mode, int iterations)
 {
-    m_args[0] = mode == LoadMode::Lazy ? QStringLiteral("RTLD_LAZY") : QStringLiteral("RTLD_NOW");
-    for (int i = 0; i < iterations; ++i) {
-        QProcess proc;
-        proc.setProcessChannelMode(QProcess::QProcess::ForwardedErrorChannel);
-        proc.start(QStringLiteral("ldbenchmark-runner"), m_args); // TODO find in libexec
-        proc.waitForFinished();
-        if (proc.exitStatus() == QProcess::CrashExit)
-            qWarning() << "Benchmark runner crashed!";
-        readResults(&proc, mode);
+    QProcess proc;
+    startRunner(&proc, mode, iterations);
+    proc.waitForFinished(-1);
+    readResults(&proc, mode);
+}
+
+void LDBenchmark::measureAdaptive(LoadMode mode)
+{
+    // cold runs evict what concurrent runners would be loading, and compete for I/O, so never run those in parallel
+    const auto cpus = availableCpus();
+    const int runnerCount = mode == LoadMode::Cold ? 1 : std::max(1, cpus.size());
+
+    int iterations = 0;
+    do {
+        std::vector<std::unique_ptr<QProcess>> runners;
+        for (int i = 0; i < runnerCount; ++i) {
+            runners.emplace_back(new QProcess);
+            startRunner(runners.back().get(), mode, AdaptiveBatchSize, cpus.value(i, -1));
+        }
+        for (const auto &runner : runners) {
+            runner->waitForFinished(-1);
+            readResults(runner.get(), mode);
+        }
+        iterations += runnerCount * AdaptiveBatchSize;
+        updateStatistics(mode);
+    } while (iterations < MaxAdaptiveIterations && (iterations < MinAdaptiveIterations || !hasConverged(mode)));
+}
+
+void LDBenchmark::computeBreakdown()
+{
+    // lookups hit the hash tables of everything loaded before, so use the average chain length
+    // of the entire set as the per-lookup cost, and skip those the linker served from its cache
+    double chainLength = 0.0;
+    for (int i = 0; i < m_results.size(); ++i)
+        chainLength += averageHashChainLength(file(i));
+    chainLength = m_results.isEmpty() ? 1.0 : chainLength / m_results.size();
+    const auto uncachedRatio = m_linkerRelocations > 0 && m_linkerCachedRelocations >= 0
+        ? 1.0 - (double)m_linkerCachedRelocations / m_linkerRelocations : 1.0;
+
+    enum { Intercept, Relocations, Lookups, MajorFaults, ReadSyscalls, MinorFaults, VarCount };
+    static_assert(MinBreakdownFileCount >= 2 * VarCount, "Too few files per regression variable");
+
+    // files already loaded by the runner have no samples, but plenty of relocations, those would skew the fit
+    QVector<int> rows;
+    QVector<QVector<double>> x;
+    QVector<double> y;
+    for (int i = 0; i < m_results.size(); ++i) {
+        if (!hasSamples(LoadMode::Now, i))
+            continue;
+        QVector<double> row(VarCount, 0.0);
+        row[Intercept] = 1.0;
+        row[Relocations] = file(i)->reverseRelocator()->size();
+        row[Lookups] = symbolRelocationCount(file(i)) * uncachedRatio * chainLength;
+        row[MajorFaults] = median(LoadMode::Now, Counter::MajorFaults, i);
+        row[ReadSyscalls] = median(LoadMode::Now, Counter::ReadSyscalls, i);
+        row[MinorFaults] = median(LoadMode::Now, Counter::MinorFaults, i);
+        rows.push_back(i);
+        x.push_back(row);
+        y.push_back(median(LoadMode::Now, i));
+    }
+    m_hasBreakdown = rows.size() >= MinBreakdownFileCount;
+    if (!m_hasBreakdown)
+        return;
+    const auto coeffs = nonNegativeLeastSquares(x, y);
+
+    for (int k = 0; k < rows.size(); ++k) {
+        const auto &row = x.at(k);
+        Breakdown b;
+        b.relocation = coeffs.value(Relocations) * row.at(Relocations);
+        b.symbolLookup = coeffs.value(Lookups) * row.at(Lookups);
+        b.io = coeffs.value(MajorFaults) * row.at(MajorFaults)
+             + coeffs.value(ReadSyscalls) * row.at(ReadSyscalls)
+             + coeffs.value(MinorFaults) * row.at(MinorFaults);
+        const auto total = y.at(k);
+        const auto explained = b.relocation + b.symbolLookup + b.io;
+        if (explained > total && explained > 0.0) {
+            const auto f = total / explained;
+            b.relocation *= f;
+            b.symbolLookup *= f;
+            b.io *= f;
+        } else {
+            b.other = total - explained;
+        }
+        m_results[rows.at(k)].breakdown = b;
     }
 }
 
-void LDBenchmark::readResults(QProcess* proc, LoadMode mode)
+void LDBenchmark::updateStatistics(LoadMode mode)
 {
-    while(proc->canReadLine()) {
-        const auto line = proc->readLine();
-        if (!line.startsWith("LDBENCHMARKRUNNER\t")) {
-            qDebug() << "target stdout:" << line;
+    for (int i = 0; i < m_results.size(); ++i) {
+        auto &s = samples(mode, i);
+        s.statistics = computeStatistics(s.time);
+    }
+}
+
+bool LDBenchmark::hasConverged(LoadMode mode) const
+{
+    // files already loaded by the runner get no samples at all, those can't converge
+    for (int i = 0; i < m_results.size(); ++i) {
+        if (!hasSamples(mode, i))
             continue;
+        const auto &p50 = samples(mode, i).statistics.p50;
+        if (p50.value <= 0.0 || (p50.upper - p50.lower) / p50.value > AdaptiveTargetPrecision)
+            return false;
+    }
+    return true;
+}
+
+void LDBenchmark::readResults(QProcess* proc, LoadMode mode)
+{
+    if (proc->exitStatus() == QProcess::CrashExit)
+        qWarning() << "Benchmark runner crashed!";
+    else if (proc->exitCode() != 0)
+        qWarning() << "Benchmark runner failed:" << proc->exitCode();
+
+    static_assert(CounterCount == LDBENCHMARK_COUNTER_COUNT, "Counter enum and runner protocol out of sync");
+
+    const auto data = proc->readAllStandardOutput();
+    if (data.size() % sizeof(ldbenchmark_record) != 0)
+        qWarning() << "Truncated benchmark runner output!";
+
+    for (int offset = 0; offset + (int)sizeof(ldbenchmark_record) <= data.size(); offset += sizeof(ldbenchmark_record)) {
+        ldbenchmark_record record;
+        memcpy(&record, data.constData() + offset, sizeof(record));
+        if (record.magic != LDBENCHMARK_RECORD_MAGIC) {
+            qWarning() << "Invalid benchmark runner output!";
+            return;
         }
-        const auto index = line.lastIndexOf('\t');
-        const auto fileName = line.mid(18, index - 18);
-        const auto cost = line.mid(index).trimmed().toDouble();
-        auto it = std::find_if(m_results.begin(), m_results.end(), [fileName](const Result &res) {
-            return res.fileName == fileName;
-        });
-        assert(it != m_results.end());
+        // first argument after mode and iteration count is file index 0
+        assert((int)record.file_index < m_results.size());
 
+        Samples *samples = nullptr;
         switch (mode) {
             case LoadMode::Lazy:
-                (*it).lazy.push_back(cost);
+                samples = &m_results[record.file_index].lazy;
                 break;
             case LoadMode::Now:
-                (*it).now.push_back(cost);
+                samples = &m_results[record.file_index].now;
+                break;
+            case LoadMode::Cold:
+                samples = &m_results[record.file_index].cold;
+                m_results[record.file_index].coldResidentPages = std::max(m_results.at(record.file_index).coldResidentPages, record.resident_pages);
                 break;
             case LoadMode::None:
                 return;
         }
+
+        samples->time.push_back(record.time_ns / 1000.0);
+        m_validCounters |= record.valid_counters;
+        for (int i = 0; i < CounterCount; ++i) {
+            if (record.valid_counters & (1u << i))
+                samples->counters[i].push_back(record.counters[i]);
+        }
     }
 }
 
@@ -125,41 +503,194 @@ void LDBenchmark::writeCSV(const QString& fileName)
         return;
     }
 
+    // files already loaded by the runner have no samples, leave those out of the plot rather than showing 0
+    const auto writeValue = [&f](bool valid, double v) {
+        f.write("\t");
+        f.write(valid ? QByteArray::number(v) : QByteArray("nan"));
+    };
+
     for (int i = 0; i < m_results.size(); ++i) {
         const auto res = m_results.at(i);
         const auto file = m_fileSet->file(m_results.size() - 1 - i);
         f.write(file->displayName().toUtf8());
+        for (const auto mode : { LoadMode::Lazy, LoadMode::Now }) {
+            const auto &s = samples(mode, i);
+            writeValue(hasSamples(mode, i), s.statistics.p50.value);
+            writeValue(hasSamples(mode, i), ::min(s.time));
+            writeValue(hasSamples(mode, i), ::max(s.time));
+        }
+        for (const auto mode : { LoadMode::Lazy, LoadMode::Now }) {
+            for (int j = 0; j < CounterCount; ++j)
+                writeValue(hasSamples(mode, i), ::median(samples(mode, i).counters[j]));
+        }
+        for (const auto mode : { LoadMode::Lazy, LoadMode::Now }) {
+            const auto &stats = statistics(mode, i);
+            for (const auto &p : { stats.p50, stats.p90, stats.p99 }) {
+                writeValue(hasSamples(mode, i), p.value);
+                writeValue(hasSamples(mode, i), p.lower);
+                writeValue(hasSamples(mode, i), p.upper);
+            }
+            f.write("\t");
+            f.write(QByteArray::number(stats.sampleCount));
+            f.write("\t");
+            f.write(QByteArray::number(stats.outlierCount));
+        }
+        for (const auto v : { res.breakdown.relocation, res.breakdown.symbolLookup, res.breakdown.io, res.breakdown.other })
+            writeValue(m_hasBreakdown && hasSamples(LoadMode::Now, i), v);
+        // invalid cold results are left out of the plot
+        const auto coldValid = isColdResultValid(i);
+        for (const auto v : { res.cold.statistics.p50.value, ::min(res.cold.time), ::max(res.cold.time) })
+            writeValue(coldValid, v);
+        writeValue(hasSamples(LoadMode::Cold, i), ::median(res.cold.counters[static_cast<int>(Counter::MajorFaults)]));
         f.write("\t");
-        f.write(QByteArray::number(::median(res.lazy)));
-        f.write("\t");
-        f.write(QByteArray::number(::min(res.lazy)));
-        f.write("\t");
-        f.write(QByteArray::number(::max(res.lazy)));
-        f.write("\t");
-        f.write(QByteArray::number(::median(res.now)));
-        f.write("\t");
-        f.write(QByteArray::number(::min(res.now)));
-        f.write("\t");
-        f.write(QByteArray::number(::max(res.now)));
+        f.write(QByteArray::number(res.coldResidentPages));
         f.write("\n");
     }
 }
 
+// nearest-rank percentile of sorted @p data, with the order statistics bounding its 95% confidence interval
+LDBenchmark::Percentile LDBenchmark::percentile(const QVector<double> &data, double q)
+{
+    Percentile p;
+    const int n = data.size();
+    if (n == 0)
+        return p;
+    const auto spread = 1.96 * std::sqrt(n * q * (1.0 - q));
+    const auto clampRank = [n](double rank) { return std::max(0, std::min(n - 1, (int)rank - 1)); };
+    p.value = data.at(clampRank(std::ceil(n * q)));
+    p.lower = data.at(clampRank(std::floor(n * q - spread)));
+    p.upper = data.at(clampRank(std::ceil(n * q + spread)));
+    return p;
+}
+
+LDBenchmark::Statistics LDBenchmark::computeStatistics(QVector<double> data)
+{
+    Statistics stats;
+    if (data.isEmpty())
+        return stats;
+    std::sort(data.begin(), data.end());
+
+    // reject samples with a modified z-score above 3.5 (Iglewicz/Hoaglin)
+    const auto med = data.at(data.size() / 2);
+    QVector<double> deviations;
+    deviations.reserve(data.size());
+    for (const auto x : data)
+        deviations.push_back(std::abs(x - med));
+    const auto mad = ::median(deviations);
+    if (mad > 0.0) {
+        const auto end = std::remove_if(data.begin(), data.end(), [med, mad](double x) {
+            return std::abs(x - med) / (1.4826 * mad) > 3.5;
+        });
+        stats.outlierCount = std::distance(end, data.end());
+        data.erase(end, data.end());
+    }
+
+    stats.sampleCount = data.size();
+    stats.p50 = percentile(data, 0.5);
+    stats.p90 = percentile(data, 0.9);
+    stats.p99 = percentile(data, 0.99);
+    return stats;
+}
+
 int LDBenchmark::size() const
 {
     return m_results.size();
 }
 
-double LDBenchmark::median(LoadMode mode, int index) const
+const LDBenchmark::Samples& LDBenchmark::samples(LoadMode mode, int index) const
 {
     const auto &res = m_results.at(index);
-    return ::median(mode == LoadMode::Lazy ? res.lazy : res.now);
+    switch (mode) {
+        case LoadMode::Lazy:
+            return res.lazy;
+        case LoadMode::Cold:
+            return res.cold;
+        default:
+            return res.now;
+    }
+}
+
+LDBenchmark::Samples& LDBenchmark::samples(LoadMode mode, int index)
+{
+    auto &res = m_results[index];
+    switch (mode) {
+        case LoadMode::Lazy:
+            return res.lazy;
+        case LoadMode::Cold:
+            return res.cold;
+        default:
+            return res.now;
+    }
+}
+
+double LDBenchmark::median(LoadMode mode, int index) const
+{
+    return statistics(mode, index).p50.value;
 }
 
 double LDBenchmark::min(LDBenchmark::LoadMode mode, int index) const
 {
-    const auto &res = m_results.at(index);
-    return ::min(mode == LoadMode::Lazy ? res.lazy : res.now);
+    return ::min(samples(mode, index).time);
+}
+
+bool LDBenchmark::hasCounter(Counter counter) const
+{
+    return m_validCounters & (1u << static_cast<int>(counter));
+}
+
+double LDBenchmark::median(LoadMode mode, Counter counter, int index) const
+{
+    return ::median(samples(mode, index).counters[static_cast<int>(counter)]);
+}
+
+const LDBenchmark::Statistics& LDBenchmark::statistics(LoadMode mode, int index) const
+{
+    return samples(mode, index).statistics;
+}
+
+bool LDBenchmark::hasBreakdown() const
+{
+    return m_hasBreakdown;
+}
+
+int LDBenchmark::measuredFileCount() const
+{
+    int count = 0;
+    for (int i = 0; i < m_results.size(); ++i) {
+        if (hasSamples(LoadMode::Now, i))
+            ++count;
+    }
+    return count;
+}
+
+bool LDBenchmark::hasSamples(LoadMode mode, int index) const
+{
+    return !samples(mode, index).time.isEmpty();
+}
+
+const LDBenchmark::Breakdown& LDBenchmark::breakdown(int index) const
+{
+    return m_results.at(index).breakdown;
+}
+
+uint64_t LDBenchmark::coldResidentPageCount(int index) const
+{
+    return m_results.at(index).coldResidentPages;
+}
+
+bool LDBenchmark::isColdResultValid(int index) const
+{
+    return m_coldCache && hasSamples(LoadMode::Cold, index) && m_results.at(index).coldResidentPages == 0;
+}
+
+int LDBenchmark::linkerRelocationCount() const
+{
+    return m_linkerRelocations;
+}
+
+int LDBenchmark::linkerCachedRelocationCount() const
+{
+    return m_linkerCachedRelocations;
 }
 
 ElfFile* LDBenchmark::file(int index) const
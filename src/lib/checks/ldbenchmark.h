@@ -22,6 +22,8 @@
 #include <QStringList>
 #include <QVector>
 
+#include <cstdint>
+
 class QProcess;
 
 class ElfFileSet;
@@ -31,6 +33,21 @@ class ElfFile;
 class LDBenchmark
 {
 public:
+    /** How many iterations are run, and how. */
+    enum class Strategy {
+        Fixed, ///< a fixed number of iterations in a single runner
+        Adaptive ///< parallel runners pinned to separate cores, until the confidence intervals converge
+    };
+    void setStrategy(Strategy strategy);
+
+    /** Additionally measure RTLD_NOW loading with every file and its separate debug file dropped
+     *  from the page cache before each iteration, as after a fresh deployment.
+     *  Our own mappings of the files are released for this, pages mapped by any other running process
+     *  cannot be dropped though, see coldResidentPageCount().
+     */
+    void setColdCache(bool enabled);
+    bool coldCache() const;
+
     void measureFileSet(ElfFileSet *fileSet);
 
     void writeCSV(const QString &fileName);
@@ -38,24 +55,108 @@ public:
     /** Number of files we have results for. */
     int size() const;
 
-    enum class LoadMode { None, Now, Lazy };
+    enum class LoadMode { None, Now, Lazy, Cold };
     double median(LoadMode mode, int index) const;
     double min(LoadMode mode, int index) const;
     ElfFile* file(int index) const;
 
+    /** Hardware/software performance counters sampled around each dlopen() call. */
+    enum class Counter { Cycles, Instructions, PageFaults, DTLBMisses, MinorFaults, MajorFaults, ReadSyscalls, ReadBytes };
+    enum { CounterCount = 8 };
+    /** Returns @c true if @p counter could be measured on this system. */
+    bool hasCounter(Counter counter) const;
+    double median(LoadMode mode, Counter counter, int index) const;
+
+    /** Distribution-free estimate of a percentile of the load time, with its 95% confidence interval. */
+    struct Percentile {
+        double value = 0.0;
+        double lower = 0.0;
+        double upper = 0.0;
+    };
+    /** Load time distribution of a single file, after MAD-based outlier rejection. */
+    struct Statistics {
+        Percentile p50;
+        Percentile p90;
+        Percentile p99;
+        int sampleCount = 0;
+        int outlierCount = 0;
+    };
+    const Statistics& statistics(LoadMode mode, int index) const;
+    /** Returns @c false if file @p index wasn't measured in @p mode, as it was already loaded by the benchmark runner itself. */
+    bool hasSamples(LoadMode mode, int index) const;
+
+    /** Statistics of the load time samples @p samples, in µs. */
+    static Statistics computeStatistics(QVector<double> samples);
+    /** Percentile @p q (0 to 1) of the sorted @p samples. */
+    static Percentile percentile(const QVector<double> &samples, double q);
+
+    /** Estimated split of the RTLD_NOW load time of a file, in µs.
+     *  Obtained from a non-negative least squares fit of the measured times of all measured files against
+     *  their relocation and symbol lookup counts and their measured page-in activity.
+     */
+    struct Breakdown {
+        double relocation = 0.0;
+        double symbolLookup = 0.0;
+        double io = 0.0;
+        double other = 0.0;
+    };
+    const Breakdown& breakdown(int index) const;
+    /** The regression behind the breakdown fits six variables, anything less than twice as many measured files gives no meaningful result. */
+    enum { MinBreakdownFileCount = 12 };
+    /** Returns @c false if too few files were measured for a breakdown, see MinBreakdownFileCount. */
+    bool hasBreakdown() const;
+    /** Number of files with RTLD_NOW samples the breakdown is based on. */
+    int measuredFileCount() const;
+
+    /** Largest number of pages of file @p index that stayed in the page cache despite eviction, over all cold iterations. */
+    uint64_t coldResidentPageCount(int index) const;
+    /** Cold results are only meaningful if the file was entirely evicted from the page cache. */
+    bool isColdResultValid(int index) const;
+
+    /** Relocations processed by the dynamic linker when loading the entire file set, as reported
+     *  by LD_DEBUG=statistics, or -1 if not available.
+     */
+    int linkerRelocationCount() const;
+    /** Relocations the dynamic linker resolved from its lookup cache, or -1 if not available. */
+    int linkerCachedRelocationCount() const;
+
 private:
     void measure(LoadMode mode, int iterations);
+    void measureLinkerStatistics();
+    void computeBreakdown();
+    void measureAdaptive(LoadMode mode);
+    void startRunner(QProcess *proc, LoadMode mode, int iterations, int cpu = -1) const;
     void readResults(QProcess *proc, LoadMode mode);
+    void updateStatistics(LoadMode mode);
+    bool hasConverged(LoadMode mode) const;
 
     ElfFileSet *m_fileSet = nullptr;
 
+    struct Samples {
+        QVector<double> time; // in µs
+        QVector<double> counters[CounterCount];
+        Statistics statistics;
+    };
     struct Result {
         QByteArray fileName;
-        QVector<double> lazy;
-        QVector<double> now;
+        Samples lazy;
+        Samples now;
+        Samples cold;
+        Breakdown breakdown;
+        uint64_t coldResidentPages = 0;
     };
+    const Samples& samples(LoadMode mode, int index) const;
+    Samples& samples(LoadMode mode, int index);
+
     QVector<Result> m_results;
     QStringList m_args;
+    QStringList m_evictArgs;
+    unsigned int m_validCounters = 0;
+    int m_linkerRelocations = -1;
+    int m_linkerCachedRelocations = -1;
+    Strategy m_strategy = Strategy::Fixed;
+    bool m_coldCache = false;
+    bool m_hasBreakdown = false;
 };
 
 #endif // LDBENCHMARK_H
@@ -0,0 +1,52 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LDBENCHMARKPROTOCOL_H
+#define LDBENCHMARKPROTOCOL_H
+
+#include <stdint.h>
+
+/* Binary protocol between LDBenchmark and ldbenchmark-runner.
+ * The runner writes one fixed-size record per dlopen() call to its stdout, in host byte order.
+ * Anything the loaded libraries print themselves is redirected to stderr.
+ */
+
+#define LDBENCHMARK_RECORD_MAGIC 0x33424c44u /* "LDB3" */
+
+enum ldbenchmark_counter {
+    LDBENCHMARK_COUNTER_CYCLES,
+    LDBENCHMARK_COUNTER_INSTRUCTIONS,
+    LDBENCHMARK_COUNTER_PAGE_FAULTS,
+    LDBENCHMARK_COUNTER_DTLB_MISSES,
+    LDBENCHMARK_COUNTER_MINOR_FAULTS, /* from getrusage() */
+    LDBENCHMARK_COUNTER_MAJOR_FAULTS,
+    LDBENCHMARK_COUNTER_READ_SYSCALLS, /* from /proc/self/io */
+    LDBENCHMARK_COUNTER_READ_BYTES,
+    LDBENCHMARK_COUNTER_COUNT
+};
+
+struct ldbenchmark_record {
+    uint32_t magic;
+    uint32_t iteration;
+    uint32_t file_index; /* position in the file list passed to the runner */
+    uint32_t valid_counters; /* bit mask of enum ldbenchmark_counter values that could be measured */
+    uint64_t time_ns;
+    uint64_t counters[LDBENCHMARK_COUNTER_COUNT];
+    uint64_t resident_pages; /* pages of the file that stayed in the page cache despite eviction, --cold only */
+};
+
+#endif /* LDBENCHMARKPROTOCOL_H */
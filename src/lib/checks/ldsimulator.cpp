@@ -0,0 +1,229 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "ldsimulator.h"
+
+#include <elf/elfdynamicsection.h>
+#include <elf/elffile.h>
+#include <elf/elffileset.h>
+#include <elf/elfheader.h>
+#include <elf/elfrelocationentry.h>
+#include <elf/elfrelocationsection.h>
+#include <elf/elfrelocationsimulator.h>
+#include <elf/elfsectionheader.h>
+#include <elf/elfsymboltableentry.h>
+
+#include <elf.h>
+
+#include <iostream>
+
+static bool isExported(ElfSymbolTableEntry *entry)
+{
+    if (entry->sectionIndex() == SHN_UNDEF)
+        return false;
+    switch (entry->bindType()) {
+        case STB_GLOBAL:
+        case STB_WEAK:
+        case STB_GNU_UNIQUE:
+            break;
+        default:
+            return false;
+    }
+    return entry->visibility() == STV_DEFAULT || entry->visibility() == STV_PROTECTED;
+}
+
+static bool isSymbolic(ElfFile *file)
+{
+    const auto dyn = file->dynamicSection();
+    if (!dyn)
+        return false;
+    if (dyn->entryWithTag(DT_SYMBOLIC))
+        return true;
+    const auto flags = dyn->entryWithTag(DT_FLAGS);
+    return flags && (flags->value() & DF_SYMBOLIC);
+}
+
+// symbols the dynamic linker binds without searching the scope
+static bool bindsLocally(ElfSymbolTableEntry *sym)
+{
+    if (sym->sectionIndex() == SHN_UNDEF)
+        return false;
+    return sym->bindType() == STB_LOCAL || sym->visibility() == STV_HIDDEN || sym->visibility() == STV_INTERNAL;
+}
+
+void LDSimulator::setCostModel(const CostModel& costModel)
+{
+    m_costModel = costModel;
+}
+
+void LDSimulator::setHiddenSymbols(const QSet<ElfSymbolTableEntry*>& symbols)
+{
+    m_hiddenSymbols = symbols;
+}
+
+void LDSimulator::simulateFileSet(ElfFileSet* fileSet)
+{
+    simulateScope(fileSet->lookupScope());
+}
+
+void LDSimulator::simulateScope(const QVector<ElfFile*>& scope)
+{
+    m_scope = scope;
+    m_results.clear();
+    m_results.resize(m_scope.size());
+    m_fileIndex.clear();
+    for (int i = 0; i < m_scope.size(); ++i)
+        m_fileIndex.insert(m_scope.at(i), i);
+
+    for (int i = 0; i < m_scope.size(); ++i)
+        simulateFile(i);
+
+    for (auto &res : m_results) {
+        res.cost = res.relocations * m_costModel.relocation
+                 + res.lookups * m_costModel.lookup
+                 + res.incurred.lookups * m_costModel.probe
+                 + res.incurred.bucketHits * m_costModel.bucketHit
+                 + res.incurred.chainSteps * m_costModel.chainStep
+                 + res.incurred.stringCompares * m_costModel.stringCompare;
+    }
+}
+
+void LDSimulator::simulateFile(int index)
+{
+    const auto file = m_scope.at(index);
+    auto &res = m_results[index];
+
+    // the dynamic linker remembers the last symbol it looked up for each file, together with
+    // the relocation type class, and skips the search if the next relocation asks for the same
+    uint32_t cachedSymbol = 0;
+    auto cachedKind = ElfRelocationSimulator::RelocationKind::None;
+
+    const auto shdrs = file->sectionHeaders();
+    for (int i = 0; i < shdrs.size(); ++i) {
+        const auto shdr = shdrs.at(i);
+        if ((shdr->flags() & SHF_ALLOC) == 0 || (shdr->type() != SHT_REL && shdr->type() != SHT_RELA))
+            continue;
+        const auto relocs = file->section<ElfRelocationSection>(i);
+        if (!relocs)
+            continue;
+
+        for (uint64_t j = 0; j < shdr->entryCount(); ++j) {
+            ++res.relocations;
+            const auto entry = relocs->entry(j);
+            if (entry->symbolIndex() == 0)
+                continue;
+            ++res.symbolRelocations;
+
+            auto kind = ElfRelocationSimulator::relocationKind(file->header()->machine(), entry->type());
+            if (kind == ElfRelocationSimulator::RelocationKind::Relative || kind == ElfRelocationSimulator::RelocationKind::IRelative)
+                continue;
+            const auto sym = entry->symbol();
+            if (!sym || bindsLocally(sym) || m_hiddenSymbols.contains(sym))
+                continue;
+
+            // only PLT and copy relocations form their own type class
+            if (kind != ElfRelocationSimulator::RelocationKind::JumpSlot && kind != ElfRelocationSimulator::RelocationKind::Copy)
+                kind = ElfRelocationSimulator::RelocationKind::None;
+            if (entry->symbolIndex() == cachedSymbol && kind == cachedKind) {
+                ++res.cachedLookups;
+                continue;
+            }
+            cachedSymbol = entry->symbolIndex();
+            cachedKind = kind;
+
+            ++res.lookups;
+            resolve(index, sym->name(), kind == ElfRelocationSimulator::RelocationKind::Copy);
+        }
+    }
+}
+
+void LDSimulator::resolve(int index, const char* name, bool excludeSelf)
+{
+    const auto file = m_scope.at(index);
+    const auto symbolic = isSymbolic(file);
+
+    // DT_SYMBOLIC files search themselves first, copy relocations must not bind to the file containing them
+    for (int i = symbolic ? -1 : 0; i < m_scope.size(); ++i) {
+        const auto probed = i < 0 ? file : m_scope.at(i);
+        if ((i >= 0 && symbolic && probed == file) || (excludeSelf && probed == file) || !probed->hash())
+            continue;
+
+        ElfHashSection::LookupStatistics stats;
+        const auto entry = probed->hash()->lookup(name, &stats);
+        m_results[index].incurred += stats;
+        m_results[m_fileIndex.value(probed)].imposed += stats;
+        if (entry && isExported(entry) && !m_hiddenSymbols.contains(entry)) {
+            m_results[index].bindings.push_back(entry);
+            return;
+        }
+    }
+    ++m_results[index].unresolvedLookups;
+    m_results[index].bindings.push_back(nullptr);
+}
+
+int LDSimulator::size() const
+{
+    return m_results.size();
+}
+
+ElfFile* LDSimulator::file(int index) const
+{
+    return m_scope.at(index);
+}
+
+int LDSimulator::indexOf(ElfFile* file) const
+{
+    return m_fileIndex.value(file, -1);
+}
+
+const LDSimulator::Result& LDSimulator::result(int index) const
+{
+    return m_results.at(index);
+}
+
+double LDSimulator::totalCost() const
+{
+    double cost = 0.0;
+    for (const auto &res : m_results)
+        cost += res.cost;
+    return cost;
+}
+
+uint64_t LDSimulator::totalProbes() const
+{
+    uint64_t probes = 0;
+    for (const auto &res : m_results)
+        probes += res.incurred.lookups;
+    return probes;
+}
+
+void LDSimulator::printResults() const
+{
+    std::cout << "file\trelocations\tsymbol relocations\tlookups\tcached lookups\tunresolved\tprobes\tbloom rejections\t"
+                 "bucket hits\tchain steps\tstring compares\timposed chain steps\timposed string compares\tcost" << std::endl;
+    for (int i = 0; i < m_results.size(); ++i) {
+        const auto &res = m_results.at(i);
+        std::cout << qPrintable(file(i)->displayName()) << '\t'
+                  << res.relocations << '\t' << res.symbolRelocations << '\t'
+                  << res.lookups << '\t' << res.cachedLookups << '\t' << res.unresolvedLookups << '\t'
+                  << res.incurred.lookups << '\t' << res.incurred.bloomRejections << '\t' << res.incurred.bucketHits << '\t'
+                  << res.incurred.chainSteps << '\t' << res.incurred.stringCompares << '\t'
+                  << res.imposed.chainSteps << '\t' << res.imposed.stringCompares << '\t'
+                  << res.cost << std::endl;
+    }
+    std::cout << "total cost\t" << totalCost() << std::endl;
+}
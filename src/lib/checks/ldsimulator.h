@@ -0,0 +1,99 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LDSIMULATOR_H
+#define LDSIMULATOR_H
+
+#include <elf/elfhashsection.h>
+
+#include <QHash>
+#include <QSet>
+#include <QVector>
+
+class ElfFile;
+class ElfFileSet;
+class ElfSymbolTableEntry;
+
+/** Statically replays the symbol lookups the dynamic linker performs when loading a file set
+ *  with RTLD_NOW, without executing anything.
+ *
+ *  Every symbolic relocation, including PLT slots, is resolved against the global lookup scope
+ *  using the hash tables of the files, counting the work done along the way. Combined with a
+ *  simple cost model this yields a startup cost estimate that is comparable across builds,
+ *  even for files that can't be loaded on the host. Symbol versions are not considered.
+ */
+class LDSimulator
+{
+public:
+    /** Weights for estimating the startup cost, roughly in ns. */
+    struct CostModel {
+        double relocation = 2.0;
+        double lookup = 10.0; ///< hashing the symbol name
+        double probe = 1.0; ///< checking one file of the scope, ie. its bloom filter or bucket index
+        double bucketHit = 5.0;
+        double chainStep = 2.0;
+        double stringCompare = 10.0;
+    };
+    void setCostModel(const CostModel &costModel);
+    /** Simulate as if @p symbols had hidden visibility, ie. bound locally and not exported. */
+    void setHiddenSymbols(const QSet<ElfSymbolTableEntry*> &symbols);
+
+    void simulateFileSet(ElfFileSet *fileSet);
+    /** Simulate loading with the given lookup scope, see ElfFileSet::lookupScope(). */
+    void simulateScope(const QVector<ElfFile*> &scope);
+
+    /** Number of files we have results for, in lookup scope order. */
+    int size() const;
+    ElfFile* file(int index) const;
+    /** Index of @p file in the results, -1 if not part of the simulated scope. */
+    int indexOf(ElfFile *file) const;
+
+    struct Result {
+        int relocations = 0; ///< relocation entries, excluding RELR
+        int symbolRelocations = 0; ///< relocations referring to a symbol
+        int lookups = 0; ///< symbol relocations that needed a scope search
+        int cachedLookups = 0; ///< lookups served from the linker's single-entry lookup cache
+        int unresolvedLookups = 0;
+        /** Hash table work done on behalf of the relocations of this file. */
+        ElfHashSection::LookupStatistics incurred;
+        /** Hash table work done in this file for relocations of any file. */
+        ElfHashSection::LookupStatistics imposed;
+        double cost = 0.0;
+        /** Definition each lookup bound to, in relocation order, @c nullptr for unresolved ones. */
+        QVector<ElfSymbolTableEntry*> bindings;
+    };
+    const Result& result(int index) const;
+    /** Estimated startup cost of the entire file set. */
+    double totalCost() const;
+    /** Number of files checked during all lookups. */
+    uint64_t totalProbes() const;
+
+    /** Dump the results to stdout as tab-separated values, for use in CLI tools. */
+    void printResults() const;
+
+private:
+    void simulateFile(int index);
+    void resolve(int index, const char *name, bool excludeSelf);
+
+    QVector<ElfFile*> m_scope;
+    QVector<Result> m_results;
+    QHash<ElfFile*, int> m_fileIndex;
+    QSet<ElfSymbolTableEntry*> m_hiddenSymbols;
+    CostModel m_costModel;
+};
+
+#endif // LDSIMULATOR_H
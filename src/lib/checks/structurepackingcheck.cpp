@@ -23,6 +23,7 @@
 #include <dwarf/dwarfinfo.h>
 #include <dwarf/dwarfdie.h>
 #include <dwarf/dwarfcudie.h>
+#include <dwarf/dwarfcupool.h>
 #include <dwarf/dwarfexpression.h>
 
 #include <dwarf.h>
@@ -41,15 +42,33 @@ void StructurePackingCheck::setElfFileSet(ElfFileSet* fileSet)
     m_fileSet = fileSet;
 }
 
-void StructurePackingCheck::checkAll(DwarfInfo* info)
+void StructurePackingCheck::checkAll(DwarfInfo* info, int threadCount)
 {
 #if HAVE_DWARF
     assert(m_fileSet);
     if (!info)
         return;
 
-    foreach (auto die, info->compilationUnits())
-        checkDie(die);
+    DwarfCuPool pool(info);
+    if (threadCount > 0)
+        pool.setThreadCount(threadCount);
+    pool.mapReduce([this](DwarfCuDie *cu) {
+        QVector<Finding> findings;
+        QSet<QString> locations;
+        if (const auto splitUnit = cu->splitUnit())
+            cu = splitUnit;
+        checkDie(cu, findings, locations);
+        return findings;
+    }, [this](QVector<Finding> &&findings) {
+        // the same structure is usually reported by many units including its header
+        for (const auto &finding : findings) {
+            if (m_duplicateCheck.contains(finding.location))
+                continue;
+            std::cout << finding.report.toLocal8Bit().constData();
+            std::cout << std::endl;
+            m_duplicateCheck.insert(finding.location);
+        }
+    });
 #endif
 }
 
@@ -71,6 +90,10 @@ static QString printSummary(int structSize, int usedBytes, int usedBits, int opt
 #if HAVE_DWARF
 static int dataMemberLocation(DwarfDie *die)
 {
+    const auto loc = die->attributeSigned(DW_AT_data_member_location, -1);
+    if (loc >= 0)
+        return loc;
+
     const auto attr = die->attribute(DW_AT_data_member_location);
     if (attr.canConvert(QVariant::Int))
         return attr.toInt();
@@ -83,7 +106,7 @@ static bool compareMemberDiesByLocation(DwarfDie *lhs, DwarfDie *rhs)
     const auto lhsLoc = dataMemberLocation(lhs);
     const auto rhsLoc = dataMemberLocation(rhs);
     if (lhsLoc == rhsLoc) {
-        return lhs->attribute(DW_AT_bit_offset) > rhs->attribute(DW_AT_bit_offset);
+        return lhs->attributeUnsigned(DW_AT_bit_offset) > rhs->attributeUnsigned(DW_AT_bit_offset);
     }
     return lhsLoc < rhsLoc;
 }
@@ -118,7 +141,7 @@ QString StructurePackingCheck::checkOneStructure(DwarfDie* structDie) const
 #endif
 }
 
-void StructurePackingCheck::checkDie(DwarfDie* die)
+void StructurePackingCheck::checkDie(DwarfDie* die, QVector<Finding> &findings, QSet<QString> &locations) const
 {
 #if HAVE_DWARF
     if (die->tag() == DW_TAG_structure_type || die->tag() == DW_TAG_class_type) {
@@ -129,7 +152,7 @@ void StructurePackingCheck::checkDie(DwarfDie* die)
             else if (child->tag() == DW_TAG_inheritance)
                 members.push_back(child);
             else
-                checkDie(child);
+                checkDie(child, findings, locations);
         }
         std::sort(members.begin(), members.end(), compareMemberDiesByLocation);
 
@@ -144,17 +167,15 @@ void StructurePackingCheck::checkDie(DwarfDie* die)
 
         if ((usedBytes != structSize || usedBits != structSize * 8) && optimalSize != structSize) {
             const QString loc = die->sourceLocation();
-            if (m_duplicateCheck.contains(loc))
+            if (locations.contains(loc))
                 return;
-            std::cout << printSummary(structSize, usedBytes, usedBits, optimalSize).toLocal8Bit().constData();
-            std::cout << printStructure(die, members).toLocal8Bit().constData();
-            std::cout << std::endl;
-            m_duplicateCheck.insert(loc);
+            findings.push_back({ loc, printSummary(structSize, usedBytes, usedBits, optimalSize) + printStructure(die, members) });
+            locations.insert(loc);
         }
 
     } else {
         foreach (auto child, die->children())
-            checkDie(child);
+            checkDie(child, findings, locations);
     }
 #endif
 }
@@ -197,7 +218,7 @@ static int bitsForEnum(DwarfDie *die)
         if (child->tag() != DW_TAG_enumerator)
             continue;
         ++enumCount;
-        const auto enumValue = child->attribute(DW_AT_const_value).toInt();
+        const auto enumValue = static_cast<int>(child->attributeSigned(DW_AT_const_value));
         for (int i = 0; i < bits.size(); ++i) {
             if ((1 << i) & enumValue)
                 bits[i] = true;
@@ -227,14 +248,14 @@ static int actualTypeSize(DwarfDie *die)
         case DW_TAG_typedef:
         case DW_TAG_volatile_type:
         {
-            const auto typeDie = die->attribute(DW_AT_type).value<DwarfDie*>();
+            const auto typeDie = die->attributeDie(DW_AT_type);
             assert(typeDie);
             return actualTypeSize(typeDie);
         }
         case DW_TAG_array_type:
         {
             return die->typeSize() * 8; // TODO the below is correct, but we need to distribute that over the memory bit array below, otherwise usedBytes is wrong
-/*            const auto typeDie = die->attribute(DW_AT_type).value<DwarfDie*>();
+/*            const auto typeDie = die->attributeDie(DW_AT_type);
             assert(typeDie);
             return die->typeSize() / typeDie->typeSize() * actualTypeSize(typeDie);*/
         }
@@ -254,12 +275,12 @@ std::tuple<int, int> StructurePackingCheck::computeStructureMemoryUsage(DwarfDie
     QBitArray memUsage(structSize * 8);
 
     for (DwarfDie *memberDie : memberDies) {
-        const auto memberTypeDie = findTypeDefinition(memberDie->attribute(DW_AT_type).value<DwarfDie*>());
+        const auto memberTypeDie = findTypeDefinition(memberDie->attributeDie(DW_AT_type));
         assert(memberTypeDie);
 
         const auto memberLocation = dataMemberLocation(memberDie);
-        const auto bitSize = memberDie->attribute(DW_AT_bit_size).toInt();
-        const auto bitOffset = memberDie->attribute(DW_AT_bit_offset).toInt();
+        const auto bitSize = static_cast<int>(memberDie->attributeUnsigned(DW_AT_bit_size));
+        const auto bitOffset = static_cast<int>(memberDie->attributeUnsigned(DW_AT_bit_offset));
 
         if (bitSize <= 0) {
             assert((structSize * 8) >= (memberLocation * 8 + memberTypeDie->typeSize() * 8));
@@ -305,7 +326,7 @@ QString StructurePackingCheck::printStructure(DwarfDie* structDie, const QVector
         if (memberDie->tag() == DW_TAG_inheritance)
             s << "inherits ";
 
-        DwarfDie *unresolvedTypeDie = memberDie->attribute(DW_AT_type).value<DwarfDie*>();
+        DwarfDie *unresolvedTypeDie = memberDie->attributeDie(DW_AT_type);
         const auto memberTypeDie = findTypeDefinition(unresolvedTypeDie);
         assert(memberTypeDie);
 
@@ -320,7 +341,7 @@ QString StructurePackingCheck::printStructure(DwarfDie* structDie, const QVector
         s << " ";
         s << memberDie->name();
 
-        const auto bitSize = memberDie->attribute(DW_AT_bit_size).toInt();
+        const auto bitSize = static_cast<int>(memberDie->attributeUnsigned(DW_AT_bit_size));
         if (bitSize > 0) {
             s << ':' << bitSize;
         }
@@ -341,7 +362,7 @@ QString StructurePackingCheck::printStructure(DwarfDie* structDie, const QVector
         s << ", alignment: " << memberTypeDie->typeAlignment();
 
         if (bitSize > 0) {
-            const auto bitOffset = memberDie->attribute(DW_AT_bit_offset).toInt();
+            const auto bitOffset = static_cast<int>(memberDie->attributeUnsigned(DW_AT_bit_offset));
             s << ", bit offset: " << bitOffset;
         }
 
@@ -364,7 +385,7 @@ static bool isEmptyBaseClass(DwarfDie* inheritanceDie)
 {
 #if HAVE_DWARF
     assert(inheritanceDie->tag() == DW_TAG_inheritance);
-    const auto baseTypeDie = inheritanceDie->attribute(DW_AT_type).value<DwarfDie*>();
+    const auto baseTypeDie = inheritanceDie->attributeDie(DW_AT_type);
     if (baseTypeDie->typeSize() != 1)
         return false;
 
@@ -398,7 +419,7 @@ int StructurePackingCheck::optimalStructureSize(DwarfDie* structDie, const QVect
         if (prevMemberLocation == dataMemberLocation(memberDie))
             continue; // skip bit fields for now
 
-        const auto memberTypeDie = findTypeDefinition(memberDie->attribute(DW_AT_type).value<DwarfDie*>());
+        const auto memberTypeDie = findTypeDefinition(memberDie->attributeDie(DW_AT_type));
         assert(memberTypeDie);
 
         const auto memberLocation = dataMemberLocation(memberDie);
@@ -453,7 +474,7 @@ DwarfDie* StructurePackingCheck::findTypeDefinition(DwarfDie* typeDie) const
 #if HAVE_DWARF
     // recurse into typedefs
     if (typeDie->tag() == DW_TAG_typedef)
-        return findTypeDefinition(typeDie->attribute(DW_AT_type).value<DwarfDie*>());
+        return findTypeDefinition(typeDie->attributeDie(DW_AT_type));
 
     if (!hasUnknownSize(typeDie))
         return typeDie;
@@ -473,6 +494,8 @@ DwarfDie* StructurePackingCheck::findTypeDefinition(DwarfDie* typeDie) const
             continue;
 
         foreach (auto cuDie, file->dwarfInfo()->compilationUnits()) {
+            if (const auto splitUnit = cuDie->splitUnit())
+                cuDie = splitUnit;
             foreach (auto topDie, cuDie->children()) {
                 DwarfDie *die = findTypeDefinitionRecursive(topDie, fullId);
                 if (die && die->typeSize() > 0) {
@@ -19,12 +19,12 @@
 #define STRUCTUREPACKINGCHECK_H
 
 #include <QSet>
+#include <QString>
 
 class ElfFileSet;
 class DwarfInfo;
 class DwarfDie;
 
-class QString;
 template<class T> class QVector;
 
 class StructurePackingCheck
@@ -39,11 +39,16 @@ public:
     /** Set the ELF file set the checked DWARF info belongs to.*/
     void setElfFileSet(ElfFileSet *fileSet);
 
-    void checkAll(DwarfInfo* info);
+    /** Checks all compilation units of @p info, using up to @p threadCount threads (0 for one per core). */
+    void checkAll(DwarfInfo* info, int threadCount = 0);
     QString checkOneStructure(DwarfDie *structDie) const;
 
 private:
-    void checkDie(DwarfDie* die);
+    struct Finding {
+        QString location;
+        QString report;
+    };
+    void checkDie(DwarfDie* die, QVector<Finding> &findings, QSet<QString> &locations) const;
     std::tuple<int, int> computeStructureMemoryUsage(DwarfDie* structDie, const QVector<DwarfDie*> &memberDies) const;
     QString printStructure(DwarfDie* structDie, const QVector< DwarfDie* >& memberDies) const;
     int optimalStructureSize(DwarfDie* structDie, const QVector<DwarfDie*> &memberDies) const;
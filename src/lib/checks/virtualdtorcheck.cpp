@@ -23,23 +23,47 @@
 #include <dwarf/dwarfinfo.h>
 #include <dwarf/dwarfdie.h>
 #include <dwarf/dwarfcudie.h>
+#include <dwarf/dwarfcupool.h>
 #include <dwarf/dwarftypes.h>
 
 #include <dwarf.h>
 #endif
 
+#include <QHash>
+
 #include <algorithm>
 #include <iostream>
 
 void VirtualDtorCheck::findImplicitVirtualDtors(ElfFileSet* fileSet)
 {
 #if HAVE_DWARF
+    QHash<QByteArray, int> resultIndex;
+    for (int i = 0; i < m_results.size(); ++i)
+        resultIndex.insert(m_results.at(i).fullName, i);
+
     for (int i = 0; i < fileSet->size(); ++i) {
         const auto file = fileSet->file(i);
         if (!file->dwarfInfo())
             continue;
-        foreach (const auto die, file->dwarfInfo()->compilationUnits())
-            findImplicitVirtualDtors(die);
+        DwarfCuPool pool(file->dwarfInfo());
+        pool.mapReduce([this](DwarfCuDie *cu) {
+            QVector<Result> candidates;
+            if (const auto splitUnit = cu->splitUnit())
+                cu = splitUnit;
+            findImplicitVirtualDtors(cu, candidates);
+            return candidates;
+        }, [this, &resultIndex](QVector<Result> &&candidates) {
+            // first occurrence wins, unless only a later one knows where the type is declared
+            for (const auto &candidate : candidates) {
+                const auto it = resultIndex.constFind(candidate.fullName);
+                if (it == resultIndex.constEnd()) {
+                    resultIndex.insert(candidate.fullName, m_results.size());
+                    m_results.push_back(candidate);
+                } else if (m_results.at(it.value()).sourceFilePath.isEmpty() && !candidate.sourceFilePath.isEmpty()) {
+                    m_results[it.value()] = candidate;
+                }
+            }
+        });
     }
 
     // implicit virtual dtors in implementation files are not a problem
@@ -53,34 +77,25 @@ void VirtualDtorCheck::findImplicitVirtualDtors(ElfFileSet* fileSet)
 #endif
 }
 
-void VirtualDtorCheck::findImplicitVirtualDtors(DwarfDie* die)
+void VirtualDtorCheck::findImplicitVirtualDtors(DwarfDie* die, QVector<Result> &candidates) const
 {
 #if HAVE_DWARF
     const bool isCandidate =
         die->tag() == DW_TAG_subprogram &&
-        die->attribute(DW_AT_external).toBool() &&
-        die->attribute(DW_AT_declaration).toBool() &&
-        die->attribute(DW_AT_artificial).toBool() &&
-        die->attribute(DW_AT_virtuality).value<DwarfVirtuality>() == DwarfVirtuality::Virtual &&
+        die->attributeFlag(DW_AT_external) &&
+        die->attributeFlag(DW_AT_declaration) &&
+        die->attributeFlag(DW_AT_artificial) &&
+        static_cast<DwarfVirtuality>(die->attributeUnsigned(DW_AT_virtuality)) == DwarfVirtuality::Virtual &&
         die->name().startsWith('~');
 
     if (isCandidate) {
-        const auto fullName = die->fullyQualifiedName();
-        const auto it = std::find_if(m_results.begin(), m_results.end(), [&fullName](const Result& res) {
-            return res.fullName == fullName;
-        });
-        const auto *typeDie = die->attribute(DW_AT_containing_type).value<DwarfDie*>();
-        if (it == m_results.end()) {
-            const Result res = {
-                fullName,
-                typeDie ? typeDie->sourceFilePath() : QString(),
-                typeDie ? typeDie->attribute(DW_AT_decl_line).toInt() : 0
-            };
-            m_results.push_back(res);
-        } else if ((*it).sourceFilePath.isEmpty() && typeDie) {
-            (*it).sourceFilePath = typeDie->sourceFilePath();
-            (*it).lineNumber = typeDie->attribute(DW_AT_decl_line).toInt();
-        }
+        const auto *typeDie = die->attributeDie(DW_AT_containing_type);
+        const Result res = {
+            die->fullyQualifiedName(),
+            typeDie ? typeDie->sourceFilePath() : QString(),
+            typeDie ? static_cast<int>(typeDie->attributeUnsigned(DW_AT_decl_line)) : 0
+        };
+        candidates.push_back(res);
     }
 
     const auto children = die->children();
@@ -90,7 +105,7 @@ void VirtualDtorCheck::findImplicitVirtualDtors(DwarfDie* die)
             child->tag() != DW_TAG_structure_type &&
             child->tag() != DW_TAG_namespace)
             continue;
-        findImplicitVirtualDtors(child);
+        findImplicitVirtualDtors(child, candidates);
     }
 #endif
 }
@@ -41,7 +41,7 @@ public:
     void clear();
 
 private:
-    void findImplicitVirtualDtors(DwarfDie* die);
+    void findImplicitVirtualDtors(DwarfDie* die, QVector<Result> &candidates) const;
 
     QVector<Result> m_results;
 };
@@ -0,0 +1,143 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "demanglecache.h"
+#include "demangler.h"
+
+#include <QCache>
+
+#include <mutex>
+
+static const int ShardCount = 16;
+static const int DefaultMaximumCost = 8 * 1024 * 1024; // per file
+
+namespace {
+struct Entry
+{
+    int cost() const
+    {
+        int c = sizeof(Entry) + full.size();
+        for (const auto &part : parts)
+            c += part.size() + sizeof(QByteArray);
+        return c;
+    }
+
+    QByteArray full;
+    QVector<QByteArray> parts;
+    bool hasFull = false;
+    bool hasParts = false;
+};
+}
+
+struct DemangleCache::Shard
+{
+    std::mutex mutex;
+    QCache<const char*, Entry> cache;
+};
+
+DemangleCache::DemangleCache() :
+    m_shards(new Shard[ShardCount])
+{
+    setMaximumCost(DefaultMaximumCost);
+}
+
+DemangleCache::~DemangleCache() = default;
+
+DemangleCache::Shard& DemangleCache::shardForName(const char* name) const
+{
+    // string table entries are not aligned, but neighbouring names tend to be looked up together
+    const auto addr = reinterpret_cast<quintptr>(name);
+    return m_shards[((addr >> 6) ^ (addr >> 12)) % ShardCount];
+}
+
+QVector<QByteArray> DemangleCache::demangle(const char* name)
+{
+    auto &shard = shardForName(name);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const auto entry = shard.cache.object(name);
+        if (entry && entry->hasParts)
+            return entry->parts;
+    }
+
+    // demangle outside of the lock, this is the expensive part
+    Demangler demangler;
+    const auto parts = demangler.demangle(name);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto entry = shard.cache.take(name);
+    if (!entry)
+        entry = new Entry;
+    entry->parts = parts;
+    entry->hasParts = true;
+    shard.cache.insert(name, entry, entry->cost());
+    return parts;
+}
+
+QByteArray DemangleCache::demangleFull(const char* name)
+{
+    auto &shard = shardForName(name);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const auto entry = shard.cache.object(name);
+        if (entry && entry->hasFull)
+            return entry->full;
+    }
+
+    const auto full = Demangler::demangleFull(name);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto entry = shard.cache.take(name);
+    if (!entry)
+        entry = new Entry;
+    entry->full = full;
+    entry->hasFull = true;
+    shard.cache.insert(name, entry, entry->cost());
+    return full;
+}
+
+void DemangleCache::clear()
+{
+    for (int i = 0; i < ShardCount; ++i) {
+        std::lock_guard<std::mutex> lock(m_shards[i].mutex);
+        m_shards[i].cache.clear();
+    }
+}
+
+int DemangleCache::maximumCost() const
+{
+    std::lock_guard<std::mutex> lock(m_shards[0].mutex);
+    return m_shards[0].cache.maxCost() * ShardCount;
+}
+
+void DemangleCache::setMaximumCost(int cost)
+{
+    for (int i = 0; i < ShardCount; ++i) {
+        std::lock_guard<std::mutex> lock(m_shards[i].mutex);
+        m_shards[i].cache.setMaxCost(cost / ShardCount);
+    }
+}
+
+int DemangleCache::size() const
+{
+    int count = 0;
+    for (int i = 0; i < ShardCount; ++i) {
+        std::lock_guard<std::mutex> lock(m_shards[i].mutex);
+        count += m_shards[i].cache.size();
+    }
+    return count;
+}
@@ -0,0 +1,62 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DEMANGLECACHE_H
+#define DEMANGLECACHE_H
+
+#include <QByteArray>
+#include <QVector>
+
+#include <memory>
+
+/** Thread-safe, memory-bounded cache for demangled symbol names.
+ *  Entries are keyed by the address of the mangled name (ie. its location in
+ *  .dynstr/.strtab), which is stable as long as the ELF file is mapped. Each
+ *  ElfFile owns one cache for its own names, and clears it when it is closed.
+ */
+class DemangleCache
+{
+public:
+    DemangleCache();
+    DemangleCache(const DemangleCache&) = delete;
+    ~DemangleCache();
+
+    DemangleCache& operator=(const DemangleCache&) = delete;
+
+    /** Cached equivalent of Demangler::demangle(). */
+    QVector<QByteArray> demangle(const char *name);
+    /** Cached equivalent of Demangler::demangleFull(). */
+    QByteArray demangleFull(const char *name);
+
+    /** Drops all entries. */
+    void clear();
+
+    /** Approximate memory limit for the cached names, in bytes. */
+    int maximumCost() const;
+    void setMaximumCost(int cost);
+
+    /** Amount of cached names. */
+    int size() const;
+
+private:
+    struct Shard;
+    Shard& shardForName(const char *name) const;
+
+    std::unique_ptr<Shard[]> m_shards;
+};
+
+#endif // DEMANGLECACHE_H
@@ -0,0 +1,91 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "demanglednametable.h"
+#include "spandemangler.h"
+
+#include <cstring>
+
+int DemangledNameTable::size() const
+{
+    return m_entries.size();
+}
+
+QByteArray DemangledNameTable::fullName(int index) const
+{
+    return string(m_entries.at(index).fullName);
+}
+
+QVector<QByteArray> DemangledNameTable::nameParts(int index) const
+{
+    const auto &entry = m_entries.at(index);
+    QVector<QByteArray> parts;
+    parts.reserve(entry.partCount);
+    for (uint32_t i = 0; i < entry.partCount; ++i)
+        parts.push_back(string(m_parts.at(entry.firstPart + i)));
+    return parts;
+}
+
+void DemangledNameTable::append(const SpanDemangler& demangler)
+{
+    Entry entry;
+    entry.fullName = addString(demangler.fullNameData(), demangler.fullNameSize());
+    entry.firstPart = m_parts.size();
+    entry.partCount = demangler.partCount();
+    const auto fullName = demangler.fullNameData();
+    const auto fullSize = demangler.fullNameSize();
+    for (int i = 0; i < demangler.partCount(); ++i) {
+        const auto part = demangler.partData(i);
+        const auto partSize = demangler.partSize(i);
+        // split names are very often suffixes of the full name, no need to store them twice
+        if (partSize <= fullSize && memcmp(fullName + fullSize - partSize, part, partSize) == 0)
+            m_parts.push_back({ entry.fullName.offset + entry.fullName.size - partSize, static_cast<uint32_t>(partSize) });
+        else
+            m_parts.push_back(addString(part, partSize));
+    }
+    m_entries.push_back(entry);
+}
+
+void DemangledNameTable::append(const DemangledNameTable& other)
+{
+    const auto poolOffset = m_pool.size();
+    const auto partOffset = m_parts.size();
+    m_pool.append(other.m_pool);
+    m_parts.reserve(m_parts.size() + other.m_parts.size());
+    for (auto span : other.m_parts) {
+        span.offset += poolOffset;
+        m_parts.push_back(span);
+    }
+    m_entries.reserve(m_entries.size() + other.m_entries.size());
+    for (auto entry : other.m_entries) {
+        entry.fullName.offset += poolOffset;
+        entry.firstPart += partOffset;
+        m_entries.push_back(entry);
+    }
+}
+
+DemangledNameTable::Span DemangledNameTable::addString(const char* s, int size)
+{
+    const Span span{ static_cast<uint32_t>(m_pool.size()), static_cast<uint32_t>(size) };
+    m_pool.append(s, size);
+    return span;
+}
+
+QByteArray DemangledNameTable::string(DemangledNameTable::Span span) const
+{
+    return QByteArray::fromRawData(m_pool.constData() + span.offset, span.size);
+}
@@ -0,0 +1,70 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DEMANGLEDNAMETABLE_H
+#define DEMANGLEDNAMETABLE_H
+
+#include <QByteArray>
+#include <QVector>
+
+#include <cstdint>
+
+class Demangler;
+class SpanDemangler;
+
+/** Demangled names of a batch of symbols, stored in a single string pool.
+ *  Created by Demangler::demangleAll(), cheap to copy.
+ */
+class DemangledNameTable
+{
+public:
+    /** Amount of names in this table. */
+    int size() const;
+
+    /** Demangled name of symbol @p index as a single string.
+     *  The result references the string pool and must not outlive this table.
+     */
+    QByteArray fullName(int index) const;
+    /** Demangled name of symbol @p index split in namespace(s)/class/method.
+     *  The results reference the string pool and must not outlive this table.
+     */
+    QVector<QByteArray> nameParts(int index) const;
+
+private:
+    friend class Demangler;
+    void append(const SpanDemangler &demangler);
+    void append(const DemangledNameTable &other);
+
+    struct Span {
+        uint32_t offset;
+        uint32_t size;
+    };
+    struct Entry {
+        Span fullName;
+        uint32_t firstPart;
+        uint32_t partCount;
+    };
+
+    Span addString(const char *s, int size);
+    QByteArray string(Span span) const;
+
+    QByteArray m_pool;
+    QVector<Span> m_parts;
+    QVector<Entry> m_entries;
+};
+
+#endif // DEMANGLEDNAMETABLE_H
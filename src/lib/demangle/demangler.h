@@ -23,14 +23,21 @@
 #include <QMetaType>
 #include <QVector>
 
-struct demangle_component;
+#include "demanglednametable.h"
+#include "spandemangler.h"
 
-/** C++ name demangler. */
+class ElfSymbolTableSection;
+
+/** C++ name demangler.
+ *  Convenience API returning deep copies of the results of SpanDemangler.
+ *  See DemangleCache for cached access to the results.
+ */
 class Demangler
 {
 public:
-    Demangler() = default;
+    Demangler();
     Demangler(const Demangler &other) = delete;
+    ~Demangler();
     Demangler& operator=(const Demangler &other) = delete;
 
     /** Demangle the given name and return the name split in namespace(s)/class/method. */
@@ -39,6 +46,11 @@ public:
     /** Demangle the given name into a single string. */
     static QByteArray demangleFull(const char* name);
 
+    /** Demangle all entries of @p symtab in parallel, indexed by symbol index. */
+    static DemangledNameTable demangleAll(const ElfSymbolTableSection *symtab);
+    /** Demangle all @p names in parallel, in the same order. */
+    static DemangledNameTable demangleAll(const QVector<const char*> &names);
+
     enum class SymbolType {
         Normal,
         VTable,
@@ -51,22 +63,7 @@ public:
     static SymbolType symbolType(const char* name);
 
 private:
-    void reset();
-    void handleNameComponent(demangle_component *component, QVector<QByteArray> &nameParts);
-    void handleOptionalNameComponent(demangle_component *component, QVector<QByteArray> &nameParts);
-    void handleOperatorComponent(demangle_component *component, QVector<QByteArray> &nameParts);
-
-    const char *m_mangledName = nullptr;
-    int m_templateParamIndex = 0;
-    QHash<int, QByteArray> m_templateParams;
-    QByteArray m_modifiers;
-    QByteArray m_ptrmemType;
-    bool m_inArgList = false;
-    bool m_pendingPointer = false;
-    bool m_pendingReference = false;
-    bool m_indexTemplateArgs = false;
-
-    // TODO shared value caching
+    SpanDemangler m_demangler;
 };
 
 Q_DECLARE_METATYPE(Demangler::SymbolType)
@@ -0,0 +1,45 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DEMANGLER_P_H
+#define DEMANGLER_P_H
+
+// workarounds for conflicting declaration in libiberty.h
+#define HAVE_DECL_BASENAME 1
+#define HAVE_DECL_ASPRINTF 1
+#define HAVE_DECL_VASPRINTF 1
+
+#include <demangle.h>
+
+// not in a public binutils header, but needed anyway
+struct demangle_operator_info
+{
+    const char *type;
+    const char *name;
+    int len;
+    int args;
+};
+
+struct demangle_builtin_type_info {
+    const char *name;
+    int len;
+    const char *java_name;
+    int java_len;
+    /*enum d_builtin_type_print*/ int print;
+};
+
+#endif // DEMANGLER_P_H
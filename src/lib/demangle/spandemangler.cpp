@@ -0,0 +1,820 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <config-elf-dissector.h>
+#include "spandemangler.h"
+
+#include <QDebug>
+#include <QScopedValueRollback>
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+#include "demangler_p.h"
+
+static const int DemangleOptions = DMGL_PARAMS | DMGL_ANSI | DMGL_TYPES | DMGL_VERBOSE;
+
+SpanDemangler::Span SpanDemangler::TemplateParams::value(int index) const
+{
+    if (index < 0 || index >= m_size)
+        return {};
+    if (index < InlineSize)
+        return m_inline[index];
+    return m_overflow[index - InlineSize];
+}
+
+void SpanDemangler::TemplateParams::insert(int index, Span value)
+{
+    assert(index >= 0);
+    for (; m_size <= index; ++m_size) {
+        if (m_size < InlineSize)
+            m_inline[m_size] = {};
+        else
+            m_overflow.push_back({});
+    }
+    if (index < InlineSize)
+        m_inline[index] = value;
+    else
+        m_overflow[index - InlineSize] = value;
+}
+
+void SpanDemangler::TemplateParams::clear()
+{
+    m_overflow.clear();
+    m_size = 0;
+}
+
+
+SpanDemangler::SpanDemangler() = default;
+SpanDemangler::~SpanDemangler() = default;
+
+static void appendFullName(const char *str, size_t size, void *opaque)
+{
+    auto buffer = static_cast<std::vector<char>*>(opaque);
+    buffer->insert(buffer->end(), str, str + size);
+}
+
+int SpanDemangler::demangle(const char* name, int outputs)
+{
+    QScopedValueRollback<const char*> mangledName(m_mangledName, name);
+    reset();
+
+    void *memory = nullptr;
+    demangle_component *component = cplus_demangle_v3_components(name, DemangleOptions, &memory);
+
+    if (!memory || !component) { // demangle failed, likely not mangled
+        if (outputs & NameParts)
+            push(addString(name));
+        if (outputs & FullName)
+            m_fullName.insert(m_fullName.end(), name, name + strlen(name));
+        free(memory);
+        return m_parts.size();
+    }
+
+    if (outputs & NameParts)
+        handleNameComponent(component, 0);
+    if (outputs & FullName) {
+        if (!cplus_demangle_print_callback(DemangleOptions, component, appendFullName, &m_fullName) || m_fullName.empty()) {
+            m_fullName.clear();
+            m_fullName.insert(m_fullName.end(), name, name + strlen(name));
+        }
+    }
+    free(memory);
+    return m_parts.size();
+}
+
+int SpanDemangler::partCount() const
+{
+    return m_parts.size();
+}
+
+const char* SpanDemangler::partData(int index) const
+{
+    return m_buffer.data() + m_parts[index].offset;
+}
+
+int SpanDemangler::partSize(int index) const
+{
+    return m_parts[index].size;
+}
+
+QByteArray SpanDemangler::part(int index) const
+{
+    return QByteArray(partData(index), partSize(index));
+}
+
+QVector<QByteArray> SpanDemangler::parts() const
+{
+    QVector<QByteArray> result;
+    result.reserve(partCount());
+    for (int i = 0; i < partCount(); ++i)
+        result.push_back(part(i));
+    return result;
+}
+
+const char* SpanDemangler::fullNameData() const
+{
+    return m_fullName.data();
+}
+
+int SpanDemangler::fullNameSize() const
+{
+    return m_fullName.size();
+}
+
+QByteArray SpanDemangler::fullName() const
+{
+    return QByteArray(fullNameData(), fullNameSize());
+}
+
+void SpanDemangler::reset()
+{
+    // clear() keeps the capacity, that's what makes this allocation-free after warming up
+    m_buffer.clear();
+    m_parts.clear();
+    m_fullName.clear();
+    m_inArgList = false;
+    m_templateParamIndex = 0;
+    m_templateParams.clear();
+    m_pendingPointer = false;
+    m_pendingReference = false;
+}
+
+SpanDemangler::Span SpanDemangler::addString(const char* str, int size)
+{
+    Span s = startString();
+    append(s, str, size);
+    return s;
+}
+
+SpanDemangler::Span SpanDemangler::addString(const char* str)
+{
+    return addString(str, strlen(str));
+}
+
+
+SpanDemangler::Span SpanDemangler::startString(Span s)
+{
+    if (s.offset + s.size == (int)m_buffer.size())
+        return s;
+    Span r = startString();
+    append(r, s);
+    return r;
+}
+
+SpanDemangler::Span SpanDemangler::startString()
+{
+    Span s;
+    s.offset = m_buffer.size();
+    return s;
+}
+
+void SpanDemangler::append(Span& s, Span other)
+{
+    assert(s.offset + s.size == (int)m_buffer.size());
+    // resizing might move the buffer, so only resolve the source after that
+    m_buffer.resize(m_buffer.size() + other.size);
+    memcpy(m_buffer.data() + s.offset + s.size, m_buffer.data() + other.offset, other.size);
+    s.size += other.size;
+}
+
+void SpanDemangler::append(Span& s, const char* str, int size)
+{
+    assert(s.offset + s.size == (int)m_buffer.size());
+    m_buffer.insert(m_buffer.end(), str, str + size);
+    s.size += size;
+}
+
+void SpanDemangler::append(Span& s, const char* str)
+{
+    append(s, str, strlen(str));
+}
+
+void SpanDemangler::append(Span& s, char c)
+{
+    append(s, &c, 1);
+}
+
+void SpanDemangler::appendNumber(Span& s, int n)
+{
+    char buffer[16];
+    const auto size = snprintf(buffer, sizeof(buffer), "%d", n);
+    append(s, buffer, size);
+}
+
+void SpanDemangler::appendJoined(Span& s, int begin, int end, const char* separator)
+{
+    for (int i = begin; i < end; ++i) {
+        if (i != begin)
+            append(s, separator);
+        append(s, m_parts[i]);
+    }
+}
+
+SpanDemangler::Span SpanDemangler::prepend(const char* prefix, Span s)
+{
+    Span r = startString();
+    append(r, prefix);
+    append(r, s);
+    return r;
+}
+
+bool SpanDemangler::equals(Span s, const char* str) const
+{
+    const auto size = strlen(str);
+    return (int)size == s.size && memcmp(m_buffer.data() + s.offset, str, size) == 0;
+}
+
+bool SpanDemangler::endsWith(Span s, char c) const
+{
+    return s.size > 0 && m_buffer[s.offset + s.size - 1] == c;
+}
+
+void SpanDemangler::push(Span s)
+{
+    m_parts.push_back(s);
+}
+
+SpanDemangler::Span SpanDemangler::takeLast()
+{
+    const auto s = m_parts.back();
+    m_parts.pop_back();
+    return s;
+}
+
+SpanDemangler::Span& SpanDemangler::last()
+{
+    return m_parts.back();
+}
+
+int SpanDemangler::listSize(int list) const
+{
+    return m_parts.size() - list;
+}
+
+void SpanDemangler::truncate(int list)
+{
+    m_parts.resize(list);
+}
+
+void SpanDemangler::handleNameComponent(demangle_component* component, int list)
+{
+    switch (component->type) {
+        case DEMANGLE_COMPONENT_NAME:
+            push(addString(component->u.s_name.s, component->u.s_name.len));
+            break;
+        case DEMANGLE_COMPONENT_QUAL_NAME:
+        case DEMANGLE_COMPONENT_LOCAL_NAME:
+            handleNameComponent(component->u.s_binary.left, list);
+            handleNameComponent(component->u.s_binary.right, list);
+            if (m_inArgList) {
+                const auto name = takeLast();
+                Span s = startString(last());
+                append(s, "::");
+                append(s, name);
+                last() = s;
+            }
+            break;
+        case DEMANGLE_COMPONENT_TYPED_NAME:
+        {
+            // template parameters are indexed per enclosing type name, so push that on the stack here
+            QScopedValueRollback<int> indexRestter(m_templateParamIndex, 0);
+            QScopedValueRollback<TemplateParams> paramsResetter(m_templateParams);
+            QScopedValueRollback<bool> shouldIndexResetter(m_indexTemplateArgs, true);
+            QScopedValueRollback<Span> modifierResetter(m_modifiers);
+            m_templateParams.clear();
+            m_modifiers = {};
+
+            // left is the name of the function, right is the return type (ignored here) and arguments
+            handleNameComponent(component->u.s_binary.left, list);
+            const int args = m_parts.size();
+            handleNameComponent(component->u.s_binary.right, args);
+            if (args > list && listSize(args) > 0) {
+                Span s = startString(m_parts[args - 1]);
+                append(s, last());
+                append(s, m_modifiers);
+                m_parts[args - 1] = s;
+            }
+            truncate(args);
+            break;
+        }
+        case DEMANGLE_COMPONENT_TEMPLATE:
+        {
+            {
+                QScopedValueRollback<bool> indexRestter(m_indexTemplateArgs, false);
+                handleNameComponent(component->u.s_binary.left, list);
+            }
+            const int args = m_parts.size();
+            handleNameComponent(component->u.s_binary.right, args);
+            Span fullTemplate = startString(m_parts[args - 1]);
+            append(fullTemplate, '<');
+            appendJoined(fullTemplate, args, m_parts.size(), ", ");
+            append(fullTemplate, '>');
+            truncate(args);
+            if (m_inArgList) // we only want the template grouping on top-level
+                m_parts.pop_back();
+            push(fullTemplate);
+            break;
+        }
+        case DEMANGLE_COMPONENT_TEMPLATE_PARAM:
+            push(m_templateParams.value(component->u.s_number.number));
+            break;
+        case DEMANGLE_COMPONENT_FUNCTION_PARAM:
+        {
+            // no idea what this means, but that's what c++filt is outputting for these...
+            Span s = addString("{parm#");
+            appendNumber(s, (int)component->u.s_number.number);
+            append(s, '}');
+            push(s);
+            break;
+        }
+        case DEMANGLE_COMPONENT_CTOR:
+            handleNameComponent(component->u.s_ctor.name, list);
+            break;
+        case DEMANGLE_COMPONENT_DTOR:
+            handleNameComponent(component->u.s_dtor.name, list);
+            last() = prepend("~", last());
+            break;
+        case DEMANGLE_COMPONENT_VTABLE:
+            handleNameComponent(component->u.s_binary.left, list);
+            push(addString("vtable"));
+            break;
+        case DEMANGLE_COMPONENT_VTT:
+            handleNameComponent(component->u.s_binary.left, list);
+            push(addString("vtt"));
+            break;
+        case DEMANGLE_COMPONENT_CONSTRUCTION_VTABLE:
+        {
+            handleNameComponent(component->u.s_binary.left, list);
+            const int tmp = m_parts.size();
+            handleNameComponent(component->u.s_binary.right, tmp);
+            Span s = addString("construction vtable in ");
+            appendJoined(s, tmp, m_parts.size(), "::");
+            truncate(tmp);
+            push(s);
+            break;
+        }
+        case DEMANGLE_COMPONENT_TYPEINFO:
+            handleNameComponent(component->u.s_binary.left, list);
+            push(addString("typeinfo"));
+            break;
+        case DEMANGLE_COMPONENT_TYPEINFO_NAME:
+            handleNameComponent(component->u.s_binary.left, list);
+            push(addString("typeinfo name"));
+            break;
+        case DEMANGLE_COMPONENT_TYPEINFO_FN:
+            handleNameComponent(component->u.s_binary.left, list);
+            push(addString("typeinfo function"));
+            break;
+        case DEMANGLE_COMPONENT_THUNK:
+            handleNameComponent(component->u.s_binary.left, list);
+            push(addString("thunk"));
+            break;
+        case DEMANGLE_COMPONENT_VIRTUAL_THUNK:
+            handleNameComponent(component->u.s_binary.left, list);
+            push(addString("virtual thunk"));
+            break;
+        case DEMANGLE_COMPONENT_COVARIANT_THUNK:
+            handleNameComponent(component->u.s_binary.left, list);
+            push(addString("covariant return thunk"));
+            break;
+        case DEMANGLE_COMPONENT_GUARD:
+            handleNameComponent(component->u.s_binary.left, list);
+            push(addString("guard variable"));
+            break;
+        case DEMANGLE_COMPONENT_REFTEMP:
+        {
+            handleNameComponent(component->u.s_binary.left, list);
+            const int tmp = m_parts.size();
+            handleNameComponent(component->u.s_binary.right, tmp);
+            Span s = addString("reference temporary #");
+            append(s, last());
+            truncate(tmp);
+            push(s);
+            break;
+        }
+        case DEMANGLE_COMPONENT_HIDDEN_ALIAS:
+            handleNameComponent(component->u.s_binary.left, list);
+            push(addString("hidden alias"));
+            break;
+        case DEMANGLE_COMPONENT_SUB_STD:
+            push(addString(component->u.s_name.s, component->u.s_name.len));
+            break;
+        case DEMANGLE_COMPONENT_RESTRICT:
+        case DEMANGLE_COMPONENT_VOLATILE:
+        case DEMANGLE_COMPONENT_CONST:
+        {
+            handleNameComponent(component->u.s_binary.left, list);
+            Span s = startString(last());
+            append(s, component->type == DEMANGLE_COMPONENT_RESTRICT ? " restrict" : component->type == DEMANGLE_COMPONENT_VOLATILE ? " volatile" : " const");
+            last() = s;
+            break;
+        }
+        case DEMANGLE_COMPONENT_RESTRICT_THIS:
+        case DEMANGLE_COMPONENT_VOLATILE_THIS:
+        case DEMANGLE_COMPONENT_CONST_THIS:
+#if BINUTILS_VERSION >= BINUTILS_VERSION_CHECK(2, 24)
+        case DEMANGLE_COMPONENT_REFERENCE_THIS:
+        case DEMANGLE_COMPONENT_RVALUE_REFERENCE_THIS:
+#endif
+        {
+            handleNameComponent(component->u.s_binary.left, list);
+            const char *modifier = nullptr;
+            switch (component->type) {
+                case DEMANGLE_COMPONENT_RESTRICT_THIS: modifier = " restrict"; break;
+                case DEMANGLE_COMPONENT_VOLATILE_THIS: modifier = " volatile"; break;
+                case DEMANGLE_COMPONENT_CONST_THIS: modifier = " const"; break;
+#if BINUTILS_VERSION >= BINUTILS_VERSION_CHECK(2, 24)
+                case DEMANGLE_COMPONENT_REFERENCE_THIS: modifier = " &"; break;
+                case DEMANGLE_COMPONENT_RVALUE_REFERENCE_THIS: modifier = " &&"; break;
+#endif
+                default: Q_UNREACHABLE();
+            }
+            Span s = startString(m_modifiers);
+            append(s, modifier);
+            m_modifiers = s;
+            break;
+        }
+        case DEMANGLE_COMPONENT_VENDOR_TYPE_QUAL:
+        {
+            const int parts = m_parts.size();
+            handleNameComponent(component->u.s_binary.left, parts);
+            handleNameComponent(component->u.s_binary.right, parts);
+            Span s = startString(m_parts[parts]);
+            append(s, ' ');
+            append(s, last());
+            truncate(parts);
+            push(s);
+            break;
+        }
+        case DEMANGLE_COMPONENT_POINTER:
+        {
+            QScopedValueRollback<bool> resetter(m_pendingPointer, true);
+            handleNameComponent(component->u.s_binary.left, list);
+            if (m_pendingPointer) { // not consumed by a function pointer
+                Span s = startString(last());
+                append(s, '*');
+                last() = s;
+            }
+            break;
+        }
+        case DEMANGLE_COMPONENT_REFERENCE:
+        {
+            QScopedValueRollback<bool> resetter(m_pendingReference, true);
+            handleNameComponent(component->u.s_binary.left, list);
+            if (m_pendingReference && !endsWith(last(), '&')) { // not consumed by the array type, and primitive reference collapsing
+                Span s = startString(last());
+                append(s, '&');
+                last() = s;
+            }
+            break;
+        }
+        case DEMANGLE_COMPONENT_RVALUE_REFERENCE:
+            handleNameComponent(component->u.s_binary.left, list);
+            // skip appending && in case of reference collapsing, or for empty template args in a pack expansion
+            if (!endsWith(last(), '&') && last().size > 0) {
+                Span s = startString(last());
+                append(s, "&&");
+                last() = s;
+            }
+            break;
+        case DEMANGLE_COMPONENT_BUILTIN_TYPE:
+            push(addString(component->u.s_builtin.type->name, component->u.s_builtin.type->len));
+            break;
+        case DEMANGLE_COMPONENT_FUNCTION_TYPE:
+        {
+            const bool previousPendingPointer = m_pendingPointer;
+            m_pendingPointer = false;
+
+            // left is return type (only relevant in argument lists), right is the (optional) argument list
+            const int returnType = m_parts.size();
+            handleOptionalNameComponent(component->u.s_binary.left, returnType);
+            const int args = m_parts.size();
+            handleOptionalNameComponent(component->u.s_binary.right, args);
+
+            Span fullName = startString();
+            if (m_inArgList && args > returnType) {
+                append(fullName, m_parts[args - 1]);
+                append(fullName, ' ');
+            }
+            if (previousPendingPointer) { // function pointer
+                append(fullName, "(*)");
+            } else if (m_ptrmemType.size > 0) {
+                append(fullName, '(');
+                append(fullName, m_ptrmemType);
+                append(fullName, "::*)");
+            } else {
+                m_pendingPointer = previousPendingPointer;
+            }
+            append(fullName, '(');
+            appendJoined(fullName, args, m_parts.size(), ", ");
+            append(fullName, ')');
+            truncate(returnType);
+            push(fullName);
+            break;
+        }
+        case DEMANGLE_COMPONENT_ARRAY_TYPE:
+        {
+            const bool prevRef = m_pendingReference;
+            m_pendingReference = false;
+            // left is optional dimension, right is type
+            handleNameComponent(component->u.s_binary.right, list);
+            const int dim = m_parts.size();
+            handleOptionalNameComponent(component->u.s_binary.left, dim);
+            Span s = startString(m_parts[dim - 1]);
+            if (prevRef) {
+                append(s, " (&)"); // array references are special...
+            } else {
+                m_pendingReference = prevRef;
+            }
+            append(s, " [");
+            if (listSize(dim) > 0)
+                append(s, last());
+            append(s, ']');
+            truncate(dim);
+            last() = s;
+            break;
+        }
+        case DEMANGLE_COMPONENT_PTRMEM_TYPE:
+        {
+            QScopedValueRollback<Span> ptrmemTypeResetter(m_ptrmemType);
+            m_ptrmemType = {};
+            const int tmp = m_parts.size();
+            handleNameComponent(component->u.s_binary.left, tmp);
+            m_ptrmemType = last();
+            truncate(tmp);
+            handleNameComponent(component->u.s_binary.right, list);
+            break;
+        }
+        case DEMANGLE_COMPONENT_VECTOR_TYPE:
+        {
+            // left is size, right is type
+            const int parts = m_parts.size();
+            handleNameComponent(component->u.s_binary.left, parts);
+            handleNameComponent(component->u.s_binary.right, parts);
+            Span s = startString(last());
+            append(s, " __vector(");
+            append(s, m_parts[parts]);
+            append(s, ')');
+            truncate(parts);
+            push(s);
+            break;
+        }
+        case DEMANGLE_COMPONENT_ARGLIST:
+        {
+            QScopedValueRollback<bool> resetter(m_inArgList, true);
+            if (!component->u.s_binary.left && !component->u.s_binary.right) {
+                push(startString()); // empty arg list
+            } else {
+                handleOptionalNameComponent(component->u.s_binary.left, list);
+                handleOptionalNameComponent(component->u.s_binary.right, list);
+            }
+            break;
+        }
+        case DEMANGLE_COMPONENT_TEMPLATE_ARGLIST:
+        {
+            QScopedValueRollback<bool> resetter(m_inArgList, true);
+
+            if (component->u.s_binary.left) {
+                int currentIndex = -1;
+                if (m_indexTemplateArgs)
+                    currentIndex = m_templateParamIndex++;
+                // the left list is directly appended to ours, so no need to copy anything
+                const int left = m_parts.size();
+                {
+                    QScopedValueRollback<bool> resetter(m_indexTemplateArgs, false);
+                    handleNameComponent(component->u.s_binary.left, left);
+                }
+                if (m_indexTemplateArgs) {
+                    Q_ASSERT(currentIndex >= 0);
+                    if (listSize(left) == 0)
+                        m_templateParams.insert(currentIndex, {}); // empty template arg, might be referenced from elsewhere...
+                    else
+                        m_templateParams.insert(currentIndex, last());
+                }
+            }
+
+            handleOptionalNameComponent(component->u.s_binary.right, list);
+            break;
+        }
+#if BINUTILS_VERSION >= BINUTILS_VERSION_CHECK(2, 32)
+        case DEMANGLE_COMPONENT_TPARM_OBJ:
+            handleNameComponent(component->u.s_binary.left, list);
+            last() = prepend("template parameter object for ", last());
+            break;
+#endif
+#if BINUTILS_VERSION >= BINUTILS_VERSION_CHECK(2, 23)
+        case DEMANGLE_COMPONENT_INITIALIZER_LIST:
+        {
+            const int parts = m_parts.size();
+            handleNameComponent(component->u.s_binary.left, parts);
+            handleNameComponent(component->u.s_binary.right, parts);
+            Span s = startString(m_parts[parts]);
+            append(s, '{');
+            append(s, m_parts[parts + 1]);
+            append(s, '}');
+            truncate(parts);
+            push(s);
+            break;
+        }
+#endif
+        case DEMANGLE_COMPONENT_OPERATOR:
+        {
+            Span s = addString("operator");
+            append(s, component->u.s_operator.op->name, component->u.s_operator.op->len);
+            push(s);
+            break;
+        }
+        case DEMANGLE_COMPONENT_EXTENDED_OPERATOR:
+            handleNameComponent(component->u.s_extended_operator.name, list);
+            break;
+        case DEMANGLE_COMPONENT_CAST:
+#if BINUTILS_VERSION >= BINUTILS_VERSION_CHECK(2, 26)
+        case DEMANGLE_COMPONENT_CONVERSION:
+#endif
+            handleNameComponent(component->u.s_binary.left, list);
+            last() = prepend("operator ", last());
+            break;
+#if BINUTILS_VERSION >= BINUTILS_VERSION_CHECK(2, 23)
+        case DEMANGLE_COMPONENT_NULLARY:
+            handleNameComponent(component->u.s_binary.left, list);
+            break;
+#endif
+        case DEMANGLE_COMPONENT_UNARY:
+        {
+            handleOperatorComponent(component->u.s_binary.left, list);
+            handleNameComponent(component->u.s_binary.right, list);
+            const auto arg = takeLast();
+            Span s = startString(last());
+            append(s, arg);
+            last() = s;
+            break;
+        }
+        case DEMANGLE_COMPONENT_BINARY:
+        {
+            handleOperatorComponent(component->u.s_binary.left, list);
+            handleNameComponent(component->u.s_binary.right, list);
+            const auto arg2 = takeLast();
+            const auto arg1 = takeLast();
+            Span s = startString(arg1);
+            append(s, last());
+            append(s, arg2);
+            last() = s;
+            break;
+        }
+        case DEMANGLE_COMPONENT_BINARY_ARGS:
+        case DEMANGLE_COMPONENT_TRINARY:
+        case DEMANGLE_COMPONENT_TRINARY_ARG1:
+        case DEMANGLE_COMPONENT_TRINARY_ARG2:
+            handleNameComponent(component->u.s_binary.left, list);
+            handleNameComponent(component->u.s_binary.right, list);
+            break;
+        case DEMANGLE_COMPONENT_LITERAL:
+        case DEMANGLE_COMPONENT_LITERAL_NEG:
+        {
+            // left is type, right is value
+            const int type = m_parts.size();
+            handleNameComponent(component->u.s_binary.left, type);
+            handleNameComponent(component->u.s_binary.right, type);
+            if (component->type == DEMANGLE_COMPONENT_LITERAL_NEG)
+                last() = prepend("-", last());
+            const auto typeName = m_parts[type];
+            const auto value = last();
+            Span typeStr;
+            // TODO add: unsigned, long, long long, unsigned long long
+            if (equals(typeName, "bool")) {
+                typeStr = addString(equals(value, "0") ? "false" : "true");
+            } else if (equals(typeName, "int")) {
+                typeStr = value;
+            } else if (equals(typeName, "unsigned long")) {
+                typeStr = startString(value);
+                append(typeStr, "ul");
+            } else { // custom type
+                typeStr = addString("(");
+                append(typeStr, typeName);
+                append(typeStr, ')');
+                append(typeStr, value);
+            }
+            truncate(type);
+            push(typeStr);
+            break;
+        }
+        case DEMANGLE_COMPONENT_NUMBER:
+        {
+            Span s = startString();
+            appendNumber(s, (int)component->u.s_number.number);
+            push(s);
+            break;
+        }
+        case DEMANGLE_COMPONENT_DECLTYPE:
+            // TODO: undocumented, but one seems to contain content at least
+            handleOptionalNameComponent(component->u.s_binary.left, list);
+            handleOptionalNameComponent(component->u.s_binary.right, list);
+            break;
+        case DEMANGLE_COMPONENT_LAMBDA:
+        {
+            const int args = m_parts.size();
+            handleNameComponent(component->u.s_unary_num.sub, args);
+            Span s = addString("{lambda(");
+            appendJoined(s, args, m_parts.size(), ", ");
+            append(s, ")#");
+            appendNumber(s, component->u.s_unary_num.num + 1);
+            append(s, '}');
+            truncate(args);
+            push(s);
+            break;
+        }
+        case DEMANGLE_COMPONENT_DEFAULT_ARG:
+        {
+            Span s = addString("{default arg#");
+            appendNumber(s, component->u.s_unary_num.num + 1);
+            append(s, '}');
+            push(s);
+            handleOptionalNameComponent(component->u.s_unary_num.sub, list);
+            break;
+        }
+        case DEMANGLE_COMPONENT_UNNAMED_TYPE:
+        {
+            Span s = addString("{unnamed type#");
+            appendNumber(s, (int)component->u.s_number.number + 1);
+            append(s, '}');
+            push(s);
+            break;
+        }
+#if BINUTILS_VERSION >= BINUTILS_VERSION_CHECK(2, 23)
+        case DEMANGLE_COMPONENT_TRANSACTION_CLONE:
+            handleNameComponent(component->u.s_binary.left, list);
+            last() = prepend("transaction clone for ", last());
+            break;
+        case DEMANGLE_COMPONENT_NONTRANSACTION_CLONE:
+            handleNameComponent(component->u.s_binary.left, list);
+            last() = prepend("non-transaction clone for ", last());
+            break;
+#endif
+        case DEMANGLE_COMPONENT_PACK_EXPANSION:
+            handleOptionalNameComponent(component->u.s_binary.left, list);
+            handleOptionalNameComponent(component->u.s_binary.right, list);
+            break;
+#if BINUTILS_VERSION >= BINUTILS_VERSION_CHECK(2, 23)
+#if BINUTILS_VERSION >= BINUTILS_VERSION_CHECK(2, 24)
+        case DEMANGLE_COMPONENT_TAGGED_NAME:
+#endif
+        case DEMANGLE_COMPONENT_CLONE:
+        {
+            handleNameComponent(component->u.s_binary.left, list);
+            const int args = m_parts.size();
+            handleNameComponent(component->u.s_binary.right, args);
+            Span s = startString(m_parts[args - 1]);
+            append(s, component->type == DEMANGLE_COMPONENT_CLONE ? " [clone " : "[abi:");
+            append(s, last());
+            append(s, ']');
+            truncate(args);
+            last() = s;
+            break;
+        }
+#endif
+#if BINUTILS_VERSION >= BINUTILS_VERSION_CHECK(2, 28)
+        case DEMANGLE_COMPONENT_NOEXCEPT:
+        {
+            handleNameComponent(component->u.s_binary.left, list);
+            Span s = startString(last());
+            append(s, " noexcept");
+            last() = s;
+            break;
+        }
+#endif
+        default:
+            qDebug() << Q_FUNC_INFO << "unhandled component type" << component->type << m_mangledName;
+    }
+}
+
+void SpanDemangler::handleOptionalNameComponent(demangle_component* component, int list)
+{
+    if (!component)
+        return;
+    handleNameComponent(component, list);
+}
+
+void SpanDemangler::handleOperatorComponent(demangle_component* component, int list)
+{
+    if (component->type == DEMANGLE_COMPONENT_OPERATOR) {
+        push(addString(component->u.s_operator.op->name, component->u.s_operator.op->len));
+        return;
+    }
+    handleNameComponent(component, list);
+}
@@ -0,0 +1,133 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SPANDEMANGLER_H
+#define SPANDEMANGLER_H
+
+#include <QByteArray>
+#include <QVector>
+
+#include <vector>
+
+struct demangle_component;
+
+/** Allocation-free C++ name demangler, this is what Demangler is built upon.
+ *  Splits names into namespace(s)/class/method parts and/or produces the full demangled
+ *  name, written into buffers that are reused between calls. Once those have grown large
+ *  enough, the only remaining heap allocation per symbol is libiberty's component tree.
+ *  Results are only valid until the next call to demangle(). Use one instance per thread.
+ */
+class SpanDemangler
+{
+public:
+    SpanDemangler();
+    SpanDemangler(const SpanDemangler&) = delete;
+    ~SpanDemangler();
+
+    SpanDemangler& operator=(const SpanDemangler&) = delete;
+
+    enum Output {
+        NameParts = 1,
+        FullName = 2
+    };
+
+    /** Demangle @p name into the outputs selected by @p outputs (a combination of Output flags).
+     *  Returns the number of name parts.
+     */
+    int demangle(const char *name, int outputs = NameParts);
+
+    /** Number of name parts of the last demangled name. */
+    int partCount() const;
+    /** Name part @p index, not null-terminated. */
+    const char* partData(int index) const;
+    int partSize(int index) const;
+    /** Deep copy of name part @p index. */
+    QByteArray part(int index) const;
+    /** Deep copy of all name parts, equivalent to the result of Demangler::demangle(). */
+    QVector<QByteArray> parts() const;
+
+    /** Full demangled name, if requested, not null-terminated. */
+    const char* fullNameData() const;
+    int fullNameSize() const;
+    /** Deep copy of the full name, equivalent to the result of Demangler::demangleFull(). */
+    QByteArray fullName() const;
+
+private:
+    /** A string in m_buffer. */
+    struct Span {
+        int offset = 0;
+        int size = 0;
+    };
+
+    /** Template arguments by index, with inline storage for the common case. */
+    class TemplateParams
+    {
+    public:
+        Span value(int index) const;
+        void insert(int index, Span value);
+        void clear();
+
+    private:
+        enum { InlineSize = 8 };
+        Span m_inline[InlineSize];
+        std::vector<Span> m_overflow;
+        int m_size = 0;
+    };
+
+    void reset();
+    // name parts are kept on a stack, a list of parts is identified by its start index on that stack
+    void handleNameComponent(demangle_component *component, int list);
+    void handleOptionalNameComponent(demangle_component *component, int list);
+    void handleOperatorComponent(demangle_component *component, int list);
+
+    Span addString(const char *str, int size);
+    Span addString(const char *str);
+    // starts a new string, extended in place if @p s is the last string in the buffer
+    Span startString(Span s);
+    Span startString();
+    void append(Span &s, Span other);
+    void append(Span &s, const char *str, int size);
+    void append(Span &s, const char *str);
+    void append(Span &s, char c);
+    void appendNumber(Span &s, int n);
+    void appendJoined(Span &s, int begin, int end, const char *separator);
+    Span prepend(const char *prefix, Span s);
+    bool equals(Span s, const char *str) const;
+    bool endsWith(Span s, char c) const;
+
+    void push(Span s);
+    Span takeLast();
+    Span& last();
+    int listSize(int list) const;
+    void truncate(int list);
+
+    const char *m_mangledName = nullptr;
+    std::vector<char> m_buffer;
+    std::vector<Span> m_parts;
+    std::vector<char> m_fullName;
+
+    int m_templateParamIndex = 0;
+    TemplateParams m_templateParams;
+    Span m_modifiers;
+    Span m_ptrmemType;
+    bool m_inArgList = false;
+    bool m_pendingPointer = false;
+    bool m_pendingReference = false;
+    bool m_indexTemplateArgs = false;
+};
+
+#endif // SPANDEMANGLER_H
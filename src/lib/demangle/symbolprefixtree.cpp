@@ -0,0 +1,280 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "symbolprefixtree.h"
+#include "demangler.h"
+
+#include <elf/elffile.h>
+#include <elf/elfsymboltablesection.h>
+#include <elf/elfsymboltableentry.h>
+
+#include <QHash>
+#include <QPair>
+
+#include <algorithm>
+#include <cassert>
+
+struct SymbolPrefixTree::BuildNode {
+    QByteArray namePart;
+    QVector<int> children;
+    int symbolCount = 0;
+};
+
+namespace {
+struct SymbolRecord {
+    int node;
+    SymbolPrefixTree::Statistics statistics;
+    uint16_t sectionIndex;
+};
+}
+
+SymbolPrefixTree::SymbolPrefixTree(const ElfFile *file)
+{
+    QVector<BuildNode> buildNodes;
+    buildNodes.push_back(BuildNode());
+    QVector<SymbolRecord> records;
+
+    const auto symtab = file->symbolTable();
+    if (symtab) {
+        m_demangledNames = Demangler::demangleAll(symtab);
+        records.reserve(symtab->header()->entryCount());
+
+        QHash<QPair<int, QByteArray>, int> childLookup;
+        for (uint32_t i = 0; i < symtab->header()->entryCount(); ++i) {
+            const auto entry = symtab->entry(i);
+            if (entry->size() == 0 || entry->sectionIndex() == 0 || entry->sectionIndex() >= file->sectionCount())
+                continue;
+
+            auto nameParts = m_demangledNames.nameParts(i);
+            if (nameParts.isEmpty())
+                nameParts.push_back(QByteArray(entry->name()));
+
+            int node = RootNode;
+            for (const auto &namePart : nameParts) {
+                const auto key = qMakePair(node, namePart);
+                auto it = childLookup.constFind(key);
+                if (it == childLookup.constEnd()) {
+                    BuildNode child;
+                    child.namePart = namePart;
+                    buildNodes.push_back(child);
+                    buildNodes[node].children.push_back(buildNodes.size() - 1);
+                    it = childLookup.insert(key, buildNodes.size() - 1);
+                }
+                node = it.value();
+            }
+            ++buildNodes[node].symbolCount;
+
+            SymbolRecord record;
+            record.node = node;
+            record.sectionIndex = entry->sectionIndex();
+            record.statistics.size = entry->size();
+            record.statistics.symbolCount = 1;
+            record.statistics.relocationCount = file->reverseRelocator()->relocationCount(entry->value(), entry->size());
+            records.push_back(record);
+        }
+    }
+
+    QVector<int> nodeForBuildNode(buildNodes.size(), -1);
+    addNode(buildNodes, RootNode, -1, nodeForBuildNode);
+
+    for (auto &record : records)
+        record.node = nodeForBuildNode.at(record.node);
+    std::sort(records.begin(), records.end(), [](const SymbolRecord &lhs, const SymbolRecord &rhs) {
+        return lhs.node < rhs.node || (lhs.node == rhs.node && lhs.sectionIndex < rhs.sectionIndex);
+    });
+
+    // nodes are in pre-order, so iterating backwards visits all children before their parent
+    QVector<SectionStatistics> sections;
+    auto recordIt = records.constEnd();
+    for (int nodeIdx = m_nodes.size() - 1; nodeIdx >= 0; --nodeIdx) {
+        sections.clear();
+        while (recordIt != records.constBegin() && (recordIt - 1)->node == nodeIdx) {
+            --recordIt;
+            sections.push_back({ recordIt->sectionIndex, recordIt->statistics });
+        }
+        auto &node = m_nodes[nodeIdx];
+        for (int i = 0; i < node.childCount; ++i) {
+            const auto &child = m_nodes.at(m_children.at(node.firstChild + i));
+            std::copy(m_sections.constBegin() + child.firstSection, m_sections.constBegin() + child.firstSection + child.sectionCount, std::back_inserter(sections));
+        }
+        std::sort(sections.begin(), sections.end(), [](const SectionStatistics &lhs, const SectionStatistics &rhs) {
+            return lhs.sectionIndex < rhs.sectionIndex;
+        });
+
+        node.firstSection = m_sections.size();
+        for (const auto &section : sections) {
+            node.statistics.size += section.statistics.size;
+            node.statistics.symbolCount += section.statistics.symbolCount;
+            node.statistics.relocationCount += section.statistics.relocationCount;
+            if (m_sections.size() > node.firstSection && m_sections.last().sectionIndex == section.sectionIndex) {
+                auto &stats = m_sections.last().statistics;
+                stats.size += section.statistics.size;
+                stats.symbolCount += section.statistics.symbolCount;
+                stats.relocationCount += section.statistics.relocationCount;
+            } else {
+                m_sections.push_back(section);
+            }
+        }
+        node.sectionCount = m_sections.size() - node.firstSection;
+    }
+}
+
+SymbolPrefixTree::~SymbolPrefixTree() = default;
+
+int SymbolPrefixTree::addNode(const QVector<BuildNode> &buildNodes, int buildIndex, int parent, QVector<int> &nodeForBuildNode)
+{
+    const int nodeIdx = m_nodes.size();
+    Node node;
+    node.parent = parent;
+    node.firstChild = 0;
+    node.childCount = 0;
+    node.firstNamePart = m_nameParts.size();
+    node.firstSection = 0;
+    node.sectionCount = 0;
+
+    // merge chains without symbols of their own into a single node
+    if (buildIndex != RootNode) {
+        forever {
+            m_nameParts.push_back(buildNodes.at(buildIndex).namePart);
+            const auto &buildNode = buildNodes.at(buildIndex);
+            if (buildNode.symbolCount > 0 || buildNode.children.size() != 1)
+                break;
+            buildIndex = buildNode.children.at(0);
+        }
+    }
+    node.namePartCount = m_nameParts.size() - node.firstNamePart;
+    nodeForBuildNode[buildIndex] = nodeIdx;
+    m_nodes.push_back(node);
+
+    auto buildChildren = buildNodes.at(buildIndex).children;
+    std::sort(buildChildren.begin(), buildChildren.end(), [&buildNodes](int lhs, int rhs) {
+        return buildNodes.at(lhs).namePart < buildNodes.at(rhs).namePart;
+    });
+    QVector<int> children;
+    children.reserve(buildChildren.size());
+    for (const auto buildChild : buildChildren)
+        children.push_back(addNode(buildNodes, buildChild, nodeIdx, nodeForBuildNode));
+
+    m_nodes[nodeIdx].firstChild = m_children.size();
+    m_nodes[nodeIdx].childCount = children.size();
+    m_children += children;
+    return nodeIdx;
+}
+
+int SymbolPrefixTree::nodeCount() const
+{
+    return m_nodes.size();
+}
+
+int SymbolPrefixTree::parent(int node) const
+{
+    return m_nodes.at(node).parent;
+}
+
+int SymbolPrefixTree::childCount(int node) const
+{
+    return m_nodes.at(node).childCount;
+}
+
+int SymbolPrefixTree::child(int node, int index) const
+{
+    assert(index >= 0 && index < childCount(node));
+    return m_children.at(m_nodes.at(node).firstChild + index);
+}
+
+QVector<QByteArray> SymbolPrefixTree::nameParts(int node) const
+{
+    const auto &n = m_nodes.at(node);
+    return m_nameParts.mid(n.firstNamePart, n.namePartCount);
+}
+
+QByteArray SymbolPrefixTree::name(int node) const
+{
+    const auto &n = m_nodes.at(node);
+    QByteArray s;
+    for (int i = 0; i < n.namePartCount; ++i) {
+        if (i > 0)
+            s += "::";
+        s += m_nameParts.at(n.firstNamePart + i);
+    }
+    return s;
+}
+
+QByteArray SymbolPrefixTree::qualifiedName(int node) const
+{
+    QByteArray s = name(node);
+    for (node = parent(node); node > RootNode; node = parent(node))
+        s.prepend(name(node) + "::");
+    return s;
+}
+
+SymbolPrefixTree::Statistics SymbolPrefixTree::statistics(int node) const
+{
+    return m_nodes.at(node).statistics;
+}
+
+SymbolPrefixTree::Statistics SymbolPrefixTree::statistics(int node, uint16_t sectionIndex) const
+{
+    const auto &n = m_nodes.at(node);
+    const auto begin = m_sections.constBegin() + n.firstSection;
+    const auto end = begin + n.sectionCount;
+    const auto it = std::lower_bound(begin, end, sectionIndex, [](const SectionStatistics &lhs, uint16_t rhs) {
+        return lhs.sectionIndex < rhs;
+    });
+    if (it == end || (*it).sectionIndex != sectionIndex)
+        return {};
+    return (*it).statistics;
+}
+
+QVector<uint16_t> SymbolPrefixTree::sections(int node) const
+{
+    const auto &n = m_nodes.at(node);
+    QVector<uint16_t> sections;
+    sections.reserve(n.sectionCount);
+    for (int i = 0; i < n.sectionCount; ++i)
+        sections.push_back(m_sections.at(n.firstSection + i).sectionIndex);
+    return sections;
+}
+
+int SymbolPrefixTree::findChild(int node, const QByteArray &namePart) const
+{
+    const auto &n = m_nodes.at(node);
+    const auto begin = m_children.constBegin() + n.firstChild;
+    const auto end = begin + n.childCount;
+    const auto it = std::lower_bound(begin, end, namePart, [this](int lhs, const QByteArray &rhs) {
+        return m_nameParts.at(m_nodes.at(lhs).firstNamePart) < rhs;
+    });
+    if (it == end || m_nameParts.at(m_nodes.at(*it).firstNamePart) != namePart)
+        return -1;
+    return *it;
+}
+
+int SymbolPrefixTree::find(const QVector<QByteArray> &path) const
+{
+    int node = RootNode;
+    for (int i = 0; i < path.size();) {
+        node = findChild(node, path.at(i));
+        if (node < 0)
+            return -1;
+        const auto &n = m_nodes.at(node);
+        for (int j = 0; j < n.namePartCount && i < path.size(); ++j, ++i) {
+            if (m_nameParts.at(n.firstNamePart + j) != path.at(i))
+                return -1;
+        }
+    }
+    return node;
+}
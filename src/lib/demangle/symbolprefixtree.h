@@ -0,0 +1,111 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SYMBOLPREFIXTREE_H
+#define SYMBOLPREFIXTREE_H
+
+#include "demanglednametable.h"
+
+#include <QByteArray>
+#include <QVector>
+
+#include <cstdint>
+
+class ElfFile;
+
+/** Compressed prefix tree over the demangled names of all symbols of a file.
+ *  Every node aggregates the symbols below it, in total as well as per section,
+ *  so namespace or class level rollups and drill-downs are O(depth) lookups.
+ *  Chains of nodes without symbols of their own and with only a single child
+ *  are merged into one node, which then covers several name parts.
+ */
+class SymbolPrefixTree
+{
+public:
+    /** Aggregated data of all symbols below a node. */
+    struct Statistics {
+        uint64_t size = 0;
+        int symbolCount = 0;
+        int relocationCount = 0;
+    };
+
+    /** Builds the tree from the symbol table of @p file. */
+    explicit SymbolPrefixTree(const ElfFile *file);
+    SymbolPrefixTree(const SymbolPrefixTree&) = delete;
+    ~SymbolPrefixTree();
+    SymbolPrefixTree& operator=(const SymbolPrefixTree&) = delete;
+
+    /** Index of the root node, which aggregates all symbols. */
+    enum { RootNode = 0 };
+
+    /** Number of nodes in this tree. */
+    int nodeCount() const;
+    /** Parent node of @p node, -1 for the root node. */
+    int parent(int node) const;
+    /** Number of child nodes of @p node. */
+    int childCount(int node) const;
+    /** Child node @p index of @p node, children are sorted by name. */
+    int child(int node, int index) const;
+
+    /** Name parts covered by @p node, the root node has none. */
+    QVector<QByteArray> nameParts(int node) const;
+    /** Name parts covered by @p node, joined with "::". */
+    QByteArray name(int node) const;
+    /** Fully qualified name of @p node. */
+    QByteArray qualifiedName(int node) const;
+
+    /** Aggregated data of all symbols below @p node. */
+    Statistics statistics(int node) const;
+    /** Aggregated data of all symbols below @p node in section @p sectionIndex. */
+    Statistics statistics(int node, uint16_t sectionIndex) const;
+    /** Indexes of the sections containing symbols below @p node, in ascending order. */
+    QVector<uint16_t> sections(int node) const;
+
+    /** Finds the node for the namespace/class/symbol given as a list of name parts.
+     *  If @p path ends within a compressed node, that node is returned.
+     *  Returns -1 if there is no such node.
+     */
+    int find(const QVector<QByteArray> &path) const;
+
+private:
+    struct BuildNode;
+    struct SectionStatistics {
+        uint16_t sectionIndex;
+        Statistics statistics;
+    };
+    struct Node {
+        int parent;
+        int firstChild;
+        int childCount;
+        int firstNamePart;
+        int namePartCount;
+        int firstSection;
+        int sectionCount;
+        Statistics statistics;
+    };
+
+    int addNode(const QVector<BuildNode> &buildNodes, int buildIndex, int parent, QVector<int> &nodeForBuildNode);
+    int findChild(int node, const QByteArray &namePart) const;
+
+    DemangledNameTable m_demangledNames;
+    QVector<Node> m_nodes;
+    QVector<int> m_children;
+    QVector<QByteArray> m_nameParts;
+    QVector<SectionStatistics> m_sections;
+};
+
+#endif // SYMBOLPREFIXTREE_H
@@ -187,11 +187,16 @@ QString Disassembler::disassembleBinutils(const unsigned char* data, uint64_t si
     info.print_address_func = print_address;
 
     uint32_t bytes = 0;
+#if HAVE_DWARF
+    DwarfLine previousLine;
+#endif
     while (bytes < size) {
 #if HAVE_DWARF
+        // rows cover address ranges, only print where a new one starts
         auto line = lineForAddress(baseAddress() + bytes);
-        if (!line.isNull())
+        if (!line.isNull() && line != previousLine)
             result += printSourceLine(line) + "<br/>";
+        previousLine = line;
 #endif
         result += QStringLiteral("%1: ").arg(bytes, 8, 10);
         bytes += (*disassemble_fn)(bytes, &info);
@@ -248,6 +253,9 @@ QString Disassembler::disassembleCapstone(const unsigned char* data, uint64_t si
 
     auto address = baseAddress();
     QString result;
+#if HAVE_DWARF
+    DwarfLine previousLine;
+#endif
 
     size_t cs_size = size; // force to size_t for 32bit host support
     while (cs_size > 0) {
@@ -257,8 +265,9 @@ QString Disassembler::disassembleCapstone(const unsigned char* data, uint64_t si
 
 #if HAVE_DWARF
         const auto line = lineForAddress(insn->address);
-        if (!line.isNull())
+        if (!line.isNull() && line != previousLine)
             result += printSourceLine(line) + "<br/>";
+        previousLine = line;
 #endif
 
         result += QString::number(insn->address - baseAddress()) + ": " + insn->mnemonic + QLatin1Char(' ') + insn->op_str;
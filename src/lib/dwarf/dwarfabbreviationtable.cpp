@@ -0,0 +1,168 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "dwarfabbreviationtable.h"
+#include "dwarfleb128.h"
+
+#include <dwarf.h>
+
+int DwarfUnitFormat::formSize(uint16_t form) const
+{
+    switch (form) {
+        case DW_FORM_flag_present:
+        case DW_FORM_implicit_const:
+            return 0;
+        case DW_FORM_data1:
+        case DW_FORM_ref1:
+        case DW_FORM_flag:
+        case DW_FORM_strx1:
+        case DW_FORM_addrx1:
+            return 1;
+        case DW_FORM_data2:
+        case DW_FORM_ref2:
+        case DW_FORM_strx2:
+        case DW_FORM_addrx2:
+            return 2;
+        case DW_FORM_strx3:
+        case DW_FORM_addrx3:
+            return 3;
+        case DW_FORM_data4:
+        case DW_FORM_ref4:
+        case DW_FORM_ref_sup4:
+        case DW_FORM_strx4:
+        case DW_FORM_addrx4:
+            return 4;
+        case DW_FORM_data8:
+        case DW_FORM_ref8:
+        case DW_FORM_ref_sig8:
+        case DW_FORM_ref_sup8:
+            return 8;
+        case DW_FORM_data16:
+            return 16;
+        case DW_FORM_addr:
+            return addressSize;
+        case DW_FORM_ref_addr:
+            // DWARF 2 used the address size here
+            return version <= 2 ? addressSize : offsetSize;
+        case DW_FORM_strp:
+        case DW_FORM_line_strp:
+        case DW_FORM_sec_offset:
+        case DW_FORM_strp_sup:
+        case DW_FORM_GNU_ref_alt:
+        case DW_FORM_GNU_strp_alt:
+            return offsetSize;
+        case DW_FORM_string:
+        case DW_FORM_block:
+        case DW_FORM_block1:
+        case DW_FORM_block2:
+        case DW_FORM_block4:
+        case DW_FORM_exprloc:
+        case DW_FORM_sdata:
+        case DW_FORM_udata:
+        case DW_FORM_ref_udata:
+        case DW_FORM_strx:
+        case DW_FORM_addrx:
+        case DW_FORM_loclistx:
+        case DW_FORM_rnglistx:
+        case DW_FORM_GNU_addr_index:
+        case DW_FORM_GNU_str_index:
+        case DW_FORM_indirect:
+            return -1;
+    }
+    return -2;
+}
+
+DwarfAbbreviationTable::DwarfAbbreviationTable(const char* data, const char* end, const DwarfUnitFormat& format)
+{
+    int size = 0;
+    while (data < end) {
+        DwarfAbbreviation abbrev;
+        abbrev.code = DwarfLEB128::decodeUnsigned(data, &size);
+        data += size;
+        if (abbrev.code == 0) {
+            m_isValid = true;
+            break;
+        }
+        if (data >= end)
+            return;
+
+        abbrev.tag = DwarfLEB128::decodeUnsigned(data, &size);
+        data += size;
+        if (data >= end)
+            return;
+        abbrev.hasChildren = *data++ == DW_CHILDREN_yes;
+
+        forever {
+            if (data >= end)
+                return;
+            DwarfAbbreviation::Attribute attr;
+            attr.attribute = DwarfLEB128::decodeUnsigned(data, &size);
+            data += size;
+            attr.form = DwarfLEB128::decodeUnsigned(data, &size);
+            data += size;
+            attr.implicitConst = 0;
+            if (attr.attribute == 0 && attr.form == 0)
+                break;
+            if (attr.form == DW_FORM_implicit_const) {
+                attr.implicitConst = DwarfLEB128::decodeSigned(data, &size);
+                data += size;
+            }
+
+            attr.size = format.formSize(attr.form);
+            if (attr.size == -2)
+                return;
+            attr.offset = abbrev.fixedSize;
+            if (attr.size < 0)
+                abbrev.fixedSize = -1;
+            else if (abbrev.fixedSize >= 0)
+                abbrev.fixedSize += attr.size;
+            abbrev.attributes.push_back(attr);
+        }
+
+        if (abbrev.code != (uint64_t)m_abbreviations.size() + 1 && m_codeIndex.isEmpty()) {
+            for (int i = 0; i < m_abbreviations.size(); ++i)
+                m_codeIndex.insert(m_abbreviations.at(i).code, i);
+        }
+        if (!m_codeIndex.isEmpty())
+            m_codeIndex.insert(abbrev.code, m_abbreviations.size());
+        m_abbreviations.push_back(abbrev);
+    }
+}
+
+bool DwarfAbbreviationTable::isValid() const
+{
+    return m_isValid;
+}
+
+int DwarfAbbreviationTable::size() const
+{
+    return m_abbreviations.size();
+}
+
+const DwarfAbbreviation* DwarfAbbreviationTable::abbreviation(uint64_t code) const
+{
+    if (m_codeIndex.isEmpty()) {
+        if (code == 0 || code > (uint64_t)m_abbreviations.size())
+            return nullptr;
+        return &m_abbreviations.at(code - 1);
+    }
+
+    const auto it = m_codeIndex.constFind(code);
+    if (it == m_codeIndex.constEnd())
+        return nullptr;
+    return &m_abbreviations.at(it.value());
+}
@@ -0,0 +1,77 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DWARFABBREVIATIONTABLE_H
+#define DWARFABBREVIATIONTABLE_H
+
+#include <QHash>
+#include <QVector>
+
+#include <cstdint>
+
+/** Unit header properties affecting the size of attribute values. */
+struct DwarfUnitFormat
+{
+    uint16_t version = 0;
+    uint8_t addressSize = 0;
+    uint8_t offsetSize = 0;
+
+    /** Size in bytes of a value of @p form, -1 if it depends on the content, -2 if @p form is not supported. */
+    int formSize(uint16_t form) const;
+};
+
+/** A single entry of an abbreviation table in the .debug_abbrev section. */
+struct DwarfAbbreviation
+{
+    struct Attribute
+    {
+        uint16_t attribute;
+        uint16_t form;
+        int size; ///< see DwarfUnitFormat::formSize
+        int offset; ///< of the value relative to the first one, -1 if that depends on the content
+        int64_t implicitConst;
+    };
+
+    uint64_t code = 0;
+    uint16_t tag = 0;
+    bool hasChildren = false;
+    /** Size of all attribute values if that doesn't depend on the content, -1 otherwise. */
+    int fixedSize = 0;
+    QVector<Attribute> attributes;
+};
+
+/** Decoded abbreviation table of a unit, with constant time lookup by code. */
+class DwarfAbbreviationTable
+{
+public:
+    DwarfAbbreviationTable() = default;
+    /** Decodes the table starting at @p data, not reading beyond @p end. */
+    explicit DwarfAbbreviationTable(const char *data, const char *end, const DwarfUnitFormat &format);
+
+    /** Returns @c false if the table is malformed or uses forms we can't decode. */
+    bool isValid() const;
+    int size() const;
+    const DwarfAbbreviation* abbreviation(uint64_t code) const;
+
+private:
+    QVector<DwarfAbbreviation> m_abbreviations;
+    // only needed when codes aren't numbered 1 to n
+    QHash<uint64_t, int> m_codeIndex;
+    bool m_isValid = false;
+};
+
+#endif // DWARFABBREVIATIONTABLE_H
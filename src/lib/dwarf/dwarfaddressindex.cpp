@@ -0,0 +1,228 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "dwarfaddressindex.h"
+#include "dwarfcudie.h"
+#include "dwarfcupool.h"
+#include "dwarfinfo.h"
+#include "dwarfinfoscanner.h"
+#include "dwarfranges.h"
+
+#include <dwarf.h>
+#include <libdwarf.h>
+
+#include <algorithm>
+#include <cassert>
+
+static bool isIndexedTag(uint16_t tag)
+{
+    return tag == DW_TAG_subprogram || tag == DW_TAG_inlined_subroutine;
+}
+
+// fallback for units the native scanner can't handle
+static void readRangesLibdwarf(DwarfDie *die, uint64_t baseAddress, QVector<DwarfAddressRange> *ranges)
+{
+    {
+        const auto lock = die->dwarfInfo()->lockDwarfHandle();
+        Dwarf_Addr lowPC = 0, highPC = 0;
+        if (dwarf_lowpc(die->dieHandle(), &lowPC, nullptr) == DW_DLV_OK) {
+            Dwarf_Half form = 0;
+            enum Dwarf_Form_Class formClass = DW_FORM_CLASS_UNKNOWN;
+            if (dwarf_highpc_b(die->dieHandle(), &highPC, &form, &formClass, nullptr) != DW_DLV_OK)
+                return;
+            if (formClass == DW_FORM_CLASS_CONSTANT)
+                highPC += lowPC;
+            if (lowPC < highPC)
+                ranges->push_back({ lowPC, highPC });
+            return;
+        }
+    }
+
+    const auto dwarfRanges = die->attribute(DW_AT_ranges).value<DwarfRanges>();
+    for (int i = 0; i < dwarfRanges.size(); ++i) {
+        const auto range = dwarfRanges.entry(i);
+        if (range->dwr_type == DW_RANGES_ADDRESS_SELECTION)
+            baseAddress = range->dwr_addr2;
+        else if (range->dwr_type == DW_RANGES_ENTRY && range->dwr_addr1 < range->dwr_addr2)
+            ranges->push_back({ baseAddress + range->dwr_addr1, baseAddress + range->dwr_addr2 });
+    }
+}
+
+DwarfAddressIndex::DwarfAddressIndex(DwarfInfo* info) :
+    m_info(info)
+{
+    assert(info);
+
+    QVector<Interval> units;
+    QVector<Interval> dies;
+    DwarfCuPool pool(info);
+    pool.mapReduce([this](DwarfCuDie *cu) {
+        return collectIntervals(cu);
+    }, [&units, &dies](UnitIntervals &&intervals) {
+        units += intervals.units;
+        dies += intervals.dies;
+    });
+
+    m_units = flatten(units);
+    m_dies = flatten(dies);
+}
+
+DwarfAddressIndex::~DwarfAddressIndex() = default;
+
+DwarfAddressIndex::UnitIntervals DwarfAddressIndex::collectIntervals(DwarfCuDie* cu) const
+{
+    UnitIntervals result;
+    QVector<DwarfAddressRange> ranges;
+    const auto addIntervals = [&ranges](QVector<Interval> &intervals, uint64_t offset, int depth) {
+        for (const auto &range : ranges)
+            intervals.push_back({ range.begin, range.end, offset, depth });
+        ranges.clear();
+    };
+
+    const auto scanner = m_info->scanner();
+    const auto unitIndex = scanner->isValid() ? scanner->indexOfUnit(cu->offset()) : -1;
+    QVector<DwarfDieRecord> records;
+    if (unitIndex >= 0 && scanner->scanUnit(unitIndex, &records)) {
+        const auto &unit = scanner->unit(unitIndex);
+        QVector<int> depths(records.size());
+        bool complete = true;
+        for (int i = 0; i < records.size() && complete; ++i) {
+            const auto &record = records.at(i);
+            depths[i] = record.parent == DwarfDieRecord::InvalidIndex ? 0 : depths.at(record.parent) + 1;
+            if (i > 0 && !isIndexedTag(record.tag))
+                continue;
+            complete = scanner->readRanges(unit, record, &ranges);
+            addIntervals(i == 0 ? result.units : result.dies, record.offset, depths.at(i));
+        }
+        if (complete)
+            return result;
+        result = UnitIntervals();
+        ranges.clear();
+    }
+
+    Dwarf_Addr baseAddress = 0;
+    {
+        const auto lock = m_info->lockDwarfHandle();
+        dwarf_lowpc(cu->dieHandle(), &baseAddress, nullptr);
+    }
+    for (int i = 0; i < cu->dieCount(); ++i) {
+        const auto die = cu->dieAt(i);
+        if (i > 0 && !isIndexedTag(die->tag()))
+            continue;
+        int depth = 0;
+        for (auto parent = die->parentDie(); parent; parent = parent->parentDie())
+            ++depth;
+        readRangesLibdwarf(die, baseAddress, &ranges);
+        addIntervals(i == 0 ? result.units : result.dies, die->offset(), depth);
+    }
+    return result;
+}
+
+QVector<DwarfAddressIndex::Segment> DwarfAddressIndex::flatten(QVector<Interval>& intervals)
+{
+    // outer intervals first, so enclosing ranges are on the stack when their nested ones are processed
+    std::sort(intervals.begin(), intervals.end(), [](const Interval &lhs, const Interval &rhs) {
+        if (lhs.begin != rhs.begin)
+            return lhs.begin < rhs.begin;
+        if (lhs.end != rhs.end)
+            return lhs.end > rhs.end;
+        return lhs.depth < rhs.depth;
+    });
+
+    QVector<Segment> segments;
+    QVector<Interval> stack;
+    uint64_t pos = 0;
+    const auto addSegment = [&segments, &pos](uint64_t end, uint64_t offset) {
+        if (pos >= end)
+            return;
+        if (!segments.isEmpty() && segments.last().end == pos && segments.last().offset == offset)
+            segments.last().end = end;
+        else
+            segments.push_back({ pos, end, offset });
+        pos = end;
+    };
+
+    for (auto interval : intervals) {
+        while (!stack.isEmpty() && stack.last().end <= interval.begin) {
+            addSegment(stack.last().end, stack.last().offset);
+            stack.pop_back();
+        }
+        if (!stack.isEmpty()) {
+            addSegment(interval.begin, stack.last().offset);
+            // partially overlapping ranges are invalid, but don't let them break the nesting
+            interval.end = std::min(interval.end, stack.last().end);
+        }
+        pos = interval.begin;
+        stack.push_back(interval);
+    }
+    while (!stack.isEmpty()) {
+        addSegment(stack.last().end, stack.last().offset);
+        stack.pop_back();
+    }
+
+    segments.squeeze();
+    return segments;
+}
+
+const DwarfAddressIndex::Segment* DwarfAddressIndex::findSegment(const QVector<Segment>& segments, uint64_t addr)
+{
+    auto it = std::upper_bound(segments.constBegin(), segments.constEnd(), addr, [](uint64_t lhs, const Segment &rhs) {
+        return lhs < rhs.begin;
+    });
+    if (it == segments.constBegin())
+        return nullptr;
+    --it;
+    return addr < (*it).end ? &(*it) : nullptr;
+}
+
+bool DwarfAddressIndex::isEmpty() const
+{
+    return m_units.isEmpty() && m_dies.isEmpty();
+}
+
+DwarfCuDie* DwarfAddressIndex::compilationUnitForAddress(uint64_t addr) const
+{
+    const auto segment = findSegment(m_units, addr);
+    if (!segment)
+        return nullptr;
+
+    auto die = m_info->dieAtOffset(segment->offset);
+    if (!die)
+        return nullptr;
+    assert(die->isCompilationUnit());
+    return static_cast<DwarfCuDie*>(die);
+}
+
+DwarfDie* DwarfAddressIndex::dieForAddress(uint64_t addr) const
+{
+    const auto segment = findSegment(m_dies, addr);
+    if (segment)
+        return m_info->dieAtOffset(segment->offset);
+
+    // skeleton units have no children, their split unit is only indexed when actually needed
+    const auto cu = compilationUnitForAddress(addr);
+    const auto splitUnit = cu ? cu->splitUnit() : nullptr;
+    return splitUnit ? splitUnit->dwarfInfo()->addressIndex()->dieForAddress(addr) : nullptr;
+}
+
+DwarfDie* DwarfAddressIndex::subprogramForAddress(uint64_t addr) const
+{
+    auto die = dieForAddress(addr);
+    while (die && die->tag() != DW_TAG_subprogram)
+        die = die->parentDie();
+    return die;
+}
@@ -0,0 +1,84 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DWARFADDRESSINDEX_H
+#define DWARFADDRESSINDEX_H
+
+#include <QVector>
+
+#include <cstdint>
+
+class DwarfInfo;
+class DwarfCuDie;
+class DwarfDie;
+
+/** Sorted interval index over the code ranges of all compilation units, subprograms
+ *  and inlined subroutines. Nested ranges are flattened into disjoint segments mapping
+ *  to the innermost DIE, so lookups are a single binary search.
+ *  All state is populated on construction, so this is safe to use from multiple threads.
+ */
+class DwarfAddressIndex
+{
+public:
+    explicit DwarfAddressIndex(DwarfInfo *info);
+    DwarfAddressIndex(const DwarfAddressIndex&) = delete;
+    ~DwarfAddressIndex();
+
+    DwarfAddressIndex& operator=(const DwarfAddressIndex&) = delete;
+
+    /** Returns @c true if no code ranges were found at all. */
+    bool isEmpty() const;
+
+    /** Looks up the CU DIE covering @p addr. */
+    DwarfCuDie* compilationUnitForAddress(uint64_t addr) const;
+    /** Looks up the innermost subprogram or inlined subroutine DIE covering @p addr.
+     *  For skeleton units, this loads the corresponding split unit.
+     */
+    DwarfDie* dieForAddress(uint64_t addr) const;
+    /** Looks up the subprogram DIE covering @p addr, ie. the function the code at @p addr got inlined into. */
+    DwarfDie* subprogramForAddress(uint64_t addr) const;
+
+private:
+    struct Interval
+    {
+        uint64_t begin;
+        uint64_t end;
+        uint64_t offset;
+        int depth;
+    };
+    struct Segment
+    {
+        uint64_t begin;
+        uint64_t end;
+        uint64_t offset; ///< of the DIE covering this segment
+    };
+    struct UnitIntervals
+    {
+        QVector<Interval> units;
+        QVector<Interval> dies;
+    };
+
+    UnitIntervals collectIntervals(DwarfCuDie *cu) const;
+    static QVector<Segment> flatten(QVector<Interval> &intervals);
+    static const Segment* findSegment(const QVector<Segment> &segments, uint64_t addr);
+
+    DwarfInfo *m_info;
+    QVector<Segment> m_units;
+    QVector<Segment> m_dies;
+};
+
+#endif // DWARFADDRESSINDEX_H
@@ -16,6 +16,7 @@
 */
 
 #include "dwarfaddressranges.h"
+#include "dwarfaddressindex.h"
 #include "dwarfinfo.h"
 #include "dwarfcudie.h"
 
@@ -28,6 +29,7 @@ DwarfAddressRanges::DwarfAddressRanges(DwarfInfo* info) :
     m_info(info)
 {
     assert(info);
+    const auto lock = info->lockDwarfHandle();
     const auto res = dwarf_get_aranges(info->dwarfHandle(), &m_aranges, &m_arangesSize, nullptr);
     if (res != DW_DLV_OK)
         return;
@@ -50,15 +52,18 @@ DwarfCuDie* DwarfAddressRanges::compilationUnitForAddress(uint64_t addr) const
     if (!isValid())
         return nullptr;
 
-    Dwarf_Arange arange;
-    auto res = dwarf_get_arange(m_aranges, m_arangesSize, addr, &arange, nullptr);
-    if (res != DW_DLV_OK)
-        return nullptr;
-
     Dwarf_Off offset;
-    res = dwarf_get_cu_die_offset(arange, &offset, nullptr);
-    if (res != DW_DLV_OK)
-        return nullptr;
+    {
+        const auto lock = m_info->lockDwarfHandle();
+        Dwarf_Arange arange;
+        auto res = dwarf_get_arange(m_aranges, m_arangesSize, addr, &arange, nullptr);
+        if (res != DW_DLV_OK)
+            return nullptr;
+
+        res = dwarf_get_cu_die_offset(arange, &offset, nullptr);
+        if (res != DW_DLV_OK)
+            return nullptr;
+    }
 
     auto die = m_info->dieAtOffset(offset);
     if (!die)
@@ -68,32 +73,7 @@ DwarfCuDie* DwarfAddressRanges::compilationUnitForAddress(uint64_t addr) const
     return static_cast<DwarfCuDie*>(die);
 }
 
-static DwarfDie* findByLowPCRecursive(DwarfDie *die, uint64_t addr)
-{
-    const auto lowPC = die->attribute(DW_AT_low_pc).toULongLong();
-    if (lowPC == addr)
-        return die;
-
-    foreach (const auto child, die->children()) {
-        auto res = findByLowPCRecursive(child, addr);
-        if (res)
-            return res;
-    }
-
-    return nullptr;
-}
-
 DwarfDie* DwarfAddressRanges::dieForAddress(uint64_t addr) const
 {
-    const auto cu = compilationUnitForAddress(addr);
-    if (!cu)
-        return nullptr;
-
-    foreach (const auto die, cu->children()) {
-        auto res = findByLowPCRecursive(die, addr);
-        if (res)
-            return res;
-    }
-
-    return nullptr;
+    return m_info->addressIndex()->subprogramForAddress(addr);
 }
@@ -41,7 +41,9 @@ public:
 
     /** Looks up the CU DIE for the given address. */
     DwarfCuDie* compilationUnitForAddress(uint64_t addr) const;
-    /** Looks up the DIE for the given address. */
+    /** Looks up the subprogram DIE for the given address.
+     *  This uses DwarfAddressIndex, and thus also works without .debug_aranges.
+     */
     DwarfDie* dieForAddress(uint64_t addr) const;
 
 private:
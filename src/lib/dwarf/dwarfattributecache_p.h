@@ -0,0 +1,87 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DWARFATTRIBUTECACHE_P_H
+#define DWARFATTRIBUTECACHE_P_H
+
+#include <QVarLengthArray>
+
+#include <libdwarf.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class DwarfDie;
+
+/** A single decoded attribute value. */
+struct DwarfAttributeEntry
+{
+    enum Kind : uint8_t {
+        Unsigned,
+        Signed,
+        String,
+        Reference,
+        Other // present, but not decodable to any of the above
+    };
+
+    Dwarf_Half attribute;
+    Kind kind;
+    union {
+        uint64_t value;
+        const char *string;
+        DwarfDie *die;
+    };
+};
+
+/** Raw attribute values of a single DIE, decoded once. */
+class DwarfAttributeCache
+{
+public:
+    const DwarfAttributeEntry* find(Dwarf_Half attribute) const
+    {
+        for (const auto &entry : entries) {
+            if (entry.attribute == attribute)
+                return &entry;
+        }
+        return nullptr;
+    }
+
+    QVarLengthArray<DwarfAttributeEntry, 8> entries;
+    DwarfDie *inheritedFrom = nullptr;
+};
+
+/** Storage for the attribute caches of all DIEs of a unit, released together with the unit. */
+class DwarfAttributeCacheArena
+{
+public:
+    /** Stores a copy of @p cache in @p slot, unless another thread did that already.
+     *  Returns the cache @p slot points to afterwards.
+     */
+    const DwarfAttributeCache* store(std::atomic<DwarfAttributeCache*> *slot, const DwarfAttributeCache &cache);
+    /** Number of stored caches. */
+    int size() const;
+
+private:
+    enum { BlockSize = 64 };
+    std::vector<std::unique_ptr<DwarfAttributeCache[]>> m_blocks;
+    int m_size = 0;
+    mutable std::mutex m_mutex;
+};
+
+#endif // DWARFATTRIBUTECACHE_P_H
@@ -16,19 +16,32 @@
 */
 
 #include "dwarfcudie.h"
+#include "dwarfattributecache_p.h"
+#include "dwarfinfo.h"
 #include "dwarfline.h"
 
 #include <libdwarf.h>
 
 #include <QFileInfo>
 
-DwarfCuDie::DwarfCuDie(Dwarf_Die die, DwarfInfo* info) : DwarfDie(die, info)
-{
+#include <algorithm>
 
+DwarfCuDie::DwarfCuDie(Dwarf_Die die, DwarfInfo* info) :
+    m_info(info),
+    m_attributeCaches(new DwarfAttributeCacheArena)
+{
+    m_cu = this;
+    m_die = die;
+    Dwarf_Off offset = 0;
+    dwarf_dieoffset(die, &offset, nullptr);
+    m_unitRecord.offset = offset;
+    dwarf_tag(die, &m_unitRecord.tag, nullptr);
 }
 
 DwarfCuDie::~DwarfCuDie()
 {
+    delete[] m_dies;
+
     for (int i = 0; i < m_srcFileCount; ++i) {
         dwarf_dealloc(dwarfHandle(), m_srcFiles[i], DW_DLA_STRING);
     }
@@ -42,13 +55,141 @@ DwarfCuDie::~DwarfCuDie()
     dwarf_dealloc(dwarfHandle(), m_die, DW_DLA_DIE);
 }
 
-const char* DwarfCuDie::sourceFileForIndex(int sourceIndex) const
+int DwarfCuDie::dieCount() const
 {
-    if (!m_srcFiles) {
-        auto res = dwarf_srcfiles(m_die, &m_srcFiles, &m_srcFileCount, nullptr);
+    loadDies();
+    return m_records.size();
+}
+
+DwarfDie* DwarfCuDie::dieAt(uint32_t index) const
+{
+    loadDies();
+    Q_ASSERT(index < (uint32_t)m_records.size());
+    if (index == 0)
+        return const_cast<DwarfCuDie*>(this);
+    return m_dies + index - 1;
+}
+
+DwarfDie* DwarfCuDie::dieForOffset(Dwarf_Off offset) const
+{
+    // don't load the DIE table for offsets that can't be ours anyway
+    if (!containsOffset(offset))
+        return nullptr;
+    loadDies();
+    // the DIE table is in .debug_info order
+    const auto it = std::lower_bound(m_records.constBegin(), m_records.constEnd(), offset, [](const DwarfDieRecord &lhs, Dwarf_Off rhs) {
+        return lhs.offset < rhs;
+    });
+    if (it == m_records.constEnd() || (*it).offset != offset)
+        return nullptr;
+    return dieAt(std::distance(m_records.constBegin(), it));
+}
+
+bool DwarfCuDie::containsOffset(Dwarf_Off offset) const
+{
+    if (offset < m_unitRecord.offset)
+        return false;
+
+    const auto scanner = m_info->scanner();
+    if (scanner->isValid()) {
+        const auto unitIndex = scanner->indexOfUnit(m_unitRecord.offset);
+        if (unitIndex >= 0)
+            return offset < scanner->unit(unitIndex).endOffset;
+    }
+
+    loadDies();
+    return offset <= m_records.last().offset;
+}
+
+int DwarfCuDie::attributeCacheCount() const
+{
+    return m_attributeCaches->size();
+}
+
+DwarfCuDie* DwarfCuDie::splitUnit() const
+{
+    std::call_once(m_splitUnitFlag, [this]() {
+        m_splitUnit = m_info->loadSplitUnit(this);
+    });
+    return m_splitUnit;
+}
+
+void DwarfCuDie::loadDies() const
+{
+    std::call_once(m_diesFlag, [this]() {
+        QVector<Dwarf_Die> handles;
+        const auto scanner = m_info->scanner();
+        const auto unitIndex = scanner->isValid() ? scanner->indexOfUnit(m_unitRecord.offset) : -1;
+        if (unitIndex >= 0 && scanner->scanUnit(unitIndex, &m_records) && m_records.first().offset == m_unitRecord.offset) {
+            m_unitIndex = unitIndex;
+        } else {
+            // fall back to libdwarf for everything we can't decode natively
+            m_records.clear();
+            m_records.push_back(m_unitRecord);
+            handles.push_back(m_die);
+            const auto lock = m_info->lockDwarfHandle();
+            scanChildren(m_die, 0, handles);
+        }
+
+        m_dies = new DwarfDie[m_records.size() - 1];
+        for (int i = 1; i < m_records.size(); ++i) {
+            auto &die = m_dies[i - 1];
+            die.m_cu = this;
+            die.m_index = i;
+            if (!handles.isEmpty())
+                die.m_die = handles.at(i);
+        }
+    });
+}
+
+void DwarfCuDie::scanChildren(Dwarf_Die die, uint32_t parentIndex, QVector<Dwarf_Die> &handles) const
+{
+    Dwarf_Die childDie;
+    auto res = dwarf_child(die, &childDie, nullptr);
+    if (res != DW_DLV_OK)
+        return;
+
+    const auto handle = dwarfHandle();
+    uint32_t previousIndex = DwarfDieRecord::InvalidIndex;
+    forever {
+        DwarfDieRecord record;
+        Dwarf_Off offset = 0;
+        dwarf_dieoffset(childDie, &offset, nullptr);
+        record.offset = offset;
+        dwarf_tag(childDie, &record.tag, nullptr);
+        record.parent = parentIndex;
+
+        const uint32_t index = m_records.size();
+        if (previousIndex == DwarfDieRecord::InvalidIndex)
+            m_records[parentIndex].firstChild = index;
+        else
+            m_records[previousIndex].sibling = index;
+        m_records.push_back(record);
+        handles.push_back(childDie);
+        previousIndex = index;
+
+        scanChildren(childDie, index, handles);
+
+        Dwarf_Die siblingDie;
+        res = dwarf_siblingof_b(handle, childDie, true, &siblingDie, nullptr);
         if (res != DW_DLV_OK)
-            return nullptr;
+            return;
+        childDie = siblingDie;
     }
+}
+
+const char* DwarfCuDie::sourceFileForIndex(int sourceIndex) const
+{
+    std::call_once(m_srcFilesFlag, [this]() {
+        const auto lock = dwarfInfo()->lockDwarfHandle();
+        auto res = dwarf_srcfiles(m_die, &m_srcFiles, &m_srcFileCount, nullptr);
+        if (res != DW_DLV_OK) {
+            m_srcFiles = nullptr;
+            m_srcFileCount = 0;
+        }
+    });
+    if (!m_srcFiles)
+        return nullptr;
 
     Q_ASSERT(sourceIndex >= 0);
     Q_ASSERT(sourceIndex < m_srcFileCount);
@@ -57,36 +198,102 @@ const char* DwarfCuDie::sourceFileForIndex(int sourceIndex) const
 
 void DwarfCuDie::loadLines() const
 {
-    if (m_lines)
-        return;
+    std::call_once(m_linesFlag, [this]() {
+        const auto lock = dwarfInfo()->lockDwarfHandle();
+        if (dwarf_srclines(m_die, &m_lines, &m_lineCount, nullptr) != DW_DLV_OK) {
+            m_lines = nullptr;
+            m_lineCount = 0;
+            return;
+        }
+
+        m_lineRows.resize(m_lineCount);
+        for (int i = 0; i < m_lineCount; ++i) {
+            auto &row = m_lineRows[i];
+            row.handle = m_lines[i];
+            Dwarf_Unsigned u = 0;
+            Dwarf_Signed s = 0;
+            Dwarf_Bool b = false;
+            dwarf_lineaddr(row.handle, &row.address, nullptr);
+            if (dwarf_lineno(row.handle, &u, nullptr) == DW_DLV_OK)
+                row.line = u;
+            if (dwarf_line_srcfileno(row.handle, &u, nullptr) == DW_DLV_OK)
+                row.fileIndex = u;
+            if (dwarf_lineoff(row.handle, &s, nullptr) == DW_DLV_OK)
+                row.column = s;
+            if (dwarf_linebeginstatement(row.handle, &b, nullptr) == DW_DLV_OK)
+                row.isStatement = b;
+            if (dwarf_lineendsequence(row.handle, &b, nullptr) == DW_DLV_OK)
+                row.isEndSequence = b;
+        }
 
-    dwarf_srclines(m_die, &m_lines, &m_lineCount, nullptr);
+        // sequences are in arbitrary order, rows within a sequence are ascending already
+        // an end of sequence marker sorts before a row starting another sequence at the same address
+        std::stable_sort(m_lineRows.begin(), m_lineRows.end(), [](const DwarfLineRow &lhs, const DwarfLineRow &rhs) {
+            if (lhs.address == rhs.address)
+                return lhs.isEndSequence && !rhs.isEndSequence;
+            return lhs.address < rhs.address;
+        });
+    });
 }
 
 DwarfLine DwarfCuDie::lineForAddress(Dwarf_Addr addr) const
 {
     loadLines();
-    // ### is this sorted in any way?
-    for (int i = 0; i < m_lineCount; ++i) {
-        DwarfLine line(m_lines[i]);
-        if (line.address() == addr)
-            return line;
-    }
+    // the last row starting at or before addr, if several start there the last one wins
+    const auto it = std::upper_bound(m_lineRows.constBegin(), m_lineRows.constEnd(), addr, [](Dwarf_Addr lhs, const DwarfLineRow &rhs) {
+        return lhs < rhs.address;
+    });
+    if (it == m_lineRows.constBegin() || (*(it - 1)).isEndSequence)
+        return {};
+    return DwarfLine(&(*(it - 1)));
+}
+
+QVector<DwarfLine> DwarfCuDie::linesForAddresses(const QVector<Dwarf_Addr>& addresses) const
+{
+    loadLines();
+    QVector<DwarfLine> lines;
+    lines.reserve(addresses.size());
 
-    return {};
+    auto it = m_lineRows.constBegin();
+    for (const auto addr : addresses) {
+        Q_ASSERT(lines.isEmpty() || addresses.at(lines.size() - 1) <= addr);
+        while (it != m_lineRows.constEnd() && (*it).address <= addr)
+            ++it;
+        if (it == m_lineRows.constBegin() || (*(it - 1)).isEndSequence)
+            lines.push_back({});
+        else
+            lines.push_back(DwarfLine(&(*(it - 1))));
+    }
+    return lines;
 }
 
 QString DwarfCuDie::sourceFileForLine(DwarfLine line) const
 {
-    char* srcFile = nullptr;
-    auto res = dwarf_linesrc(line.handle(), &srcFile, nullptr);
-    if (res != DW_DLV_OK)
+    if (line.isNull())
         return {};
-    auto fileName = QString::fromUtf8(srcFile);
-    dwarf_dealloc(dwarfHandle(), srcFile, DW_DLA_STRING);
+    {
+        std::lock_guard<std::mutex> guard(m_lineFileNamesMutex);
+        const auto it = m_lineFileNames.constFind(line.fileIndex());
+        if (it != m_lineFileNames.constEnd())
+            return it.value();
+    }
+
+    QString fileName;
+    {
+        const auto lock = dwarfInfo()->lockDwarfHandle();
+        char* srcFile = nullptr;
+        auto res = dwarf_linesrc(line.handle(), &srcFile, nullptr);
+        if (res != DW_DLV_OK)
+            return {};
+        fileName = QString::fromUtf8(srcFile);
+        dwarf_dealloc(dwarfHandle(), srcFile, DW_DLA_STRING);
+    }
 
     QFileInfo fi(fileName);
     if (fi.exists())
-        return fi.canonicalFilePath();
+        fileName = fi.canonicalFilePath();
+
+    std::lock_guard<std::mutex> guard(m_lineFileNamesMutex);
+    m_lineFileNames.insert(line.fileIndex(), fileName);
     return fileName;
 }
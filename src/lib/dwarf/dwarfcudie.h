@@ -19,18 +19,48 @@
 #define DWARFCUDIE_H
 
 #include "dwarfdie.h"
+#include "dwarfinfoscanner.h"
+#include "dwarfline.h"
 
+#include <QHash>
+
+#include <memory>
+#include <mutex>
+
+class DwarfAttributeCacheArena;
 class DwarfInfo;
-class DwarfLine;
 
 class DwarfCuDie : public DwarfDie
 {
 public:
     ~DwarfCuDie();
 
+    /** The line table row covering @p addr, null if @p addr isn't covered by the line table of this unit. */
     DwarfLine lineForAddress(Dwarf_Addr addr) const;
+    /** Batch version of lineForAddress(), for ascending @p addresses.
+     *  The addresses are merged against the line table in a single pass.
+     */
+    QVector<DwarfLine> linesForAddresses(const QVector<Dwarf_Addr> &addresses) const;
+    /** Source file of @p line, cached per line table file entry. */
     QString sourceFileForLine(DwarfLine line) const;
 
+    /** Number of DIEs in this unit, including the unit DIE itself. */
+    int dieCount() const;
+    /** DIE at position @p index of the DIE table, the unit DIE itself is at index 0. */
+    DwarfDie* dieAt(uint32_t index) const;
+    /** DIE starting exactly at @p offset, @c nullptr if there is none in this unit. */
+    DwarfDie* dieForOffset(Dwarf_Off offset) const;
+    /** Checks whether @p offset lies within this unit, without loading the DIE table if possible. */
+    bool containsOffset(Dwarf_Off offset) const;
+
+    /** For skeleton units of split DWARF, the unit with the actual content from the .dwo file or .dwp package.
+     *  That is only loaded on first use. @c nullptr for other units, or if the split unit can't be found.
+     */
+    DwarfCuDie* splitUnit() const;
+
+    /** Number of DIEs of this unit with decoded attribute caches, for memory diagnostics. */
+    int attributeCacheCount() const;
+
 protected:
     friend class DwarfDie;
     friend class DwarfInfoPrivate;
@@ -40,13 +70,35 @@ protected:
 
 private:
     void loadLines() const;
+    void loadDies() const;
+    void scanChildren(Dwarf_Die die, uint32_t parentIndex, QVector<Dwarf_Die> &handles) const;
 
 private:
+    DwarfInfo *m_info = nullptr;
+    // available without loading the DIE table
+    DwarfDieRecord m_unitRecord;
+
+    mutable QVector<DwarfDieRecord> m_records;
+    mutable DwarfDie *m_dies = nullptr; // handles for m_records[1..n]
+    mutable int m_unitIndex = -1; // in DwarfInfoScanner, if m_records was decoded natively
+    mutable std::once_flag m_diesFlag;
+    // only used for DIEs whose attributes can't be located natively
+    std::unique_ptr<DwarfAttributeCacheArena> m_attributeCaches;
+
+    mutable DwarfCuDie *m_splitUnit = nullptr;
+    mutable std::once_flag m_splitUnitFlag;
+
     mutable char** m_srcFiles = nullptr;
     mutable Dwarf_Signed m_srcFileCount = 0;
+    mutable std::once_flag m_srcFilesFlag;
 
     mutable Dwarf_Line* m_lines = nullptr;
     mutable Dwarf_Signed m_lineCount = 0;
+    mutable QVector<DwarfLineRow> m_lineRows; // sorted by address
+    // resolved file names by line table file index, resolving involves file system access
+    mutable QHash<uint32_t, QString> m_lineFileNames;
+    mutable std::mutex m_lineFileNamesMutex;
+    mutable std::once_flag m_linesFlag;
 };
 
 #endif // DWARFCUDIE_H
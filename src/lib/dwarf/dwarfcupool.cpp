@@ -0,0 +1,97 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "dwarfcupool.h"
+#include "dwarfinfo.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+DwarfCuPool::DwarfCuPool(DwarfInfo* info) :
+    m_threadCount(std::max<int>(1, std::thread::hardware_concurrency()))
+{
+    if (info)
+        m_cus = info->compilationUnits();
+}
+
+DwarfCuPool::~DwarfCuPool() = default;
+
+int DwarfCuPool::threadCount() const
+{
+    return m_threadCount;
+}
+
+void DwarfCuPool::setThreadCount(int threadCount)
+{
+    m_threadCount = std::max(1, threadCount);
+}
+
+const QVector<DwarfCuDie*>& DwarfCuPool::compilationUnits() const
+{
+    return m_cus;
+}
+
+void DwarfCuPool::run(const std::function<void(int)>& map, const std::function<void(int)>& reduce) const
+{
+    const int count = m_cus.size();
+    const int threadCount = std::min(m_threadCount, count);
+    if (threadCount <= 1) {
+        for (int i = 0; i < count; ++i) {
+            map(i);
+            reduce(i);
+        }
+        return;
+    }
+
+    // workers pick the next unit dynamically, as unit sizes vary a lot
+    std::atomic<int> nextIndex(0);
+    std::vector<bool> done(count, false);
+    std::mutex mutex;
+    std::condition_variable doneCondition;
+    const auto worker = [&]() {
+        forever {
+            const int index = nextIndex++;
+            if (index >= count)
+                return;
+            map(index);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                done[index] = true;
+            }
+            doneCondition.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (int i = 0; i < threadCount; ++i)
+        threads.emplace_back(worker);
+
+    for (int i = 0; i < count; ++i) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            doneCondition.wait(lock, [&done, i]() { return done[i]; });
+        }
+        reduce(i);
+    }
+
+    for (auto &thread : threads)
+        thread.join();
+}
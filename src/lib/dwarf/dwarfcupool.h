@@ -0,0 +1,74 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DWARFCUPOOL_H
+#define DWARFCUPOOL_H
+
+#include <QVector>
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class DwarfInfo;
+class DwarfCuDie;
+
+/** Processes all compilation units of a DwarfInfo on multiple threads.
+ *  Work is split into a map step per compilation unit, which runs on worker threads
+ *  and must only use the thread-safe DWARF API, and a reduce step, which runs on the
+ *  calling thread in compilation unit order. Results therefore don't depend on scheduling.
+ */
+class DwarfCuPool
+{
+public:
+    explicit DwarfCuPool(DwarfInfo *info);
+    DwarfCuPool(const DwarfCuPool&) = delete;
+    ~DwarfCuPool();
+
+    DwarfCuPool& operator=(const DwarfCuPool&) = delete;
+
+    /** Number of worker threads, defaults to the number of cores. */
+    int threadCount() const;
+    void setThreadCount(int threadCount);
+
+    const QVector<DwarfCuDie*>& compilationUnits() const;
+
+    /** Calls @p map for every compilation unit, and @p reduce with the result of that,
+     *  in compilation unit order. Reducing starts as soon as the first results are available.
+     */
+    template <typename Map, typename Reduce>
+    void mapReduce(Map map, Reduce reduce) const
+    {
+        typedef typename std::decay<decltype(map(std::declval<DwarfCuDie*>()))>::type Result;
+        std::vector<Result> results(m_cus.size());
+        run([this, &map, &results](int index) {
+            results[index] = map(m_cus.at(index));
+        }, [&reduce, &results](int index) {
+            reduce(std::move(results[index]));
+            results[index] = Result();
+        });
+    }
+
+private:
+    void run(const std::function<void(int)> &map, const std::function<void(int)> &reduce) const;
+
+    QVector<DwarfCuDie*> m_cus;
+    int m_threadCount;
+};
+
+#endif // DWARFCUPOOL_H
@@ -16,14 +16,17 @@
 */
 
 #include "dwarfdie.h"
+#include "dwarfattributecache_p.h"
 #include "dwarfcudie.h"
 #include "dwarfinfo.h"
+#include "dwarfinfoscanner.h"
 #include "dwarfexpression.h"
 #include "dwarfranges.h"
 #include "dwarftypes.h"
 
 #include <QFileInfo>
 #include <QString>
+#include <QVarLengthArray>
 
 #include <dwarf.h>
 #include <libdwarf.h>
@@ -31,68 +34,98 @@
 #include <cassert>
 #include <type_traits>
 
-DwarfDie::DwarfDie(Dwarf_Die die, DwarfDie* parent) :
-    m_die(die)
+const DwarfAttributeCache* DwarfAttributeCacheArena::store(std::atomic<DwarfAttributeCache*> *slot, const DwarfAttributeCache &cache)
 {
-    m_parent.parent = parent;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (const auto existing = slot->load(std::memory_order_acquire))
+        return existing;
+
+    if (m_size % BlockSize == 0)
+        m_blocks.emplace_back(new DwarfAttributeCache[BlockSize]);
+    auto stored = &m_blocks.back()[m_size++ % BlockSize];
+    *stored = cache;
+    slot->store(stored, std::memory_order_release);
+    return stored;
+}
+
+int DwarfAttributeCacheArena::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_size;
+}
+
+int DwarfDieRange::size() const
+{
+    return std::distance(begin(), end());
 }
 
-DwarfDie::DwarfDie(Dwarf_Die die, DwarfInfo* info) :
-    m_die(die)
+DwarfDie* DwarfDieRange::at(int index) const
 {
-    m_parent.info = info;
+    auto it = begin();
+    std::advance(it, index);
+    Q_ASSERT(it != end());
+    return *it;
 }
 
+int DwarfDieRange::indexOf(const DwarfDie* die) const
+{
+    int index = 0;
+    for (auto child : *this) {
+        if (child == die)
+            return index;
+        ++index;
+    }
+    return -1;
+}
+
+QVector<DwarfDie*> DwarfDieRange::toVector() const
+{
+    QVector<DwarfDie*> dies;
+    std::copy(begin(), end(), std::back_inserter(dies));
+    return dies;
+}
+
+
 DwarfDie::~DwarfDie()
 {
-    qDeleteAll(m_children);
+    // attribute caches are owned by the unit, the unit's own handle is released by DwarfCuDie
+    if (m_die && !isCompilationUnit())
+        dwarf_dealloc(dwarfHandle(), m_die, DW_DLA_DIE);
 }
 
 DwarfInfo* DwarfDie::dwarfInfo() const
 {
-    if (isCompilationUnit())
-        return m_parent.info;
-    Q_ASSERT(m_parent.parent);
-    return m_parent.parent->dwarfInfo();
+    return m_cu->m_info;
 }
 
 DwarfDie* DwarfDie::parentDie() const
 {
     if (isCompilationUnit())
         return nullptr;
-    return m_parent.parent;
+    return m_cu->dieAt(record().parent);
 }
 
 bool DwarfDie::isCompilationUnit() const
 {
-    const auto tagType = tag();
-    return tagType == DW_TAG_compile_unit || tagType == DW_TAG_partial_unit || tagType == DW_TAG_type_unit;
+    return m_index == 0;
 }
 
-QByteArray DwarfDie::name() const
+const DwarfDieRecord& DwarfDie::record() const
 {
-    Q_ASSERT(m_die);
+    if (isCompilationUnit())
+        return m_cu->m_unitRecord;
+    // handles for other DIEs only exist once the table is loaded
+    return m_cu->m_records.at(m_index);
+}
 
-    char* dwarfStr;
-    const auto res = dwarf_diename(m_die, &dwarfStr, nullptr);
-    if (res != DW_DLV_OK) {
-        const auto ref = inheritedFrom();
-        if (ref)
-            return ref->name();
-        return {};
-    }
-    const QByteArray s(dwarfStr);
-    dwarf_dealloc(dwarfHandle(), dwarfStr, DW_DLA_STRING);
-    return s;
+QByteArray DwarfDie::name() const
+{
+    return QByteArray(attributeString(DW_AT_name));
 }
 
 Dwarf_Half DwarfDie::tag() const
 {
-    Dwarf_Half tagType;
-    const auto res = dwarf_tag(m_die, &tagType, nullptr);
-    if (res != DW_DLV_OK)
-        return {};
-    return tagType;
+    return record().tag;
 }
 
 QByteArray DwarfDie::tagName() const
@@ -106,10 +139,7 @@ QByteArray DwarfDie::tagName() const
 
 Dwarf_Off DwarfDie::offset() const
 {
-    Dwarf_Off offset;
-    const auto res = dwarf_dieoffset(m_die, &offset, nullptr);
-    assert(res == DW_DLV_OK);
-    return offset;
+    return record().offset;
 }
 
 static QVector<int> arrayDimensions(const DwarfDie *die)
@@ -118,11 +148,10 @@ static QVector<int> arrayDimensions(const DwarfDie *die)
     foreach (const auto child, die->children()) {
         if (child->tag() != DW_TAG_subrange_type)
             continue;
-        const auto attr = child->attribute(DW_AT_upper_bound);
-        if (attr.isNull())
+        if (!child->hasAttribute(DW_AT_upper_bound))
             dims.push_back(0);
         // DW_AT_upper_bound is the highest allowed index, not the size
-        dims.push_back(attr.toInt() + 1);
+        dims.push_back(static_cast<int>(child->attributeSigned(DW_AT_upper_bound)) + 1);
     }
     return dims;
 }
@@ -144,7 +173,7 @@ QByteArray DwarfDie::typeName() const
     if (!n.isEmpty())
         return n;
 
-    const auto typeDie = attribute(DW_AT_type).value<DwarfDie*>();
+    const auto typeDie = attributeDie(DW_AT_type);
     QByteArray typeName;
     if (!typeDie) {
         switch (tag()) {
@@ -203,7 +232,7 @@ QByteArray DwarfDie::typeName() const
             return typeName + " (*)(" + argumentList(this).join(", ") + ')';
         case DW_TAG_ptr_to_member_type:
         {
-            const auto classDie = attribute(DW_AT_containing_type).value<DwarfDie*>();
+            const auto classDie = attributeDie(DW_AT_containing_type);
             QByteArray className;
             if (classDie)
                 className = classDie->typeName();
@@ -221,7 +250,7 @@ int DwarfDie::typeSize() const
         case DW_TAG_enumeration_type:
         case DW_TAG_structure_type:
         case DW_TAG_union_type:
-            return attribute(DW_AT_byte_size).toInt();
+            return attributeUnsigned(DW_AT_byte_size);
         case DW_TAG_pointer_type:
         case DW_TAG_reference_type:
         case DW_TAG_rvalue_reference_type:
@@ -231,13 +260,13 @@ int DwarfDie::typeSize() const
         case DW_TAG_typedef:
         case DW_TAG_volatile_type:
         {
-            const auto typeDie = attribute(DW_AT_type).value<DwarfDie*>();
+            const auto typeDie = attributeDie(DW_AT_type);
             assert(typeDie);
             return typeDie->typeSize();
         }
         case DW_TAG_array_type:
         {
-            const auto typeDie = attribute(DW_AT_type).value<DwarfDie*>();
+            const auto typeDie = attributeDie(DW_AT_type);
             assert(typeDie);
             int s = typeDie->typeSize();
             foreach (auto d, arrayDimensions(this))
@@ -261,7 +290,7 @@ int DwarfDie::typeAlignment() const
         case DW_TAG_typedef:
         case DW_TAG_volatile_type:
         {
-            const auto typeDie = attribute(DW_AT_type).value<DwarfDie*>();
+            const auto typeDie = attributeDie(DW_AT_type);
             assert(typeDie);
             return typeDie->typeAlignment();
         }
@@ -279,7 +308,7 @@ int DwarfDie::typeAlignment() const
                     continue;
                 if (child->isStaticMember())
                     continue;
-                const auto typeDie = child->attribute(DW_AT_type).value<DwarfDie*>();
+                const auto typeDie = child->attributeDie(DW_AT_type);
                 assert(typeDie);
                 align = std::max(align, typeDie->typeAlignment());
             }
@@ -293,13 +322,10 @@ int DwarfDie::typeAlignment() const
 bool DwarfDie::isStaticMember() const
 {
     // TODO not entirely sure yet this is correct...
-    const auto memberLocationAttr = attribute(DW_AT_data_member_location);
-    if (!memberLocationAttr.isNull())
+    if (hasAttribute(DW_AT_data_member_location))
         return false;
 
-    const auto externalAttr = attribute(DW_AT_external).toBool();
-    const auto declAttr = attribute(DW_AT_declaration).toBool();
-    return externalAttr || declAttr;
+    return attributeFlag(DW_AT_external) || attributeFlag(DW_AT_declaration);
 }
 
 QString DwarfDie::displayName() const
@@ -368,23 +394,26 @@ static void stringifyEnum(QVariant &value, int (*get_name)(unsigned int, const c
 
 QVector< Dwarf_Half > DwarfDie::attributes() const
 {
-    Dwarf_Attribute* attrList;
-    Dwarf_Signed attrCount;
-    auto res = dwarf_attrlist(m_die, &attrList, &attrCount, nullptr);
-    if (res != DW_DLV_OK)
-        return {};
-
     QVector<Dwarf_Half> attrs;
-    attrs.reserve(attrCount);
-    for (int i = 0; i < attrCount; ++i) {
-        Dwarf_Half attrType;
-        res = dwarf_whatattr(attrList[i], &attrType, nullptr);
+    {
+        const auto lock = dwarfInfo()->lockDwarfHandle();
+        Dwarf_Attribute* attrList;
+        Dwarf_Signed attrCount;
+        auto res = dwarf_attrlist(dieHandle(), &attrList, &attrCount, nullptr);
         if (res != DW_DLV_OK)
-            continue;
-        attrs.push_back(attrType);
-    }
+            return {};
 
-    dwarf_dealloc(dwarfHandle(), attrList, DW_DLA_LIST);
+        attrs.reserve(attrCount);
+        for (int i = 0; i < attrCount; ++i) {
+            Dwarf_Half attrType;
+            res = dwarf_whatattr(attrList[i], &attrType, nullptr);
+            if (res != DW_DLV_OK)
+                continue;
+            attrs.push_back(attrType);
+        }
+
+        dwarf_dealloc(dwarfHandle(), attrList, DW_DLA_LIST);
+    }
 
     if (const auto die = inheritedFrom()) {
         auto inheritedAttrs = die->attributes();
@@ -431,98 +460,112 @@ QVariant DwarfDie::attribute(Dwarf_Half attributeType) const
 
 QVariant DwarfDie::attributeLocal(Dwarf_Half attributeType) const
 {
-    Dwarf_Attribute attr;
-    auto res = dwarf_attr(m_die, attributeType, &attr, nullptr);
-    if (res != DW_DLV_OK)
-        return {};
-
-    Dwarf_Half formType;
-    res = dwarf_whatform(attr, &formType, nullptr);
-    if (res != DW_DLV_OK)
-        return {};
-
     QVariant value;
-    switch (formType) {
-        case DW_FORM_data1:
-        case DW_FORM_data2:
-        case DW_FORM_data4:
-        case DW_FORM_data8:
-        case DW_FORM_udata:
-        {
-            static_assert( std::is_convertible<Dwarf_Unsigned, qulonglong>::value, "Incompatible DWARFs" );
-            Dwarf_Unsigned n;
-            res = dwarf_formudata(attr, &n, nullptr);
-            value = static_cast<qulonglong>(n);
-            break;
-        }
-        case DW_FORM_sdata:
-        {
-            static_assert( std::is_convertible<Dwarf_Signed, qlonglong>::value, "Incompatible DWARFs" );
-            Dwarf_Signed n;
-            res = dwarf_formsdata(attr, &n, nullptr);
-            value = static_cast<qlonglong>(n);
-            break;
-        }
-        case DW_FORM_string:
-        case DW_FORM_strp:
-        {
-            char *str;
-            res = dwarf_formstring(attr, &str, nullptr);
-            value = QByteArray(str);
-            break;
-        }
-        case DW_FORM_flag:
-        case DW_FORM_flag_present:
-        {
-            Dwarf_Bool b;
-            res = dwarf_formflag(attr, &b, nullptr);
-            value = b ? true : false;
-            break;
-        }
-        case DW_FORM_ref1:
-        case DW_FORM_ref2:
-        case DW_FORM_ref4:
-        case DW_FORM_ref8:
-        {
-            Dwarf_Off offset;
-            res = dwarf_global_formref(attr, &offset, nullptr);
-            value = QVariant::fromValue(dwarfInfo()->dieAtOffset(offset));
-            break;
-        }
-        case DW_FORM_sec_offset:
-        {
-            static_assert( std::is_convertible<Dwarf_Off, qulonglong>::value, "Incompatible DWARFs" );
-            Dwarf_Off offset;
-            res = dwarf_global_formref(attr, &offset, nullptr);
-            value = static_cast<qulonglong>(offset);
-            break;
-        }
-        case DW_FORM_addr:
-        {
-            static_assert( std::is_convertible<Dwarf_Addr, qulonglong>::value, "Incompatible DWARFs" );
-            Dwarf_Addr addr;
-            res = dwarf_formaddr(attr, &addr, nullptr);
-            value = static_cast<qulonglong>(addr);
-            break;
-        }
-        case DW_FORM_exprloc:
-        {
-            Dwarf_Unsigned len;
-            Dwarf_Ptr block;
-            res = dwarf_formexprloc(attr, &len, &block, nullptr);
-            value = QVariant::fromValue(DwarfExpression(block, len, dwarfInfo()->elfFile()->addressSize()));
-            break;
-        }
-        default:
-        {
-            const char* formName;
-            res = dwarf_get_FORM_name(formType, &formName);
-            if (res != DW_DLV_OK)
-                return {};
-            value = QLatin1String("TODO: ") + QString::fromLocal8Bit(formName);
-            break;
+    // resolving references might need to scan children, so that has to happen outside of the libdwarf lock
+    Dwarf_Off refOffset = 0;
+    bool isRef = false;
+    {
+        const auto lock = dwarfInfo()->lockDwarfHandle();
+        Dwarf_Attribute attr;
+        auto res = dwarf_attr(dieHandle(), attributeType, &attr, nullptr);
+        if (res != DW_DLV_OK)
+            return {};
+
+        Dwarf_Half formType;
+        res = dwarf_whatform(attr, &formType, nullptr);
+        if (res != DW_DLV_OK)
+            return {};
+
+        switch (formType) {
+            case DW_FORM_data1:
+            case DW_FORM_data2:
+            case DW_FORM_data4:
+            case DW_FORM_data8:
+            case DW_FORM_udata:
+            {
+                static_assert( std::is_convertible<Dwarf_Unsigned, qulonglong>::value, "Incompatible DWARFs" );
+                Dwarf_Unsigned n;
+                res = dwarf_formudata(attr, &n, nullptr);
+                value = static_cast<qulonglong>(n);
+                break;
+            }
+            case DW_FORM_sdata:
+            {
+                static_assert( std::is_convertible<Dwarf_Signed, qlonglong>::value, "Incompatible DWARFs" );
+                Dwarf_Signed n;
+                res = dwarf_formsdata(attr, &n, nullptr);
+                value = static_cast<qlonglong>(n);
+                break;
+            }
+            case DW_FORM_string:
+            case DW_FORM_strp:
+            case DW_FORM_line_strp:
+            case DW_FORM_strx:
+            case DW_FORM_strx1:
+            case DW_FORM_strx2:
+            case DW_FORM_strx3:
+            case DW_FORM_strx4:
+            case DW_FORM_GNU_str_index:
+            {
+                char *str;
+                res = dwarf_formstring(attr, &str, nullptr);
+                value = QByteArray(str);
+                break;
+            }
+            case DW_FORM_flag:
+            case DW_FORM_flag_present:
+            {
+                Dwarf_Bool b;
+                res = dwarf_formflag(attr, &b, nullptr);
+                value = b ? true : false;
+                break;
+            }
+            case DW_FORM_ref1:
+            case DW_FORM_ref2:
+            case DW_FORM_ref4:
+            case DW_FORM_ref8:
+            {
+                res = dwarf_global_formref(attr, &refOffset, nullptr);
+                isRef = res == DW_DLV_OK;
+                break;
+            }
+            case DW_FORM_sec_offset:
+            {
+                static_assert( std::is_convertible<Dwarf_Off, qulonglong>::value, "Incompatible DWARFs" );
+                Dwarf_Off offset;
+                res = dwarf_global_formref(attr, &offset, nullptr);
+                value = static_cast<qulonglong>(offset);
+                break;
+            }
+            case DW_FORM_addr:
+            {
+                static_assert( std::is_convertible<Dwarf_Addr, qulonglong>::value, "Incompatible DWARFs" );
+                Dwarf_Addr addr;
+                res = dwarf_formaddr(attr, &addr, nullptr);
+                value = static_cast<qulonglong>(addr);
+                break;
+            }
+            case DW_FORM_exprloc:
+            {
+                Dwarf_Unsigned len;
+                Dwarf_Ptr block;
+                res = dwarf_formexprloc(attr, &len, &block, nullptr);
+                value = QVariant::fromValue(DwarfExpression(block, len, dwarfInfo()->elfFile()->addressSize()));
+                break;
+            }
+            default:
+            {
+                const char* formName;
+                res = dwarf_get_FORM_name(formType, &formName);
+                if (res != DW_DLV_OK)
+                    return {};
+                value = QLatin1String("TODO: ") + QString::fromLocal8Bit(formName);
+                break;
+            }
         }
     }
+    if (isRef)
+        value = QVariant::fromValue(dieAtOffset(refOffset));
 
     // post-process some well-known types
     switch (attributeType) {
@@ -574,56 +617,293 @@ QVariant DwarfDie::attributeLocal(Dwarf_Half attributeType) const
     return value;
 }
 
-QVector< DwarfDie* > DwarfDie::children() const
+// decodes a natively located attribute value, references are returned as .debug_info offset in @p refOffset
+static void decodeValue(const DwarfInfoScanner *scanner, const DwarfInfoScanner::Unit &unit, const DwarfFormValue &value, DwarfAttributeEntry *entry, uint64_t *refOffset)
 {
-    if (!m_childrenScanned)
-        scanChildren();
-    return m_children;
+    uint64_t n = 0;
+    if (scanner->readReference(unit, value, refOffset)) {
+        entry->kind = DwarfAttributeEntry::Reference;
+        entry->die = nullptr;
+    } else if (const auto str = scanner->readString(unit, value)) {
+        entry->kind = DwarfAttributeEntry::String;
+        entry->string = str;
+    } else if (scanner->readUnsigned(unit, value, &n)) {
+        entry->kind = (value.form == DW_FORM_sdata || value.form == DW_FORM_implicit_const) ? DwarfAttributeEntry::Signed : DwarfAttributeEntry::Unsigned;
+        entry->value = n;
+    } else {
+        entry->kind = DwarfAttributeEntry::Other;
+        entry->value = 0;
+    }
 }
 
-DwarfDie* DwarfDie::dieAtOffset(Dwarf_Off offset) const
+static bool findAttribute(const DwarfDie *die, Dwarf_Half attributeType, DwarfAttributeEntry *entry)
 {
-    const auto cus = children();
-    auto it = std::lower_bound(cus.begin(), cus.end(), offset, [](DwarfDie* lhs, Dwarf_Off rhs) { return lhs->offset() < rhs; });
+    if (die->localAttribute(attributeType, entry))
+        return true;
 
-    if (it != cus.end() && (*it)->offset() == offset)
-        return *it;
+    switch (attributeType) {
+        case DW_AT_sibling:
+        case DW_AT_declaration:
+            return false; // never inherit these
+    }
+    const auto inheritedFrom = die->inheritedFrom();
+    return inheritedFrom && findAttribute(inheritedFrom, attributeType, entry);
+}
 
-    Q_ASSERT(it != cus.begin());
-    --it;
-    return (*it)->dieAtOffset(offset);
+bool DwarfDie::hasAttribute(Dwarf_Half attributeType) const
+{
+    DwarfAttributeEntry entry;
+    return findAttribute(this, attributeType, &entry);
 }
 
-DwarfDie* DwarfDie::inheritedFrom() const
+uint64_t DwarfDie::attributeUnsigned(Dwarf_Half attributeType, uint64_t defaultValue) const
+{
+    DwarfAttributeEntry entry;
+    if (!findAttribute(this, attributeType, &entry) || (entry.kind != DwarfAttributeEntry::Unsigned && entry.kind != DwarfAttributeEntry::Signed))
+        return defaultValue;
+    return entry.value;
+}
+
+int64_t DwarfDie::attributeSigned(Dwarf_Half attributeType, int64_t defaultValue) const
+{
+    DwarfAttributeEntry entry;
+    if (!findAttribute(this, attributeType, &entry) || (entry.kind != DwarfAttributeEntry::Unsigned && entry.kind != DwarfAttributeEntry::Signed))
+        return defaultValue;
+    return static_cast<int64_t>(entry.value);
+}
+
+bool DwarfDie::attributeFlag(Dwarf_Half attributeType) const
+{
+    return attributeUnsigned(attributeType) != 0;
+}
+
+const char* DwarfDie::attributeString(Dwarf_Half attributeType) const
+{
+    DwarfAttributeEntry entry;
+    if (!findAttribute(this, attributeType, &entry) || entry.kind != DwarfAttributeEntry::String)
+        return nullptr;
+    return entry.string;
+}
+
+DwarfDie* DwarfDie::attributeDie(Dwarf_Half attributeType) const
 {
-    auto ref = attributeLocal(DW_AT_abstract_origin);
-    if (ref.isNull())
-        ref = attributeLocal(DW_AT_specification);
-    if (ref.isNull())
+    DwarfAttributeEntry entry;
+    if (!findAttribute(this, attributeType, &entry) || entry.kind != DwarfAttributeEntry::Reference)
         return nullptr;
-    return ref.value<DwarfDie*>();
+    return entry.die;
 }
 
-void DwarfDie::scanChildren() const
+bool DwarfDie::isScannedNatively() const
 {
-    m_childrenScanned = true;
+    return record().abbreviation && m_cu->m_unitIndex >= 0;
+}
 
-    Dwarf_Die childDie;
-    auto res = dwarf_child(m_die, &childDie, nullptr);
-    if (res != DW_DLV_OK)
-        return;
+bool DwarfDie::localAttribute(Dwarf_Half attributeType, DwarfAttributeEntry *entry) const
+{
+    if (!isScannedNatively()) {
+        const auto cached = attributeCache()->find(attributeType);
+        if (!cached)
+            return false;
+        *entry = *cached;
+        return true;
+    }
 
-    const auto handle = dwarfHandle();
-    forever {
-        m_children.push_back(new DwarfDie(childDie, const_cast<DwarfDie*>(this)));
+    // cheap enough to decode on every access, with the value offsets from the abbreviation
+    const auto scanner = dwarfInfo()->scanner();
+    const auto &unit = scanner->unit(m_cu->m_unitIndex);
+    DwarfFormValue value;
+    if (!scanner->findAttribute(unit, record(), attributeType, &value))
+        return false;
 
-        Dwarf_Die siblingDie;
-        res = dwarf_siblingof_b(handle, childDie, true, &siblingDie, nullptr);
-        if (res != DW_DLV_OK)
-            return;
+    entry->attribute = attributeType;
+    uint64_t refOffset = 0;
+    decodeValue(scanner, unit, value, entry, &refOffset);
+    if (entry->kind == DwarfAttributeEntry::Reference)
+        entry->die = dieAtOffset(refOffset);
+    return true;
+}
+
+const DwarfAttributeCache* DwarfDie::attributeCache() const
+{
+    const auto cache = m_attributes.load(std::memory_order_acquire);
+    if (cache)
+        return cache;
+
+    // decoding is idempotent, so concurrent callers can race here, only the first result is kept
+    DwarfAttributeCache decoded;
+    decodeAttributes(&decoded);
+    return m_cu->m_attributeCaches->store(&m_attributes, decoded);
+}
+
+void DwarfDie::decodeAttributes(DwarfAttributeCache *cache) const
+{
+    // references are resolved outside of the libdwarf lock, as that might need to load other units
+    QVarLengthArray<QPair<int, Dwarf_Off>, 4> refs;
+
+    if (isScannedNatively()) {
+        const auto scanner = dwarfInfo()->scanner();
+        const auto &unit = scanner->unit(m_cu->m_unitIndex);
+        const auto &attrs = record().abbreviation->attributes;
+        const auto values = scanner->attributeValues(unit, record());
+        cache->entries.reserve(values.size());
+        for (int i = 0; i < values.size(); ++i) {
+            DwarfAttributeEntry entry;
+            entry.attribute = attrs.at(i).attribute;
+            uint64_t refOffset = 0;
+            decodeValue(scanner, unit, values.at(i), &entry, &refOffset);
+            if (entry.kind == DwarfAttributeEntry::Reference)
+                refs.push_back(qMakePair(cache->entries.size(), refOffset));
+            cache->entries.push_back(entry);
+        }
+    } else {
+        const auto lock = dwarfInfo()->lockDwarfHandle();
+        Dwarf_Attribute* attrList;
+        Dwarf_Signed attrCount;
+        if (dwarf_attrlist(dieHandle(), &attrList, &attrCount, nullptr) == DW_DLV_OK) {
+            cache->entries.reserve(attrCount);
+            for (int i = 0; i < attrCount; ++i) {
+                DwarfAttributeEntry entry;
+                Dwarf_Half formType;
+                if (dwarf_whatattr(attrList[i], &entry.attribute, nullptr) != DW_DLV_OK || dwarf_whatform(attrList[i], &formType, nullptr) != DW_DLV_OK)
+                    continue;
 
-        childDie = siblingDie;
+                entry.kind = DwarfAttributeEntry::Other;
+                entry.value = 0;
+                switch (formType) {
+                    case DW_FORM_data1:
+                    case DW_FORM_data2:
+                    case DW_FORM_data4:
+                    case DW_FORM_data8:
+                    case DW_FORM_udata:
+                    {
+                        Dwarf_Unsigned n;
+                        if (dwarf_formudata(attrList[i], &n, nullptr) == DW_DLV_OK) {
+                            entry.kind = DwarfAttributeEntry::Unsigned;
+                            entry.value = n;
+                        }
+                        break;
+                    }
+                    case DW_FORM_sdata:
+                    case DW_FORM_implicit_const:
+                    {
+                        Dwarf_Signed n;
+                        if (dwarf_formsdata(attrList[i], &n, nullptr) == DW_DLV_OK) {
+                            entry.kind = DwarfAttributeEntry::Signed;
+                            entry.value = n;
+                        }
+                        break;
+                    }
+                    case DW_FORM_flag:
+                    case DW_FORM_flag_present:
+                    {
+                        Dwarf_Bool b;
+                        if (dwarf_formflag(attrList[i], &b, nullptr) == DW_DLV_OK) {
+                            entry.kind = DwarfAttributeEntry::Unsigned;
+                            entry.value = b ? 1 : 0;
+                        }
+                        break;
+                    }
+                    case DW_FORM_addr:
+                    {
+                        Dwarf_Addr addr;
+                        if (dwarf_formaddr(attrList[i], &addr, nullptr) == DW_DLV_OK) {
+                            entry.kind = DwarfAttributeEntry::Unsigned;
+                            entry.value = addr;
+                        }
+                        break;
+                    }
+                    case DW_FORM_sec_offset:
+                    {
+                        Dwarf_Off offset;
+                        if (dwarf_global_formref(attrList[i], &offset, nullptr) == DW_DLV_OK) {
+                            entry.kind = DwarfAttributeEntry::Unsigned;
+                            entry.value = offset;
+                        }
+                        break;
+                    }
+                    case DW_FORM_string:
+                    case DW_FORM_strp:
+                    case DW_FORM_line_strp:
+                    case DW_FORM_strx:
+                    case DW_FORM_strx1:
+                    case DW_FORM_strx2:
+                    case DW_FORM_strx3:
+                    case DW_FORM_strx4:
+                    case DW_FORM_GNU_str_index:
+                    {
+                        char *str;
+                        if (dwarf_formstring(attrList[i], &str, nullptr) == DW_DLV_OK) {
+                            entry.kind = DwarfAttributeEntry::String;
+                            entry.string = str;
+                        }
+                        break;
+                    }
+                    case DW_FORM_ref1:
+                    case DW_FORM_ref2:
+                    case DW_FORM_ref4:
+                    case DW_FORM_ref8:
+                    case DW_FORM_ref_udata:
+                    case DW_FORM_ref_addr:
+                    {
+                        Dwarf_Off offset;
+                        if (dwarf_global_formref(attrList[i], &offset, nullptr) == DW_DLV_OK) {
+                            entry.kind = DwarfAttributeEntry::Reference;
+                            refs.push_back(qMakePair(cache->entries.size(), offset));
+                        }
+                        break;
+                    }
+                }
+                cache->entries.push_back(entry);
+            }
+            dwarf_dealloc(dwarfHandle(), attrList, DW_DLA_LIST);
+        }
     }
+
+    for (const auto &ref : refs)
+        cache->entries[ref.first].die = dieAtOffset(ref.second);
+
+    if (const auto origin = cache->find(DW_AT_abstract_origin))
+        cache->inheritedFrom = origin->kind == DwarfAttributeEntry::Reference ? origin->die : nullptr;
+    else if (const auto spec = cache->find(DW_AT_specification))
+        cache->inheritedFrom = spec->kind == DwarfAttributeEntry::Reference ? spec->die : nullptr;
+}
+
+DwarfDieRange DwarfDie::children() const
+{
+    m_cu->loadDies();
+    const auto firstChild = m_cu->m_records.at(m_index).firstChild;
+    if (firstChild == DwarfDieRecord::InvalidIndex)
+        return {};
+    return DwarfDieRange(m_cu->dieAt(firstChild));
+}
+
+DwarfDie* DwarfDie::nextSibling() const
+{
+    if (isCompilationUnit())
+        return nullptr;
+    const auto sibling = record().sibling;
+    if (sibling == DwarfDieRecord::InvalidIndex)
+        return nullptr;
+    return m_cu->dieAt(sibling);
+}
+
+DwarfDie* DwarfDie::dieAtOffset(Dwarf_Off offset) const
+{
+    // most references are unit-local, no need to search the unit list for those
+    if (m_cu->containsOffset(offset))
+        return m_cu->dieForOffset(offset);
+    return dwarfInfo()->dieAtOffset(offset);
+}
+
+DwarfDie* DwarfDie::inheritedFrom() const
+{
+    if (!isScannedNatively())
+        return attributeCache()->inheritedFrom;
+
+    DwarfAttributeEntry entry;
+    if (localAttribute(DW_AT_abstract_origin, &entry) || localAttribute(DW_AT_specification, &entry))
+        return entry.kind == DwarfAttributeEntry::Reference ? entry.die : nullptr;
+    return nullptr;
 }
 
 Dwarf_Debug DwarfDie::dwarfHandle() const
@@ -633,13 +913,12 @@ Dwarf_Debug DwarfDie::dwarfHandle() const
 
 Dwarf_Die DwarfDie::dieHandle() const
 {
+    if (!m_die)
+        dwarf_offdie_b(dwarfHandle(), offset(), true, &m_die, nullptr);
     return m_die;
 }
 
 const DwarfCuDie* DwarfDie::compilationUnit() const
 {
-    if (isCompilationUnit())
-        return static_cast<const DwarfCuDie*>(this);
-    assert(m_parent.parent);
-    return m_parent.parent->compilationUnit();
+    return m_cu;
 }
@@ -23,10 +23,67 @@
 
 #include <libdwarf.h>
 
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+
 class DwarfInfo;
 class DwarfCuDie;
+class DwarfDie;
+class DwarfAttributeCache;
+struct DwarfAttributeEntry;
+struct DwarfDieRecord;
 class QString;
 
+/** The children of a DIE, iterated directly on the DIE table of their compilation unit. */
+class DwarfDieRange
+{
+public:
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef DwarfDie* value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef DwarfDie* const* pointer;
+        typedef DwarfDie* reference;
+
+        const_iterator() = default;
+        explicit const_iterator(DwarfDie *die) : m_die(die) {}
+
+        DwarfDie* operator*() const { return m_die; }
+        inline const_iterator& operator++();
+        const_iterator operator++(int) { auto it = *this; ++(*this); return it; }
+        bool operator==(const const_iterator &other) const { return m_die == other.m_die; }
+        bool operator!=(const const_iterator &other) const { return m_die != other.m_die; }
+
+    private:
+        DwarfDie *m_die = nullptr;
+    };
+    typedef const_iterator iterator;
+
+    DwarfDieRange() = default;
+    explicit DwarfDieRange(DwarfDie *first) : m_first(first) {}
+
+    const_iterator begin() const { return const_iterator(m_first); }
+    const_iterator end() const { return const_iterator(); }
+
+    bool isEmpty() const { return !m_first; }
+    /** Linear in the number of children. */
+    int size() const;
+    DwarfDie* first() const { return m_first; }
+    /** Linear in @p index. */
+    DwarfDie* at(int index) const;
+    int indexOf(const DwarfDie *die) const;
+    QVector<DwarfDie*> toVector() const;
+
+private:
+    DwarfDie *m_first = nullptr;
+};
+
+/** Handle for an entry in the flat DIE table of a compilation unit.
+ *  These are allocated in one block per compilation unit and owned by that.
+ */
 class DwarfDie
 {
 public:
@@ -68,7 +125,22 @@ public:
     static QByteArray attributeName(Dwarf_Half attributeType);
     QVariant attribute(Dwarf_Half attributeType) const;
 
-    QVector<DwarfDie*> children() const;
+    /** Typed access to raw attribute values, for use in analysis code.
+     *  Attributes of a DIE are decoded once, on first use. Inherited attributes are
+     *  considered the same way as in attribute(), but there is no post-processing
+     *  of well-known attributes. The default value is returned if the attribute is
+     *  missing or has an incompatible form.
+     */
+    bool hasAttribute(Dwarf_Half attributeType) const;
+    uint64_t attributeUnsigned(Dwarf_Half attributeType, uint64_t defaultValue = 0) const;
+    int64_t attributeSigned(Dwarf_Half attributeType, int64_t defaultValue = 0) const;
+    bool attributeFlag(Dwarf_Half attributeType) const;
+    const char* attributeString(Dwarf_Half attributeType) const;
+    DwarfDie* attributeDie(Dwarf_Half attributeType) const;
+
+    DwarfDieRange children() const;
+    DwarfDie* nextSibling() const;
+    /** Resolves a DIE reference, within the same unit directly, via DwarfInfo otherwise. */
     DwarfDie* dieAtOffset(Dwarf_Off offset) const;
 
     /** If this DIE is inheriting attributes from another DIE, that's returned here. */
@@ -76,29 +148,42 @@ public:
 
     // internal
     const DwarfCuDie* compilationUnit() const;
+    /** The libdwarf handle for this DIE, created on demand.
+     *  DwarfInfo::lockDwarfHandle() must be held when calling this.
+     */
     Dwarf_Die dieHandle() const;
+    /** The entry for this DIE in the DIE table of its compilation unit. */
+    const DwarfDieRecord& record() const;
+    /** Decoded attribute values of this DIE, created on demand in the arena of its unit. */
+    const DwarfAttributeCache* attributeCache() const;
+    /** Looks up @p attributeType on this DIE only, without following DW_AT_abstract_origin or DW_AT_specification.
+     *  DIEs of natively scanned units are decoded on demand, everything else via attributeCache().
+     */
+    bool localAttribute(Dwarf_Half attributeType, DwarfAttributeEntry *entry) const;
 
 protected:
-    friend class DwarfInfoPrivate;
-    DwarfDie(Dwarf_Die die, DwarfDie* parent);
-    DwarfDie(Dwarf_Die die, DwarfInfo* info);
+    friend class DwarfCuDie;
+    DwarfDie() = default;
 
     QVariant attributeLocal(Dwarf_Half attributeType) const;
-
-    void scanChildren() const;
+    void decodeAttributes(DwarfAttributeCache *cache) const;
+    /** Whether the attributes of this DIE can be located by DwarfInfoScanner. */
+    bool isScannedNatively() const;
 
     Dwarf_Debug dwarfHandle() const;
 
-    Dwarf_Die m_die = nullptr;
-    union {
-        DwarfDie *parent = nullptr;
-        DwarfInfo *info;
-    } m_parent;
-
-    mutable QVector<DwarfDie*> m_children;
-    mutable bool m_childrenScanned = false;
+    const DwarfCuDie *m_cu = nullptr;
+    mutable Dwarf_Die m_die = nullptr;
+    mutable std::atomic<DwarfAttributeCache*> m_attributes { nullptr };
+    uint32_t m_index = 0;
 };
 
+DwarfDieRange::const_iterator& DwarfDieRange::const_iterator::operator++()
+{
+    m_die = m_die->nextSibling();
+    return *this;
+}
+
 Q_DECLARE_METATYPE(DwarfDie*)
 
 #endif // DWARFDIE_H
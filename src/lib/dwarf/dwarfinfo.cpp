@@ -17,17 +17,29 @@
 
 #include "dwarfinfo.h"
 #include "dwarfcudie.h"
+#include "dwarfaddressindex.h"
 #include "dwarfaddressranges.h"
-#include "dwarfranges.h"
+#include "dwarfinfoscanner.h"
+#include "dwarfline.h"
+#include "dwarfnameindex.h"
+
+#include <demangle/demangler.h>
 
 #include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
 
 #include <dwarf.h>
 #include <libdwarf.h>
 
 #include <elf.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <type_traits>
+#include <vector>
 
 class DwarfInfoPrivate {
 public:
@@ -36,9 +48,16 @@ public:
 
     void scanCompilationUnits();
     DwarfDie *dieForMangledSymbolRecursive(const QByteArray &symbol, DwarfDie *die) const;
+    DwarfDie *dieForMangledSymbolInUnit(const QByteArray &symbol, uint64_t unitOffset) const;
+    DwarfCuDie *unitForHeaderOffset(uint64_t unitOffset) const;
+    void indexLinkageNames();
+    void indexLinkageNamesRecursive(DwarfDie *die);
+    ElfFile* splitFile(const QString &fileName);
+    DwarfCuDie* unitForDwoId(uint64_t dwoId);
 
     ElfFile *elfFile = nullptr;
     QVector<DwarfCuDie*> compilationUnits;
+    std::once_flag compilationUnitsFlag;
     Dwarf_Obj_Access_Interface objAccessIface;
     Dwarf_Obj_Access_Methods objAccessMethods;
 
@@ -46,8 +65,34 @@ public:
 
     DwarfInfo *q;
     DwarfAddressRanges *aranges = nullptr;
-
-    bool isValid;
+    std::once_flag arangesFlag;
+    std::unique_ptr<DwarfAddressIndex> addressIndex;
+    std::once_flag addressIndexFlag;
+    std::unique_ptr<DwarfInfoScanner> scanner;
+    std::once_flag scannerFlag;
+    std::unique_ptr<DwarfNameIndex> nameIndex;
+    std::once_flag nameIndexFlag;
+    // keys point into the mapped sections where possible
+    QHash<QByteArray, uint64_t> linkageNames;
+    std::once_flag linkageNamesFlag;
+
+    // split DWARF, the skeleton side owns the .dwo files and .dwp package
+    struct SplitFile
+    {
+        std::unique_ptr<ElfFile> file; // nullptr if the file can't be opened
+        std::once_flag fileFlag;
+    };
+    DwarfInfo *skeleton = nullptr;
+    std::vector<std::unique_ptr<SplitFile>> splitFiles;
+    QHash<QString, SplitFile*> splitFileIndex;
+    std::mutex splitFilesMutex;
+    // split units created individually, adopted by scanCompilationUnits
+    QHash<uint64_t, DwarfCuDie*> dwoIdUnits;
+    std::mutex dwoIdUnitsMutex;
+    bool compilationUnitsScanned = false; // guarded by the DWARF handle lock
+
+    std::mutex dwarfMutex;
+    std::atomic<bool> isValid;
 };
 
 
@@ -139,12 +184,21 @@ DwarfInfoPrivate::DwarfInfoPrivate(DwarfInfo *qq) :
 
 DwarfInfoPrivate::~DwarfInfoPrivate()
 {
+    foreach (auto unit, dwoIdUnits) {
+        if (!compilationUnits.contains(unit))
+            delete unit;
+    }
     qDeleteAll(compilationUnits);
+    // split files are tied to our handle
+    splitFiles.clear();
     dwarf_object_finish(dbg, nullptr);
 }
 
 void DwarfInfoPrivate::scanCompilationUnits()
 {
+    const auto lock = q->lockDwarfHandle();
+    compilationUnitsScanned = true;
+    std::lock_guard<std::mutex> dwoIdLock(dwoIdUnitsMutex);
     Dwarf_Unsigned nextHeader = 0;
     forever {
         auto res = dwarf_next_cu_header(dbg, nullptr, nullptr, nullptr, nullptr, &nextHeader, nullptr);
@@ -156,14 +210,28 @@ void DwarfInfoPrivate::scanCompilationUnits()
         if(res != DW_DLV_OK)
             return;
 
-        compilationUnits.push_back(new DwarfCuDie(cuDie, q));
+        // split units looked up by DWO id before are reused, DIE pointers to them are already handed out
+        Dwarf_Off offset = 0;
+        dwarf_dieoffset(cuDie, &offset, nullptr);
+        DwarfCuDie *unit = nullptr;
+        foreach (auto dwoIdUnit, dwoIdUnits) {
+            if (dwoIdUnit->offset() == offset) {
+                unit = dwoIdUnit;
+                break;
+            }
+        }
+        if (unit)
+            dwarf_dealloc(dbg, cuDie, DW_DLA_DIE);
+        else
+            unit = new DwarfCuDie(cuDie, q);
+        compilationUnits.push_back(unit);
     }
 }
 
 
 DwarfDie* DwarfInfoPrivate::dieForMangledSymbolRecursive(const QByteArray& symbol, DwarfDie *die) const
 {
-    if (die->attribute(DW_AT_linkage_name).toByteArray() == symbol)
+    if (symbol == die->attributeString(DW_AT_linkage_name))
         return die;
     foreach (auto childDie, die->children()) {
         const auto hit = dieForMangledSymbolRecursive(symbol, childDie);
@@ -173,6 +241,207 @@ DwarfDie* DwarfInfoPrivate::dieForMangledSymbolRecursive(const QByteArray& symbo
     return nullptr;
 }
 
+DwarfDie* DwarfInfoPrivate::dieForMangledSymbolInUnit(const QByteArray& symbol, uint64_t unitOffset) const
+{
+    const auto s = q->scanner();
+    const auto unitIndex = s->isValid() ? s->indexOfUnit(unitOffset) : -1;
+    QVector<DwarfDieRecord> dies;
+    if (unitIndex < 0 || !s->scanUnit(unitIndex, &dies)) {
+        // index entries refer to the unit header, not to the unit DIE following it
+        const auto cu = unitIndex >= 0 ? q->dieAtOffset(s->unit(unitIndex).dieOffset) : unitForHeaderOffset(unitOffset);
+        return cu ? dieForMangledSymbolRecursive(symbol, cu) : nullptr;
+    }
+
+    // only materialize the DIE we are looking for
+    const auto &unit = s->unit(unitIndex);
+    for (const auto &die : dies) {
+        DwarfFormValue value;
+        if (!s->findAttribute(unit, die, DW_AT_linkage_name, &value))
+            continue;
+        const auto name = s->readString(unit, value);
+        if (name ? symbol == name : symbol == q->dieAtOffset(die.offset)->attributeString(DW_AT_linkage_name))
+            return q->dieAtOffset(die.offset);
+    }
+    return nullptr;
+}
+
+DwarfCuDie* DwarfInfoPrivate::unitForHeaderOffset(uint64_t unitOffset) const
+{
+    // the unit DIE directly follows the header, so that's the first one after unitOffset
+    const auto cus = q->compilationUnits();
+    const auto it = std::upper_bound(cus.constBegin(), cus.constEnd(), unitOffset, [](uint64_t offset, DwarfCuDie *cu) {
+        return offset < cu->offset();
+    });
+    // the largest header is that of a 64bit DWARF 5 type unit
+    if (it == cus.constEnd() || (*it)->offset() - unitOffset > 40)
+        return nullptr;
+    return *it;
+}
+
+void DwarfInfoPrivate::indexLinkageNames()
+{
+    const auto s = q->scanner();
+    QVector<DwarfDieRecord> dies;
+    foreach (auto cu, q->compilationUnits()) {
+        const auto unitIndex = s->isValid() ? s->indexOfUnit(cu->offset()) : -1;
+        if (unitIndex < 0 || !s->scanUnit(unitIndex, &dies)) {
+            indexLinkageNamesRecursive(cu);
+            continue;
+        }
+
+        const auto &unit = s->unit(unitIndex);
+        for (const auto &die : dies) {
+            DwarfFormValue value;
+            if (!s->findAttribute(unit, die, DW_AT_linkage_name, &value))
+                continue;
+            const auto name = s->readString(unit, value);
+            const auto key = name ? QByteArray::fromRawData(name, strlen(name)) : QByteArray(q->dieAtOffset(die.offset)->attributeString(DW_AT_linkage_name));
+            // the first DIE wins, as with the recursive search
+            if (!key.isEmpty() && !linkageNames.contains(key))
+                linkageNames.insert(key, die.offset);
+        }
+    }
+}
+
+void DwarfInfoPrivate::indexLinkageNamesRecursive(DwarfDie* die)
+{
+    const QByteArray key(die->attributeString(DW_AT_linkage_name));
+    if (!key.isEmpty() && !linkageNames.contains(key))
+        linkageNames.insert(key, die->offset());
+    foreach (auto childDie, die->children())
+        indexLinkageNamesRecursive(childDie);
+}
+
+ElfFile* DwarfInfoPrivate::splitFile(const QString& fileName)
+{
+    SplitFile *entry = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(splitFilesMutex);
+        auto &slot = splitFileIndex[fileName];
+        if (!slot) {
+            splitFiles.emplace_back(new SplitFile);
+            slot = splitFiles.back().get();
+        }
+        entry = slot;
+    }
+
+    // opened outside of the lock, other files can be looked up meanwhile
+    std::call_once(entry->fileFlag, [this, entry, &fileName]() {
+        if (!QFileInfo::exists(fileName))
+            return;
+        std::unique_ptr<ElfFile> dwoFile(new ElfFile(fileName));
+        if (!dwoFile->open(QIODevice::ReadOnly) || !dwoFile->isValid() || !dwoFile->dwarfInfo())
+            return;
+        // not visible to anyone else yet, so this can't race with users of the split file
+        const auto splitInfo = dwoFile->dwarfInfo();
+        splitInfo->d->skeleton = q;
+        {
+            const auto dwarfLock = q->lockDwarfHandle();
+            dwarf_set_tied_dbg(splitInfo->d->dbg, dbg, nullptr);
+        }
+        entry->file = std::move(dwoFile);
+    });
+    return entry->file.get();
+}
+
+DwarfCuDie* DwarfInfoPrivate::unitForDwoId(uint64_t dwoId)
+{
+    {
+        std::lock_guard<std::mutex> lock(dwoIdUnitsMutex);
+        const auto it = dwoIdUnits.constFind(dwoId);
+        if (it != dwoIdUnits.constEnd())
+            return it.value();
+    }
+
+    // packages can contain thousands of units, so only create the one we are looking for
+    const auto s = q->scanner();
+    const auto unitIndex = s->isValid() ? s->indexOfDwoId(dwoId) : -1;
+    const auto isPackage = elfFile->indexOfSection(".debug_cu_index") >= 0;
+    if (unitIndex < 0) {
+        // the native scanner knows all DWO ids
+        if (dwoId != 0 && s->isValid())
+            return nullptr;
+        // DWARF 5 DWO ids are only available with the native scanner, a .dwo file has only one unit anyway
+        if (dwoId == 0 || !isPackage) {
+            const auto cus = q->compilationUnits();
+            return cus.size() == 1 ? cus.first() : nullptr;
+        }
+    }
+
+    const auto dwarfLock = q->lockDwarfHandle();
+    std::lock_guard<std::mutex> lock(dwoIdUnitsMutex);
+    const auto it = dwoIdUnits.constFind(dwoId);
+    if (it != dwoIdUnits.constEnd())
+        return it.value();
+
+    Dwarf_Die die = nullptr;
+    if (unitIndex >= 0) {
+        dwarf_offdie_b(dbg, s->unit(unitIndex).dieOffset, true, &die, nullptr);
+    } else {
+        // let libdwarf resolve the id via .debug_cu_index, which stores it as raw bytes
+        Dwarf_Sig8 signature;
+        static_assert(sizeof(signature.signature) == sizeof(dwoId), "Incompatible DWO id");
+        memcpy(signature.signature, &dwoId, sizeof(dwoId));
+        dwarf_die_from_hash_signature(dbg, &signature, "cu", &die, nullptr);
+    }
+    if (!die)
+        return nullptr;
+
+    DwarfCuDie *unit = nullptr;
+    if (compilationUnitsScanned) {
+        Dwarf_Off offset = 0;
+        dwarf_dieoffset(die, &offset, nullptr);
+        dwarf_dealloc(dbg, die, DW_DLA_DIE);
+        const auto cuIt = std::find_if(compilationUnits.constBegin(), compilationUnits.constEnd(), [offset](DwarfCuDie *cu) {
+            return cu->offset() == offset;
+        });
+        if (cuIt == compilationUnits.constEnd())
+            return nullptr;
+        unit = *cuIt;
+    } else {
+        unit = new DwarfCuDie(die, q);
+    }
+    dwoIdUnits.insert(dwoId, unit);
+    return unit;
+}
+
+/** The qualified name used by accelerator tables keyed by source names, ie. without return type and parameters. */
+static QByteArray sourceNameForSymbol(const QByteArray &symbol)
+{
+    if (!symbol.startsWith("_Z"))
+        return symbol;
+
+    // best effort, misses are handled by the caller
+    const auto name = Demangler::demangleFull(symbol.constData());
+    int depth = 0;
+    int begin = 0;
+    bool isOperator = false;
+    for (int i = 0; i < name.size(); ++i) {
+        switch (name.at(i)) {
+            case '<':
+                ++depth;
+                break;
+            case '>':
+                --depth;
+                break;
+            case ' ':
+                // skip the return type of template functions, but not the type of conversion operators
+                if (depth != 0 || isOperator)
+                    break;
+                if (name.left(i).endsWith("operator"))
+                    isOperator = true;
+                else
+                    begin = i + 1;
+                break;
+            case '(':
+                if (depth == 0 && !name.left(i).endsWith("operator"))
+                    return name.mid(begin, i - begin);
+                break;
+        }
+    }
+    return name.mid(begin);
+}
+
 DwarfInfo::DwarfInfo(ElfFile* elfFile) :
     d(new DwarfInfoPrivate(this))
 {
@@ -198,39 +467,125 @@ ElfFile* DwarfInfo::elfFile() const
 
 DwarfAddressRanges* DwarfInfo::addressRanges() const
 {
-    if (!d->aranges)
+    std::call_once(d->arangesFlag, [this]() {
         d->aranges = new DwarfAddressRanges(const_cast<DwarfInfo*>(this));
+    });
     return d->aranges;
 }
 
+DwarfAddressIndex* DwarfInfo::addressIndex() const
+{
+    std::call_once(d->addressIndexFlag, [this]() {
+        d->addressIndex.reset(new DwarfAddressIndex(const_cast<DwarfInfo*>(this)));
+    });
+    return d->addressIndex.get();
+}
+
+DwarfInfoScanner* DwarfInfo::scanner() const
+{
+    std::call_once(d->scannerFlag, [this]() {
+        d->scanner.reset(new DwarfInfoScanner(d->elfFile, d->skeleton ? d->skeleton->scanner() : nullptr));
+    });
+    return d->scanner.get();
+}
+
+DwarfNameIndex* DwarfInfo::nameIndex() const
+{
+    std::call_once(d->nameIndexFlag, [this]() {
+        d->nameIndex.reset(new DwarfNameIndex(d->elfFile));
+    });
+    return d->nameIndex.get();
+}
+
 Dwarf_Debug DwarfInfo::dwarfHandle() const
 {
     return d->dbg;
 }
 
+std::unique_lock<std::mutex> DwarfInfo::lockDwarfHandle() const
+{
+    // libdwarf accesses the skeleton handle from a tied split file handle
+    if (d->skeleton)
+        return d->skeleton->lockDwarfHandle();
+    return std::unique_lock<std::mutex>(d->dwarfMutex);
+}
+
 QVector< DwarfCuDie* > DwarfInfo::compilationUnits() const
 {
-    if (d->compilationUnits.isEmpty())
+    std::call_once(d->compilationUnitsFlag, [this]() {
         d->scanCompilationUnits();
+    });
     return d->compilationUnits;
 }
 
 DwarfCuDie* DwarfInfo::compilationUnitForAddress(uint64_t address) const
 {
-    auto cu = addressRanges()->compilationUnitForAddress(address);
-    if (cu)
-        return cu;
-
-    foreach (auto cu, compilationUnits()) {
-        auto ranges = cu->attribute(DW_AT_ranges).value<DwarfRanges>();
-        for (int i = 0; i < ranges.size(); ++i) {
-            auto range = ranges.entry(i);
-            if (range->dwr_type == DW_RANGES_ENTRY && range->dwr_addr1 <= address && address < range->dwr_addr2)
-                return cu;
-            // TODO DW_RANGES_ADDRESS_SELECTION
+    // .debug_aranges is cheaper to load, the index needs a full scan
+    if (addressRanges()->isValid()) {
+        if (auto cu = addressRanges()->compilationUnitForAddress(address))
+            return cu;
+    }
+    return addressIndex()->compilationUnitForAddress(address);
+}
+
+QVector<DwarfLine> DwarfInfo::linesForAddresses(const QVector<Dwarf_Addr>& addresses, QVector<DwarfCuDie*>* units) const
+{
+    if (units)
+        units->fill(nullptr, addresses.size());
+    QHash<DwarfCuDie*, QVector<int>> unitAddresses;
+    for (int i = 0; i < addresses.size(); ++i) {
+        if (auto cu = compilationUnitForAddress(addresses.at(i))) {
+            unitAddresses[cu].push_back(i);
+            if (units)
+                (*units)[i] = cu;
         }
     }
 
+    QVector<DwarfLine> lines(addresses.size());
+    QVector<Dwarf_Addr> unitAddrs;
+    for (auto it = unitAddresses.constBegin(); it != unitAddresses.constEnd(); ++it) {
+        unitAddrs.clear();
+        for (const auto i : it.value())
+            unitAddrs.push_back(addresses.at(i));
+        const auto unitLines = it.key()->linesForAddresses(unitAddrs);
+        for (int i = 0; i < unitLines.size(); ++i)
+            lines[it.value().at(i)] = unitLines.at(i);
+    }
+    return lines;
+}
+
+DwarfCuDie* DwarfInfo::loadSplitUnit(const DwarfCuDie* skeleton) const
+{
+    if (d->skeleton)
+        return nullptr;
+    auto dwoName = skeleton->attributeString(DW_AT_dwo_name);
+    if (!dwoName)
+        dwoName = skeleton->attributeString(DW_AT_GNU_dwo_name);
+    if (!dwoName)
+        return nullptr;
+
+    const auto s = scanner();
+    const auto unitIndex = s->isValid() ? s->indexOfUnit(skeleton->offset()) : -1;
+    const auto dwoId = unitIndex >= 0 ? s->unit(unitIndex).dwoId : skeleton->attributeUnsigned(DW_AT_GNU_dwo_id);
+
+    // a package next to the executable takes precedence, build directories don't necessarily survive deployment
+    QStringList fileNames;
+    fileNames.push_back(elfFile()->fileName() + QLatin1String(".dwp"));
+    const auto dwoFileName = QString::fromUtf8(dwoName);
+    const QFileInfo dwoFileInfo(dwoFileName);
+    if (dwoFileInfo.isAbsolute())
+        fileNames.push_back(dwoFileName);
+    else if (const auto compDir = skeleton->attributeString(DW_AT_comp_dir))
+        fileNames.push_back(QDir(QString::fromUtf8(compDir)).filePath(dwoFileName));
+    fileNames.push_back(QDir(QFileInfo(elfFile()->fileName()).absolutePath()).filePath(dwoFileInfo.fileName()));
+
+    foreach (const auto &fileName, fileNames) {
+        const auto file = d->splitFile(fileName);
+        if (!file)
+            continue;
+        if (const auto unit = file->dwarfInfo()->d->unitForDwoId(dwoId))
+            return unit;
+    }
     return nullptr;
 }
 
@@ -240,24 +595,48 @@ DwarfDie* DwarfInfo::dieAtOffset(Dwarf_Off offset) const
     if (cus.isEmpty())
         return nullptr;
 
-    auto it = std::lower_bound(cus.begin(), cus.end(), offset, [](DwarfDie* lhs, Dwarf_Off rhs) { return lhs->offset() < rhs; });
+    // with the unit boundaries known, we can map to the right unit directly
+    // and reject offsets in type units or outside of .debug_info without loading anything
+    const auto s = scanner();
+    const auto unitIndex = s->isValid() ? s->indexOfUnit(offset) : -1;
+    const auto unitOffset = unitIndex >= 0 ? s->unit(unitIndex).dieOffset : offset;
+    if (s->isValid() && unitIndex < 0)
+        return nullptr;
+
+    auto it = std::lower_bound(cus.begin(), cus.end(), unitOffset, [](DwarfDie* lhs, Dwarf_Off rhs) { return lhs->offset() < rhs; });
 
     if (it != cus.end() && (*it)->offset() == offset)
         return *it;
+    if (unitIndex >= 0)
+        return it != cus.end() && (*it)->offset() == unitOffset ? (*it)->dieForOffset(offset) : nullptr;
 
-    Q_ASSERT(it != cus.begin());
+    // offsets from accelerator tables aren't necessarily valid
+    if (it == cus.begin())
+        return nullptr;
     --it;
-    return (*it)->dieAtOffset(offset);
+    return (*it)->dieForOffset(offset);
 }
 
 DwarfDie* DwarfInfo::dieForMangledSymbol(const QByteArray& symbol) const
 {
-    foreach (auto die, compilationUnits()) {
-        const auto hit = d->dieForMangledSymbolRecursive(symbol, die);
-        if (hit)
-            return hit;
+    const auto index = nameIndex();
+    if (index->type() != DwarfNameIndex::NoIndex) {
+        const auto name = index->hasLinkageNames() ? symbol : sourceNameForSymbol(symbol);
+        foreach (const auto &entry, index->lookup(name)) {
+            const auto die = entry.isUnit ? d->dieForMangledSymbolInUnit(symbol, entry.offset) : dieAtOffset(entry.offset);
+            if (die && symbol == die->attributeString(DW_AT_linkage_name))
+                return die;
+        }
     }
-    return nullptr;
+
+    // accelerator tables are optional, and don't necessarily cover all units
+    std::call_once(d->linkageNamesFlag, [this]() {
+        d->indexLinkageNames();
+    });
+    const auto it = d->linkageNames.constFind(symbol);
+    if (it == d->linkageNames.constEnd())
+        return nullptr;
+    return dieAtOffset(it.value());
 }
 
 bool DwarfInfo::isValid() const
@@ -23,13 +23,20 @@
 #include <libdwarf.h>
 
 #include <memory>
+#include <mutex>
 
 class DwarfCuDie;
 class DwarfDie;
+class DwarfLine;
 class DwarfInfoPrivate;
+class DwarfInfoScanner;
+class DwarfNameIndex;
+class DwarfAddressIndex;
 class DwarfAddressRanges;
 
-/** Represents the .debug_info section. */
+/** Represents the .debug_info section.
+ *  All lazily populated caches are safe to access from multiple threads.
+ */
 class DwarfInfo
 {
 public:
@@ -44,10 +51,24 @@ public:
 
     /** The corresponding .debug_arange section. Use for address-based lookups. */
     DwarfAddressRanges* addressRanges() const;
+    /** Interval index of all code ranges, built on first use. Use for address to DIE lookups. */
+    DwarfAddressIndex* addressIndex() const;
 
+    /** Looks up the DIE with DW_AT_linkage_name @p symbol.
+     *  Uses accelerator tables if available, and an index of all linkage names built on first use otherwise.
+     */
     DwarfDie* dieForMangledSymbol(const QByteArray &symbol) const;
 
+    /** Native .debug_info decoder, for bulk access bypassing libdwarf. */
+    DwarfInfoScanner* scanner() const;
+    /** Accelerator tables for name lookups. */
+    DwarfNameIndex* nameIndex() const;
+
     Dwarf_Debug dwarfHandle() const; // TODO this shouldn't be public API
+    /** libdwarf is not thread-safe, hold this around any call using dwarfHandle().
+     *  Must not be held while calling back into our own API.
+     */
+    std::unique_lock<std::mutex> lockDwarfHandle() const; // internal
 
     QVector<DwarfCuDie*> compilationUnits() const;
     /** Returns the CU DIE for the given address.
@@ -55,11 +76,23 @@ public:
      *  available.
      */
     DwarfCuDie* compilationUnitForAddress(uint64_t address) const;
+    /** Line table rows covering each of the ascending @p addresses, null where there is none.
+     *  Addresses are grouped by compilation unit, so every line table is traversed only once.
+     *  If @p units is given, it receives the unit owning each line, for DwarfCuDie::sourceFileForLine.
+     */
+    QVector<DwarfLine> linesForAddresses(const QVector<Dwarf_Addr> &addresses, QVector<DwarfCuDie*> *units = nullptr) const;
 
     DwarfDie* dieAtOffset(Dwarf_Off offset) const;
 
     bool isValid() const;
 private:
+    friend class DwarfCuDie;
+    friend class DwarfInfoPrivate;
+    /** Looks up the split unit for @p skeleton in the corresponding .dwo file or .dwp package.
+     *  Use DwarfCuDie::splitUnit() instead, which caches the result.
+     */
+    DwarfCuDie* loadSplitUnit(const DwarfCuDie *skeleton) const;
+
     std::unique_ptr<DwarfInfoPrivate> d;
 };
 
@@ -0,0 +1,822 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "dwarfinfoscanner.h"
+#include "dwarfleb128.h"
+
+#include <elf/elffile.h>
+#include <elf/elfheader.h>
+#include <elf/elfsectionheader.h>
+
+#include <dwarf.h>
+#include <elf.h>
+
+#include <algorithm>
+#include <cstring>
+
+template <typename T>
+static inline T readValue(const char *data)
+{
+    T value;
+    memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+static uint64_t readSized(const char *data, int size)
+{
+    switch (size) {
+        case 1:
+            return readValue<uint8_t>(data);
+        case 2:
+            return readValue<uint16_t>(data);
+        case 3:
+            return readValue<uint16_t>(data) | (uint64_t(readValue<uint8_t>(data + 2)) << 16);
+        case 4:
+            return readValue<uint32_t>(data);
+        case 8:
+            return readValue<uint64_t>(data);
+    }
+    return 0;
+}
+
+static const char* skipLEB128(const char *data, const char *end)
+{
+    while (data < end && (*data & 0x80))
+        ++data;
+    return data < end ? data + 1 : nullptr;
+}
+
+// section identifiers in .dwp unit indexes
+enum {
+    SectionInfo = 1,
+    SectionAbbrev = 3,
+    SectionStrOffsets = 6,
+    SectionRngLists = 8 // DWARF 5 only, this is .debug_macro in the GNU extension
+};
+
+DwarfInfoScanner::DwarfInfoScanner(ElfFile* file, const DwarfInfoScanner *skeleton)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    const auto hostByteOrder = ELFDATA2LSB;
+#else
+    const auto hostByteOrder = ELFDATA2MSB;
+#endif
+    if (file->byteOrder() != hostByteOrder)
+        return;
+    // .dwo files are relocatable, but their addresses come from the skeleton
+    m_isRelocatable = skeleton ? skeleton->m_isRelocatable : file->header()->type() == ET_REL;
+
+    m_info = section(file, ".debug_info");
+    if (m_info.data) {
+        m_abbrev = section(file, ".debug_abbrev");
+        m_str = section(file, ".debug_str");
+        m_lineStr = section(file, ".debug_line_str");
+        m_strOffsets = section(file, ".debug_str_offsets");
+        m_addr = section(file, ".debug_addr");
+        m_ranges = section(file, ".debug_ranges");
+        m_rngLists = section(file, ".debug_rnglists");
+    } else {
+        // split DWARF, addresses and pre-standard range lists remain in the skeleton file
+        m_isSplit = true;
+        m_info = section(file, ".debug_info.dwo");
+        m_abbrev = section(file, ".debug_abbrev.dwo");
+        m_str = section(file, ".debug_str.dwo");
+        m_strOffsets = section(file, ".debug_str_offsets.dwo");
+        m_rngLists = section(file, ".debug_rnglists.dwo");
+        if (skeleton) {
+            m_addr = skeleton->m_addr;
+            m_ranges = skeleton->m_ranges;
+        }
+        readUnitIndex(section(file, ".debug_cu_index"));
+        readUnitIndex(section(file, ".debug_tu_index"));
+    }
+    if (!m_info.data || !m_abbrev.data)
+        return;
+
+    scanUnits();
+
+    for (int i = 0; i < m_units.size(); ++i) {
+        auto &unit = m_units[i];
+        if (unit.dwoId == 0 || unit.unitType == DW_UT_type || unit.unitType == DW_UT_split_type)
+            continue;
+        m_dwoIds.insert(unit.dwoId, i);
+
+        // split units inherit the address base and the base address from their skeleton
+        const auto skeletonIndex = m_isSplit && skeleton ? skeleton->indexOfDwoId(unit.dwoId) : -1;
+        if (skeletonIndex < 0)
+            continue;
+        const auto &skeletonUnit = skeleton->unit(skeletonIndex);
+        unit.addrBase = skeletonUnit.addrBase;
+        unit.hasAddrBase = skeletonUnit.hasAddrBase;
+        unit.baseAddress = skeletonUnit.baseAddress;
+        unit.rangesBase = skeletonUnit.rangesBase;
+    }
+}
+
+DwarfInfoScanner::~DwarfInfoScanner()
+{
+    qDeleteAll(m_abbreviationTables);
+}
+
+DwarfInfoScanner::Section DwarfInfoScanner::section(ElfFile* file, const char* name) const
+{
+    Section s;
+    const auto index = file->indexOfSection(name);
+    if (index < 0)
+        return s;
+    const auto header = file->sectionHeaders().at(index);
+    // compressed sections are left to libdwarf
+    if (header->type() == SHT_NOBITS || (header->flags() & SHF_COMPRESSED))
+        return s;
+    s.data = reinterpret_cast<const char*>(file->rawData() + header->sectionOffset());
+    s.size = header->size();
+    return s;
+}
+
+void DwarfInfoScanner::readUnitIndex(const Section& index)
+{
+    // .dwp packages, DWARF 5 and the GNU extension to DWARF 4 share the same layout
+    if (index.size < 16)
+        return;
+    const auto version = readValue<uint32_t>(index.data); // the DWARF 5 version is followed by 2 bytes of padding
+    const uint64_t columnCount = readValue<uint32_t>(index.data + 4);
+    const uint64_t unitCount = readValue<uint32_t>(index.data + 8);
+    const uint64_t slotCount = readValue<uint32_t>(index.data + 12);
+    if ((version != 2 && version != 5) || 16 + slotCount * 12 + columnCount * 4 + unitCount * columnCount * 8 > index.size)
+        return;
+    m_isPackage = true;
+
+    const char *columns = index.data + 16 + slotCount * 12;
+    const char *offsets = columns + columnCount * 4;
+    for (uint64_t row = 0; row < unitCount; ++row) {
+        Contribution contribution;
+        uint64_t infoOffset = 0;
+        bool hasInfo = false;
+        for (uint64_t column = 0; column < columnCount; ++column) {
+            const uint64_t offset = readValue<uint32_t>(offsets + (row * columnCount + column) * 4);
+            switch (readValue<uint32_t>(columns + column * 4)) {
+                case SectionInfo:
+                    infoOffset = offset;
+                    hasInfo = true;
+                    break;
+                case SectionAbbrev:
+                    contribution.abbreviationOffset = offset;
+                    break;
+                case SectionStrOffsets:
+                    contribution.strOffsetsOffset = offset;
+                    break;
+                case SectionRngLists:
+                    if (version == 5)
+                        contribution.rnglistsOffset = offset;
+                    break;
+            }
+        }
+        // DWARF 4 type units are indexed by their .debug_types.dwo offset, which we don't decode
+        if (hasInfo)
+            m_contributions.insert(infoOffset, contribution);
+    }
+}
+
+void DwarfInfoScanner::scanUnits()
+{
+    uint64_t offset = 0;
+    while (offset + 4 <= m_info.size) {
+        Unit unit;
+        unit.offset = offset;
+        const char *data = m_info.data + offset;
+        uint64_t length = readValue<uint32_t>(data);
+        unit.format.offsetSize = 4;
+        data += 4;
+        if (length == 0xffffffff) {
+            if (offset + 12 > m_info.size)
+                return;
+            length = readValue<uint64_t>(data);
+            unit.format.offsetSize = 8;
+            data += 8;
+        } else if (length >= 0xfffffff0) {
+            return;
+        }
+
+        const uint64_t headerEnd = data - m_info.data;
+        if (length > m_info.size - headerEnd || length < 2u + 1u + 2u * unit.format.offsetSize)
+            return;
+        unit.endOffset = headerEnd + length;
+
+        unit.format.version = readValue<uint16_t>(data);
+        data += 2;
+        if (unit.format.version < 2 || unit.format.version > 5)
+            return;
+        if (unit.format.version >= 5) {
+            unit.unitType = *data++;
+            unit.format.addressSize = *data++;
+            unit.abbreviationOffset = readSized(data, unit.format.offsetSize);
+            data += unit.format.offsetSize;
+            switch (unit.unitType) {
+                case DW_UT_compile:
+                case DW_UT_partial:
+                    break;
+                case DW_UT_skeleton:
+                case DW_UT_split_compile:
+                    unit.dwoId = readValue<uint64_t>(data);
+                    data += 8;
+                    break;
+                case DW_UT_type:
+                case DW_UT_split_type:
+                    data += 8 + unit.format.offsetSize;
+                    break;
+                default:
+                    return;
+            }
+        } else {
+            unit.unitType = DW_UT_compile;
+            unit.abbreviationOffset = readSized(data, unit.format.offsetSize);
+            data += unit.format.offsetSize;
+            unit.format.addressSize = *data++;
+        }
+        unit.dieOffset = data - m_info.data;
+        if (unit.dieOffset >= unit.endOffset)
+            return;
+
+        // units of a package have their abbreviations and strings at the offsets given by the unit index
+        Contribution contribution;
+        const auto contributionIt = m_contributions.constFind(unit.offset);
+        if (contributionIt != m_contributions.constEnd())
+            contribution = contributionIt.value();
+        unit.abbreviationOffset += contribution.abbreviationOffset;
+        if (!m_isPackage || contributionIt != m_contributions.constEnd())
+            unit.abbreviations = abbreviationTable(unit.abbreviationOffset, unit.format);
+        readUnitAttributes(unit);
+
+        // split units have no base attributes, their contributions are used right after the section headers
+        if (m_isSplit && !unit.hasStrOffsetsBase) {
+            unit.strOffsetsBase = contribution.strOffsetsOffset + (unit.format.version >= 5 ? 2 * unit.format.offsetSize : 0);
+            unit.hasStrOffsetsBase = true;
+        }
+        if (m_isSplit && !unit.hasRnglistsBase && unit.format.version >= 5) {
+            unit.rnglistsBase = contribution.rnglistsOffset + 2 * unit.format.offsetSize + 4;
+            unit.hasRnglistsBase = true;
+        }
+        m_units.push_back(unit);
+        offset = unit.endOffset;
+    }
+
+    m_isValid = true;
+}
+
+void DwarfInfoScanner::readUnitAttributes(Unit& unit) const
+{
+    if (!unit.abbreviations)
+        return;
+
+    int size = 0;
+    DwarfDieRecord die;
+    die.offset = unit.dieOffset;
+    die.abbreviation = unit.abbreviations->abbreviation(DwarfLEB128::decodeUnsigned(m_info.data + die.offset, &size));
+    if (!die.abbreviation)
+        return;
+    die.tag = die.abbreviation->tag;
+
+    DwarfFormValue value;
+    if (findAttribute(unit, die, DW_AT_str_offsets_base, &value) && readUnsigned(unit, value, &unit.strOffsetsBase))
+        unit.hasStrOffsetsBase = true;
+    if ((findAttribute(unit, die, DW_AT_addr_base, &value) || findAttribute(unit, die, DW_AT_GNU_addr_base, &value))
+        && readUnsigned(unit, value, &unit.addrBase))
+        unit.hasAddrBase = true;
+    if (findAttribute(unit, die, DW_AT_rnglists_base, &value) && readUnsigned(unit, value, &unit.rnglistsBase))
+        unit.hasRnglistsBase = true;
+    if (findAttribute(unit, die, DW_AT_GNU_ranges_base, &value))
+        readUnsigned(unit, value, &unit.rangesBase);
+    if (findAttribute(unit, die, DW_AT_low_pc, &value))
+        readUnsigned(unit, value, &unit.baseAddress);
+    if (unit.dwoId == 0 && findAttribute(unit, die, DW_AT_GNU_dwo_id, &value))
+        readUnsigned(unit, value, &unit.dwoId);
+}
+
+const DwarfAbbreviationTable* DwarfInfoScanner::abbreviationTable(uint64_t offset, const DwarfUnitFormat& format)
+{
+    if (offset >= m_abbrev.size || (format.addressSize != 4 && format.addressSize != 8))
+        return nullptr;
+
+    // only address size, offset size and DWARF 2 vs. later affect the decoded sizes
+    const uint64_t key = (offset << 8) | (format.addressSize << 4) | (format.offsetSize == 8 ? 2 : 0) | (format.version <= 2 ? 1 : 0);
+    auto it = m_abbreviationTables.constFind(key);
+    if (it != m_abbreviationTables.constEnd())
+        return it.value();
+
+    auto table = new DwarfAbbreviationTable(m_abbrev.data + offset, m_abbrev.data + m_abbrev.size, format);
+    if (!table->isValid()) {
+        delete table;
+        table = nullptr;
+    }
+    m_abbreviationTables.insert(key, table);
+    return table;
+}
+
+int DwarfInfoScanner::indexOfDwoId(uint64_t dwoId) const
+{
+    return m_dwoIds.value(dwoId, -1);
+}
+
+bool DwarfInfoScanner::isValid() const
+{
+    return m_isValid;
+}
+
+int DwarfInfoScanner::unitCount() const
+{
+    return m_units.size();
+}
+
+const DwarfInfoScanner::Unit& DwarfInfoScanner::unit(int index) const
+{
+    return m_units.at(index);
+}
+
+int DwarfInfoScanner::indexOfUnit(uint64_t offset) const
+{
+    const auto it = std::upper_bound(m_units.constBegin(), m_units.constEnd(), offset, [](uint64_t lhs, const Unit &rhs) {
+        return lhs < rhs.endOffset;
+    });
+    if (it == m_units.constEnd() || offset < (*it).offset)
+        return -1;
+    return std::distance(m_units.constBegin(), it);
+}
+
+const char* DwarfInfoScanner::skipValue(const char* data, const char* end, uint16_t form, const DwarfUnitFormat& format) const
+{
+    int size = 0;
+    switch (form) {
+        case DW_FORM_string:
+        {
+            const auto terminator = static_cast<const char*>(memchr(data, 0, end - data));
+            return terminator ? terminator + 1 : nullptr;
+        }
+        case DW_FORM_block1:
+            return data + 1 + readValue<uint8_t>(data);
+        case DW_FORM_block2:
+            return data + 2 + readValue<uint16_t>(data);
+        case DW_FORM_block4:
+            return data + 4 + readValue<uint32_t>(data);
+        case DW_FORM_block:
+        case DW_FORM_exprloc:
+        {
+            const auto length = DwarfLEB128::decodeUnsigned(data, &size);
+            if (length > uint64_t(end - data))
+                return nullptr;
+            return data + size + length;
+        }
+        case DW_FORM_indirect:
+        {
+            const auto actualForm = DwarfLEB128::decodeUnsigned(data, &size);
+            data += size;
+            size = format.formSize(actualForm);
+            if (size >= 0)
+                return data + size;
+            if (size == -2 || actualForm == DW_FORM_indirect)
+                return nullptr;
+            return skipValue(data, end, actualForm, format);
+        }
+    }
+    // all remaining variable-sized forms are LEB128 encoded
+    return skipLEB128(data, end);
+}
+
+bool DwarfInfoScanner::scanUnit(int index, QVector<DwarfDieRecord>* dies) const
+{
+    dies->clear();
+    const auto &unit = m_units.at(index);
+    if (!unit.abbreviations)
+        return false;
+
+    const char *data = m_info.data + unit.dieOffset;
+    const char *end = m_info.data + unit.endOffset;
+    dies->reserve((unit.endOffset - unit.dieOffset) / 16);
+
+    // the current parent chain, and the last DIE seen on each level of it
+    QVector<uint32_t> parents;
+    QVector<uint32_t> previous;
+    previous.push_back(DwarfDieRecord::InvalidIndex);
+
+    int size = 0;
+    while (data < end) {
+        const uint64_t offset = data - m_info.data;
+        const auto code = DwarfLEB128::decodeUnsigned(data, &size);
+        data += size;
+        if (code == 0) {
+            // end of a sibling chain, or padding at the end of the unit
+            if (!parents.isEmpty()) {
+                parents.pop_back();
+                previous.pop_back();
+            }
+            continue;
+        }
+
+        DwarfDieRecord die;
+        die.offset = offset;
+        die.abbreviation = unit.abbreviations->abbreviation(code);
+        if (!die.abbreviation)
+            return false;
+        die.tag = die.abbreviation->tag;
+
+        const uint32_t dieIndex = dies->size();
+        if (!parents.isEmpty()) {
+            die.parent = parents.last();
+            auto &parent = (*dies)[die.parent];
+            if (parent.firstChild == DwarfDieRecord::InvalidIndex)
+                parent.firstChild = dieIndex;
+        }
+        if (previous.last() != DwarfDieRecord::InvalidIndex)
+            (*dies)[previous.last()].sibling = dieIndex;
+        previous.last() = dieIndex;
+
+        if (die.abbreviation->fixedSize >= 0) {
+            data += die.abbreviation->fixedSize;
+        } else {
+            for (const auto &attr : die.abbreviation->attributes) {
+                data = attr.size >= 0 ? data + attr.size : skipValue(data, end, attr.form, unit.format);
+                if (!data || data > end)
+                    return false;
+            }
+        }
+        if (data > end)
+            return false;
+
+        dies->push_back(die);
+        if (die.abbreviation->hasChildren) {
+            parents.push_back(dieIndex);
+            previous.push_back(DwarfDieRecord::InvalidIndex);
+        }
+    }
+
+    return true;
+}
+
+bool DwarfInfoScanner::readIndirect(DwarfFormValue* value) const
+{
+    int size = 0;
+    while (value->form == DW_FORM_indirect) {
+        value->form = DwarfLEB128::decodeUnsigned(value->data, &size);
+        value->data += size;
+    }
+    return value->form != DW_FORM_implicit_const;
+}
+
+bool DwarfInfoScanner::findAttribute(const Unit& unit, const DwarfDieRecord& die, uint16_t attribute, DwarfFormValue* value) const
+{
+    if (!die.abbreviation)
+        return false;
+
+    int size = 0;
+    const char *data = m_info.data + die.offset;
+    const char *end = m_info.data + unit.endOffset;
+    DwarfLEB128::decodeUnsigned(data, &size);
+    data += size;
+    const char *values = data;
+
+    for (const auto &attr : die.abbreviation->attributes) {
+        // no need to skip over anything as long as all preceding values have a fixed size
+        if (attr.offset >= 0)
+            data = values + attr.offset;
+        if (attr.attribute == attribute) {
+            value->data = data;
+            value->form = attr.form;
+            value->implicitConst = attr.implicitConst;
+            return attr.form != DW_FORM_indirect || readIndirect(value);
+        }
+        if (attr.offset >= 0 && attr.size >= 0)
+            continue;
+        data = attr.size >= 0 ? data + attr.size : skipValue(data, end, attr.form, unit.format);
+        if (!data || data > end)
+            return false;
+    }
+    return false;
+}
+
+QVector<DwarfFormValue> DwarfInfoScanner::attributeValues(const Unit& unit, const DwarfDieRecord& die) const
+{
+    QVector<DwarfFormValue> values;
+    if (!die.abbreviation)
+        return values;
+
+    int size = 0;
+    const char *data = m_info.data + die.offset;
+    const char *end = m_info.data + unit.endOffset;
+    DwarfLEB128::decodeUnsigned(data, &size);
+    data += size;
+
+    values.reserve(die.abbreviation->attributes.size());
+    for (const auto &attr : die.abbreviation->attributes) {
+        DwarfFormValue value;
+        value.data = data;
+        value.form = attr.form;
+        value.implicitConst = attr.implicitConst;
+        if (attr.form == DW_FORM_indirect && !readIndirect(&value))
+            return values;
+        values.push_back(value);
+        data = attr.size >= 0 ? data + attr.size : skipValue(data, end, attr.form, unit.format);
+        if (!data || data > end)
+            return values;
+    }
+    return values;
+}
+
+bool DwarfInfoScanner::readUnsigned(const Unit& unit, const DwarfFormValue& value, uint64_t* result) const
+{
+    uint64_t index = 0;
+    switch (value.form) {
+        case DW_FORM_data1:
+        case DW_FORM_data2:
+        case DW_FORM_data4:
+        case DW_FORM_data8:
+        case DW_FORM_flag:
+            *result = readSized(value.data, unit.format.formSize(value.form));
+            return true;
+        case DW_FORM_sec_offset:
+            *result = readSized(value.data, unit.format.offsetSize);
+            return true;
+        case DW_FORM_addr:
+            *result = readSized(value.data, unit.format.addressSize);
+            return true;
+        case DW_FORM_udata:
+            *result = DwarfLEB128::decodeUnsigned(value.data);
+            return true;
+        case DW_FORM_sdata:
+            *result = DwarfLEB128::decodeSigned(value.data);
+            return true;
+        case DW_FORM_implicit_const:
+            *result = value.implicitConst;
+            return true;
+        case DW_FORM_flag_present:
+            *result = 1;
+            return true;
+        case DW_FORM_addrx1:
+        case DW_FORM_addrx2:
+        case DW_FORM_addrx3:
+        case DW_FORM_addrx4:
+            index = readSized(value.data, unit.format.formSize(value.form));
+            break;
+        case DW_FORM_addrx:
+        case DW_FORM_GNU_addr_index:
+            index = DwarfLEB128::decodeUnsigned(value.data);
+            break;
+        default:
+            return false;
+    }
+
+    return readIndexedAddress(unit, index, result);
+}
+
+bool DwarfInfoScanner::readIndexedAddress(const Unit& unit, uint64_t index, uint64_t* result) const
+{
+    if (!unit.hasAddrBase || !m_addr.data)
+        return false;
+    const auto addrOffset = unit.addrBase + index * unit.format.addressSize;
+    if (addrOffset + unit.format.addressSize > m_addr.size)
+        return false;
+    *result = readSized(m_addr.data + addrOffset, unit.format.addressSize);
+    return true;
+}
+
+const char* DwarfInfoScanner::readString(const Unit& unit, const DwarfFormValue& value) const
+{
+    uint64_t index = 0;
+    switch (value.form) {
+        case DW_FORM_string:
+            return value.data;
+        case DW_FORM_strp:
+        {
+            const auto offset = readSized(value.data, unit.format.offsetSize);
+            return m_str.data && offset < m_str.size ? m_str.data + offset : nullptr;
+        }
+        case DW_FORM_line_strp:
+        {
+            const auto offset = readSized(value.data, unit.format.offsetSize);
+            return m_lineStr.data && offset < m_lineStr.size ? m_lineStr.data + offset : nullptr;
+        }
+        case DW_FORM_strx1:
+        case DW_FORM_strx2:
+        case DW_FORM_strx3:
+        case DW_FORM_strx4:
+            index = readSized(value.data, unit.format.formSize(value.form));
+            break;
+        case DW_FORM_strx:
+        case DW_FORM_GNU_str_index:
+            index = DwarfLEB128::decodeUnsigned(value.data);
+            break;
+        default:
+            return nullptr;
+    }
+
+    // indexed strings, pre-standard split DWARF has no base attribute
+    if (!m_strOffsets.data || !m_str.data || (!unit.hasStrOffsetsBase && value.form != DW_FORM_GNU_str_index))
+        return nullptr;
+    const auto entryOffset = unit.strOffsetsBase + index * unit.format.offsetSize;
+    if (entryOffset + unit.format.offsetSize > m_strOffsets.size)
+        return nullptr;
+    const auto offset = readSized(m_strOffsets.data + entryOffset, unit.format.offsetSize);
+    return offset < m_str.size ? m_str.data + offset : nullptr;
+}
+
+bool DwarfInfoScanner::readReference(const Unit& unit, const DwarfFormValue& value, uint64_t* offset) const
+{
+    switch (value.form) {
+        case DW_FORM_ref1:
+        case DW_FORM_ref2:
+        case DW_FORM_ref4:
+        case DW_FORM_ref8:
+            *offset = unit.offset + readSized(value.data, unit.format.formSize(value.form));
+            return true;
+        case DW_FORM_ref_udata:
+            *offset = unit.offset + DwarfLEB128::decodeUnsigned(value.data);
+            return true;
+        case DW_FORM_ref_addr:
+            *offset = readSized(value.data, unit.format.formSize(value.form));
+            return true;
+    }
+    return false;
+}
+
+void DwarfInfoScanner::addRange(QVector<DwarfAddressRange> *ranges, uint64_t begin, uint64_t end) const
+{
+    // also drops the tombstone values linkers use for discarded code: -1 or -2 from lld and gold,
+    // and 0 from BFD ld, which is a valid address in relocatable files though
+    if (begin < end && (begin != 0 || m_isRelocatable))
+        ranges->push_back({ begin, end });
+}
+
+bool DwarfInfoScanner::readRanges(const Unit& unit, const DwarfDieRecord& die, QVector<DwarfAddressRange>* ranges) const
+{
+    DwarfFormValue value, highPCValue;
+    // a low_pc on its own is a single address (eg. a label), or the base address for DW_AT_ranges of a unit
+    if (findAttribute(unit, die, DW_AT_low_pc, &value) && findAttribute(unit, die, DW_AT_high_pc, &highPCValue)) {
+        uint64_t lowPC = 0, highPC = 0;
+        if (!readUnsigned(unit, value, &lowPC) || !readUnsigned(unit, highPCValue, &highPC))
+            return false;
+        // since DWARF 4 high_pc can also be the size of the range
+        switch (highPCValue.form) {
+            case DW_FORM_addr:
+            case DW_FORM_addrx:
+            case DW_FORM_addrx1:
+            case DW_FORM_addrx2:
+            case DW_FORM_addrx3:
+            case DW_FORM_addrx4:
+            case DW_FORM_GNU_addr_index:
+                break;
+            default:
+                highPC += lowPC;
+        }
+        addRange(ranges, lowPC, highPC);
+        return true;
+    }
+
+    if (!findAttribute(unit, die, DW_AT_ranges, &value))
+        return true;
+    uint64_t offset = 0;
+    if (value.form == DW_FORM_rnglistx) {
+        if (!unit.hasRnglistsBase || !m_rngLists.data)
+            return false;
+        const auto entryOffset = unit.rnglistsBase + DwarfLEB128::decodeUnsigned(value.data) * unit.format.offsetSize;
+        if (entryOffset + unit.format.offsetSize > m_rngLists.size)
+            return false;
+        offset = unit.rnglistsBase + readSized(m_rngLists.data + entryOffset, unit.format.offsetSize);
+        return readRngList(unit, offset, ranges);
+    }
+    if (!readUnsigned(unit, value, &offset))
+        return false;
+    if (unit.format.version >= 5)
+        return readRngList(unit, offset, ranges);
+    return readRangeList(unit, m_isSplit ? unit.rangesBase + offset : offset, ranges);
+}
+
+bool DwarfInfoScanner::readRangeList(const Unit& unit, uint64_t offset, QVector<DwarfAddressRange>* ranges) const
+{
+    if (!m_ranges.data)
+        return false;
+
+    const int size = unit.format.addressSize;
+    const uint64_t maxAddress = size == 8 ? ~0ull : 0xffffffffull;
+    uint64_t base = unit.baseAddress;
+    while (offset + 2 * size <= m_ranges.size) {
+        const auto begin = readSized(m_ranges.data + offset, size);
+        const auto end = readSized(m_ranges.data + offset + size, size);
+        offset += 2 * size;
+        if (begin == 0 && end == 0)
+            return true;
+        if (begin == maxAddress)
+            base = end; // base address selection entry
+        else
+            addRange(ranges, base + begin, base + end);
+    }
+    return false;
+}
+
+bool DwarfInfoScanner::readRngList(const Unit& unit, uint64_t offset, QVector<DwarfAddressRange>* ranges) const
+{
+    if (!m_rngLists.data || offset >= m_rngLists.size)
+        return false;
+
+    const int size = unit.format.addressSize;
+    const char *data = m_rngLists.data + offset;
+    const char *end = m_rngLists.data + m_rngLists.size;
+    uint64_t base = unit.baseAddress;
+    // all reads are bounds-checked, a truncated entry fails the entire list
+    bool ok = true;
+    const auto readULEB128 = [&data, end, &ok]() -> uint64_t {
+        const auto next = ok ? skipLEB128(data, end) : nullptr;
+        if (!next) {
+            ok = false;
+            return 0;
+        }
+        const auto value = DwarfLEB128::decodeUnsigned(data);
+        data = next;
+        return value;
+    };
+    const auto readAddress = [&data, end, size, &ok]() -> uint64_t {
+        if (!ok || end - data < size) {
+            ok = false;
+            return 0;
+        }
+        const auto value = readSized(data, size);
+        data += size;
+        return value;
+    };
+
+    while (data < end) {
+        uint64_t begin = 0, length = 0;
+        switch (*data++) {
+            case DW_RLE_end_of_list:
+                return true;
+            case DW_RLE_base_addressx:
+            {
+                const auto index = readULEB128();
+                if (!ok || !readIndexedAddress(unit, index, &base))
+                    return false;
+                break;
+            }
+            case DW_RLE_startx_endx:
+            {
+                const auto beginIndex = readULEB128();
+                const auto endIndex = readULEB128();
+                uint64_t endAddr = 0;
+                if (!ok || !readIndexedAddress(unit, beginIndex, &begin) || !readIndexedAddress(unit, endIndex, &endAddr))
+                    return false;
+                addRange(ranges, begin, endAddr);
+                break;
+            }
+            case DW_RLE_startx_length:
+            {
+                const auto index = readULEB128();
+                length = readULEB128();
+                if (!ok || !readIndexedAddress(unit, index, &begin))
+                    return false;
+                addRange(ranges, begin, begin + length);
+                break;
+            }
+            case DW_RLE_offset_pair:
+                begin = readULEB128();
+                length = readULEB128();
+                if (!ok)
+                    return false;
+                addRange(ranges, base + begin, base + length);
+                break;
+            case DW_RLE_base_address:
+                base = readAddress();
+                if (!ok)
+                    return false;
+                break;
+            case DW_RLE_start_end:
+            {
+                begin = readAddress();
+                const auto endAddr = readAddress();
+                if (!ok)
+                    return false;
+                addRange(ranges, begin, endAddr);
+                break;
+            }
+            case DW_RLE_start_length:
+                begin = readAddress();
+                length = readULEB128();
+                if (!ok)
+                    return false;
+                addRange(ranges, begin, begin + length);
+                break;
+            default:
+                return false;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,174 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DWARFINFOSCANNER_H
+#define DWARFINFOSCANNER_H
+
+#include "dwarfabbreviationtable.h"
+
+#include <QHash>
+#include <QVector>
+
+#include <cstdint>
+
+class ElfFile;
+
+/** Compact entry of a flat DIE table, in the order the DIEs appear in .debug_info. */
+struct DwarfDieRecord
+{
+    enum : uint32_t { InvalidIndex = 0xffffffff };
+
+    uint64_t offset = 0;
+    const DwarfAbbreviation *abbreviation = nullptr;
+    uint32_t parent = InvalidIndex;
+    uint32_t firstChild = InvalidIndex;
+    uint32_t sibling = InvalidIndex;
+    uint16_t tag = 0;
+};
+
+/** Location of a single attribute value inside .debug_info. */
+struct DwarfFormValue
+{
+    const char *data = nullptr;
+    int64_t implicitConst = 0;
+    uint16_t form = 0;
+};
+
+/** Half-open address range covered by a DIE. */
+struct DwarfAddressRange
+{
+    uint64_t begin = 0;
+    uint64_t end = 0;
+};
+
+/** Native decoder for .debug_info, working directly on the mapped sections.
+ *  Abbreviation tables are decoded once, and attribute values are skipped based
+ *  on their precomputed sizes. Units using forms not handled here are reported as
+ *  such, callers are expected to fall back to libdwarf for those.
+ *  Split DWARF .dwo files and .dwp packages are supported when given the scanner of the
+ *  file with the corresponding skeleton units, which provides the addresses.
+ *  All state is populated on construction, so this is safe to use from multiple threads.
+ */
+class DwarfInfoScanner
+{
+public:
+    struct Unit
+    {
+        uint64_t offset = 0; ///< of the unit header
+        uint64_t endOffset = 0; ///< one past the last byte of the unit
+        uint64_t dieOffset = 0; ///< of the unit DIE
+        uint64_t abbreviationOffset = 0;
+        uint64_t dwoId = 0;
+        uint64_t strOffsetsBase = 0;
+        uint64_t addrBase = 0;
+        uint64_t rnglistsBase = 0;
+        uint64_t rangesBase = 0; ///< DW_AT_GNU_ranges_base, for the range lists of pre-standard split units
+        uint64_t baseAddress = 0; ///< DW_AT_low_pc of the unit DIE, for range lists
+        DwarfUnitFormat format;
+        uint8_t unitType = 0;
+        bool hasStrOffsetsBase = false;
+        bool hasAddrBase = false;
+        bool hasRnglistsBase = false;
+        /** @c nullptr if the abbreviations of this unit can't be decoded natively. */
+        const DwarfAbbreviationTable *abbreviations = nullptr;
+    };
+
+    explicit DwarfInfoScanner(ElfFile *file, const DwarfInfoScanner *skeleton = nullptr);
+    DwarfInfoScanner(const DwarfInfoScanner&) = delete;
+    ~DwarfInfoScanner();
+
+    DwarfInfoScanner& operator=(const DwarfInfoScanner&) = delete;
+
+    /** Returns @c false if .debug_info can't be decoded natively at all. */
+    bool isValid() const;
+
+    int unitCount() const;
+    const Unit& unit(int index) const;
+    /** Index of the unit containing @p offset, -1 if there is none. */
+    int indexOfUnit(uint64_t offset) const;
+    /** Index of the compilation unit with DWO id @p dwoId, -1 if there is none. */
+    int indexOfDwoId(uint64_t dwoId) const;
+
+    /** Decodes all DIEs of unit @p index into @p dies, which is cleared first.
+     *  Returns @c false if that isn't possible natively.
+     */
+    bool scanUnit(int index, QVector<DwarfDieRecord> *dies) const;
+
+    /** Locates @p attribute in @p die. Returns @c false if @p die doesn't have it locally. */
+    bool findAttribute(const Unit &unit, const DwarfDieRecord &die, uint16_t attribute, DwarfFormValue *value) const;
+    /** Locates all attribute values of @p die, in the order of its abbreviation.
+     *  The result is shorter than the abbreviation if decoding stops early.
+     */
+    QVector<DwarfFormValue> attributeValues(const Unit &unit, const DwarfDieRecord &die) const;
+    /** Decodes constant, flag, address and section offset forms. */
+    bool readUnsigned(const Unit &unit, const DwarfFormValue &value, uint64_t *result) const;
+    /** Decodes string forms, returns @c nullptr for anything else. */
+    const char* readString(const Unit &unit, const DwarfFormValue &value) const;
+    /** Decodes reference forms into a .debug_info offset. */
+    bool readReference(const Unit &unit, const DwarfFormValue &value, uint64_t *offset) const;
+    /** Decodes the address ranges covered by @p die into @p ranges, from either DW_AT_low_pc/DW_AT_high_pc
+     *  or DW_AT_ranges, with base address selection applied. Empty ranges are dropped.
+     *  Returns @c false if the ranges exist but can't be decoded natively.
+     */
+    bool readRanges(const Unit &unit, const DwarfDieRecord &die, QVector<DwarfAddressRange> *ranges) const;
+
+private:
+    struct Section
+    {
+        const char *data = nullptr;
+        uint64_t size = 0;
+    };
+    /** Section offsets of a unit in a .dwp package. */
+    struct Contribution
+    {
+        uint64_t abbreviationOffset = 0;
+        uint64_t strOffsetsOffset = 0;
+        uint64_t rnglistsOffset = 0;
+    };
+    Section section(ElfFile *file, const char *name) const;
+
+    void readUnitIndex(const Section &index);
+    void scanUnits();
+    void readUnitAttributes(Unit &unit) const;
+    const DwarfAbbreviationTable* abbreviationTable(uint64_t offset, const DwarfUnitFormat &format);
+    const char* skipValue(const char *data, const char *end, uint16_t form, const DwarfUnitFormat &format) const;
+    bool readIndirect(DwarfFormValue *value) const;
+    bool readIndexedAddress(const Unit &unit, uint64_t index, uint64_t *result) const;
+    bool readRangeList(const Unit &unit, uint64_t offset, QVector<DwarfAddressRange> *ranges) const;
+    bool readRngList(const Unit &unit, uint64_t offset, QVector<DwarfAddressRange> *ranges) const;
+    void addRange(QVector<DwarfAddressRange> *ranges, uint64_t begin, uint64_t end) const;
+
+    Section m_info;
+    Section m_abbrev;
+    Section m_str;
+    Section m_lineStr;
+    Section m_strOffsets;
+    Section m_addr;
+    Section m_ranges;
+    Section m_rngLists;
+
+    QVector<Unit> m_units;
+    QHash<uint64_t, DwarfAbbreviationTable*> m_abbreviationTables;
+    QHash<uint64_t, int> m_dwoIds;
+    QHash<uint64_t, Contribution> m_contributions; // by .debug_info.dwo offset
+    bool m_isSplit = false;
+    bool m_isPackage = false;
+    bool m_isRelocatable = false;
+    bool m_isValid = false;
+};
+
+#endif // DWARFINFOSCANNER_H
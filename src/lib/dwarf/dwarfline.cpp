@@ -19,42 +19,43 @@
 
 #include <cassert>
 
-DwarfLine::DwarfLine(Dwarf_Line line) :
-    m_line(line)
+DwarfLine::DwarfLine(const DwarfLineRow *row) :
+    m_row(row)
 {
-    assert(line);
+    assert(row);
 }
 
 bool DwarfLine::isNull() const
 {
-    return m_line == nullptr;
+    return m_row == nullptr;
 }
 
 Dwarf_Unsigned DwarfLine::line() const
 {
-    Dwarf_Unsigned n = 0;
-    if (dwarf_lineno(m_line, &n, nullptr) == DW_DLV_OK)
-        return n;
-    return 0;
+    return m_row ? m_row->line : 0;
 }
 
 Dwarf_Signed DwarfLine::column() const
 {
-    Dwarf_Signed n = 0;
-    if (dwarf_lineoff(m_line, &n, nullptr) == DW_DLV_OK)
-        return n;
-    return 0;
+    return m_row ? m_row->column : 0;
 }
 
 Dwarf_Addr DwarfLine::address() const
 {
-    Dwarf_Addr addr = 0;
-    if (dwarf_lineaddr(m_line, &addr, nullptr) == DW_DLV_OK)
-        return addr;
-    return 0;
+    return m_row ? m_row->address : 0;
+}
+
+bool DwarfLine::isStatement() const
+{
+    return m_row && m_row->isStatement;
 }
 
 Dwarf_Line DwarfLine::handle() const
 {
-    return m_line;
+    return m_row ? m_row->handle : nullptr;
+}
+
+uint32_t DwarfLine::fileIndex() const
+{
+    return m_row ? m_row->fileIndex : 0;
 }
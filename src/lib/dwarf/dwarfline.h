@@ -20,8 +20,23 @@
 
 #include <libdwarf.h>
 
+#include <cstdint>
 
-/** Represents one line information entry in the .debug_lines section. */
+/** One decoded row of a line table, see DwarfCuDie. */
+struct DwarfLineRow
+{
+    Dwarf_Addr address = 0;
+    Dwarf_Line handle = nullptr;
+    uint32_t line = 0;
+    uint32_t fileIndex = 0;
+    int32_t column = 0;
+    bool isStatement = false;
+    bool isEndSequence = false;
+};
+
+/** Represents one line information entry in the .debug_lines section.
+ *  This is a lightweight handle, the data is owned by the DwarfCuDie it was obtained from.
+ */
 class DwarfLine
 {
 public:
@@ -30,20 +45,26 @@ public:
     ~DwarfLine() = default;
 
     DwarfLine& operator=(const DwarfLine &other) = default;
+    bool operator==(const DwarfLine &other) const { return m_row == other.m_row; }
+    bool operator!=(const DwarfLine &other) const { return m_row != other.m_row; }
 
     bool isNull() const;
 
     Dwarf_Unsigned line() const;
     Dwarf_Signed column() const;
+    /** Start address of the range covered by this line table row. */
     Dwarf_Addr address() const;
+    /** Recommended breakpoint location, ie. the start of a statement. */
+    bool isStatement() const;
 
 protected:
     friend class DwarfCuDie;
-    DwarfLine(Dwarf_Line line);
+    explicit DwarfLine(const DwarfLineRow *row);
     Dwarf_Line handle() const;
+    uint32_t fileIndex() const;
 
 private:
-    Dwarf_Line m_line = nullptr;
+    const DwarfLineRow *m_row = nullptr;
 };
 
 #endif // DWARFLINE_H
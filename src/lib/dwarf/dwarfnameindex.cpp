@@ -0,0 +1,461 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "dwarfnameindex.h"
+#include "dwarfabbreviationtable.h"
+#include "dwarfleb128.h"
+
+#include <elf/elffile.h>
+#include <elf/elfsectionheader.h>
+
+#include <dwarf.h>
+#include <elf.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+template <typename T>
+static inline T readValue(const char *data)
+{
+    T value;
+    memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+static uint64_t readSized(const char *data, int size)
+{
+    switch (size) {
+        case 1:
+            return readValue<uint8_t>(data);
+        case 2:
+            return readValue<uint16_t>(data);
+        case 4:
+            return readValue<uint32_t>(data);
+        case 8:
+            return readValue<uint64_t>(data);
+    }
+    return 0;
+}
+
+static const char* readULEB128(const char *data, const char *end, uint64_t *value)
+{
+    const char *it = data;
+    while (it < end && (*it & 0x80))
+        ++it;
+    if (it >= end)
+        return nullptr;
+    *value = DwarfLEB128::decodeUnsigned(data);
+    return it + 1;
+}
+
+/** Compares the zero-terminated string at @p offset in @p data to @p name, without reading beyond @p size. */
+static bool equalsString(const char *data, uint64_t size, uint64_t offset, const QByteArray &name)
+{
+    if (offset >= size || size - offset <= uint64_t(name.size()))
+        return false;
+    return memcmp(data + offset, name.constData(), name.size()) == 0 && data[offset + name.size()] == 0;
+}
+
+/** The DJB hash used by .debug_names. */
+static uint32_t debugNamesHash(const QByteArray &name)
+{
+    uint32_t hash = 5381;
+    for (const char c : name)
+        hash = hash * 33 + static_cast<uint8_t>(c);
+    return hash;
+}
+
+/** The hash used by .gdb_index since version 5, which ignores case. */
+static uint32_t gdbIndexHash(const QByteArray &name)
+{
+    uint32_t hash = 0;
+    for (const char c : name)
+        hash = hash * 67 + static_cast<uint8_t>(tolower(static_cast<uint8_t>(c))) - 113;
+    return hash;
+}
+
+DwarfNameIndex::DwarfNameIndex(ElfFile* file)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    const auto hostByteOrder = ELFDATA2LSB;
+#else
+    const auto hostByteOrder = ELFDATA2MSB;
+#endif
+    if (file->byteOrder() != hostByteOrder)
+        return;
+
+    m_str = section(file, ".debug_str");
+    if (loadDebugNames(section(file, ".debug_names")))
+        m_type = DebugNames;
+    else if (loadGdbIndex(section(file, ".gdb_index")))
+        m_type = GdbIndex;
+    else if (loadPubNames(section(file, ".debug_gnu_pubnames"), true) || loadPubNames(section(file, ".debug_pubnames"), false))
+        m_type = PubNames;
+}
+
+DwarfNameIndex::~DwarfNameIndex() = default;
+
+DwarfNameIndex::Section DwarfNameIndex::section(ElfFile* file, const char* name) const
+{
+    Section s;
+    const auto index = file->indexOfSection(name);
+    if (index < 0)
+        return s;
+    const auto header = file->sectionHeaders().at(index);
+    if (header->type() == SHT_NOBITS || (header->flags() & SHF_COMPRESSED))
+        return s;
+    s.data = reinterpret_cast<const char*>(file->rawData() + header->sectionOffset());
+    s.size = header->size();
+    return s;
+}
+
+DwarfNameIndex::Type DwarfNameIndex::type() const
+{
+    return m_type;
+}
+
+bool DwarfNameIndex::hasLinkageNames() const
+{
+    return m_type == DebugNames;
+}
+
+bool DwarfNameIndex::loadDebugNames(const Section& names)
+{
+    if (!names.data || !m_str.data)
+        return false;
+
+    // there is one name table per linked object file, or a single merged one
+    uint64_t offset = 0;
+    while (offset + 4 <= names.size) {
+        NameTable table;
+        uint64_t length = readValue<uint32_t>(names.data + offset);
+        offset += 4;
+        if (length == 0xffffffff) {
+            if (offset + 8 > names.size)
+                return false;
+            length = readValue<uint64_t>(names.data + offset);
+            offset += 8;
+            table.offsetSize = 8;
+        } else if (length >= 0xfffffff0) {
+            return false;
+        }
+        if (length > names.size - offset || length < 32)
+            return false;
+
+        const char *data = names.data + offset;
+        table.end = data + length;
+        offset += length;
+        if (readValue<uint16_t>(data) != 5)
+            return false;
+
+        table.compUnitCount = readValue<uint32_t>(data + 4);
+        const uint64_t localTypeUnitCount = readValue<uint32_t>(data + 8);
+        const uint64_t foreignTypeUnitCount = readValue<uint32_t>(data + 12);
+        table.bucketCount = readValue<uint32_t>(data + 16);
+        table.nameCount = readValue<uint32_t>(data + 20);
+        const uint64_t abbreviationTableSize = readValue<uint32_t>(data + 24);
+        const uint64_t augmentationSize = (readValue<uint32_t>(data + 28) + 3) & ~uint64_t(3);
+
+        uint64_t pos = 32 + augmentationSize;
+        const uint64_t compUnitsPos = pos;
+        pos += (table.compUnitCount + localTypeUnitCount) * table.offsetSize + foreignTypeUnitCount * 8;
+        const uint64_t bucketsPos = pos;
+        pos += uint64_t(table.bucketCount) * 4;
+        const uint64_t hashesPos = pos;
+        if (table.bucketCount)
+            pos += uint64_t(table.nameCount) * 4;
+        const uint64_t stringOffsetsPos = pos;
+        pos += uint64_t(table.nameCount) * table.offsetSize;
+        const uint64_t entryOffsetsPos = pos;
+        pos += uint64_t(table.nameCount) * table.offsetSize;
+        const uint64_t abbreviationsPos = pos;
+        pos += abbreviationTableSize;
+        if (pos > length)
+            return false;
+
+        table.compUnits = data + compUnitsPos;
+        table.buckets = data + bucketsPos;
+        table.hashes = data + hashesPos;
+        table.stringOffsets = data + stringOffsetsPos;
+        table.entryOffsets = data + entryOffsetsPos;
+        table.entryPool = data + pos;
+
+        const char *abbrevData = data + abbreviationsPos;
+        const char *abbrevEnd = table.entryPool;
+        forever {
+            uint64_t code = 0;
+            uint64_t tag = 0;
+            abbrevData = readULEB128(abbrevData, abbrevEnd, &code);
+            if (!abbrevData)
+                return false;
+            if (code == 0)
+                break;
+            abbrevData = readULEB128(abbrevData, abbrevEnd, &tag);
+            if (!abbrevData)
+                return false;
+
+            NameTableAbbreviation abbrev;
+            forever {
+                uint64_t index = 0;
+                uint64_t form = 0;
+                abbrevData = readULEB128(abbrevData, abbrevEnd, &index);
+                if (abbrevData)
+                    abbrevData = readULEB128(abbrevData, abbrevEnd, &form);
+                if (!abbrevData)
+                    return false;
+                if (index == 0 && form == 0)
+                    break;
+                abbrev.attributes.push_back({ static_cast<uint16_t>(index), static_cast<uint16_t>(form) });
+            }
+            table.abbreviations.insert(code, abbrev);
+        }
+
+        m_nameTables.push_back(table);
+    }
+
+    return !m_nameTables.isEmpty();
+}
+
+bool DwarfNameIndex::loadGdbIndex(const Section& index)
+{
+    if (!index.data || index.size < 24)
+        return false;
+
+    // older versions use a different hash function and lack symbol kinds in the CU vectors
+    const auto version = readValue<uint32_t>(index.data);
+    if (version < 7)
+        return false;
+
+    const auto compUnitsOffset = readValue<uint32_t>(index.data + 4);
+    const auto typeUnitsOffset = readValue<uint32_t>(index.data + 8);
+    const auto symbolTableOffset = readValue<uint32_t>(index.data + 16);
+    const auto constantPoolOffset = readValue<uint32_t>(index.data + 20);
+    if (compUnitsOffset > typeUnitsOffset || typeUnitsOffset > index.size || symbolTableOffset > constantPoolOffset || constantPoolOffset > index.size)
+        return false;
+
+    const auto slotCount = (constantPoolOffset - symbolTableOffset) / 8;
+    if (slotCount == 0 || (slotCount & (slotCount - 1)))
+        return false;
+
+    for (uint64_t offset = compUnitsOffset; offset + 16 <= typeUnitsOffset; offset += 16)
+        m_gdbIndexUnits.push_back(readValue<uint64_t>(index.data + offset));
+    m_gdbIndex = index;
+    return true;
+}
+
+bool DwarfNameIndex::loadPubNames(const Section& pubNames, bool isGnu)
+{
+    if (!pubNames.data)
+        return false;
+
+    uint64_t offset = 0;
+    while (offset + 4 <= pubNames.size) {
+        int offsetSize = 4;
+        uint64_t length = readValue<uint32_t>(pubNames.data + offset);
+        offset += 4;
+        if (length == 0xffffffff) {
+            if (offset + 8 > pubNames.size)
+                break;
+            length = readValue<uint64_t>(pubNames.data + offset);
+            offset += 8;
+            offsetSize = 8;
+        }
+        if (length > pubNames.size - offset)
+            break;
+
+        const uint64_t end = offset + length;
+        // header: version, unit offset, unit size
+        uint64_t pos = offset + 2 + 2 * offsetSize;
+        const auto unitOffset = readSized(pubNames.data + offset + 2, offsetSize);
+        offset = end;
+        while (pos + offsetSize <= end) {
+            const auto dieOffset = readSized(pubNames.data + pos, offsetSize);
+            pos += offsetSize;
+            if (dieOffset == 0)
+                break;
+            if (isGnu)
+                ++pos; // symbol kind flags
+            if (pos >= end)
+                break;
+            const auto size = strnlen(pubNames.data + pos, end - pos);
+            if (pos + size >= end)
+                break;
+            m_pubNames.insert(QByteArray::fromRawData(pubNames.data + pos, size), unitOffset + dieOffset);
+            pos += size + 1;
+        }
+    }
+
+    return !m_pubNames.isEmpty();
+}
+
+QVector<DwarfNameIndex::Entry> DwarfNameIndex::lookup(const QByteArray& name) const
+{
+    QVector<Entry> entries;
+    switch (m_type) {
+        case NoIndex:
+            break;
+        case DebugNames:
+            for (const auto &table : m_nameTables)
+                lookupDebugNames(table, name, entries);
+            break;
+        case GdbIndex:
+            lookupGdbIndex(name, entries);
+            break;
+        case PubNames:
+            for (auto it = m_pubNames.constFind(name); it != m_pubNames.constEnd() && it.key() == name; ++it) {
+                Entry entry;
+                entry.offset = it.value();
+                entries.push_back(entry);
+            }
+            break;
+    }
+    return entries;
+}
+
+static const char* readIndexValue(const char *data, const char *end, uint16_t form, uint8_t offsetSize, uint64_t *value)
+{
+    DwarfUnitFormat format;
+    format.version = 5;
+    format.addressSize = 8;
+    format.offsetSize = offsetSize;
+    const auto size = format.formSize(form);
+    if (size >= 0) {
+        if (size > end - data)
+            return nullptr;
+        *value = readSized(data, size);
+        return data + size;
+    }
+
+    switch (form) {
+        case DW_FORM_udata:
+        case DW_FORM_ref_udata:
+        case DW_FORM_sdata:
+            return readULEB128(data, end, value);
+    }
+    return nullptr;
+}
+
+void DwarfNameIndex::lookupDebugNames(const NameTable& table, const QByteArray& name, QVector<Entry>& entries) const
+{
+    const auto readEntries = [this, &table, &entries](uint32_t nameIndex) {
+        const auto poolOffset = readSized(table.entryOffsets + uint64_t(nameIndex) * table.offsetSize, table.offsetSize);
+        if (poolOffset >= uint64_t(table.end - table.entryPool))
+            return;
+
+        const char *data = table.entryPool + poolOffset;
+        forever {
+            uint64_t code = 0;
+            data = readULEB128(data, table.end, &code);
+            if (!data || code == 0)
+                return;
+            const auto abbrev = table.abbreviations.constFind(code);
+            if (abbrev == table.abbreviations.constEnd())
+                return;
+
+            uint64_t unitIndex = 0;
+            uint64_t dieOffset = 0;
+            bool hasDieOffset = false;
+            bool isTypeUnit = false;
+            for (const auto &attr : abbrev.value().attributes) {
+                uint64_t value = 0;
+                data = readIndexValue(data, table.end, attr.form, table.offsetSize, &value);
+                if (!data)
+                    return;
+                switch (attr.index) {
+                    case DW_IDX_compile_unit:
+                        unitIndex = value;
+                        break;
+                    case DW_IDX_type_unit:
+                        isTypeUnit = true;
+                        break;
+                    case DW_IDX_die_offset:
+                        dieOffset = value;
+                        hasDieOffset = true;
+                        break;
+                }
+            }
+
+            if (!hasDieOffset || isTypeUnit || unitIndex >= table.compUnitCount)
+                continue;
+            Entry entry;
+            entry.offset = readSized(table.compUnits + unitIndex * table.offsetSize, table.offsetSize) + dieOffset;
+            entries.push_back(entry);
+        }
+    };
+    const auto matches = [this, &table, &name](uint32_t nameIndex) {
+        const auto strOffset = readSized(table.stringOffsets + uint64_t(nameIndex) * table.offsetSize, table.offsetSize);
+        return equalsString(m_str.data, m_str.size, strOffset, name);
+    };
+
+    if (table.bucketCount == 0) {
+        for (uint32_t i = 0; i < table.nameCount; ++i) {
+            if (matches(i))
+                readEntries(i);
+        }
+        return;
+    }
+
+    // buckets hold the 1-based index of the first name with a matching hash, names in a bucket are consecutive
+    const auto hash = debugNamesHash(name);
+    const auto bucket = hash % table.bucketCount;
+    for (auto i = readValue<uint32_t>(table.buckets + bucket * 4); i > 0 && i <= table.nameCount; ++i) {
+        const auto nameHash = readValue<uint32_t>(table.hashes + (i - 1) * 4);
+        if (nameHash % table.bucketCount != bucket)
+            break;
+        if (nameHash == hash && matches(i - 1))
+            readEntries(i - 1);
+    }
+}
+
+void DwarfNameIndex::lookupGdbIndex(const QByteArray& name, QVector<Entry>& entries) const
+{
+    const auto symbolTableOffset = readValue<uint32_t>(m_gdbIndex.data + 16);
+    const auto constantPoolOffset = readValue<uint32_t>(m_gdbIndex.data + 20);
+    const uint32_t mask = (constantPoolOffset - symbolTableOffset) / 8 - 1;
+
+    const auto hash = gdbIndexHash(name);
+    const uint32_t step = ((hash * 17) & mask) | 1;
+    auto slot = hash & mask;
+    for (uint32_t probe = 0; probe <= mask; ++probe, slot = (slot + step) & mask) {
+        const char *slotData = m_gdbIndex.data + symbolTableOffset + uint64_t(slot) * 8;
+        const auto nameOffset = readValue<uint32_t>(slotData);
+        const auto vectorOffset = readValue<uint32_t>(slotData + 4);
+        if (nameOffset == 0 && vectorOffset == 0)
+            return;
+        if (!equalsString(m_gdbIndex.data, m_gdbIndex.size, uint64_t(constantPoolOffset) + nameOffset, name))
+            continue;
+
+        // CU vector: count, followed by CU indexes with symbol kind attributes in the upper bits
+        uint64_t pos = uint64_t(constantPoolOffset) + vectorOffset;
+        if (pos + 4 > m_gdbIndex.size)
+            return;
+        const auto count = readValue<uint32_t>(m_gdbIndex.data + pos);
+        pos += 4;
+        for (uint32_t i = 0; i < count && pos + 4 <= m_gdbIndex.size; ++i, pos += 4) {
+            const auto unitIndex = readValue<uint32_t>(m_gdbIndex.data + pos) & 0xffffff;
+            if (unitIndex >= uint32_t(m_gdbIndexUnits.size()))
+                continue; // type unit
+            Entry entry;
+            entry.offset = m_gdbIndexUnits.at(unitIndex);
+            entry.isUnit = true;
+            if (std::find_if(entries.constBegin(), entries.constEnd(), [&entry](const Entry &e) { return e.offset == entry.offset; }) == entries.constEnd())
+                entries.push_back(entry);
+        }
+        return;
+    }
+}
@@ -0,0 +1,111 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DWARFNAMEINDEX_H
+#define DWARFNAMEINDEX_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+
+#include <cstdint>
+
+class ElfFile;
+
+/** Name lookup based on the accelerator tables emitted by compilers or linkers.
+ *  Supports .debug_names, .gdb_index and .debug_pubnames/.debug_gnu_pubnames, in that
+ *  order of preference. All state is populated on construction, so this is safe to use
+ *  from multiple threads.
+ */
+class DwarfNameIndex
+{
+public:
+    enum Type {
+        NoIndex,
+        DebugNames,
+        GdbIndex,
+        PubNames
+    };
+
+    struct Entry
+    {
+        uint64_t offset = 0; ///< .debug_info offset of a DIE, or of a unit if isUnit is set
+        bool isUnit = false;
+    };
+
+    explicit DwarfNameIndex(ElfFile *file);
+    DwarfNameIndex(const DwarfNameIndex&) = delete;
+    ~DwarfNameIndex();
+
+    DwarfNameIndex& operator=(const DwarfNameIndex&) = delete;
+
+    Type type() const;
+    /** @c true if the index contains linkage names, otherwise names are qualified source names. */
+    bool hasLinkageNames() const;
+
+    /** Candidates for @p name, these still need to be verified by the caller. */
+    QVector<Entry> lookup(const QByteArray &name) const;
+
+private:
+    struct Section
+    {
+        const char *data = nullptr;
+        uint64_t size = 0;
+    };
+    Section section(ElfFile *file, const char *name) const;
+
+    struct NameTableAbbreviation
+    {
+        struct Attribute
+        {
+            uint16_t index;
+            uint16_t form;
+        };
+        QVector<Attribute> attributes;
+    };
+    struct NameTable
+    {
+        const char *compUnits = nullptr;
+        const char *buckets = nullptr;
+        const char *hashes = nullptr;
+        const char *stringOffsets = nullptr;
+        const char *entryOffsets = nullptr;
+        const char *entryPool = nullptr;
+        const char *end = nullptr;
+        uint32_t compUnitCount = 0;
+        uint32_t bucketCount = 0;
+        uint32_t nameCount = 0;
+        uint8_t offsetSize = 4;
+        QHash<uint64_t, NameTableAbbreviation> abbreviations;
+    };
+
+    bool loadDebugNames(const Section &names);
+    bool loadGdbIndex(const Section &index);
+    bool loadPubNames(const Section &pubNames, bool isGnu);
+
+    void lookupDebugNames(const NameTable &table, const QByteArray &name, QVector<Entry> &entries) const;
+    void lookupGdbIndex(const QByteArray &name, QVector<Entry> &entries) const;
+
+    Section m_str;
+    QVector<NameTable> m_nameTables;
+    Section m_gdbIndex;
+    QVector<uint64_t> m_gdbIndexUnits;
+    QMultiHash<QByteArray, uint64_t> m_pubNames;
+    Type m_type = NoIndex;
+};
+
+#endif // DWARFNAMEINDEX_H
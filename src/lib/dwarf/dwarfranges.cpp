@@ -27,15 +27,20 @@ DwarfRanges::DwarfRanges() : m_rangeSize(0)
 
 DwarfRanges::DwarfRanges(const DwarfDie* die, uint64_t offset)
 {
+    const auto info = die->dwarfInfo();
+    const auto lock = info->lockDwarfHandle();
+
     Dwarf_Ranges* ranges = nullptr;
-    const auto res = dwarf_get_ranges_a(die->dwarfInfo()->dwarfHandle(), offset,
+    const auto res = dwarf_get_ranges_a(info->dwarfHandle(), offset,
                                         die->dieHandle(), &ranges, &m_rangeSize,
                                         nullptr, nullptr);
     if (res != DW_DLV_OK)
         return;
 
-    m_ranges.reset(ranges, [die, this](Dwarf_Ranges* ranges) {
-        dwarf_ranges_dealloc(die->dwarfInfo()->dwarfHandle(), ranges, m_rangeSize);
+    const auto rangeSize = m_rangeSize;
+    m_ranges.reset(ranges, [info, rangeSize](Dwarf_Ranges* ranges) {
+        const auto lock = info->lockDwarfHandle();
+        dwarf_ranges_dealloc(info->dwarfHandle(), ranges, rangeSize);
     });
 }
 
@@ -35,6 +35,9 @@
 #include "elfsegmentheader_impl.h"
 #include "elfnoteentry.h"
 
+#include <demangle/demanglecache.h>
+#include <demangle/symbolprefixtree.h>
+
 #if HAVE_DWARF
 #include <dwarf/dwarfinfo.h>
 #endif
@@ -45,9 +48,15 @@
 #include <cassert>
 #include <elf.h>
 
+#ifdef Q_OS_LINUX
+#include <sys/mman.h>
+#endif
+
 struct ElfFileException {};
 
-ElfFile::ElfFile(const QString& fileName) : m_data(nullptr)
+ElfFile::ElfFile(const QString& fileName) :
+    m_data(nullptr),
+    m_demangleCache(new DemangleCache)
 {
     m_file.setFileName(fileName);
 }
@@ -84,6 +93,15 @@ unsigned char* ElfFile::rawData() const
     return m_data;
 }
 
+void ElfFile::releaseMappedPages() const
+{
+#ifdef Q_OS_LINUX
+    // the mapping is shared and read-only, so this just unmaps the pages until they are touched again
+    if (m_data)
+        madvise(m_data, size(), MADV_DONTNEED);
+#endif
+}
+
 int ElfFile::type() const
 {
     assert(isValid());
@@ -154,6 +172,7 @@ void ElfFile::close()
         delete m_sectionHeaders.at(i);
         delete m_sections.at(i);
     }
+    m_demangleCache->clear();
     m_file.close();
     m_data = nullptr;
 }
@@ -169,7 +188,7 @@ void ElfFile::parse()
     parseSegments();
 
 #if HAVE_DWARF
-    if (indexOfSection(".debug_info") >= 0)
+    if (indexOfSection(".debug_info") >= 0 || indexOfSection(".debug_info.dwo") >= 0)
         m_dwarfInfo = new DwarfInfo(this);
 #endif
 }
@@ -382,6 +401,19 @@ const ElfReverseRelocator* ElfFile::reverseRelocator() const
     return &m_reverseReloc;
 }
 
+const SymbolPrefixTree* ElfFile::symbolPrefixTree() const
+{
+    std::call_once(m_symbolPrefixTreeFlag, [this]() {
+        m_symbolPrefixTree.reset(new SymbolPrefixTree(this));
+    });
+    return m_symbolPrefixTree.get();
+}
+
+DemangleCache* ElfFile::demangleCache() const
+{
+    return m_demangleCache.get();
+}
+
 QByteArray ElfFile::buildId() const
 {
     auto buildIdIndex = indexOfSection(".note.gnu.build-id");
@@ -28,12 +28,15 @@
 #include <QVector>
 
 #include <memory>
+#include <mutex>
 
+class DemangleCache;
 class DwarfInfo;
 class ElfHashSection;
 class ElfHeader;
 class ElfSymbolTableSection;
 class ElfSegmentHeader;
+class SymbolPrefixTree;
 
 /** Represents a ELF file. */
 class ElfFile
@@ -63,6 +66,10 @@ public:
 
     /** Returns a pointer to the raw ELF data. */
     unsigned char* rawData() const;
+    /** Drops the pages of the file mapping from this process, so the page cache can evict them.
+     *  The content remains accessible, it is read back on the next access.
+     */
+    void releaseMappedPages() const;
 
     /** ELF class type (32/64 bit). */
     int type() const;
@@ -104,6 +111,10 @@ public:
     ElfHashSection* hash() const;
     /** Reverse relocation lookup. */
     const ElfReverseRelocator* reverseRelocator() const;
+    /** Namespace/class prefix tree over the symbol table, built on first use. */
+    const SymbolPrefixTree* symbolPrefixTree() const;
+    /** Cache for the demangled names from the string tables of this file. */
+    DemangleCache* demangleCache() const;
 
     /** Returns the build-id, if present. */
     QByteArray buildId() const;
@@ -139,6 +150,9 @@ private:
     ElfDynamicSection* m_dynamicSection = nullptr;
     ElfHashSection* m_hashSection = nullptr;
     ElfReverseRelocator m_reverseReloc;
+    mutable std::once_flag m_symbolPrefixTreeFlag;
+    mutable std::unique_ptr<SymbolPrefixTree> m_symbolPrefixTree;
+    std::unique_ptr<DemangleCache> m_demangleCache;
     std::unique_ptr<ElfFile> m_separateDebugFile;
     ElfFile *m_contentFile = nullptr; // the counter part for a separate debug file
     DwarfInfo *m_dwarfInfo = nullptr;
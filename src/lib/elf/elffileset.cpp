@@ -129,6 +129,42 @@ ElfFile* ElfFileSet::file(int index) const
     return m_files.at(index);
 }
 
+QVector<ElfFile*> ElfFileSet::lookupScope() const
+{
+    return lookupScope({});
+}
+
+QVector<ElfFile*> ElfFileSet::lookupScope(const QHash<ElfFile*, QVector<QByteArray>> &neededOverrides) const
+{
+    QVector<ElfFile*> scope;
+    if (m_files.isEmpty())
+        return scope;
+
+    scope.reserve(m_files.size());
+    scope.push_back(m_files.at(0));
+    for (int i = 0; i < scope.size(); ++i) {
+        const auto dyn = scope.at(i)->dynamicSection();
+        if (!dyn)
+            continue;
+        const auto overrideIt = neededOverrides.constFind(scope.at(i));
+        const auto needed = overrideIt != neededOverrides.constEnd() ? overrideIt.value() : dyn->neededLibraries();
+        foreach (const auto &lib, needed) {
+            const auto it = std::find_if(m_files.cbegin(), m_files.cend(), [lib](ElfFile *file) {
+                return (file->dynamicSection() && file->dynamicSection()->soName() == lib) || file->fileName().toUtf8() == lib;
+            });
+            if (it != m_files.cend() && !scope.contains(*it))
+                scope.push_back(*it);
+        }
+    }
+
+    // files not reachable via DT_NEEDED, e.g. added manually
+    foreach (auto file, m_files) {
+        if (!scope.contains(file))
+            scope.push_back(file);
+    }
+    return scope;
+}
+
 static bool hasUnresolvedDependencies(ElfFile *file, const QVector<ElfFile*> &resolved, int startIndex)
 {
     if (!file->dynamicSection())
@@ -20,6 +20,7 @@
 
 #include "elffile.h"
 
+#include <QHash>
 #include <QObject>
 
 /** A set of ELF files. */
@@ -35,6 +36,13 @@ public:
 
     ElfFile* file(int index) const;
 
+    /** Returns all files in the order the dynamic linker searches them for symbol definitions,
+     *  ie. breadth-first along the DT_NEEDED entries starting with the first file.
+     */
+    QVector<ElfFile*> lookupScope() const;
+    /** Same as the above, with the DT_NEEDED entries of some files replaced by @p neededOverrides. */
+    QVector<ElfFile*> lookupScope(const QHash<ElfFile*, QVector<QByteArray>> &neededOverrides) const;
+
     void topologicalSort();
 private:
     void addFile(ElfFile* file);
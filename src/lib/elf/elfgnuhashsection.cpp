@@ -85,8 +85,13 @@ uint64_t ElfGnuHashSection::filterMask(uint32_t index) const
     return *(reinterpret_cast<const uint32_t*>(rawData()) + 4 + index);
 }
 
-ElfSymbolTableEntry* ElfGnuHashSection::lookup(const char* name) const
+ElfSymbolTableEntry* ElfGnuHashSection::lookup(const char* name, LookupStatistics *stats) const
 {
+    LookupStatistics dummy;
+    if (!stats)
+        stats = &dummy;
+    ++stats->lookups;
+
     auto h1 = hash(name);
 
     {
@@ -98,13 +103,16 @@ ElfSymbolTableEntry* ElfGnuHashSection::lookup(const char* name) const
         const uint32_t hashbit2 = h2 & (c - 1);
 
         const auto bitmask = filterMask(n);
-        if (((bitmask >> hashbit1) & (bitmask >> hashbit2) & 1) == 0)
+        if (((bitmask >> hashbit1) & (bitmask >> hashbit2) & 1) == 0) {
+            ++stats->bloomRejections;
             return nullptr;
+        }
     }
 
     auto n = bucket(h1 % bucketCount());
     if (n == 0)
         return nullptr;
+    ++stats->bucketHits;
 
     const auto symTab = linkedSection<ElfSymbolTableSection>();
     assert(symTab);
@@ -113,8 +121,12 @@ ElfSymbolTableEntry* ElfGnuHashSection::lookup(const char* name) const
     for (h1 &= ~1; true; ++n) {
         const auto entry = symTab->entry(n);
         const auto h2 = *hashValue++;
-        if ((h1 == (h2 & ~1)) && strcmp(name, entry->name()) == 0)
-            return entry;
+        ++stats->chainSteps;
+        if (h1 == (h2 & ~1)) {
+            ++stats->stringCompares;
+            if (strcmp(name, entry->name()) == 0)
+                return entry;
+        }
         if (h2 & 1)
             break;
     }
@@ -122,6 +134,32 @@ ElfSymbolTableEntry* ElfGnuHashSection::lookup(const char* name) const
     return nullptr;
 }
 
+QVector<ElfSymbolTableEntry*> ElfGnuHashSection::lookupAll(const char* name) const
+{
+    QVector<ElfSymbolTableEntry*> entries;
+    auto h1 = hash(name);
+    auto n = bucket(h1 % bucketCount());
+    if (n == 0)
+        return entries;
+
+    const auto symTab = linkedSection<ElfSymbolTableSection>();
+    assert(symTab);
+    auto hashValue = value(n);
+
+    for (h1 &= ~1; true; ++n) {
+        const auto h2 = *hashValue++;
+        if (h1 == (h2 & ~1)) {
+            const auto entry = symTab->entry(n);
+            if (strcmp(name, entry->name()) == 0)
+                entries.push_back(entry);
+        }
+        if (h2 & 1)
+            break;
+    }
+
+    return entries;
+}
+
 QVector<uint32_t> ElfGnuHashSection::histogram() const
 {
     QVector<uint32_t> hist;
@@ -24,6 +24,21 @@ ElfHashSection::ElfHashSection(ElfFile* file, ElfSectionHeader* shdr) :
 
 ElfHashSection::~ElfHashSection() = default;
 
+ElfSymbolTableEntry* ElfHashSection::lookup(const char* name) const
+{
+    return lookup(name, nullptr);
+}
+
+ElfHashSection::LookupStatistics& ElfHashSection::LookupStatistics::operator+=(const LookupStatistics &other)
+{
+    lookups += other.lookups;
+    bloomRejections += other.bloomRejections;
+    bucketHits += other.bucketHits;
+    chainSteps += other.chainSteps;
+    stringCompares += other.stringCompares;
+    return *this;
+}
+
 int ElfHashSection::commonPrefixLength(const char* s1, const char* s2)
 {
     int l = 0;
@@ -34,7 +34,21 @@ public:
     virtual uint32_t bucketCount() const = 0;
     virtual uint32_t chainCount() const = 0;
 
-    virtual ElfSymbolTableEntry *lookup(const char* name) const = 0;
+    /** Work done by symbol lookups, as counted by the instrumented lookup(). */
+    struct LookupStatistics {
+        uint64_t lookups = 0;
+        uint64_t bloomRejections = 0; ///< lookups rejected by the bloom filter (.gnu.hash only)
+        uint64_t bucketHits = 0; ///< lookups that reached a non-empty hash bucket
+        uint64_t chainSteps = 0; ///< hash chain entries visited
+        uint64_t stringCompares = 0; ///< symbol names compared
+        LookupStatistics& operator+=(const LookupStatistics &other);
+    };
+
+    ElfSymbolTableEntry *lookup(const char* name) const;
+    /** Same as the above, but also accumulates the work done into @p stats. */
+    virtual ElfSymbolTableEntry *lookup(const char* name, LookupStatistics *stats) const = 0;
+    /** Returns all entries named @p name, such as the different versions of a versioned symbol. */
+    virtual QVector<ElfSymbolTableEntry*> lookupAll(const char* name) const = 0;
 
     /** Histogram of the hash chain lengths. */
     virtual QVector<uint32_t> histogram() const = 0;
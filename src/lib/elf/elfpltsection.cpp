@@ -39,10 +39,10 @@ ElfPltEntry* ElfPltSection::entry(uint64_t index) const
 
 ElfGotSection* ElfPltSection::gotSection() const
 {
-    if (!m_gotSection) {
+    std::call_once(m_gotSectionFlag, [this]() {
         const auto gotAddr = m_file->dynamicSection()->entryWithTag(DT_PLTGOT)->pointer();
         const auto gotIdx = m_file->indexOfSectionWithVirtualAddress(gotAddr);
         m_gotSection = m_file->section<ElfGotSection>(gotIdx);
-    }
+    });
     return m_gotSection;
 }
@@ -23,6 +23,8 @@
 
 #include <QVector>
 
+#include <mutex>
+
 class ElfGotSection;
 
 class ElfPltSection : public ElfSection
@@ -39,6 +41,7 @@ public:
 private:
     QVector<ElfPltEntry> m_entries;
     mutable ElfGotSection *m_gotSection;
+    mutable std::once_flag m_gotSectionFlag;
 };
 
 #endif // ELFPLTSECTION_H
@@ -0,0 +1,577 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "elfrelocationsimulator.h"
+#include "elffile.h"
+#include "elffileset.h"
+#include "elfgnusymbolversiondefinition.h"
+#include "elfgnusymbolversiondefinitionauxiliaryentry.h"
+#include "elfgnusymbolversiondefinitionssection.h"
+#include "elfgnusymbolversionrequirementauxiliaryentry.h"
+#include "elfgnusymbolversionrequirementssection.h"
+#include "elfgnusymbolversiontable.h"
+#include "elfhashsection.h"
+#include "elfheader.h"
+#include "elfrelocationsection.h"
+#include "elfsegmentheader.h"
+#include "elfsymboltablesection.h"
+
+#include <elf.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+#ifndef SHT_RELR
+#define SHT_RELR 19
+#endif
+
+static const uint64_t PageSize = 4096;
+
+ElfRelocationSimulator::ElfRelocationSimulator(ElfFileSet* fileSet) :
+    m_fileSet(fileSet)
+{
+    assert(fileSet);
+    layoutFiles();
+}
+
+ElfRelocationSimulator::~ElfRelocationSimulator() = default;
+
+ElfRelocationSimulator::RelocationKind ElfRelocationSimulator::relocationKind(uint16_t machine, uint32_t type)
+{
+    switch (machine) {
+        case EM_386:
+            switch (type) {
+                case R_386_NONE: return RelocationKind::None;
+                case R_386_32: return RelocationKind::Absolute;
+                case R_386_COPY: return RelocationKind::Copy;
+                case R_386_GLOB_DAT: return RelocationKind::GlobalData;
+                case R_386_JMP_SLOT: return RelocationKind::JumpSlot;
+                case R_386_RELATIVE: return RelocationKind::Relative;
+                case R_386_IRELATIVE: return RelocationKind::IRelative;
+            }
+            break;
+        case EM_X86_64:
+            switch (type) {
+                case R_X86_64_NONE: return RelocationKind::None;
+                case R_X86_64_64: return RelocationKind::Absolute;
+                case R_X86_64_COPY: return RelocationKind::Copy;
+                case R_X86_64_GLOB_DAT: return RelocationKind::GlobalData;
+                case R_X86_64_JUMP_SLOT: return RelocationKind::JumpSlot;
+                case R_X86_64_RELATIVE: return RelocationKind::Relative;
+                case R_X86_64_IRELATIVE: return RelocationKind::IRelative;
+            }
+            break;
+        case EM_ARM:
+            switch (type) {
+                case R_ARM_NONE: return RelocationKind::None;
+                case R_ARM_ABS32: return RelocationKind::Absolute;
+                case R_ARM_COPY: return RelocationKind::Copy;
+                case R_ARM_GLOB_DAT: return RelocationKind::GlobalData;
+                case R_ARM_JUMP_SLOT: return RelocationKind::JumpSlot;
+                case R_ARM_RELATIVE: return RelocationKind::Relative;
+                case R_ARM_IRELATIVE: return RelocationKind::IRelative;
+            }
+            break;
+        case EM_AARCH64:
+            switch (type) {
+                case R_AARCH64_NONE: return RelocationKind::None;
+                case R_AARCH64_ABS64: return RelocationKind::Absolute;
+                case R_AARCH64_COPY: return RelocationKind::Copy;
+                case R_AARCH64_GLOB_DAT: return RelocationKind::GlobalData;
+                case R_AARCH64_JUMP_SLOT: return RelocationKind::JumpSlot;
+                case R_AARCH64_RELATIVE: return RelocationKind::Relative;
+                case R_AARCH64_IRELATIVE: return RelocationKind::IRelative;
+            }
+            break;
+    }
+    return RelocationKind::Unsupported;
+}
+
+void ElfRelocationSimulator::layoutFiles()
+{
+    m_scope = m_fileSet->lookupScope();
+    if (m_scope.isEmpty())
+        return;
+
+    const bool is64 = m_scope.at(0)->addressSize() == 8;
+    uint64_t nextLibraryAddress = is64 ? 0x7f0000000000ull : 0xe0000000ull;
+
+    for (int i = 0; i < m_scope.size(); ++i) {
+        const auto file = m_scope.at(i);
+        auto &s = m_states[file];
+
+        uint64_t low = std::numeric_limits<uint64_t>::max();
+        uint64_t high = 0;
+        uint64_t alignment = PageSize;
+        foreach (const auto phdr, file->segmentHeaders()) {
+            if (phdr->type() != PT_LOAD)
+                continue;
+            low = std::min(low, phdr->virtualAddress() & ~(PageSize - 1));
+            high = std::max(high, phdr->virtualAddress() + phdr->memorySize());
+            alignment = std::max(alignment, phdr->alignment());
+        }
+        if (high == 0)
+            continue;
+
+        if (file->header()->type() == ET_EXEC) {
+            s.baseAddress = 0;
+        } else if (i == 0) { // position independent executable
+            s.baseAddress = is64 ? 0x555555554000ull : 0x56555000ull;
+        } else {
+            s.baseAddress = (nextLibraryAddress + alignment - 1) & ~(alignment - 1);
+            nextLibraryAddress = s.baseAddress + ((high + PageSize - 1) & ~(PageSize - 1));
+        }
+        s.lowAddress = low;
+        s.highAddress = high;
+    }
+}
+
+ElfRelocationSimulator::FileState* ElfRelocationSimulator::state(ElfFile* file) const
+{
+    const auto it = m_states.find(file);
+    if (it == m_states.end())
+        return nullptr;
+    return &it.value();
+}
+
+bool ElfRelocationSimulator::contains(ElfFile* file) const
+{
+    return m_states.contains(file);
+}
+
+uint64_t ElfRelocationSimulator::baseAddress(ElfFile* file) const
+{
+    const auto s = state(file);
+    return s ? s->baseAddress : 0;
+}
+
+bool ElfRelocationSimulator::setBaseAddress(ElfFile* file, uint64_t baseAddr)
+{
+    const auto s = state(file);
+    if (!s)
+        return false;
+    s->baseAddress = baseAddr;
+
+    // relocation results of other files depend on our symbol addresses as well
+    for (auto it = m_states.begin(); it != m_states.end(); ++it) {
+        it.value().pages.clear();
+        it.value().unresolved = 0;
+        it.value().relocated = false;
+    }
+    return true;
+}
+
+uint64_t ElfRelocationSimulator::pointerValue(ElfFile* file, uint64_t vaddr, bool *ok) const
+{
+    uint64_t value = 0;
+    bool success = false;
+    if (state(file)) {
+        relocate(file);
+        success = readPointer(file, vaddr, &value);
+    }
+    if (ok)
+        *ok = success;
+    return value;
+}
+
+uint64_t ElfRelocationSimulator::pointerValue(const ElfRelocationEntry* entry, bool *ok) const
+{
+    return pointerValue(entry->relocationTable()->file(), entry->offset(), ok);
+}
+
+ElfFile* ElfRelocationSimulator::fileForAddress(uint64_t addr) const
+{
+    for (auto it = m_states.cbegin(); it != m_states.cend(); ++it) {
+        const auto &s = it.value();
+        if (s.highAddress == 0)
+            continue;
+        if (addr >= s.baseAddress + s.lowAddress && addr < s.baseAddress + s.highAddress)
+            return it.key();
+    }
+    return nullptr;
+}
+
+ElfSymbolTableEntry* ElfRelocationSimulator::symbolForAddress(uint64_t addr) const
+{
+    const auto file = fileForAddress(addr);
+    if (!file || !file->symbolTable())
+        return nullptr;
+    return file->symbolTable()->entryContainingValue(addr - baseAddress(file));
+}
+
+static bool isExported(ElfSymbolTableEntry *entry)
+{
+    if (entry->sectionIndex() == SHN_UNDEF)
+        return false;
+    switch (entry->bindType()) {
+        case STB_GLOBAL:
+        case STB_WEAK:
+        case STB_GNU_UNIQUE:
+            break;
+        default:
+            return false;
+    }
+    return entry->visibility() == STV_DEFAULT || entry->visibility() == STV_PROTECTED;
+}
+
+static ElfGNUSymbolVersionTable* versionTable(ElfSymbolTableEntry *entry)
+{
+    const auto file = entry->symbolTable()->file();
+    const auto index = file->indexOfSection(SHT_GNU_versym);
+    if (index < 0)
+        return nullptr;
+    const auto versym = file->section<ElfGNUSymbolVersionTable>(index);
+    if (!versym || versym->linkedSection<ElfSymbolTableSection>() != entry->symbolTable() || entry->index() >= versym->header()->entryCount())
+        return nullptr;
+    return versym;
+}
+
+// name of the version required by (if undefined) or assigned to (if defined) @p entry, @c nullptr if unversioned
+static const char* versionName(ElfSymbolTableEntry *entry)
+{
+    const auto versym = versionTable(entry);
+    if (!versym)
+        return nullptr;
+    const auto versionIndex = versym->versionIndex(entry->index());
+    if (versionIndex <= VER_NDX_GLOBAL)
+        return nullptr;
+
+    const auto file = entry->symbolTable()->file();
+    if (entry->sectionIndex() == SHN_UNDEF) {
+        const auto index = file->indexOfSection(SHT_GNU_verneed);
+        const auto verneed = index >= 0 ? file->section<ElfGNUSymbolVersionRequirementsSection>(index) : nullptr;
+        const auto aux = verneed ? verneed->requirementForVersionIndex(versionIndex) : nullptr;
+        return aux ? aux->name() : nullptr;
+    }
+    const auto index = file->indexOfSection(SHT_GNU_verdef);
+    const auto verdef = index >= 0 ? file->section<ElfGNUSymbolVersionDefinitionsSection>(index) : nullptr;
+    const auto def = verdef ? verdef->definitionForVersionIndex(versionIndex) : nullptr;
+    return def && def->auxiliarySize() > 0 ? def->auxiliaryEntry(0)->name() : nullptr;
+}
+
+// matches versioned definitions the same way ld.so does: an unversioned reference binds to the default
+// (non-hidden) version, a versioned one to the definition of exactly that version, or to an unversioned one
+static bool matchesVersion(ElfSymbolTableEntry *entry, const char *version)
+{
+    const auto versym = versionTable(entry);
+    if (!versym)
+        return true;
+    const auto hidden = versym->isHidden(entry->index());
+    if (!version)
+        return !hidden;
+    const auto defVersion = versionName(entry);
+    if (!defVersion)
+        return !hidden;
+    return strcmp(version, defVersion) == 0;
+}
+
+ElfSymbolTableEntry* ElfRelocationSimulator::resolveSymbol(const char* name, ElfFile* excludedFile) const
+{
+    return resolveSymbol(name, nullptr, excludedFile);
+}
+
+ElfSymbolTableEntry* ElfRelocationSimulator::resolveSymbol(const char* name, const char* version, ElfFile* excludedFile) const
+{
+    foreach (auto file, m_scope) {
+        if (file == excludedFile || !file->hash())
+            continue;
+        foreach (auto entry, file->hash()->lookupAll(name)) {
+            if (isExported(entry) && matchesVersion(entry, version))
+                return entry;
+        }
+    }
+    return nullptr;
+}
+
+int ElfRelocationSimulator::unresolvedRelocationCount(ElfFile* file) const
+{
+    const auto s = state(file);
+    if (!s)
+        return -1;
+    relocate(file);
+    return s->unresolved;
+}
+
+static bool isSymbolic(ElfFile *file)
+{
+    const auto dyn = file->dynamicSection();
+    if (!dyn)
+        return false;
+    if (dyn->entryWithTag(DT_SYMBOLIC))
+        return true;
+    const auto flags = dyn->entryWithTag(DT_FLAGS);
+    return flags && (flags->value() & DF_SYMBOLIC);
+}
+
+uint64_t ElfRelocationSimulator::symbolAddress(ElfFile* file, ElfSymbolTableEntry* sym, bool* resolved) const
+{
+    *resolved = true;
+    if (sym->sectionIndex() == SHN_ABS)
+        return sym->value();
+
+    const auto isDefined = sym->sectionIndex() != SHN_UNDEF;
+    if (isDefined && (sym->bindType() == STB_LOCAL || sym->visibility() == STV_HIDDEN || sym->visibility() == STV_INTERNAL || sym->visibility() == STV_PROTECTED || isSymbolic(file)))
+        return baseAddress(file) + sym->value();
+
+    const auto def = resolveSymbol(sym->name(), versionName(sym), nullptr);
+    if (def) {
+        if (def->sectionIndex() == SHN_ABS)
+            return def->value();
+        return baseAddress(def->symbolTable()->file()) + def->value();
+    }
+
+    if (sym->bindType() == STB_WEAK)
+        return 0;
+    *resolved = false;
+    return 0;
+}
+
+void ElfRelocationSimulator::relocate(ElfFile* file) const
+{
+    const auto s = state(file);
+    if (!s || s->relocated || s->relocating)
+        return;
+    s->relocating = true;
+
+    const auto shdrs = file->sectionHeaders();
+    for (int i = 0; i < shdrs.size(); ++i) {
+        const auto shdr = shdrs.at(i);
+        if ((shdr->flags() & SHF_ALLOC) == 0)
+            continue;
+        switch (shdr->type()) {
+            case SHT_REL:
+            case SHT_RELA:
+            {
+                const auto relocs = file->section<ElfRelocationSection>(i);
+                if (!relocs)
+                    break;
+                for (uint64_t j = 0; j < shdr->entryCount(); ++j)
+                    applyRelocation(file, relocs->entry(j));
+                break;
+            }
+            case SHT_RELR:
+                applyRelrSection(file, i);
+                break;
+        }
+    }
+
+    s->relocating = false;
+    s->relocated = true;
+}
+
+void ElfRelocationSimulator::applyRelocation(ElfFile* file, ElfRelocationEntry* entry) const
+{
+    auto &s = *state(file);
+    const auto kind = relocationKind(file->header()->machine(), entry->type());
+    const auto withAddend = entry->relocationTable()->header()->type() == SHT_RELA;
+    const auto place = entry->offset();
+
+    switch (kind) {
+        case RelocationKind::None:
+            return;
+        case RelocationKind::Unsupported:
+            ++s.unresolved;
+            return;
+        case RelocationKind::Relative:
+        case RelocationKind::IRelative: // we can't run the resolver, so this points to that instead
+        {
+            uint64_t addend = 0;
+            if (withAddend) {
+                addend = entry->addend();
+            } else if (!readPointer(file, place, &addend)) {
+                ++s.unresolved;
+                return;
+            }
+            writePointer(file, place, s.baseAddress + addend);
+            return;
+        }
+        case RelocationKind::Copy:
+        {
+            const auto sym = entry->symbol();
+            const auto def = sym ? resolveSymbol(sym->name(), versionName(sym), file) : nullptr;
+            if (!def) {
+                ++s.unresolved;
+                return;
+            }
+            const auto defFile = def->symbolTable()->file();
+            relocate(defFile);
+            QByteArray buffer(sym->size(), 0);
+            if (!read(defFile, def->value(), buffer.data(), buffer.size())) {
+                ++s.unresolved;
+                return;
+            }
+            write(file, place, buffer.constData(), buffer.size());
+            return;
+        }
+        case RelocationKind::Absolute:
+        case RelocationKind::GlobalData:
+        case RelocationKind::JumpSlot:
+        {
+            uint64_t addend = 0;
+            if (withAddend) {
+                addend = entry->addend();
+            } else if (kind == RelocationKind::Absolute && !readPointer(file, place, &addend)) {
+                ++s.unresolved;
+                return;
+            }
+
+            uint64_t value = 0;
+            const auto sym = entry->symbol();
+            if (sym) {
+                bool resolved = false;
+                value = symbolAddress(file, sym, &resolved);
+                if (!resolved)
+                    ++s.unresolved;
+            }
+            writePointer(file, place, value + addend);
+            return;
+        }
+    }
+}
+
+void ElfRelocationSimulator::applyRelrSection(ElfFile* file, int sectionIndex) const
+{
+    const auto section = file->section<ElfSection>(sectionIndex);
+    const auto addrSize = file->addressSize();
+    auto &s = *state(file);
+    const auto base = s.baseAddress;
+    const auto bitsPerEntry = addrSize * 8 - 1;
+
+    uint64_t where = 0;
+    for (uint64_t i = 0; i < section->size() / addrSize; ++i) {
+        uint64_t entry = 0;
+        memcpy(&entry, section->rawData() + i * addrSize, addrSize);
+        uint64_t value = 0;
+        if ((entry & 1) == 0) {
+            if (readPointer(file, entry, &value))
+                writePointer(file, entry, base + value);
+            else
+                ++s.unresolved;
+            where = entry + addrSize;
+            continue;
+        }
+        for (int bit = 0; bit < bitsPerEntry; ++bit) {
+            entry >>= 1;
+            if (entry & 1) {
+                const auto addr = where + bit * addrSize;
+                if (readPointer(file, addr, &value))
+                    writePointer(file, addr, base + value);
+                else
+                    ++s.unresolved;
+            }
+        }
+        where += bitsPerEntry * addrSize;
+    }
+}
+
+// reads from the unrelocated file content, zero-filling the parts of segments not backed by the file
+static bool readFromFile(ElfFile *file, uint64_t vaddr, char *buffer, int size)
+{
+    while (size > 0) {
+        const ElfSegmentHeader *segment = nullptr;
+        foreach (const auto phdr, file->segmentHeaders()) {
+            if (phdr->type() == PT_LOAD && vaddr >= phdr->virtualAddress() && vaddr < phdr->virtualAddress() + phdr->memorySize()) {
+                segment = phdr;
+                break;
+            }
+        }
+        if (!segment)
+            return false;
+
+        const auto segmentOffset = vaddr - segment->virtualAddress();
+        const auto n = std::min<uint64_t>(size, segment->memorySize() - segmentOffset);
+        for (uint64_t i = 0; i < n; ++i) {
+            if (segmentOffset + i < segment->fileSize() && segment->offset() + segmentOffset + i < file->size())
+                buffer[i] = file->rawData()[segment->offset() + segmentOffset + i];
+            else
+                buffer[i] = 0;
+        }
+        buffer += n;
+        vaddr += n;
+        size -= n;
+    }
+    return true;
+}
+
+// same as the above, for an entire page, zero-filling everything outside of any segment
+static void readPageFromFile(ElfFile *file, uint64_t page, char *buffer)
+{
+    memset(buffer, 0, PageSize);
+    foreach (const auto phdr, file->segmentHeaders()) {
+        if (phdr->type() != PT_LOAD)
+            continue;
+        const auto fileBacked = std::min(phdr->fileSize(), file->size() - std::min(file->size(), phdr->offset()));
+        const auto begin = std::max(page, phdr->virtualAddress());
+        const auto end = std::min(page + PageSize, phdr->virtualAddress() + fileBacked);
+        if (begin >= end)
+            continue;
+        memcpy(buffer + (begin - page), file->rawData() + phdr->offset() + (begin - phdr->virtualAddress()), end - begin);
+    }
+}
+
+bool ElfRelocationSimulator::read(ElfFile* file, uint64_t vaddr, void* buffer, int size) const
+{
+    const auto &pages = state(file)->pages;
+    auto out = static_cast<char*>(buffer);
+    while (size > 0) {
+        const auto page = vaddr & ~(PageSize - 1);
+        const int n = std::min<uint64_t>(size, page + PageSize - vaddr);
+        const auto it = pages.constFind(page);
+        if (it != pages.constEnd())
+            memcpy(out, it.value().constData() + (vaddr - page), n);
+        else if (!readFromFile(file, vaddr, out, n))
+            return false;
+        out += n;
+        vaddr += n;
+        size -= n;
+    }
+    return true;
+}
+
+void ElfRelocationSimulator::write(ElfFile* file, uint64_t vaddr, const void* buffer, int size) const
+{
+    auto &pages = state(file)->pages;
+    auto in = static_cast<const char*>(buffer);
+    while (size > 0) {
+        const auto page = vaddr & ~(PageSize - 1);
+        const int n = std::min<uint64_t>(size, page + PageSize - vaddr);
+        auto it = pages.find(page);
+        if (it == pages.end()) {
+            QByteArray content(PageSize, Qt::Uninitialized);
+            readPageFromFile(file, page, content.data());
+            it = pages.insert(page, content);
+        }
+        memcpy(it.value().data() + (vaddr - page), in, n);
+        in += n;
+        vaddr += n;
+        size -= n;
+    }
+}
+
+bool ElfRelocationSimulator::readPointer(ElfFile* file, uint64_t vaddr, uint64_t *value) const
+{
+    // TODO this assumes endianess equalness, like the rest of the code
+    *value = 0;
+    return read(file, vaddr, value, file->addressSize());
+}
+
+void ElfRelocationSimulator::writePointer(ElfFile* file, uint64_t vaddr, uint64_t value) const
+{
+    write(file, vaddr, &value, file->addressSize());
+}
@@ -0,0 +1,121 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef ELFRELOCATIONSIMULATOR_H
+#define ELFRELOCATIONSIMULATOR_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+
+#include <cstdint>
+
+class ElfFile;
+class ElfFileSet;
+class ElfRelocationEntry;
+class ElfSymbolTableEntry;
+
+/** Statically applies the dynamic relocations of a set of ELF files.
+ *
+ *  This lays out all files of an ElfFileSet in a virtual address space and resolves
+ *  their dynamic relocations as the dynamic linker would do at load time, so that
+ *  pointer values only known after relocation (vtables, init arrays, GOT entries, etc)
+ *  can be inspected. Relocated content is kept in a sparse copy-on-write page overlay,
+ *  the underlying file mappings are never modified.
+ *  Unlike the lazy caches of ElfFile, this is not safe for concurrent use.
+ */
+class ElfRelocationSimulator
+{
+public:
+    explicit ElfRelocationSimulator(ElfFileSet *fileSet);
+    ElfRelocationSimulator(const ElfRelocationSimulator&) = delete;
+    ~ElfRelocationSimulator();
+
+    ElfRelocationSimulator& operator=(const ElfRelocationSimulator&) = delete;
+
+    /** Relocation categories relevant for simulation, independent of the target architecture. */
+    enum class RelocationKind {
+        Unsupported,
+        None,
+        Relative,
+        IRelative,
+        Absolute,
+        GlobalData,
+        JumpSlot,
+        Copy
+    };
+    /** Classifies relocation @p type for ELF machine @p machine. */
+    static RelocationKind relocationKind(uint16_t machine, uint32_t type);
+
+    /** Returns @c true if @p file is part of the simulated file set. */
+    bool contains(ElfFile *file) const;
+
+    /** Load address of @p file. By default files are placed next to each other in lookup scope order. */
+    uint64_t baseAddress(ElfFile *file) const;
+    /** Overrides the load address of @p file, this discards all relocation results computed so far.
+     *  Returns @c false if @p file is not part of the simulated file set.
+     */
+    bool setBaseAddress(ElfFile *file, uint64_t baseAddr);
+
+    /** Returns the relocated pointer-sized value at the (unrelocated) virtual address @p vaddr of @p file.
+     *  @p ok is set to @c false if @p file is not part of the file set or @p vaddr is not mapped.
+     */
+    uint64_t pointerValue(ElfFile *file, uint64_t vaddr, bool *ok = nullptr) const;
+    /** Same as the above, for the pointer that relocation @p entry applies to. */
+    uint64_t pointerValue(const ElfRelocationEntry *entry, bool *ok = nullptr) const;
+
+    /** Returns the file mapped at the relocated address @p addr, @c nullptr if there is none. */
+    ElfFile* fileForAddress(uint64_t addr) const;
+    /** Returns the symbol containing the relocated address @p addr, @c nullptr if there is none. */
+    ElfSymbolTableEntry* symbolForAddress(uint64_t addr) const;
+
+    /** Finds the default version definition of @p name in the global lookup scope. */
+    ElfSymbolTableEntry* resolveSymbol(const char *name, ElfFile *excludedFile = nullptr) const;
+
+    /** Number of relocations in @p file that could not be simulated, -1 if @p file is not part of the file set. */
+    int unresolvedRelocationCount(ElfFile *file) const;
+
+private:
+    struct FileState {
+        QHash<uint64_t, QByteArray> pages;
+        uint64_t baseAddress = 0;
+        uint64_t lowAddress = 0;
+        uint64_t highAddress = 0;
+        int unresolved = 0;
+        bool relocated = false;
+        bool relocating = false;
+    };
+
+    void layoutFiles();
+    FileState* state(ElfFile *file) const;
+    void relocate(ElfFile *file) const;
+    void applyRelocation(ElfFile *file, ElfRelocationEntry *entry) const;
+    void applyRelrSection(ElfFile *file, int sectionIndex) const;
+    uint64_t symbolAddress(ElfFile *file, ElfSymbolTableEntry *sym, bool *resolved) const;
+    ElfSymbolTableEntry* resolveSymbol(const char *name, const char *version, ElfFile *excludedFile) const;
+
+    bool read(ElfFile *file, uint64_t vaddr, void *buffer, int size) const;
+    void write(ElfFile *file, uint64_t vaddr, const void *buffer, int size) const;
+    bool readPointer(ElfFile *file, uint64_t vaddr, uint64_t *value) const;
+    void writePointer(ElfFile *file, uint64_t vaddr, uint64_t value) const;
+
+    ElfFileSet *m_fileSet;
+    QVector<ElfFile*> m_scope;
+    mutable QHash<ElfFile*, FileState> m_states;
+};
+
+#endif // ELFRELOCATIONSIMULATOR_H
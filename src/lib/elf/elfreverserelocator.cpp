@@ -66,23 +66,22 @@ void ElfReverseRelocator::addRelocationSection(ElfRelocationSection* section)
 
 void ElfReverseRelocator::indexRelocations() const
 {
-    if (!m_relocations.isEmpty())
-        return;
-
-    int totalSize = 0;
-    std::for_each(m_relocSections.constBegin(), m_relocSections.constEnd(), [&totalSize](ElfRelocationSection* section) {
-        totalSize += section->header()->entryCount();
-    });
-
-    m_relocations.resize(totalSize);
-    auto oit = m_relocations.begin();
-    for (const auto sec : m_relocSections) {
-        for (uint64_t i = 0; i < sec->header()->entryCount(); ++i) {
-            *oit++ = sec->entry(i);
+    std::call_once(m_indexFlag, [this]() {
+        int totalSize = 0;
+        std::for_each(m_relocSections.constBegin(), m_relocSections.constEnd(), [&totalSize](ElfRelocationSection* section) {
+            totalSize += section->header()->entryCount();
+        });
+
+        m_relocations.resize(totalSize);
+        auto oit = m_relocations.begin();
+        for (const auto sec : m_relocSections) {
+            for (uint64_t i = 0; i < sec->header()->entryCount(); ++i) {
+                *oit++ = sec->entry(i);
+            }
         }
-    }
 
-    std::sort(m_relocations.begin(), m_relocations.end(), [](ElfRelocationEntry *lhs, ElfRelocationEntry *rhs) {
-        return lhs->offset() < rhs->offset();
+        std::sort(m_relocations.begin(), m_relocations.end(), [](ElfRelocationEntry *lhs, ElfRelocationEntry *rhs) {
+            return lhs->offset() < rhs->offset();
+        });
     });
 }
@@ -20,10 +20,14 @@
 
 #include <QVector>
 
+#include <mutex>
+
 class ElfRelocationEntry;
 class ElfRelocationSection;
 
-/** Look up if a given address is relocated. */
+/** Look up if a given address is relocated.
+ *  The relocation index is built on first use and is safe to query from multiple threads.
+ */
 class ElfReverseRelocator
 {
 public:
@@ -46,6 +50,7 @@ private:
 
     QVector<ElfRelocationSection*> m_relocSections;
     mutable QVector<ElfRelocationEntry*> m_relocations;
+    mutable std::once_flag m_indexFlag;
 };
 
 #endif // ELFREVERSERELOCATOR_H
@@ -61,15 +61,24 @@ uint32_t ElfSysvHashSection::hash(const char* name)
     return h;
 }
 
-ElfSymbolTableEntry* ElfSysvHashSection::lookup(const char* name) const
+ElfSymbolTableEntry* ElfSysvHashSection::lookup(const char* name, LookupStatistics *stats) const
 {
+    LookupStatistics dummy;
+    if (!stats)
+        stats = &dummy;
+    ++stats->lookups;
+
     const auto x = hash(name);
 
     const auto symTab = linkedSection<ElfSymbolTableSection>();
     assert(symTab);
     auto y = bucket(x % bucketCount());
+    if (y != STN_UNDEF)
+        ++stats->bucketHits;
     while (y != STN_UNDEF) {
         const auto entry = symTab->entry(y);
+        ++stats->chainSteps;
+        ++stats->stringCompares;
         if (strcmp(entry->name(), name) == 0)
             return entry;
         y = chain(y);
@@ -78,6 +87,19 @@ ElfSymbolTableEntry* ElfSysvHashSection::lookup(const char* name) const
     return nullptr;
 }
 
+QVector<ElfSymbolTableEntry*> ElfSysvHashSection::lookupAll(const char* name) const
+{
+    QVector<ElfSymbolTableEntry*> entries;
+    const auto symTab = linkedSection<ElfSymbolTableSection>();
+    assert(symTab);
+    for (auto y = bucket(hash(name) % bucketCount()); y != STN_UNDEF; y = chain(y)) {
+        const auto entry = symTab->entry(y);
+        if (strcmp(entry->name(), name) == 0)
+            entries.push_back(entry);
+    }
+    return entries;
+}
+
 QVector<uint32_t> ElfSysvHashSection::histogram() const
 {
     QVector<uint32_t> hist;
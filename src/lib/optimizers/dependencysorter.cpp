@@ -17,22 +17,30 @@
 
 #include "dependencysorter.h"
 #include <checks/dependenciescheck.h>
+#include <checks/ldsimulator.h>
 #include <elf/elffileset.h>
 
 #include <QDebug>
-#include <QHash>
 
 #include <cassert>
+#include <iostream>
+#include <numeric>
 #include <elf.h>
 
+void DependencySorter::setDryRun(bool dryRun)
+{
+    m_dryRun = dryRun;
+}
+
+void DependencySorter::setProcessAllFiles(bool allFiles)
+{
+    m_allFiles = allFiles;
+}
+
 void DependencySorter::sortDtNeeded(ElfFileSet* fileSet)
 {
     assert(fileSet->size() > 0);
 
-    auto file = fileSet->file(0);
-    if (!file->dynamicSection())
-        return;
-
     // TODO index SO_NAME, this probably should be moved to ElfFileSet, we have that in a bunch of places now
     QHash<QByteArray, int> nameIndex;
     for (int i = 0; i < fileSet->size(); ++i) {
@@ -49,42 +57,137 @@ void DependencySorter::sortDtNeeded(ElfFileSet* fileSet)
             nameIndex.insert(soName, i);
     }
 
-    // count usages
-    QVector<int> usageCounts;
-    const auto needed = file->dynamicSection()->neededLibraries();
-    usageCounts.resize(needed.size());
-    for (int i = 0; i < needed.size(); ++i) {
-        auto depFile = fileSet->file(nameIndex.value(needed.at(i)));
-        assert(depFile);
-        assert(file != depFile);
+    m_neededOverrides.clear();
+    LDSimulator baseline;
+    baseline.simulateFileSet(fileSet);
 
-        usageCounts[i] = DependenciesCheck::usedSymbolCount(file, depFile);
+    if (m_allFiles) {
+        for (int i = 0; i < baseline.size(); ++i)
+            sortDtNeeded(fileSet, baseline.file(i), baseline);
+    } else {
+        sortDtNeeded(fileSet, fileSet->file(0), baseline);
     }
-    qDebug() << usageCounts;
 
-    // sort, check if change is needed
-    QVector<int> sortedNeededIndex;
-    sortedNeededIndex.resize(needed.size());
-    std::iota(sortedNeededIndex.begin(), sortedNeededIndex.end(), 0);
-    assert(sortedNeededIndex.size() == usageCounts.size());
-    qDebug() << sortedNeededIndex;
+    LDSimulator result;
+    result.simulateScope(fileSet->lookupScope(m_neededOverrides));
+    std::cout << "total probes: " << baseline.totalProbes() << " -> " << result.totalProbes()
+              << ", estimated cost: " << baseline.totalCost() << " -> " << result.totalCost();
+    if (m_dryRun)
+        std::cout << " (dry run, no files modified)";
+    std::cout << std::endl;
+}
+
+DependencySorter::Evaluation DependencySorter::evaluate(ElfFileSet *fileSet, ElfFile *file, const QVector<QByteArray> &needed, const LDSimulator &baseline) const
+{
+    auto overrides = m_neededOverrides;
+    overrides.insert(file, needed);
+
+    LDSimulator sim;
+    sim.simulateScope(fileSet->lookupScope(overrides));
+
+    Evaluation eval;
+    eval.probes = sim.totalProbes();
+    eval.cost = sim.totalCost();
+
+    // reordering must not affect interposition, ie. every lookup has to find the same definition as before
+    eval.valid = sim.size() == baseline.size();
+    for (int i = 0; i < sim.size() && eval.valid; ++i) {
+        const auto baselineIndex = baseline.indexOf(sim.file(i));
+        eval.valid = baselineIndex >= 0 && sim.result(i).bindings == baseline.result(baselineIndex).bindings;
+    }
+    return eval;
+}
+
+void DependencySorter::sortDtNeeded(ElfFileSet* fileSet, ElfFile* file, const LDSimulator &baseline)
+{
+    if (!file->dynamicSection())
+        return;
+    const auto needed = file->dynamicSection()->neededLibraries();
+    if (needed.size() < 2)
+        return;
 
-    std::sort(sortedNeededIndex.begin(), sortedNeededIndex.end(), [usageCounts](int lhs, int rhs) {
+    const auto reordered = [&needed](const QVector<int> &order) {
+        QVector<QByteArray> libs;
+        libs.reserve(order.size());
+        for (auto i : order)
+            libs.push_back(needed.at(i));
+        return libs;
+    };
+
+    QVector<int> bestOrder;
+    bestOrder.resize(needed.size());
+    std::iota(bestOrder.begin(), bestOrder.end(), 0);
+    const auto original = evaluate(fileSet, file, needed, baseline);
+    auto best = original;
+
+    // start from sorting by usage count, then improve by swapping neighbors as long as that helps
+    QVector<int> usageCounts;
+    usageCounts.resize(needed.size());
+    for (int i = 0; i < needed.size(); ++i) {
+        for (int j = 0; j < baseline.size(); ++j) {
+            const auto depFile = baseline.file(j);
+            if (depFile != file && depFile->dynamicSection() && depFile->dynamicSection()->soName() == needed.at(i) && depFile->hash()) {
+                usageCounts[i] = DependenciesCheck::usedSymbolCount(file, depFile);
+                break;
+            }
+        }
+    }
+    auto order = bestOrder;
+    std::stable_sort(order.begin(), order.end(), [&usageCounts](int lhs, int rhs) {
         return usageCounts.at(lhs) > usageCounts.at(rhs);
     });
+    if (order != bestOrder) {
+        const auto eval = evaluate(fileSet, file, reordered(order), baseline);
+        if (eval.valid && eval.probes < best.probes) {
+            best = eval;
+            bestOrder = order;
+        }
+    }
 
-    qDebug() << sortedNeededIndex;
+    for (bool improved = true; improved;) {
+        improved = false;
+        for (int i = 0; i + 1 < bestOrder.size(); ++i) {
+            order = bestOrder;
+            std::swap(order[i], order[i + 1]);
+            const auto eval = evaluate(fileSet, file, reordered(order), baseline);
+            if (eval.valid && eval.probes < best.probes) {
+                best = eval;
+                bestOrder = order;
+                improved = true;
+            }
+        }
+    }
+
+    if (best.probes >= original.probes)
+        return;
 
+    m_neededOverrides.insert(file, reordered(bestOrder));
+    std::cout << qPrintable(file->displayName()) << ":";
+    for (const auto &lib : needed)
+        std::cout << " " << lib.constData();
+    std::cout << " ->";
+    for (const auto &lib : m_neededOverrides.value(file))
+        std::cout << " " << lib.constData();
+    std::cout << std::endl << "  probes: " << original.probes << " -> " << best.probes
+              << " (-" << (original.probes - best.probes) << ")"
+              << ", estimated cost: " << original.cost << " -> " << best.cost << std::endl;
+
+    if (!m_dryRun)
+        writeDtNeeded(file, bestOrder);
+}
+
+void DependencySorter::writeDtNeeded(ElfFile* file, const QVector<int>& order) const
+{
     // since we modify the file in-place, get the necessary string table values before we do that
     QVector<uint64_t> neededValues;
-    neededValues.resize(needed.size());
-    int neededIndex = 0;
+    neededValues.reserve(order.size());
     for (uint i = 0; i < file->dynamicSection()->header()->entryCount(); ++i) {
         auto dynEntry = file->dynamicSection()->entry(i);
         if (dynEntry->tag() != DT_NEEDED)
             continue;
-        neededValues[neededIndex++] = dynEntry->value();
+        neededValues.push_back(dynEntry->value());
     }
+    assert(neededValues.size() == order.size());
 
     // open target file
     ElfFile newFile(file->fileName());
@@ -94,17 +197,12 @@ void DependencySorter::sortDtNeeded(ElfFileSet* fileSet)
     }
 
     // write change
-    neededIndex = 0;
+    int neededIndex = 0;
     auto newDynSection = newFile.dynamicSection();
     for (uint i = 0; i < newDynSection->header()->entryCount(); ++i) {
         auto dynEntry = newDynSection->entry(i);
         if (dynEntry->tag() != DT_NEEDED)
             continue;
-
-        dynEntry->setValue(neededValues.at(sortedNeededIndex.at(neededIndex)));
-
-        qDebug() << needed.at(sortedNeededIndex.at(neededIndex));
-        ++neededIndex;
+        dynEntry->setValue(neededValues.at(order.at(neededIndex++)));
     }
-
 }
@@ -18,13 +18,43 @@
 #ifndef DEPENDENCYSORTER_H
 #define DEPENDENCYSORTER_H
 
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+
+#include <cstdint>
+
+class ElfFile;
 class ElfFileSet;
+class LDSimulator;
 
-/** Sorts DT_NEEDED entries of .dynamic by symbol lookup hit probability. */
+/** Sorts DT_NEEDED entries of .dynamic to minimize the symbol lookup work of the dynamic linker.
+ *  Candidate orders are ranked by the number of hash table probes LDSimulator predicts for the
+ *  entire lookup scope. Orders that change the definition any symbol binds to are rejected.
+ */
 class DependencySorter
 {
 public:
+    /** Only report the proposed changes, without modifying any file. */
+    void setDryRun(bool dryRun);
+    /** Reorder the DT_NEEDED entries of all files in the set, not just of the first one. */
+    void setProcessAllFiles(bool allFiles);
+
     void sortDtNeeded(ElfFileSet* fileSet);
+
+private:
+    struct Evaluation {
+        uint64_t probes = 0;
+        double cost = 0.0;
+        bool valid = false;
+    };
+    Evaluation evaluate(ElfFileSet *fileSet, ElfFile *file, const QVector<QByteArray> &needed, const LDSimulator &baseline) const;
+    void sortDtNeeded(ElfFileSet *fileSet, ElfFile *file, const LDSimulator &baseline);
+    void writeDtNeeded(ElfFile *file, const QVector<int> &order) const;
+
+    QHash<ElfFile*, QVector<QByteArray>> m_neededOverrides;
+    bool m_dryRun = false;
+    bool m_allFiles = false;
 };
 
 #endif // DEPENDENCYSORTER_H
@@ -0,0 +1,412 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "gnuhashoptimizer.h"
+
+#include <elf/elfdynamicsection.h>
+#include <elf/elffile.h>
+#include <elf/elfgnuhashsection.h>
+#include <elf/elfheader.h>
+#include <elf/elfsectionheader.h>
+#include <elf/elfsymboltablesection.h>
+#include <elf/elfsysvhashsection.h>
+
+#include <QDebug>
+#include <QVector>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <numeric>
+
+#include <elf.h>
+
+static QVector<uint32_t> symbolHashes(const ElfGnuHashSection *hash)
+{
+    const auto symTab = hash->linkedSection<ElfSymbolTableSection>();
+    assert(symTab);
+    QVector<uint32_t> hashes;
+    hashes.reserve(hash->chainCount());
+    for (auto i = hash->symbolIndex(); i < symTab->header()->entryCount(); ++i)
+        hashes.push_back(ElfGnuHashSection::hash(symTab->entry(i)->name()));
+    return hashes;
+}
+
+static int floorLog2(uint32_t v)
+{
+    int l = 0;
+    while (v >>= 1)
+        ++l;
+    return l;
+}
+
+static uint32_t nextPowerOfTwo(uint32_t v)
+{
+    uint32_t p = 1;
+    while (p < v)
+        p <<= 1;
+    return p;
+}
+
+static QVector<uint64_t> bloomFilter(const QVector<uint32_t> &hashes, const GnuHashOptimizer::Parameters &params, int wordBits)
+{
+    QVector<uint64_t> bloom((int)params.maskWordsCount, 0);
+    for (const auto h : hashes) {
+        const auto n = (h / wordBits) & (params.maskWordsCount - 1);
+        bloom[n] |= (uint64_t)1 << (h % wordBits);
+        bloom[n] |= (uint64_t)1 << ((h >> params.shift2) % wordBits);
+    }
+    return bloom;
+}
+
+static double falsePositiveRate(const QVector<uint64_t> &bloom, int wordBits)
+{
+    // for a random hash value, both bits are set with probability fill^2 of the selected word,
+    // as long as shift2 doesn't overlap with the bits selecting the word
+    double rate = 0.0;
+    for (const auto word : bloom) {
+        const auto fill = (double)__builtin_popcountll(word) / wordBits;
+        rate += fill * fill;
+    }
+    return bloom.isEmpty() ? 1.0 : rate / bloom.size();
+}
+
+static uint64_t sumOfSquaredChainLengths(const QVector<uint32_t> &hashes, uint32_t bucketCount)
+{
+    QVector<uint32_t> lengths((int)bucketCount, 0);
+    for (const auto h : hashes)
+        ++lengths[h % bucketCount];
+    uint64_t sum = 0;
+    for (const auto l : lengths)
+        sum += (uint64_t)l * l;
+    return sum;
+}
+
+GnuHashOptimizer::Parameters GnuHashOptimizer::parameters(const ElfGnuHashSection* hash)
+{
+    Parameters params;
+    params.bucketCount = hash->bucketCount();
+    params.maskWordsCount = hash->maskWordsCount();
+    params.shift2 = hash->shift2();
+    return params;
+}
+
+GnuHashOptimizer::Parameters GnuHashOptimizer::optimalParameters(const ElfGnuHashSection* hash)
+{
+    const auto hashes = symbolHashes(hash);
+    const int wordBits = hash->file()->addressSize() * 8;
+    const uint32_t symbolCount = std::max(1, hashes.size());
+
+    // expected chain length only depends on the load factor, so aim for two symbols per bucket
+    // and pick the bucket count around that with the fewest collisions for this symbol set
+    Parameters params;
+    const auto target = std::max(1u, symbolCount / 2);
+    const auto low = std::max(1u, target * 4 / 5);
+    const auto high = std::max(low, target * 5 / 4);
+    const auto step = std::max(1u, (high - low) / 256);
+    uint64_t bestCollisions = std::numeric_limits<uint64_t>::max();
+    for (auto count = low; count <= high; count += step) {
+        const auto collisions = sumOfSquaredChainLengths(hashes, count);
+        if (collisions < bestCollisions) {
+            bestCollisions = collisions;
+            params.bucketCount = count;
+        }
+    }
+
+    // two bits per symbol, for a false positive rate of about 2%
+    params.maskWordsCount = std::max(1u, nextPowerOfTwo(symbolCount * 12) / wordBits);
+
+    // shift2 must not overlap with the bits used for selecting the word and the first bit
+    const auto minShift = std::min(31, floorLog2(wordBits) + floorLog2(params.maskWordsCount));
+    params.shift2 = minShift;
+    auto bestRate = 2.0;
+    for (int shift = minShift; shift < 32; ++shift) {
+        auto candidate = params;
+        candidate.shift2 = shift;
+        const auto rate = falsePositiveRate(bloomFilter(hashes, candidate, wordBits), wordBits);
+        if (rate < bestRate) {
+            bestRate = rate;
+            params.shift2 = shift;
+        }
+    }
+
+    return params;
+}
+
+GnuHashOptimizer::Quality GnuHashOptimizer::quality(const ElfGnuHashSection* hash, const Parameters& params)
+{
+    const auto hashes = symbolHashes(hash);
+    const int wordBits = hash->file()->addressSize() * 8;
+
+    Quality q;
+    q.size = 4 * sizeof(uint32_t) + (uint64_t)params.maskWordsCount * hash->file()->addressSize()
+           + (uint64_t)params.bucketCount * sizeof(uint32_t) + (uint64_t)hashes.size() * sizeof(uint32_t);
+    if (params.bucketCount == 0 || params.maskWordsCount == 0)
+        return q;
+
+    q.bloomFalsePositiveRate = falsePositiveRate(bloomFilter(hashes, params, wordBits), wordBits);
+
+    QVector<bool> used((int)params.bucketCount, false);
+    for (const auto h : hashes)
+        used[h % params.bucketCount] = true;
+    const auto usedCount = std::count(used.constBegin(), used.constEnd(), true);
+    q.averageChainLength = usedCount > 0 ? (double)hashes.size() / usedCount : 0.0;
+    return q;
+}
+
+// reorders entries [offset, offset + order.size()) of the table at @p data, so that new entry k is old entry offset + order[k]
+static void permute(unsigned char *data, uint64_t entrySize, uint32_t offset, const QVector<uint32_t> &order)
+{
+    const QByteArray copy(reinterpret_cast<const char*>(data + offset * entrySize), order.size() * entrySize);
+    for (int k = 0; k < order.size(); ++k)
+        memcpy(data + (offset + k) * entrySize, copy.constData() + order.at(k) * entrySize, entrySize);
+}
+
+template <typename Rel>
+static void remapRelocations(unsigned char *data, uint64_t count, const QVector<uint32_t> &newIndex, bool is64)
+{
+    auto rel = reinterpret_cast<Rel*>(data);
+    for (uint64_t i = 0; i < count; ++i) {
+        if (is64) {
+            const auto sym = ELF64_R_SYM(rel[i].r_info);
+            if (sym < (uint64_t)newIndex.size())
+                rel[i].r_info = ELF64_R_INFO(newIndex.at(sym), ELF64_R_TYPE(rel[i].r_info));
+        } else {
+            const auto sym = ELF32_R_SYM(rel[i].r_info);
+            if (sym < (uint32_t)newIndex.size())
+                rel[i].r_info = ELF32_R_INFO(newIndex.at(sym), ELF32_R_TYPE(rel[i].r_info));
+        }
+    }
+}
+
+static void rebuildSysvHash(unsigned char *data, const QVector<const char*> &names)
+{
+    auto words = reinterpret_cast<uint32_t*>(data);
+    const auto bucketCount = words[0];
+    const auto chainCount = words[1];
+    auto buckets = words + 2;
+    auto chains = buckets + bucketCount;
+    std::fill(buckets, buckets + bucketCount, STN_UNDEF);
+    std::fill(chains, chains + chainCount, STN_UNDEF);
+    for (uint32_t i = 1; i < std::min<uint32_t>(chainCount, names.size()); ++i) {
+        const auto b = ElfSysvHashSection::hash(names.at(i)) % bucketCount;
+        chains[i] = buckets[b];
+        buckets[b] = i;
+    }
+}
+
+template <typename Word>
+static void writeBloomFilter(unsigned char *data, const QVector<uint64_t> &bloom)
+{
+    auto words = reinterpret_cast<Word*>(data);
+    for (int i = 0; i < bloom.size(); ++i)
+        words[i] = bloom.at(i);
+}
+
+bool GnuHashOptimizer::canReorderSymbols(ElfFile *file)
+{
+    // the MIPS GOT maps to the tail of .dynsym, starting at DT_MIPS_GOTSYM
+    if (file->header()->machine() == EM_MIPS || file->header()->machine() == EM_MIPS_RS3_LE)
+        return false;
+    if (const auto dynamic = file->dynamicSection()) {
+        for (uint i = 0; i < dynamic->header()->entryCount(); ++i) {
+            if (dynamic->entry(i)->tag() == DT_MIPS_GOTSYM)
+                return false;
+        }
+    }
+
+    const auto symTabIndex = file->indexOfSection(SHT_DYNSYM);
+    if (symTabIndex < 0)
+        return false;
+    foreach (const auto shdr, file->sectionHeaders()) {
+        if (shdr->link() != (uint32_t)symTabIndex)
+            continue;
+        switch (shdr->type()) {
+            case SHT_GNU_HASH:
+            case SHT_GNU_versym:
+            case SHT_SYMTAB_SHNDX:
+            case SHT_REL:
+            case SHT_RELA:
+            case SHT_HASH:
+                break;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+bool GnuHashOptimizer::rebuild(const QString& fileName, const Parameters& params)
+{
+    if (params.bucketCount == 0 || params.maskWordsCount == 0 || (params.maskWordsCount & (params.maskWordsCount - 1)) != 0)
+        return false;
+
+    ElfFile file(fileName);
+    if (!file.open(QFile::ReadWrite) || !file.isValid()) {
+        qWarning() << "Can't open" << fileName << "for writing.";
+        return false;
+    }
+
+    const auto hashIndex = file.indexOfSection(SHT_GNU_HASH);
+    if (hashIndex < 0)
+        return false;
+    const auto gnuHash = file.section<ElfGnuHashSection>(hashIndex);
+    const auto symTab = gnuHash->linkedSection<ElfSymbolTableSection>();
+    if (!symTab || !canReorderSymbols(&file))
+        return false;
+    if (quality(gnuHash, params).size > gnuHash->header()->size())
+        return false;
+
+    const auto symOffset = gnuHash->symbolIndex();
+    const auto symCount = (uint32_t)symTab->header()->entryCount();
+    const auto hashes = symbolHashes(gnuHash);
+    QVector<const char*> names((int)symCount);
+    for (uint32_t i = 0; i < symCount; ++i)
+        names[i] = symTab->entry(i)->name(); // .dynstr isn't modified, so these stay valid
+    const auto bloom = bloomFilter(hashes, params, file.addressSize() * 8);
+
+    // symbols need to be grouped by bucket, keep their relative order otherwise
+    QVector<uint32_t> order(hashes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&hashes, &params](uint32_t lhs, uint32_t rhs) {
+        return hashes.at(lhs) % params.bucketCount < hashes.at(rhs) % params.bucketCount;
+    });
+    QVector<uint32_t> newIndex((int)symCount);
+    std::iota(newIndex.begin(), newIndex.end(), 0);
+    QVector<const char*> newNames = names;
+    for (int k = 0; k < order.size(); ++k) {
+        newIndex[symOffset + order.at(k)] = symOffset + k;
+        newNames[symOffset + k] = names.at(symOffset + order.at(k));
+    }
+
+    // update .dynsym and everything indexing it
+    const auto symTabIndex = symTab->header()->sectionIndex();
+    permute(symTab->rawData(), symTab->header()->entrySize(), symOffset, order);
+    const auto is64 = file.type() == ELFCLASS64;
+    foreach (const auto shdr, file.sectionHeaders()) {
+        if (shdr->link() != symTabIndex)
+            continue;
+        const auto section = file.section<ElfSection>(shdr->sectionIndex());
+        switch (shdr->type()) {
+            case SHT_GNU_versym:
+                if (shdr->size() >= symCount * sizeof(uint16_t))
+                    permute(section->rawData(), sizeof(uint16_t), symOffset, order);
+                break;
+            case SHT_SYMTAB_SHNDX:
+                if (shdr->size() >= symCount * sizeof(uint32_t))
+                    permute(section->rawData(), sizeof(uint32_t), symOffset, order);
+                break;
+            case SHT_REL:
+                if (is64)
+                    remapRelocations<Elf64_Rel>(section->rawData(), shdr->size() / sizeof(Elf64_Rel), newIndex, is64);
+                else
+                    remapRelocations<Elf32_Rel>(section->rawData(), shdr->size() / sizeof(Elf32_Rel), newIndex, is64);
+                break;
+            case SHT_RELA:
+                if (is64)
+                    remapRelocations<Elf64_Rela>(section->rawData(), shdr->size() / sizeof(Elf64_Rela), newIndex, is64);
+                else
+                    remapRelocations<Elf32_Rela>(section->rawData(), shdr->size() / sizeof(Elf32_Rela), newIndex, is64);
+                break;
+            case SHT_HASH:
+                rebuildSysvHash(section->rawData(), newNames);
+                break;
+        }
+    }
+
+    // write the new .gnu.hash, zero-padded to the old size
+    auto data = gnuHash->rawData();
+    memset(data, 0, gnuHash->header()->size());
+    auto header = reinterpret_cast<uint32_t*>(data);
+    header[0] = params.bucketCount;
+    header[1] = symOffset;
+    header[2] = params.maskWordsCount;
+    header[3] = params.shift2;
+    data += 4 * sizeof(uint32_t);
+    if (is64)
+        writeBloomFilter<uint64_t>(data, bloom);
+    else
+        writeBloomFilter<uint32_t>(data, bloom);
+    data += params.maskWordsCount * file.addressSize();
+
+    auto buckets = reinterpret_cast<uint32_t*>(data);
+    auto chain = buckets + params.bucketCount;
+    for (int k = order.size() - 1; k >= 0; --k) {
+        const auto h = hashes.at(order.at(k));
+        const auto b = h % params.bucketCount;
+        const auto isLast = k + 1 == order.size() || hashes.at(order.at(k + 1)) % params.bucketCount != b;
+        chain[k] = isLast ? (h | 1) : (h & ~1u);
+        buckets[b] = symOffset + k;
+    }
+
+    return true;
+}
+
+void GnuHashOptimizer::setDryRun(bool dryRun)
+{
+    m_dryRun = dryRun;
+}
+
+static void printQuality(const char *label, const GnuHashOptimizer::Parameters &params, const GnuHashOptimizer::Quality &q)
+{
+    std::cout << "  " << label << ": " << params.bucketCount << " buckets, " << params.maskWordsCount << " bloom words, shift2 "
+              << params.shift2 << ", " << q.size << " bytes, bloom false positive rate " << q.bloomFalsePositiveRate * 100.0
+              << "%, average chain length " << q.averageChainLength << std::endl;
+}
+
+void GnuHashOptimizer::optimize(const QString& fileName)
+{
+    GnuHashOptimizer::Parameters optimal;
+    bool fits = false;
+    {
+        ElfFile file(fileName);
+        if (!file.open(QFile::ReadOnly) || !file.isValid())
+            return;
+        std::cout << qPrintable(file.displayName()) << ":" << std::endl;
+        const auto hashIndex = file.indexOfSection(SHT_GNU_HASH);
+        if (hashIndex < 0) {
+            std::cout << "  no .gnu.hash section" << std::endl;
+            return;
+        }
+        const auto gnuHash = file.section<ElfGnuHashSection>(hashIndex);
+        if (!gnuHash->linkedSection<ElfSymbolTableSection>() || gnuHash->chainCount() == 0)
+            return;
+
+        const auto current = parameters(gnuHash);
+        printQuality("current", current, quality(gnuHash, current));
+        optimal = optimalParameters(gnuHash);
+        const auto q = quality(gnuHash, optimal);
+        printQuality("optimal", optimal, q);
+        if (!canReorderSymbols(&file)) {
+            std::cout << "  .dynsym order is part of the ABI of this file, can't rebuild" << std::endl;
+            return;
+        }
+
+        fits = q.size <= gnuHash->header()->size();
+        if (!fits)
+            std::cout << "  new table needs " << q.size << " bytes, only " << gnuHash->header()->size() << " available" << std::endl;
+    }
+
+    if (!fits || m_dryRun)
+        return;
+    if (rebuild(fileName, optimal))
+        std::cout << "  .gnu.hash rebuilt" << std::endl;
+    else
+        std::cout << "  failed to rebuild .gnu.hash" << std::endl;
+}
@@ -0,0 +1,75 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef GNUHASHOPTIMIZER_H
+#define GNUHASHOPTIMIZER_H
+
+#include <QString>
+
+#include <cstdint>
+
+class ElfFile;
+class ElfGnuHashSection;
+
+/** Rebuilds the .gnu.hash section of a file with better bucket count and bloom filter parameters.
+ *  As symbols have to be ordered by bucket, this also reorders the hashed part of .dynsym and
+ *  updates everything referring to it (.gnu.version, .hash and relocations) in place.
+ */
+class GnuHashOptimizer
+{
+public:
+    struct Parameters {
+        uint32_t bucketCount = 0;
+        uint32_t maskWordsCount = 0;
+        uint32_t shift2 = 0;
+    };
+    /** Expected quality of a hash table for a given symbol set. */
+    struct Quality {
+        double bloomFalsePositiveRate = 0.0; ///< for symbols not in the table
+        double averageChainLength = 0.0; ///< of non-empty buckets
+        uint64_t size = 0; ///< in bytes
+    };
+
+    /** Parameters currently used by @p hash. */
+    static Parameters parameters(const ElfGnuHashSection *hash);
+    /** Parameters for the symbols in @p hash, aiming at two symbols per bucket and a bloom filter
+     *  of at least 12 bits per symbol, with bucket count and shift2 picked to minimize collisions.
+     */
+    static Parameters optimalParameters(const ElfGnuHashSection *hash);
+    /** Quality of a table for the symbols in @p hash built with @p params. */
+    static Quality quality(const ElfGnuHashSection *hash, const Parameters &params);
+
+    /** Returns @c false if the .dynsym order of @p file is part of its ABI, such as the GOT mapping
+     *  on MIPS, or if it has sections indexing .dynsym that we don't know how to update.
+     */
+    static bool canReorderSymbols(ElfFile *file);
+    /** Rewrites .gnu.hash of @p fileName in place using @p params.
+     *  Returns @c false if the file can't be written, its symbols can't be reordered
+     *  or the new table doesn't fit.
+     */
+    static bool rebuild(const QString &fileName, const Parameters &params);
+
+    /** Only report, don't modify any file. */
+    void setDryRun(bool dryRun);
+    /** Rebuild .gnu.hash of @p fileName with optimal parameters if possible, and print a quality report. */
+    void optimize(const QString &fileName);
+
+private:
+    bool m_dryRun = false;
+};
+
+#endif // GNUHASHOPTIMIZER_H
@@ -0,0 +1,336 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "config-elf-dissector.h"
+#include "searchindex.h"
+
+#include <demangle/demangler.h>
+#include <elf/elffile.h>
+#include <elf/elffileset.h>
+#include <elf/elfsymboltablesection.h>
+#include <elf/elfsymboltableentry.h>
+
+#if HAVE_DWARF
+#include <dwarf/dwarfcudie.h>
+#include <dwarf/dwarfinfo.h>
+#endif
+
+#include <QRegularExpression>
+#include <QSet>
+#include <QThread>
+
+#include <algorithm>
+#include <cctype>
+#include <numeric>
+
+static uint32_t trigram(const char *s)
+{
+    return (uint32_t)(uint8_t)tolower(s[0]) << 16 | (uint32_t)(uint8_t)tolower(s[1]) << 8 | (uint8_t)tolower(s[2]);
+}
+
+static int indexOfCaseInsensitive(const char *text, int size, const QByteArray &needle)
+{
+    for (int i = 0; i + needle.size() <= size; ++i) {
+        if (qstrnicmp(text + i, needle.constData(), needle.size()) == 0)
+            return i;
+    }
+    return -1;
+}
+
+// checking for interruption is too costly to do for every single entry
+static bool isInterruptionRequested(int i)
+{
+    return (i & 0x3ff) == 0 && QThread::currentThread()->isInterruptionRequested();
+}
+
+// lower is better: exact match, prefix, start of a name component, anywhere else, shorter names first
+static int rankMatch(const char *text, int size, int pos, int length)
+{
+    int rank = 3;
+    if (pos == 0 && length == size)
+        rank = 0;
+    else if (pos == 0)
+        rank = 1;
+    else if (!isalnum(text[pos - 1]) && text[pos - 1] != '_')
+        rank = 2;
+    return (rank << 24) | std::min(size, 0xffffff);
+}
+
+// literal strings any match of @p pattern has to contain, empty if that can't be determined
+// groups are skipped entirely, as they might be optional or contain alternatives
+static QVector<QByteArray> requiredLiterals(const QString &pattern)
+{
+    QVector<QByteArray> literals;
+    QByteArray current;
+    const auto flush = [&]() {
+        if (current.size() >= 3)
+            literals.push_back(current);
+        current.clear();
+    };
+
+    const auto p = pattern.toUtf8();
+    int depth = 0;
+    for (int i = 0; i < p.size(); ++i) {
+        const char c = p.at(i);
+        switch (c) {
+            case '|':
+                if (depth == 0)
+                    return {};
+                break;
+            case '\\':
+                if (depth == 0 && i + 1 < p.size() && !isalnum(static_cast<unsigned char>(p.at(i + 1)))) {
+                    current.push_back(p.at(++i));
+                } else {
+                    ++i;
+                    flush();
+                }
+                break;
+            case '*':
+            case '?':
+            case '{':
+                // the previous character is optional, that might be a multi-byte UTF-8 sequence
+                while (!current.isEmpty() && (current.at(current.size() - 1) & 0xc0) == 0x80)
+                    current.chop(1);
+                if (!current.isEmpty())
+                    current.chop(1);
+                flush();
+                if (c == '{') {
+                    while (i < p.size() && p.at(i) != '}')
+                        ++i;
+                }
+                break;
+            case '[':
+                flush();
+                while (i < p.size() && p.at(i) != ']')
+                    ++i;
+                break;
+            case '(':
+                flush();
+                ++depth;
+                break;
+            case ')':
+                flush();
+                --depth;
+                break;
+            case '+':
+            case '.':
+            case '^':
+            case '$':
+                flush();
+                break;
+            default:
+                if (depth == 0)
+                    current.push_back(c);
+        }
+    }
+    flush();
+    return literals;
+}
+
+SearchIndex::SearchIndex() = default;
+SearchIndex::~SearchIndex() = default;
+
+void SearchIndex::addFileSet(const ElfFileSet *fileSet)
+{
+    for (int i = 0; i < fileSet->size(); ++i) {
+        if (QThread::currentThread()->isInterruptionRequested())
+            return;
+        addFile(fileSet->file(i));
+    }
+}
+
+void SearchIndex::addFile(ElfFile *file)
+{
+    addEntry(File, file, file->displayName().toUtf8());
+    if (file->dynamicSection())
+        addEntry(File, file, file->dynamicSection()->soName());
+
+    for (int i = 0; i < file->sectionCount(); ++i) {
+        const auto section = file->section<ElfSection>(i);
+        if (!section)
+            continue;
+        addEntry(Section, section, section->header()->name(), qstrlen(section->header()->name()));
+
+        const auto symtab = file->section<ElfSymbolTableSection>(i);
+        if (!symtab)
+            continue;
+        const auto demangledNames = Demangler::demangleAll(symtab);
+        for (uint32_t j = 0; j < symtab->header()->entryCount(); ++j) {
+            const auto entry = symtab->entry(j);
+            const auto name = entry->name();
+            const auto nameSize = qstrlen(name);
+            addEntry(Symbol, entry, name, nameSize);
+            const auto demangledName = demangledNames.fullName(j);
+            if (demangledName.size() != (int)nameSize || qstrncmp(demangledName.constData(), name, nameSize) != 0)
+                addEntry(Symbol, entry, demangledName);
+        }
+    }
+
+#if HAVE_DWARF
+    if (file->dwarfInfo() && !file->isSeparateDebugFile()) {
+        foreach (const auto cu, file->dwarfInfo()->compilationUnits()) {
+            if (QThread::currentThread()->isInterruptionRequested())
+                return;
+            addDwarfDie(cu);
+        }
+    }
+#endif
+}
+
+#if HAVE_DWARF
+void SearchIndex::addDwarfDie(::DwarfDie *die)
+{
+    addEntry(DwarfDie, die, die->name());
+    foreach (const auto child, die->children())
+        addDwarfDie(child);
+}
+#endif
+
+void SearchIndex::addEntry(Type type, void *payload, const QByteArray &text)
+{
+    addEntry(type, payload, text.constData(), text.size());
+}
+
+void SearchIndex::addEntry(Type type, void *payload, const char *text, int size)
+{
+    if (size <= 0)
+        return;
+
+    const int entryIdx = m_entries.size();
+    m_entries.push_back({ (uint32_t)m_pool.size(), (uint32_t)size, type, payload });
+    m_pool.append(text, size);
+
+    for (int i = 0; i + 3 <= size; ++i) {
+        auto &postings = m_trigrams[trigram(text + i)];
+        if (postings.isEmpty() || postings.last() != entryIdx)
+            postings.push_back(entryIdx);
+    }
+}
+
+int SearchIndex::size() const
+{
+    return m_entries.size();
+}
+
+QVector<int> SearchIndex::candidates(const QVector<QByteArray> &literals, bool *indexed) const
+{
+    *indexed = true;
+    QVector<const QVector<int>*> postings;
+    for (const auto &literal : literals) {
+        for (int i = 0; i + 3 <= literal.size(); ++i) {
+            const auto it = m_trigrams.constFind(trigram(literal.constData() + i));
+            if (it == m_trigrams.constEnd())
+                return {};
+            postings.push_back(&it.value());
+        }
+    }
+
+    QVector<int> result;
+    if (postings.isEmpty()) {
+        *indexed = false;
+        result.resize(m_entries.size());
+        std::iota(result.begin(), result.end(), 0);
+        return result;
+    }
+
+    std::sort(postings.begin(), postings.end(), [](const QVector<int> *lhs, const QVector<int> *rhs) {
+        return lhs->size() < rhs->size();
+    });
+    result = *postings.at(0);
+    QVector<int> tmp;
+    for (int i = 1; i < postings.size() && !result.isEmpty(); ++i) {
+        tmp.clear();
+        std::set_intersection(result.constBegin(), result.constEnd(), postings.at(i)->constBegin(), postings.at(i)->constEnd(), std::back_inserter(tmp));
+        std::swap(result, tmp);
+    }
+    return result;
+}
+
+QVector<SearchIndex::Hit> SearchIndex::find(const QByteArray &text, int maxHits) const
+{
+    if (text.isEmpty())
+        return {};
+
+    bool indexed = false;
+    const auto entries = candidates({ text }, &indexed);
+    QVector<Match> matches;
+    for (int i = 0; i < entries.size(); ++i) {
+        if (isInterruptionRequested(i))
+            return {};
+        if (!indexed && maxHits >= 0 && matches.size() >= maxHits)
+            break;
+        const auto &entry = m_entries.at(entries.at(i));
+        const auto s = m_pool.constData() + entry.offset;
+        const auto pos = indexOfCaseInsensitive(s, entry.size, text);
+        if (pos >= 0)
+            matches.push_back({ entries.at(i), rankMatch(s, entry.size, pos, text.size()) });
+    }
+    return rankedHits(matches, maxHits);
+}
+
+QVector<SearchIndex::Hit> SearchIndex::find(const QRegularExpression &regExp, int maxHits) const
+{
+    if (!regExp.isValid() || regExp.pattern().isEmpty())
+        return {};
+
+    bool indexed = false;
+    const auto entries = candidates(requiredLiterals(regExp.pattern()), &indexed);
+    QVector<Match> matches;
+    for (int i = 0; i < entries.size(); ++i) {
+        if (isInterruptionRequested(i))
+            return {};
+        if (!indexed && maxHits >= 0 && matches.size() >= maxHits)
+            break;
+        const auto &entry = m_entries.at(entries.at(i));
+        const auto s = m_pool.constData() + entry.offset;
+        const auto str = QString::fromUtf8(s, entry.size);
+        const auto match = regExp.match(str);
+        if (!match.hasMatch())
+            continue;
+
+        // rank in bytes like the substring search, the match positions are in UTF-16 code units
+        auto pos = match.capturedStart();
+        auto length = match.capturedLength();
+        if (str.size() != (int)entry.size) {
+            pos = str.left(pos).toUtf8().size();
+            length = match.captured().toUtf8().size();
+        }
+        matches.push_back({ entries.at(i), rankMatch(s, entry.size, pos, length) });
+    }
+    return rankedHits(matches, maxHits);
+}
+
+QVector<SearchIndex::Hit> SearchIndex::rankedHits(QVector<Match> &matches, int maxHits) const
+{
+    std::stable_sort(matches.begin(), matches.end(), [](const Match &lhs, const Match &rhs) {
+        return lhs.rank < rhs.rank;
+    });
+
+    // mangled and demangled names point to the same symbol, only report it once
+    QVector<Hit> hits;
+    QSet<void*> seen;
+    for (const auto &match : matches) {
+        if (maxHits >= 0 && hits.size() >= maxHits)
+            break;
+        const auto &entry = m_entries.at(match.entry);
+        if (seen.contains(entry.payload))
+            continue;
+        seen.insert(entry.payload);
+        hits.push_back({ entry.type, entry.payload, QByteArray(m_pool.constData() + entry.offset, entry.size) });
+    }
+    return hits;
+}
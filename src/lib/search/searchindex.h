@@ -0,0 +1,105 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+
+#include <cstdint>
+
+class DwarfDie;
+class ElfFile;
+class ElfFileSet;
+class QRegularExpression;
+
+/** Trigram index over the names found in a set of ELF files.
+ *  Covers file names and SONAMEs, section names, mangled and demangled symbol
+ *  names as well as DWARF DIE names, and answers case-insensitive substring and
+ *  regular expression queries without touching the files again.
+ */
+class SearchIndex
+{
+public:
+    enum Type : uint8_t {
+        File,
+        Section,
+        Symbol,
+        DwarfDie
+    };
+
+    /** A search result, pointing to an ElfFile, ElfSection, ElfSymbolTableEntry or DwarfDie. */
+    struct Hit {
+        Type type;
+        void *payload;
+        QByteArray text;
+    };
+
+    SearchIndex();
+    SearchIndex(const SearchIndex&) = delete;
+    ~SearchIndex();
+    SearchIndex& operator=(const SearchIndex&) = delete;
+
+    /** Adds all names found in the files of @p fileSet.
+     *  Can be called from a background thread, stops early if interruption of that thread is requested.
+     */
+    void addFileSet(const ElfFileSet *fileSet);
+    /** Adds all names found in @p file. */
+    void addFile(ElfFile *file);
+
+    /** Number of indexed names. */
+    int size() const;
+
+    /** Case-insensitive substring search, best matches first.
+     *  Returns at most @p maxHits results, or all if @p maxHits is negative.
+     *  Queries shorter than three characters can't use the trigram index, for those
+     *  the search stops after @p maxHits matches rather than ranking all names.
+     *  Can be called from a background thread, returns nothing if interruption of that thread is requested.
+     */
+    QVector<Hit> find(const QByteArray &text, int maxHits = -1) const;
+    /** Regular expression search, best matches first.
+     *  Same as the above, patterns without a literal of at least three characters can't use the index.
+     */
+    QVector<Hit> find(const QRegularExpression &regExp, int maxHits = -1) const;
+
+private:
+    struct Entry {
+        uint32_t offset;
+        uint32_t size;
+        Type type;
+        void *payload;
+    };
+    struct Match {
+        int entry;
+        int rank;
+    };
+
+    void addEntry(Type type, void *payload, const char *text, int size);
+    void addEntry(Type type, void *payload, const QByteArray &text);
+    void addDwarfDie(::DwarfDie *die);
+    /** Entries containing all trigrams of @p literals, or all entries if there are none, @p indexed tells which one. */
+    QVector<int> candidates(const QVector<QByteArray> &literals, bool *indexed) const;
+    QVector<Hit> rankedHits(QVector<Match> &matches, int maxHits) const;
+
+    QByteArray m_pool;
+    QVector<Entry> m_entries;
+    QHash<uint32_t, QVector<int>> m_trigrams;
+};
+
+#endif // SEARCHINDEX_H
@@ -40,10 +40,16 @@ void UsedSymbolModel::setFiles(ElfFile* user, ElfFile* provider)
     const auto endReset = std::unique_ptr<UsedSymbolModel, decltype(l)>(this, l);
 
     m_entries.clear();
+    m_demangledNames = {};
     if (!user || !provider)
         return;
 
     m_entries = DependenciesCheck::usedSymbols(user, provider);
+    QVector<const char*> names;
+    names.reserve(m_entries.size());
+    for (const auto entry : m_entries)
+        names.push_back(entry->name());
+    m_demangledNames = Demangler::demangleAll(names);
 }
 
 QVariant UsedSymbolModel::data(const QModelIndex& index, int role) const
@@ -53,7 +59,8 @@ QVariant UsedSymbolModel::data(const QModelIndex& index, int role) const
 
     switch (role) {
         case Qt::DisplayRole:
-            return Demangler::demangleFull(m_entries.at(index.row())->name());
+            // deep copy, the name table is gone on the next reset
+            return QString::fromUtf8(m_demangledNames.fullName(index.row()));
             break;
     }
 
@@ -18,6 +18,8 @@
 #ifndef USEDSYMBOLMODEL_H
 #define USEDSYMBOLMODEL_H
 
+#include <demangle/demanglednametable.h>
+
 #include <QAbstractListModel>
 #include <QVector>
 
@@ -39,6 +41,7 @@ public:
 
 private:
     QVector<ElfSymbolTableEntry*> m_entries;
+    DemangledNameTable m_demangledNames;
 };
 
 #endif // USEDSYMBOLMODEL_H
@@ -20,6 +20,7 @@
 
 #include <elf/elffile.h>
 #include <elf/elfnoteentry.h>
+#include <elf/elfrelocationsimulator.h>
 #include <elf/elfgnusymbolversiontable.h>
 #include <elf/elfgnusymbolversiondefinitionssection.h>
 #include <elf/elfgnusymbolversiondefinitionauxiliaryentry.h>
@@ -29,10 +30,11 @@
 #include <elf.h>
 
 #if HAVE_DWARF
-#include <dwarf/dwarfaddressranges.h>
+#include <dwarf/dwarfaddressindex.h>
 #endif
 
 #include <disassmbler/disassembler.h>
+#include <demangle/demanglecache.h>
 #include <demangle/demangler.h>
 #include <checks/structurepackingcheck.h>
 #include <navigator/codenavigatorprinter.h>
@@ -207,11 +209,8 @@ QVariant DataVisitor::doVisit(ElfSection* section, int arg) const
                             s += QLatin1Char(' ') + printSymbolName(ref);
                     } else { // check for relocation
                         const auto relocEntry = section->file()->reverseRelocator()->find(section->header()->virtualAddress() + i * addrSize);
-                        if (relocEntry) {
-                            const auto sym = section->file()->symbolTable()->entryContainingValue(relocEntry->relocationTarget());
-                            if (sym)
-                                s += " relocated to: " + printSymbolName(sym);
-                        }
+                        if (relocEntry)
+                            s += printRelocatedValue(section->file(), relocEntry->offset());
                     }
 
                     s += QLatin1String("<br/>");
@@ -308,9 +307,7 @@ static DwarfDie* findDwarfDie(ElfSymbolTableEntry *entry)
     if (!dwarf || entry->value() == 0)
         return nullptr;
 
-    DwarfDie* res = nullptr;
-    if (dwarf->addressRanges()->isValid())
-       res = dwarf->addressRanges()->dieForAddress(entry->value());
+    auto res = dwarf->addressIndex()->subprogramForAddress(entry->value());
     if (!res)
         res = dwarf->dieForMangledSymbol(entry->name());
     return res;
@@ -330,8 +327,7 @@ QVariant DataVisitor::doVisit(ElfSymbolTableEntry* entry, int arg) const
         {
             QString s(QStringLiteral("<b>Symbol</b><br/>"));
             s += QLatin1String("Mangled name: ") + entry->name() + "<br/>";
-            Demangler demangler;
-            s += QLatin1String("Demangled name: ") + QString(demangler.demangleFull(entry->name())).toHtmlEscaped() + "<br/>";
+            s += QLatin1String("Demangled name: ") + QString(entry->symbolTable()->file()->demangleCache()->demangleFull(entry->name())).toHtmlEscaped() + "<br/>";
             s += QLatin1String("Size: ") + QString::number(entry->size()) + "<br/>";
             s += QLatin1String("Value: 0x") + QString::number(entry->value(), 16) + "<br/>";
             s += QLatin1String("Bind type: ") + SymbolPrinter::bindType(entry->bindType()) + "<br/>";
@@ -363,13 +359,14 @@ QVariant DataVisitor::doVisit(ElfSymbolTableEntry* entry, int arg) const
                             s += QString::number(i) + ": 0x" + QString::number(v, 16);
                             const auto ref = entry->symbolTable()->entryWithValue(v);
                             if (ref) {
-                                s += QLatin1Char(' ') + printSymbolName(ref) + QLatin1String(" (") + Demangler::demangleFull(ref->name()) + QLatin1Char(')');
+                                s += QLatin1Char(' ') + printSymbolName(ref) + QLatin1String(" (") + ref->symbolTable()->file()->demangleCache()->demangleFull(ref->name()) + QLatin1Char(')');
                             } else {
                                 auto reloc = entry->symbolTable()->file()->reverseRelocator()->find(entry->value() + i * addrSize);
                                 if (reloc) {
                                     const auto relocSym = reloc->symbol();
                                     if (relocSym)
                                         s += QLatin1String(" relocation: ") + printSymbolName(relocSym);
+                                    s += printRelocatedValue(entry->symbolTable()->file(), reloc->offset());
                                 }
                             }
                             s += QLatin1String("<br/>");
@@ -380,16 +377,23 @@ QVariant DataVisitor::doVisit(ElfSymbolTableEntry* entry, int arg) const
                     case Demangler::SymbolType::VTT:
                     {
                         s += QLatin1String("VTT:<br/><tt>");
+                        const auto file = entry->symbolTable()->file();
                         for (uint i = 0; i < entry->size() / addrSize; ++i) {
                             const uint64_t v = virtualTableEntry(entry, i);
                             s += QString::number(i) + ": 0x" + QString::number(v, 16);
+                            // position independent code has these as relative relocations only
+                            const auto reloc = file->reverseRelocator()->find(entry->value() + i * addrSize);
+                            if (reloc) {
+                                s += printRelocatedValue(file, reloc->offset()) + QLatin1String("<br/>");
+                                continue;
+                            }
                             // vptrs point to one after the RTTI entry, which is the first virtual method, unless there is none in that
                             // case we would point past the vtable here, and thus we wont find it, so better look for the RTTI spot.
                             const auto ref = entry->symbolTable()->entryContainingValue(v - addrSize);
                             if (ref) {
                                 const auto offset = v - ref->value();
                                 s += QLatin1String(" entry ") + QString::number(offset / addrSize) + QLatin1String(" in ") + printSymbolName(ref);
-                                s += QLatin1String(" (") + Demangler::demangleFull(ref->name()) + QLatin1Char(')');
+                                s += QLatin1String(" (") + ref->symbolTable()->file()->demangleCache()->demangleFull(ref->name()) + QLatin1Char(')');
                             }
                             s += QLatin1String("<br/>");
                         }
@@ -752,6 +756,29 @@ QString DataVisitor::printSymbolName(ElfSymbolTableEntry* symbol) const
     return s;
 }
 
+QString DataVisitor::printRelocatedValue(ElfFile* file, uint64_t vaddr) const
+{
+    const auto sim = m_model->relocationSimulator();
+    bool ok = false;
+    const auto value = sim->pointerValue(file, vaddr, &ok);
+    if (!ok)
+        return QString();
+
+    QString s = QLatin1String(" relocated to: 0x") + QString::number(value, 16);
+    const auto sym = sim->symbolForAddress(value);
+    if (!sym)
+        return s;
+
+    const auto symFile = sym->symbolTable()->file();
+    const auto offset = value - sim->baseAddress(symFile) - sym->value();
+    s += QLatin1Char(' ') + printSymbolName(sym);
+    if (offset)
+        s += QLatin1String(" + ") + QString::number(offset);
+    if (symFile != file)
+        s += QLatin1String(" in ") + symFile->displayName();
+    return s;
+}
+
 QString DataVisitor::printRelocation(ElfRelocationEntry* entry) const
 {
     QString s;
@@ -776,7 +803,7 @@ QString DataVisitor::printRelocation(ElfRelocationEntry* entry) const
     const auto sourceSym = entry->symbol();
     if (sourceSym) {
         s += QLatin1String("Symbol: ") + printSymbolName(sourceSym) + "<br/>";
-        s += QLatin1String("Demangled symbol: ") + QString(Demangler::demangleFull(sourceSym->name())).toHtmlEscaped() + "<br/>";
+        s += QLatin1String("Demangled symbol: ") + QString(sourceSym->symbolTable()->file()->demangleCache()->demangleFull(sourceSym->name())).toHtmlEscaped() + "<br/>";
     } else {
         s += QStringLiteral("Symbol: &lt;none&gt;<br/>");
     }
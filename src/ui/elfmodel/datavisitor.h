@@ -56,6 +56,7 @@ private:
     QString printSectionName(ElfSection *section) const;
     QString printSymbolName(ElfSymbolTableEntry *symbol) const;
     QString printRelocation(ElfRelocationEntry *entry) const;
+    QString printRelocatedValue(ElfFile *file, uint64_t vaddr) const;
 #if HAVE_DWARF
     QString printDwarfDie(DwarfDie* die) const;
     QString printDwarfDieName(DwarfDie* die) const;
@@ -20,6 +20,7 @@
 #include <elf/elffile.h>
 #include <elf/elfheader.h>
 #include <elf/elfgotentry.h>
+#include <elf/elfrelocationsimulator.h>
 
 #include "rowcountvisitor.h"
 #include "indexvisitor.h"
@@ -46,6 +47,7 @@ void ElfModel::setFileSet(ElfFileSet *fileSet)
 {
     beginResetModel();
     clearInternalPointerMap();
+    m_relocSimulator.reset();
     m_fileSet = fileSet;
 
     auto v = new ElfNodeVariant;
@@ -56,6 +58,13 @@ void ElfModel::setFileSet(ElfFileSet *fileSet)
     endResetModel();
 }
 
+ElfRelocationSimulator* ElfModel::relocationSimulator() const
+{
+    if (!m_relocSimulator && m_fileSet)
+        m_relocSimulator.reset(new ElfRelocationSimulator(m_fileSet));
+    return m_relocSimulator.get();
+}
+
 void ElfModel::clearInternalPointerMap()
 {
     for (auto it = m_internalPointerMap.cbegin(); it != m_internalPointerMap.cend(); ++it)
@@ -138,6 +147,11 @@ QVariant ElfModel::headerData(int section, Qt::Orientation orientation, int role
     return QAbstractItemModel::headerData(section, orientation, role);
 }
 
+QModelIndex ElfModel::indexForNode(ElfFile* file) const
+{
+    return indexForNode(file, ElfNodeVariant::File);
+}
+
 QModelIndex ElfModel::indexForNode(ElfSection* section) const
 {
     return indexForNode(section, ElfNodeVariant::Section);
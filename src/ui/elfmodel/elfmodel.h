@@ -22,7 +22,11 @@
 
 #include <QAbstractItemModel>
 
+#include <memory>
+
+class ElfFile;
 class ElfFileSet;
+class ElfRelocationSimulator;
 class ElfSection;
 class ElfSymbolTableEntry;
 class ElfGotEntry;
@@ -50,6 +54,8 @@ public:
 
     ElfFileSet* fileSet() const;
     void setFileSet(ElfFileSet* fileSet);
+    /** Relocation simulator for the current file set, created on first use. */
+    ElfRelocationSimulator* relocationSimulator() const;
 
     QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
     int columnCount(const QModelIndex& parent = QModelIndex()) const override;
@@ -58,6 +64,7 @@ public:
     QModelIndex index(int row, int column, const QModelIndex& parent) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
 
+    QModelIndex indexForNode(ElfFile* file) const;
     QModelIndex indexForNode(ElfSection* section) const;
     QModelIndex indexForNode(ElfSymbolTableEntry* symbol) const;
     QModelIndex indexForNode(ElfGotEntry *entry) const;
@@ -80,6 +87,7 @@ private:
 private:
     ElfFileSet *m_fileSet = nullptr;
     mutable QHash<void*, ElfNodeVariant*> m_internalPointerMap;
+    mutable std::unique_ptr<ElfRelocationSimulator> m_relocSimulator;
 
 };
 
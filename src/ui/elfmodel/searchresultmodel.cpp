@@ -0,0 +1,143 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "config-elf-dissector.h"
+#include "searchresultmodel.h"
+#include "elfmodel.h"
+
+#include <elf/elffile.h>
+#include <elf/elfsymboltableentry.h>
+#include <elf/elfsymboltablesection.h>
+
+#if HAVE_DWARF
+#include <dwarf/dwarfdie.h>
+#include <dwarf/dwarfinfo.h>
+#endif
+
+#include <QUrl>
+
+static const int BatchSize = 256;
+
+SearchResultModel::SearchResultModel(QObject *parent) : QAbstractListModel(parent)
+{
+}
+
+SearchResultModel::~SearchResultModel() = default;
+
+void SearchResultModel::setElfModel(ElfModel *model)
+{
+    m_elfModel = model;
+}
+
+void SearchResultModel::setHits(const QVector<SearchIndex::Hit> &hits)
+{
+    beginResetModel();
+    m_hits = hits;
+    m_rowCount = std::min(BatchSize, m_hits.size());
+    endResetModel();
+}
+
+static ElfFile* fileForHit(const SearchIndex::Hit &hit)
+{
+    switch (hit.type) {
+        case SearchIndex::File:
+            return static_cast<ElfFile*>(hit.payload);
+        case SearchIndex::Section:
+            return static_cast<ElfSection*>(hit.payload)->file();
+        case SearchIndex::Symbol:
+            return static_cast<ElfSymbolTableEntry*>(hit.payload)->symbolTable()->file();
+        case SearchIndex::DwarfDie:
+#if HAVE_DWARF
+            return static_cast<DwarfDie*>(hit.payload)->dwarfInfo()->elfFile();
+#else
+            break;
+#endif
+    }
+    return nullptr;
+}
+
+QModelIndex SearchResultModel::elfModelIndex(const SearchIndex::Hit &hit) const
+{
+    if (!m_elfModel)
+        return {};
+    switch (hit.type) {
+        case SearchIndex::File:
+            return m_elfModel->indexForNode(static_cast<ElfFile*>(hit.payload));
+        case SearchIndex::Section:
+            return m_elfModel->indexForNode(static_cast<ElfSection*>(hit.payload));
+        case SearchIndex::Symbol:
+            return m_elfModel->indexForNode(static_cast<ElfSymbolTableEntry*>(hit.payload));
+        case SearchIndex::DwarfDie:
+            return m_elfModel->indexForNode(static_cast<DwarfDie*>(hit.payload));
+    }
+    return {};
+}
+
+QVariant SearchResultModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rowCount)
+        return {};
+
+    const auto &hit = m_hits.at(index.row());
+    switch (role) {
+        case Qt::DisplayRole:
+            return QString::fromUtf8(hit.text);
+        case Qt::ToolTipRole:
+        {
+            const auto file = fileForHit(hit);
+            switch (hit.type) {
+                case SearchIndex::File:
+                    return tr("File %1").arg(file->fileName());
+                case SearchIndex::Section:
+                    return tr("Section in %1").arg(file->displayName());
+                case SearchIndex::Symbol:
+                    return tr("Symbol in %1").arg(file->displayName());
+                case SearchIndex::DwarfDie:
+                    return tr("Debug information entry in %1").arg(file->displayName());
+            }
+            break;
+        }
+        case NodeUrl:
+            return elfModelIndex(hit).data(ElfModel::NodeUrl);
+    }
+
+    return {};
+}
+
+int SearchResultModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_rowCount;
+}
+
+bool SearchResultModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && m_rowCount < m_hits.size();
+}
+
+void SearchResultModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid())
+        return;
+    const auto count = std::min(BatchSize, m_hits.size() - m_rowCount);
+    if (count <= 0)
+        return;
+    beginInsertRows({}, m_rowCount, m_rowCount + count - 1);
+    m_rowCount += count;
+    endInsertRows();
+}
@@ -0,0 +1,54 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SEARCHRESULTMODEL_H
+#define SEARCHRESULTMODEL_H
+
+#include <search/searchindex.h>
+
+#include <QAbstractListModel>
+
+class ElfModel;
+
+/** Hits of a SearchIndex query, populated incrementally and mapped to ElfModel URLs on demand. */
+class SearchResultModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    enum Role {
+        NodeUrl = Qt::UserRole + 1
+    };
+    explicit SearchResultModel(QObject *parent = nullptr);
+    ~SearchResultModel();
+
+    void setElfModel(ElfModel *model);
+    void setHits(const QVector<SearchIndex::Hit> &hits);
+
+    QVariant data(const QModelIndex &index, int role) const override;
+    int rowCount(const QModelIndex &parent) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+private:
+    QModelIndex elfModelIndex(const SearchIndex::Hit &hit) const;
+
+    ElfModel *m_elfModel = nullptr;
+    QVector<SearchIndex::Hit> m_hits;
+    int m_rowCount = 0;
+};
+
+#endif // SEARCHRESULTMODEL_H
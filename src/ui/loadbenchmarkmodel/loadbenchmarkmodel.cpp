@@ -38,6 +38,13 @@ QVariant LoadBenchmarkModel::data(const QModelIndex& index, int role) const
     if (!m_data || !index.isValid())
         return {};
 
+    // files already loaded by the benchmark runner itself have no samples, show nothing rather than 0 for those
+    if (!hasSamples(index.column(), index.row())) {
+        if (role == Qt::ToolTipRole && index.column() >= 14 && index.column() <= 17 && !m_data->hasBreakdown())
+            return breakdownToolTip();
+        return {};
+    }
+
     if (role == Qt::DisplayRole || role == Qt::EditRole) {
         switch (index.column()) {
             case 0: return m_data->file(index.row())->displayName();
@@ -46,15 +53,114 @@ QVariant LoadBenchmarkModel::data(const QModelIndex& index, int role) const
             case 3: return m_data->median(LDBenchmark::LoadMode::Now, index.row());
             case 4: return m_data->min(LDBenchmark::LoadMode::Now, index.row());
             case 5: return m_data->file(index.row())->reverseRelocator()->size();
+            case 6: return counter(LDBenchmark::Counter::Cycles, index.row());
+            case 7: return counter(LDBenchmark::Counter::Instructions, index.row());
+            case 8: return counter(LDBenchmark::Counter::PageFaults, index.row());
+            case 9: return counter(LDBenchmark::Counter::DTLBMisses, index.row());
+            case 10: return m_data->statistics(LDBenchmark::LoadMode::Lazy, index.row()).p90.value;
+            case 11: return m_data->statistics(LDBenchmark::LoadMode::Lazy, index.row()).p99.value;
+            case 12: return m_data->statistics(LDBenchmark::LoadMode::Now, index.row()).p90.value;
+            case 13: return m_data->statistics(LDBenchmark::LoadMode::Now, index.row()).p99.value;
+            case 14: return m_data->breakdown(index.row()).relocation;
+            case 15: return m_data->breakdown(index.row()).symbolLookup;
+            case 16: return m_data->breakdown(index.row()).io;
+            case 17: return m_data->breakdown(index.row()).other;
+            case 18: return m_data->isColdResultValid(index.row()) ? m_data->median(LDBenchmark::LoadMode::Cold, index.row()) : QVariant();
+            case 19:
+                if (!m_data->coldCache() || !m_data->hasCounter(LDBenchmark::Counter::MajorFaults))
+                    return {};
+                return m_data->median(LDBenchmark::LoadMode::Cold, LDBenchmark::Counter::MajorFaults, index.row());
+            case 20: return m_data->coldCache() ? QVariant::fromValue<quint64>(m_data->coldResidentPageCount(index.row())) : QVariant();
+        }
+    } else if (role == Qt::ToolTipRole) {
+        switch (index.column()) {
+            case 1: return percentileToolTip(LDBenchmark::LoadMode::Lazy, &LDBenchmark::Statistics::p50, index.row());
+            case 3: return percentileToolTip(LDBenchmark::LoadMode::Now, &LDBenchmark::Statistics::p50, index.row());
+            case 10: return percentileToolTip(LDBenchmark::LoadMode::Lazy, &LDBenchmark::Statistics::p90, index.row());
+            case 11: return percentileToolTip(LDBenchmark::LoadMode::Lazy, &LDBenchmark::Statistics::p99, index.row());
+            case 12: return percentileToolTip(LDBenchmark::LoadMode::Now, &LDBenchmark::Statistics::p90, index.row());
+            case 13: return percentileToolTip(LDBenchmark::LoadMode::Now, &LDBenchmark::Statistics::p99, index.row());
+            case 14:
+            case 15:
+            case 16:
+            case 17:
+                return breakdownToolTip();
+            case 18:
+            case 20:
+                if (!m_data->coldCache())
+                    break;
+                if (!m_data->isColdResultValid(index.row()))
+                    return tr("%1 pages stayed in the page cache, they are likely mapped by another process. This is not a cold cache result.")
+                        .arg(m_data->coldResidentPageCount(index.row()));
+                return percentileToolTip(LDBenchmark::LoadMode::Cold, &LDBenchmark::Statistics::p50, index.row());
         }
     }
     return {};
 }
 
+bool LoadBenchmarkModel::hasSamples(int column, int row) const
+{
+    switch (column) {
+        case 1:
+        case 2:
+        case 10:
+        case 11:
+            return m_data->hasSamples(LDBenchmark::LoadMode::Lazy, row);
+        case 3:
+        case 4:
+        case 6:
+        case 7:
+        case 8:
+        case 9:
+        case 12:
+        case 13:
+            return m_data->hasSamples(LDBenchmark::LoadMode::Now, row);
+        case 14:
+        case 15:
+        case 16:
+        case 17:
+            return m_data->hasBreakdown() && m_data->hasSamples(LDBenchmark::LoadMode::Now, row);
+        case 18:
+        case 19:
+        case 20:
+            return m_data->hasSamples(LDBenchmark::LoadMode::Cold, row);
+    }
+    return true;
+}
+
+QString LoadBenchmarkModel::percentileToolTip(LDBenchmark::LoadMode mode, LDBenchmark::Percentile LDBenchmark::Statistics::*percentile, int row) const
+{
+    const auto &stats = m_data->statistics(mode, row);
+    const auto &p = stats.*percentile;
+    return tr("95% confidence interval: [%1, %2]\n%3 samples, %4 outliers rejected")
+        .arg(p.lower).arg(p.upper).arg(stats.sampleCount).arg(stats.outlierCount);
+}
+
+QString LoadBenchmarkModel::breakdownToolTip() const
+{
+    if (!m_data->hasBreakdown()) {
+        return tr("Only %1 files could be measured, at least %2 are needed for a meaningful regression over relocation, symbol lookup and I/O costs.")
+            .arg(m_data->measuredFileCount()).arg(LDBenchmark::MinBreakdownFileCount);
+    }
+    auto s = tr("Estimated share of the Now median, from a regression over all measured files.");
+    if (m_data->linkerRelocationCount() >= 0) {
+        s += QLatin1Char('\n') + tr("Dynamic linker: %1 relocations, %2 served from the lookup cache")
+            .arg(m_data->linkerRelocationCount()).arg(m_data->linkerCachedRelocationCount());
+    }
+    return s;
+}
+
+QVariant LoadBenchmarkModel::counter(LDBenchmark::Counter counter, int row) const
+{
+    if (!m_data->hasCounter(counter))
+        return {};
+    return m_data->median(LDBenchmark::LoadMode::Now, counter, row);
+}
+
 int LoadBenchmarkModel::columnCount(const QModelIndex& parent) const
 {
     Q_UNUSED(parent);
-    return 6;
+    return 21;
 }
 
 int LoadBenchmarkModel::rowCount(const QModelIndex& parent) const
@@ -74,6 +180,21 @@ QVariant LoadBenchmarkModel::headerData(int section, Qt::Orientation orientation
             case 3: return tr("Now Median");
             case 4: return tr("Now Min");
             case 5: return tr("Relocs");
+            case 6: return tr("Now Cycles");
+            case 7: return tr("Now Instructions");
+            case 8: return tr("Now Page Faults");
+            case 9: return tr("Now dTLB Misses");
+            case 10: return tr("Lazy P90");
+            case 11: return tr("Lazy P99");
+            case 12: return tr("Now P90");
+            case 13: return tr("Now P99");
+            case 14: return tr("Relocation");
+            case 15: return tr("Symbol Lookup");
+            case 16: return tr("Page-in I/O");
+            case 17: return tr("Other");
+            case 18: return tr("Cold Median");
+            case 19: return tr("Cold Major Faults");
+            case 20: return tr("Cold Resident Pages");
         }
     }
     return QAbstractItemModel::headerData(section, orientation, role);
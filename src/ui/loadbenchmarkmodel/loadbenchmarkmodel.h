@@ -18,12 +18,12 @@
 #ifndef LOADBENCHMARKMODEL_H
 #define LOADBENCHMARKMODEL_H
 
+#include <checks/ldbenchmark.h>
+
 #include <QAbstractTableModel>
 
 #include <memory>
 
-class LDBenchmark;
-
 /** Result table of the load benchmark results. */
 class LoadBenchmarkModel : public QAbstractTableModel
 {
@@ -40,6 +40,11 @@ public:
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
 
 private:
+    bool hasSamples(int column, int row) const;
+    QVariant counter(LDBenchmark::Counter counter, int row) const;
+    QString percentileToolTip(LDBenchmark::LoadMode mode, LDBenchmark::Percentile LDBenchmark::Statistics::*percentile, int row) const;
+    QString breakdownToolTip() const;
+
     std::shared_ptr<LDBenchmark> m_data;
 };
 
@@ -135,6 +135,8 @@ void MainWindow::loadFile(const QString& fileName)
         return;
     setWindowFilePath(fileName);
 
+    // detach the model (and thus any background indexing) before the old file set is destroyed
+    m_elfModel->setFileSet(nullptr);
     m_fileSet.reset(new ElfFileSet(this));
     m_fileSet->addFile(fileName);
 
@@ -0,0 +1,15 @@
+set title "Warm vs. Cold Cache Dynamic Linking/Loading Time" textcolor rgb "@TEXTCOLOR@"
+set xlabel textcolor rgb "@TEXTCOLOR@"
+set xtics rotate
+set ylabel "µs" textcolor rgb "@TEXTCOLOR@"
+set yrange [0:]
+set grid
+set style data histograms
+set style histogram clustered gap 1
+set style fill solid border -1
+set border linecolor rgb "@TEXTCOLOR@"
+set key textcolor rgb "@TEXTCOLOR@"
+
+# column 5 is the warm RTLD_NOW median, column 50 the cold one
+plot 'ldbenchmark.csv' using 5:xticlabels(1) title "Warm" linecolor rgb "#2C72C7", \
+     'ldbenchmark.csv' using 50 title "Cold" linecolor rgb "#bf0303"
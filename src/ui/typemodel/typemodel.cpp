@@ -24,6 +24,7 @@
 #include <dwarf/dwarfinfo.h>
 #include <dwarf/dwarfdie.h>
 #include <dwarf/dwarfcudie.h>
+#include <dwarf/dwarfcupool.h>
 #endif
 #include <printers/dwarfprinter.h>
 #include <checks/structurepackingcheck.h>
@@ -36,6 +37,14 @@
 #include <QTime>
 #include <QDebug>
 
+/** Candidate type DIE, collected in pre-order per compilation unit. */
+struct TypeModel::TypeEntry
+{
+    DwarfDie *die;
+    QByteArray typeName;
+    int end; // index after the last entry of the sub-tree
+};
+
 TypeModel::TypeModel(QObject* parent): QAbstractItemModel(parent)
 {
     setFileSet(nullptr);
@@ -75,10 +84,19 @@ void TypeModel::addFile(ElfFile* file)
         return;
 
 #if HAVE_DWARF
-    foreach (const auto cu, dwarf->compilationUnits()) {
+    // finding types and computing their names runs in parallel, building the tree in unit order
+    DwarfCuPool pool(dwarf);
+    pool.mapReduce([](DwarfCuDie *cu) {
+        QVector<TypeEntry> entries;
+        if (const auto splitUnit = cu->splitUnit())
+            cu = splitUnit;
         foreach (const auto die, cu->children())
-            addDwarfDieRecursive(die, 0);
-    }
+            collectTypeEntries(die, entries);
+        return entries;
+    }, [this](QVector<TypeEntry> &&entries) {
+        for (int i = 0; i < entries.size(); i = entries.at(i).end)
+            addTypeEntryRecursive(entries, i, 0);
+    });
 #endif
 }
 
@@ -104,7 +122,7 @@ bool isBetterDie(DwarfDie *prevDie, DwarfDie *newDie)
         return false;
 
     // declarations are always worse then the real one
-    if (prevDie->attribute(DW_AT_declaration).toBool())
+    if (prevDie->attributeFlag(DW_AT_declaration))
         return true;
 
     // size is also a good indicator for this belonging to a complete DIE
@@ -124,32 +142,45 @@ bool isBetterDie(DwarfDie *prevDie, DwarfDie *newDie)
     return false;
 }
 
-bool TypeModel::addDwarfDieRecursive(DwarfDie* die, uint32_t parentId)
+void TypeModel::collectTypeEntries(DwarfDie* die, QVector<TypeEntry>& entries)
 {
 #if HAVE_DWARF
-    if (!die->dwarfInfo()->isValid()) {
-        m_hasInvalidDies = true;
-        return false;
-    }
-
     switch (die->tag()) {
         case DW_TAG_class_type:
         case DW_TAG_namespace:
         case DW_TAG_structure_type: // TODO we can also have nested types in DW_TAG_subprograms!
             break;
         default:
-            return false;
+            return;
+    }
+
+    const int index = entries.size();
+    entries.push_back({ die, die->typeName(), 0 });
+    foreach (auto child, die->children())
+        collectTypeEntries(child, entries);
+    entries[index].end = entries.size();
+#endif
+}
+
+bool TypeModel::addTypeEntryRecursive(const QVector<TypeEntry> &entries, int index, uint32_t parentId)
+{
+#if HAVE_DWARF
+    const auto &entry = entries.at(index);
+    const auto die = entry.die;
+    if (!die->dwarfInfo()->isValid()) {
+        m_hasInvalidDies = true;
+        return false;
     }
 
     QVector<uint32_t> children;
     if (parentId < (uint32_t)m_childMap.size())
         children = m_childMap.at(parentId);
 
-    const auto dieName = die->typeName();
+    const auto &dieName = entry.typeName;
     const auto it = std::lower_bound(children.constBegin(), children.constEnd(), die, [this, &dieName](uint32_t nodeId, DwarfDie *die) {
-        const auto lhs = m_nodes.at(nodeId);
+        const auto &lhs = m_nodes.at(nodeId);
         if (lhs.die->tag() == die->tag())
-            return m_nodes.at(nodeId).die->typeName() < dieName;
+            return lhs.typeName < dieName;
         return lhs.die->tag() < die->tag();
     });
 
@@ -160,7 +191,7 @@ bool TypeModel::addDwarfDieRecursive(DwarfDie* die, uint32_t parentId)
 
     // TODO what about anon stuff, name() is empty there, typeName() isn't, but that merges too much
     // TODO what about local symbols, compare CUs?
-    if (it != children.constEnd() && m_nodes.at(*it).die->tag() == die->tag() && m_nodes.at(*it).die->typeName() == dieName) {
+    if (it != children.constEnd() && m_nodes.at(*it).die->tag() == die->tag() && m_nodes.at(*it).typeName == dieName) {
         nodeId = *it;
         if (isBetterDie(m_nodes.at(nodeId).die, die))
             m_nodes[nodeId].die = die;
@@ -171,12 +202,13 @@ bool TypeModel::addDwarfDieRecursive(DwarfDie* die, uint32_t parentId)
     }
 
     bool childCreated = false;
-    foreach (auto child, die->children())
-        childCreated |= addDwarfDieRecursive(child, nodeId);
+    for (int i = index + 1; i < entry.end; i = entries.at(i).end)
+        childCreated |= addTypeEntryRecursive(entries, i, nodeId);
 
     if (!nodeExits && (childCreated || die->tag() == DW_TAG_class_type || die->tag() == DW_TAG_structure_type)) {
         m_nodes.resize(std::max((uint32_t)m_nodes.size(), nodeId + 1));
         m_nodes[nodeId].die = die;
+        m_nodes[nodeId].typeName = dieName;
         m_childMap.resize(std::max((uint32_t)m_childMap.size(), nodeId + 1));
         m_childMap[parentId].insert(childInsertIndex, nodeId);
         m_parentMap.resize(std::max((uint32_t)m_parentMap.size(), nodeId + 1));
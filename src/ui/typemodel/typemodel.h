@@ -48,12 +48,15 @@ public:
 
     bool hasInvalidDies() const { return m_hasInvalidDies; }
 private:
+    struct TypeEntry;
     void addFile(ElfFile *file);
-    bool addDwarfDieRecursive(DwarfDie* die, uint32_t parentId);
+    static void collectTypeEntries(DwarfDie *die, QVector<TypeEntry> &entries);
+    bool addTypeEntryRecursive(const QVector<TypeEntry> &entries, int index, uint32_t parentId);
 
     // the tree hierarchy is built using 32bit sequential ids, which act as index for the node struct
     struct Node {
         DwarfDie *die = nullptr;
+        QByteArray typeName;
     };
     QVector<QVector<uint32_t>> m_childMap;
     QVector<uint32_t> m_parentMap;
@@ -19,27 +19,48 @@
 #include "ui_elfstructureview.h"
 
 #include <elfmodel/elfmodel.h>
+#include <elfmodel/searchresultmodel.h>
 #include <navigator/codenavigator.h>
 
-#include <QSortFilterProxyModel>
+#include <search/searchindex.h>
+
+#include <QRegularExpression>
+#include <QThread>
+#include <QTimer>
 
 #include <QMouseEvent>
 
+#include <memory>
+
+static const int MaxHits = 10000;
+// shorter queries can't use the trigram index and would match most names anyway
+static const int MinimumQueryLength = 3;
+
 ElfStructureView::ElfStructureView(QWidget* parent):
     QWidget(parent),
     ui(new Ui::ElfStructureView),
-    m_proxy(new QSortFilterProxyModel(this))
+    m_searchResultModel(new SearchResultModel(this)),
+    m_searchTimer(new QTimer(this))
 {
     ui->setupUi(this);
-    ui->elfStructureView->setModel(m_proxy);
-    m_proxy->setRecursiveFilteringEnabled(true);
     ui->elfStructureView->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
-
-    connect(ui->elfStructureView->selectionModel(), &QItemSelectionModel::selectionChanged,
-            this, &ElfStructureView::selectionChanged);
-    connect(ui->elfStructureSearchLine, &QLineEdit::textChanged, this, [this](const QString &text) {
-        m_proxy->setFilterFixedString(text);
+    ui->searchResultView->setModel(m_searchResultModel);
+    ui->searchResultView->hide();
+
+    // don't search on every keystroke
+    m_searchTimer->setSingleShot(true);
+    m_searchTimer->setInterval(200);
+    connect(m_searchTimer, &QTimer::timeout, this, &ElfStructureView::search);
+    connect(ui->elfStructureSearchLine, &QLineEdit::textChanged, m_searchTimer, static_cast<void(QTimer::*)()>(&QTimer::start));
+    connect(ui->elfStructureSearchLine, &QLineEdit::returnPressed, this, &ElfStructureView::search);
+    ui->elfStructureSearchLine->addAction(ui->actionRegExpSearch, QLineEdit::TrailingPosition);
+    connect(ui->actionRegExpSearch, &QAction::toggled, this, &ElfStructureView::search);
+    connect(ui->searchResultView, &QAbstractItemView::activated, this, [this](const QModelIndex &index) {
+        const auto url = index.data(SearchResultModel::NodeUrl).toUrl();
+        if (url.isValid() && !url.isEmpty())
+            selectUrl(url);
     });
+    connect(ui->searchResultView, &QAbstractItemView::clicked, ui->searchResultView, &QAbstractItemView::activated);
     connect(ui->elfDetailView, &QTextBrowser::anchorClicked, this, &ElfStructureView::anchorClicked);
 
     ui->actionBack->setShortcut(QKeySequence::Back);
@@ -65,12 +86,103 @@ ElfStructureView::ElfStructureView(QWidget* parent):
     installEventFilter(this);
 }
 
-ElfStructureView::~ElfStructureView() = default;
+ElfStructureView::~ElfStructureView()
+{
+    stopSearch();
+    stopIndexing();
+}
 
 void ElfStructureView::setModel(ElfModel* model)
 {
     m_elfModel = model;
-    m_proxy->setSourceModel(model);
+    ui->elfStructureView->setModel(model);
+    connect(ui->elfStructureView->selectionModel(), &QItemSelectionModel::selectionChanged,
+            this, &ElfStructureView::selectionChanged);
+    m_searchResultModel->setElfModel(model);
+
+    connect(model, &QAbstractItemModel::modelAboutToBeReset, this, [this]() {
+        stopSearch();
+        stopIndexing();
+        m_searchIndex.reset();
+        m_searchResultModel->setHits({});
+    });
+    connect(model, &QAbstractItemModel::modelReset, this, &ElfStructureView::startIndexing);
+    startIndexing();
+}
+
+void ElfStructureView::startIndexing()
+{
+    stopIndexing();
+    if (!m_elfModel || !m_elfModel->fileSet())
+        return;
+
+    // building the index touches every symbol and DIE of the entire file set, keep that off the GUI thread
+    m_pendingSearchIndex.reset(new SearchIndex);
+    const auto index = m_pendingSearchIndex.get();
+    const auto fileSet = m_elfModel->fileSet();
+    m_indexThread = QThread::create([index, fileSet]() {
+        index->addFileSet(fileSet);
+    });
+    connect(m_indexThread, &QThread::finished, m_indexThread, [this]() {
+        m_indexThread->deleteLater();
+        m_indexThread = nullptr;
+        m_searchIndex = std::move(m_pendingSearchIndex);
+        ui->elfStructureSearchLine->setPlaceholderText(tr("Search"));
+        search();
+    });
+    ui->elfStructureSearchLine->setPlaceholderText(tr("Search (indexing...)"));
+    m_indexThread->start();
+}
+
+void ElfStructureView::stopIndexing()
+{
+    if (!m_indexThread)
+        return;
+    m_indexThread->requestInterruption();
+    m_indexThread->wait();
+    delete m_indexThread;
+    m_indexThread = nullptr;
+    m_pendingSearchIndex.reset();
+}
+
+void ElfStructureView::search()
+{
+    stopSearch();
+    m_searchTimer->stop();
+
+    const auto text = ui->elfStructureSearchLine->text();
+    const auto regExp = ui->actionRegExpSearch->isChecked();
+    ui->searchResultView->setVisible(!text.isEmpty());
+    if (text.isEmpty() || !m_searchIndex || (!regExp && text.toUtf8().size() < MinimumQueryLength)) {
+        m_searchResultModel->setHits({});
+        return;
+    }
+
+    // patterns the index can't narrow down need to look at every name, keep that off the GUI thread
+    const auto index = m_searchIndex.get();
+    const auto hits = std::make_shared<QVector<SearchIndex::Hit>>();
+    m_searchThread = QThread::create([index, text, regExp, hits]() {
+        if (regExp)
+            *hits = index->find(QRegularExpression(text, QRegularExpression::CaseInsensitiveOption), MaxHits);
+        else
+            *hits = index->find(text.toUtf8(), MaxHits);
+    });
+    connect(m_searchThread, &QThread::finished, m_searchThread, [this, hits]() {
+        m_searchThread->deleteLater();
+        m_searchThread = nullptr;
+        m_searchResultModel->setHits(*hits);
+    });
+    m_searchThread->start();
+}
+
+void ElfStructureView::stopSearch()
+{
+    if (!m_searchThread)
+        return;
+    m_searchThread->requestInterruption();
+    m_searchThread->wait();
+    delete m_searchThread;
+    m_searchThread = nullptr;
 }
 
 void ElfStructureView::selectionChanged(const QItemSelection &selection)
@@ -109,8 +221,7 @@ void ElfStructureView::updateActionState()
 
 void ElfStructureView::selectUrl(const QUrl& url)
 {
-    auto idx = m_elfModel->indexForUrl(url);
-    idx = m_proxy->mapFromSource(idx);
+    const auto idx = m_elfModel->indexForUrl(url);
     ui->elfStructureView->selectionModel()->select(idx, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
     ui->elfStructureView->selectionModel()->setCurrentIndex(idx, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
     ui->elfStructureView->scrollTo(idx);
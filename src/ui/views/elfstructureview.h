@@ -28,8 +28,11 @@ class ElfStructureView;
 }
 
 class ElfModel;
+class SearchIndex;
+class SearchResultModel;
 class QItemSelection;
-class QSortFilterProxyModel;
+class QThread;
+class QTimer;
 class QUrl;
 
 class ElfStructureView : public QWidget
@@ -51,10 +54,19 @@ private slots:
 private:
     void updateActionState();
     void selectUrl(const QUrl &url);
+    void startIndexing();
+    void stopIndexing();
+    void search();
+    void stopSearch();
 
     std::unique_ptr<Ui::ElfStructureView> ui;
     ElfModel *m_elfModel = nullptr;
-    QSortFilterProxyModel* m_proxy;
+    SearchResultModel *m_searchResultModel;
+    std::unique_ptr<SearchIndex> m_searchIndex;
+    std::unique_ptr<SearchIndex> m_pendingSearchIndex;
+    QThread *m_indexThread = nullptr;
+    QThread *m_searchThread = nullptr;
+    QTimer *m_searchTimer;
     QVector<QUrl> m_history;
     int m_historyIndex = -1;
     bool m_historyLock = false;
@@ -38,7 +38,10 @@ LoadBenchmarkView::LoadBenchmarkView(QWidget* parent):
     ui->actionRunBenchmark->setEnabled(Gnuplotter::hasGnuplot());
     connect(ui->actionRunBenchmark, &QAction::triggered, this, &LoadBenchmarkView::runBenchmark);
 
-    addActions({ ui->actionRunBenchmark });
+    auto separator = new QAction(this);
+    separator->setSeparator(true);
+    addActions({ ui->actionRunBenchmark, separator, ui->actionAdaptiveBenchmark, ui->actionColdCache });
+    ui->tabWidget->setTabEnabled(ui->tabWidget->indexOf(ui->coldPlotTab), false);
 }
 
 LoadBenchmarkView::~LoadBenchmarkView() = default;
@@ -54,6 +57,8 @@ void LoadBenchmarkView::runBenchmark()
         return;
 
     m_benchmark = std::make_shared<LDBenchmark>();
+    m_benchmark->setStrategy(ui->actionAdaptiveBenchmark->isChecked() ? LDBenchmark::Strategy::Adaptive : LDBenchmark::Strategy::Fixed);
+    m_benchmark->setColdCache(ui->actionColdCache->isChecked());
     m_benchmark->measureFileSet(m_fileSet);
 
     Gnuplotter plotter;
@@ -63,5 +68,14 @@ void LoadBenchmarkView::runBenchmark()
     m_benchmark->writeCSV(plotter.workingDir() + "/ldbenchmark.csv");
     ui->plotter->setPlotter(std::move(plotter));
 
+    ui->tabWidget->setTabEnabled(ui->tabWidget->indexOf(ui->coldPlotTab), m_benchmark->coldCache());
+    if (m_benchmark->coldCache()) {
+        Gnuplotter coldPlotter;
+        coldPlotter.setSize(ui->coldPlotter->size());
+        coldPlotter.setTemplate(QStringLiteral(":/ldbenchmark-cold.gnuplot"));
+        m_benchmark->writeCSV(coldPlotter.workingDir() + "/ldbenchmark.csv");
+        ui->coldPlotter->setPlotter(std::move(coldPlotter));
+    }
+
     m_model->setBenchmark(m_benchmark);
 }
@@ -24,8 +24,7 @@
 #include <elfmodel/sectionproxymodel.h>
 
 #include <elf/elffile.h>
-#include <elf/elfsymboltablesection.h>
-#include <demangle/demangler.h>
+#include <demangle/symbolprefixtree.h>
 
 #include <QMenu>
 #include <QSettings>
@@ -84,13 +83,6 @@ SizeTreeMapView::SizeTreeMapView(QWidget* parent) :
 
 SizeTreeMapView::~SizeTreeMapView() = default;
 
-static double relocRatio(ElfSymbolTableEntry *symbol)
-{
-    if (symbol->size() <= 0)
-        return 0;
-    return (double)(symbol->symbolTable()->file()->reverseRelocator()->relocationCount(symbol->value(), symbol->size()) * symbol->symbolTable()->file()->addressSize()) / symbol->size();
-}
-
 static double relocRatio(ElfSectionHeader *shdr)
 {
     if (shdr->size() <= 0)
@@ -107,6 +99,29 @@ static QColor relocColor(double ratio)
     );
 }
 
+// adds tree map items for the symbols of @p node in section @p sectionIndex, relocation heatmap is disabled if addressSize is 0
+static void addSymbolItems(const SymbolPrefixTree *tree, int node, uint16_t sectionIndex, TreeMapItem *parentItem, const QColor &color, int addressSize)
+{
+    const auto stats = tree->statistics(node, sectionIndex);
+    auto item = new TreeMapItem(parentItem);
+    item->setField(0, tree->name(node));
+    item->setSum(stats.size);
+    item->setValue(stats.size);
+    item->setField(1, QString::number(stats.size));
+    item->setBackColor(color);
+
+    bool hasChildren = false;
+    for (int i = 0; i < tree->childCount(node); ++i) {
+        const auto child = tree->child(node, i);
+        if (tree->statistics(child, sectionIndex).size == 0)
+            continue;
+        hasChildren = true;
+        addSymbolItems(tree, child, sectionIndex, item, color, addressSize);
+    }
+    if (!hasChildren && addressSize > 0)
+        item->setBackColor(relocColor((double)(stats.relocationCount * addressSize) / stats.size));
+}
+
 void SizeTreeMapView::setModel(QAbstractItemModel* model)
 {
     m_sectionProxy->setSourceModel(model);
@@ -166,12 +181,7 @@ void SizeTreeMapView::reloadTreeMap()
     QSettings settings;
     m_treeMap->setSplitMode(settings.value(QStringLiteral("TreeMap/SplitMode"), "Bisection").toString());
 
-    struct SymbolNode {
-        TreeMapItem *item;
-        QHash<QByteArray, SymbolNode*> children;
-    };
-
-    QVector<SymbolNode*> sectionItems;
+    QVector<TreeMapItem*> sectionItems;
     sectionItems.resize(file->sectionHeaders().size());
 
     if (!section) {
@@ -187,8 +197,7 @@ void SizeTreeMapView::reloadTreeMap()
                 item->setBackColor(sectionColorizer.nextColor());
             if (ui->actionRelocationHeatmap->isChecked() && shdr->flags() & SHF_WRITE)
                 item->setBackColor(relocColor(relocRatio(shdr)));
-            sectionItems[shdr->sectionIndex()] = new SymbolNode;
-            sectionItems[shdr->sectionIndex()]->item = item;
+            sectionItems[shdr->sectionIndex()] = item;
         }
     } else {
         baseItem->setSum(section->header()->size());
@@ -196,41 +205,23 @@ void SizeTreeMapView::reloadTreeMap()
         item->setSum(section->header()->size());
         if (ui->actionRelocationHeatmap->isChecked() && section->header()->flags() & SHF_WRITE)
             item->setBackColor(relocColor(relocRatio(section->header())));
-        sectionItems[section->header()->sectionIndex()] = new SymbolNode;
-        sectionItems[section->header()->sectionIndex()]->item = item;
+        sectionItems[section->header()->sectionIndex()] = item;
     }
 
     Colorizer symbolColorizer;
-    Demangler demangler;
-
-    const auto symtab = file->symbolTable();
-    if (symtab) {
-        for (unsigned int j = 0; j < symtab->header()->entryCount(); ++j) {
-            const auto entry = symtab->entry(j);
-            if (entry->size() == 0 || !sectionItems.at(entry->sectionIndex()))
+    const auto tree = file->symbolPrefixTree();
+    for (int i = 0; i < sectionItems.size(); ++i) {
+        if (!sectionItems.at(i))
+            continue;
+        const auto relocHeatmap = ui->actionRelocationHeatmap->isChecked() && file->sectionHeaders().at(i)->flags() & SHF_WRITE;
+        for (int j = 0; j < tree->childCount(SymbolPrefixTree::RootNode); ++j) {
+            const auto child = tree->child(SymbolPrefixTree::RootNode, j);
+            if (tree->statistics(child, i).size == 0)
                 continue;
-            SymbolNode *parentNode = sectionItems.at(entry->sectionIndex());
-            const QVector<QByteArray> demangledNames = demangler.demangle(entry->name());
-            for (const QByteArray &demangledName : demangledNames) {
-                SymbolNode *node = parentNode->children.value(demangledName);
-                if (!node) {
-                    node = new SymbolNode;
-                    node->item = new TreeMapItem(parentNode->item);
-                    node->item->setField(0, demangledName);
-                    if (ui->actionColorizeSymbols->isChecked() && parentNode->item->parent() == baseItem) {
-                        node->item->setBackColor(symbolColorizer.nextColor());
-                    } else {
-                        node->item->setBackColor(parentNode->item->backColor());
-                    }
-                    parentNode->children.insert(demangledName, node);
-                }
-                node->item->setSum(node->item->sum() + entry->size());
-                node->item->setValue(node->item->sum());
-                node->item->setField(1, QString::number(node->item->sum()));
-                parentNode = node;
-            }
-            if (ui->actionRelocationHeatmap->isChecked() && entry->sectionHeader()->flags() & SHF_WRITE)
-                parentNode->item->setBackColor(relocColor(relocRatio(entry)));
+            QColor color = sectionItems.at(i)->backColor();
+            if (ui->actionColorizeSymbols->isChecked())
+                color = symbolColorizer.nextColor();
+            addSymbolItems(tree, child, i, sectionItems.at(i), color, relocHeatmap ? file->addressSize() : 0);
         }
     }
 
@@ -0,0 +1,290 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <config-elf-dissector.h>
+
+#include <elf/elffile.h>
+#include <elf/elfgotsection.h>
+#include <elf/elfpltsection.h>
+#include <elf/elfrelocationentry.h>
+#include <elf/elfrelocationsection.h>
+#include <elf/elfreverserelocator.h>
+#include <elf/elfsymboltablesection.h>
+
+#if HAVE_DWARF
+#include <dwarf/dwarfaddressranges.h>
+#include <dwarf/dwarfcudie.h>
+#include <dwarf/dwarfcupool.h>
+#include <dwarf/dwarfdie.h>
+#include <dwarf/dwarfinfo.h>
+#include <dwarf/dwarfline.h>
+#endif
+
+#include <QtTest/qtest.h>
+#include <QAtomicInt>
+#include <QObject>
+#include <QThreadPool>
+
+#include <elf.h>
+#if HAVE_DWARF
+#include <dwarf.h>
+#endif
+
+#include <functional>
+#include <vector>
+
+// stress tests for the lazily populated caches, most useful when built with ECM_ENABLE_SANITIZERS=thread
+
+static const int ThreadCount = 8;
+
+class FunctionRunnable : public QRunnable
+{
+public:
+    explicit FunctionRunnable(const std::function<void(int)> &func, int index) :
+        m_func(func),
+        m_index(index)
+    {
+    }
+
+    void run() override
+    {
+        m_func(m_index);
+    }
+
+private:
+    std::function<void(int)> m_func;
+    int m_index;
+};
+
+static void runConcurrently(const std::function<void(int)> &func)
+{
+    QThreadPool pool;
+    pool.setMaxThreadCount(ThreadCount);
+    for (int i = 0; i < ThreadCount; ++i)
+        pool.start(new FunctionRunnable(func, i));
+    pool.waitForDone();
+}
+
+static QVector<uint64_t> relocationOffsets(ElfFile *file)
+{
+    QVector<uint64_t> offsets;
+    for (int i = 0; i < file->sectionHeaders().size(); ++i) {
+        const auto type = file->sectionHeaders().at(i)->type();
+        if (type != SHT_REL && type != SHT_RELA)
+            continue;
+        const auto section = file->section<ElfRelocationSection>(i);
+        for (uint64_t j = 0; j < section->header()->entryCount(); ++j)
+            offsets.push_back(section->entry(j)->offset());
+    }
+    return offsets;
+}
+
+#if HAVE_DWARF
+struct DieStats
+{
+    int count = 0;
+    uint64_t offsetSum = 0;
+    int typeRefs = 0;
+
+    bool operator==(const DieStats &other) const
+    {
+        return count == other.count && offsetSum == other.offsetSum && typeRefs == other.typeRefs;
+    }
+};
+
+static void collectDieStats(DwarfDie *die, DieStats &stats)
+{
+    ++stats.count;
+    stats.offsetSum += die->offset();
+    die->name();
+    if (die->attribute(DW_AT_type).value<DwarfDie*>())
+        ++stats.typeRefs;
+    foreach (auto child, die->children())
+        collectDieStats(child, stats);
+}
+
+static DieStats dieStats(DwarfInfo *info, int rotation)
+{
+    DieStats stats;
+    const auto cus = info->compilationUnits();
+    for (int i = 0; i < cus.size(); ++i)
+        collectDieStats(cus.at((i + rotation) % cus.size()), stats);
+    return stats;
+}
+
+static QVector<uint64_t> functionAddresses(ElfFile *file)
+{
+    QVector<uint64_t> addrs;
+    const auto symtab = file->symbolTable();
+    if (!symtab)
+        return addrs;
+    for (uint32_t i = 0; i < symtab->header()->entryCount(); ++i) {
+        const auto entry = symtab->entry(i);
+        if (entry->type() == STT_FUNC && entry->value() != 0)
+            addrs.push_back(entry->value());
+    }
+    return addrs;
+}
+
+static QVector<uint64_t> lineNumbers(ElfFile *file, const QVector<uint64_t> &addrs)
+{
+    QVector<uint64_t> lines;
+    lines.reserve(addrs.size());
+    for (const auto addr : addrs) {
+        const auto cu = file->dwarfInfo()->compilationUnitForAddress(addr);
+        lines.push_back(cu ? cu->lineForAddress(addr).line() : 0);
+    }
+    return lines;
+}
+#endif
+
+class ConcurrencyTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testReverseRelocator()
+    {
+        ElfFile ref(QStringLiteral(BINDIR "elf-dissector"));
+        QVERIFY(ref.open(QFile::ReadOnly));
+        const auto offsets = relocationOffsets(&ref);
+        QVERIFY(!offsets.isEmpty());
+        const auto size = ref.reverseRelocator()->size();
+
+        ElfFile f(QStringLiteral(BINDIR "elf-dissector"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        QAtomicInt failures;
+        runConcurrently([&](int index) {
+            const auto relocator = f.reverseRelocator();
+            for (int i = 0; i < offsets.size(); ++i) {
+                const auto offset = offsets.at((i + index * offsets.size() / ThreadCount) % offsets.size());
+                const auto reloc = relocator->find(offset);
+                if (!reloc || reloc->offset() != offset)
+                    failures.ref();
+            }
+            if (relocator->size() != size)
+                failures.ref();
+        });
+        QCOMPARE(failures.load(), 0);
+    }
+
+    void testPltGotSection()
+    {
+        ElfFile f(QStringLiteral(BINDIR "elf-dissector"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        const auto pltIndex = f.indexOfSection(".plt");
+        if (pltIndex < 0)
+            QSKIP("no .plt section");
+        const auto plt = f.section<ElfPltSection>(pltIndex);
+        QVERIFY(plt);
+
+        std::vector<ElfGotSection*> gots(ThreadCount, nullptr);
+        runConcurrently([&](int index) {
+            gots[index] = plt->gotSection();
+        });
+        QVERIFY(gots.front());
+        for (const auto got : gots)
+            QCOMPARE(got, gots.front());
+    }
+
+#if HAVE_DWARF
+    void testDwarfChildren_data()
+    {
+        QTest::addColumn<QString>("executable");
+        QTest::newRow("structures") << QStringLiteral(BINDIR "structures");
+        QTest::newRow("virtual-methods") << QStringLiteral(BINDIR "virtual-methods");
+    }
+
+    void testDwarfChildren()
+    {
+        QFETCH(QString, executable);
+
+        ElfFile ref(executable);
+        QVERIFY(ref.open(QFile::ReadOnly));
+        QVERIFY(ref.dwarfInfo());
+        const auto refStats = dieStats(ref.dwarfInfo(), 0);
+        QVERIFY(refStats.count > 0);
+
+        ElfFile f(executable);
+        QVERIFY(f.open(QFile::ReadOnly));
+        QVERIFY(f.dwarfInfo());
+        std::vector<DieStats> stats(ThreadCount);
+        runConcurrently([&](int index) {
+            stats[index] = dieStats(f.dwarfInfo(), index);
+        });
+        for (const auto &s : stats)
+            QVERIFY(s == refStats);
+    }
+
+    void testDwarfCuPool()
+    {
+        ElfFile ref(QStringLiteral(BINDIR "structures"));
+        QVERIFY(ref.open(QFile::ReadOnly));
+        QVERIFY(ref.dwarfInfo());
+        DwarfCuPool refPool(ref.dwarfInfo());
+        refPool.setThreadCount(1);
+        std::vector<DieStats> refStats;
+        refPool.mapReduce([](DwarfCuDie *cu) {
+            DieStats stats;
+            collectDieStats(cu, stats);
+            return stats;
+        }, [&](DieStats &&stats) {
+            refStats.push_back(stats);
+        });
+        QCOMPARE((int)refStats.size(), ref.dwarfInfo()->compilationUnits().size());
+
+        ElfFile f(QStringLiteral(BINDIR "structures"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        QVERIFY(f.dwarfInfo());
+        DwarfCuPool pool(f.dwarfInfo());
+        pool.setThreadCount(ThreadCount);
+        QCOMPARE(pool.threadCount(), ThreadCount);
+        std::vector<DieStats> stats;
+        pool.mapReduce([](DwarfCuDie *cu) {
+            DieStats stats;
+            collectDieStats(cu, stats);
+            return stats;
+        }, [&](DieStats &&s) {
+            stats.push_back(s);
+        });
+        QVERIFY(stats == refStats);
+    }
+
+    void testDwarfLines()
+    {
+        ElfFile ref(QStringLiteral(BINDIR "single-executable"));
+        QVERIFY(ref.open(QFile::ReadOnly));
+        QVERIFY(ref.dwarfInfo());
+        const auto addrs = functionAddresses(&ref);
+        QVERIFY(!addrs.isEmpty());
+        const auto refLines = lineNumbers(&ref, addrs);
+
+        ElfFile f(QStringLiteral(BINDIR "single-executable"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        QVERIFY(f.dwarfInfo());
+        std::vector<QVector<uint64_t>> lines(ThreadCount);
+        runConcurrently([&](int index) {
+            lines[index] = lineNumbers(&f, addrs);
+        });
+        for (const auto &l : lines)
+            QCOMPARE(l, refLines);
+    }
+#endif
+};
+
+QTEST_MAIN(ConcurrencyTest)
+
+#include "concurrencytest.moc"
@@ -18,13 +18,61 @@
 #include <config-elf-dissector.h>
 
 #include <QtTest/qtest.h>
+#include <QAtomicInt>
+#include <QCoreApplication>
 #include <QObject>
 #include <QDebug>
 
+#include <demangle/demanglecache.h>
 #include <demangle/demangler.h>
+#include <demangle/spandemangler.h>
+#include <elf/elffile.h>
+#include <elf/elffileset.h>
+#include <elf/elfsymboltableentry.h>
+#include <elf/elfsymboltablesection.h>
+
+// workarounds for conflicting declaration in libiberty.h
+#define HAVE_DECL_BASENAME 1
+#define HAVE_DECL_ASPRINTF 1
+#define HAVE_DECL_VASPRINTF 1
+
+#include <demangle.h>
+
+#include <thread>
+#include <vector>
 
 #define VB QVector<QByteArray>()
 
+static const int DemangleOptions = DMGL_PARAMS | DMGL_ANSI | DMGL_TYPES | DMGL_VERBOSE;
+
+/** Mangled names from the symbol tables of this test and its dependencies, a realistic mix of Qt, STL and our own code. */
+static const QVector<QByteArray>& symbolCorpus()
+{
+    static const QVector<QByteArray> corpus = []() {
+        QVector<QByteArray> names;
+        ElfFileSet fileSet;
+        fileSet.addFile(QCoreApplication::applicationFilePath());
+        for (int i = 0; i < fileSet.size(); ++i) {
+            const auto symtab = fileSet.file(i)->symbolTable();
+            if (!symtab)
+                continue;
+            for (uint32_t j = 0; j < symtab->header()->entryCount(); ++j) {
+                const QByteArray name(symtab->entry(j)->name());
+                if (name.startsWith("_Z"))
+                    names.push_back(name);
+            }
+        }
+        return names;
+    }();
+    return corpus;
+}
+
+static void appendToBuffer(const char *str, size_t size, void *opaque)
+{
+    auto buffer = static_cast<std::vector<char>*>(opaque);
+    buffer->insert(buffer->end(), str, str + size);
+}
+
 class DemanglerTest : public QObject
 {
     Q_OBJECT
@@ -159,6 +207,154 @@ private slots:
 
         QCOMPARE(Demangler::symbolType(symbol), type);
     }
+    void testCache()
+    {
+        static const char* names[] = {
+            "malloc",
+            "_ZN10QByteArray6appendERKS_",
+            "_ZN10QByteArrayD1Ev",
+            "_ZNK10QByteArraycvPKcEv",
+            "_ZSt4moveIRP11TreeMapItemEONSt16remove_referenceIT_E4typeEOS4_",
+            "_ZN20QGlobalStaticDeleterI5QListIPFP7QObjectvEEED1Ev"
+        };
+
+        // emulate a string table, the cache is keyed by address
+        QByteArray strtab;
+        QVector<int> offsets;
+        for (int i = 0; i < 256; ++i) {
+            for (auto name : names) {
+                offsets.push_back(strtab.size());
+                strtab.append(name, strlen(name) + 1);
+            }
+        }
+
+        DemangleCache cache;
+        for (int i = 0; i < 6; ++i) {
+            const auto name = strtab.constData() + offsets.at(i);
+            Demangler demangler;
+            QCOMPARE(cache.demangle(name), demangler.demangle(name));
+            QCOMPARE(cache.demangleFull(name), Demangler::demangleFull(name));
+            QCOMPARE(cache.size(), i + 1);
+            // cached results
+            QCOMPARE(cache.demangle(name), demangler.demangle(name));
+            QCOMPARE(cache.demangleFull(name), Demangler::demangleFull(name));
+            QCOMPARE(cache.size(), i + 1);
+        }
+
+        cache.clear();
+        QCOMPARE(cache.size(), 0);
+
+        // concurrent access, and eviction when exceeding the size limit
+        cache.setMaximumCost(16 * 1024);
+        std::vector<std::thread> threads;
+        QAtomicInt failures;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&cache, &strtab, &offsets, &failures, t]() {
+                for (int i = 0; i < offsets.size(); ++i) {
+                    const auto name = strtab.constData() + offsets.at((i + t * 97) % offsets.size());
+                    const auto full = cache.demangleFull(name);
+                    if (full != Demangler::demangleFull(name))
+                        failures.ref();
+                    if (cache.demangle(name).isEmpty())
+                        failures.ref();
+                }
+            });
+        }
+        for (auto &thread : threads)
+            thread.join();
+        QCOMPARE(failures.load(), 0);
+        QVERIFY(cache.size() > 0);
+        QVERIFY(cache.size() < offsets.size());
+    }
+    void testDemangleAll()
+    {
+        static const char* names[] = {
+            "",
+            "malloc",
+            "_ZN10QByteArray6appendERKS_",
+            "_ZN10QByteArrayC1EPKci",
+            "_ZZN13Ui_MainWindow7setupUiEP11QMainWindowENKUlvE5_clEv",
+            "_ZSt4moveIRP11TreeMapItemEONSt16remove_referenceIT_E4typeEOS4_"
+        };
+
+        QVector<const char*> input;
+        for (int i = 0; i < 1000; ++i)
+            input.push_back(names[i % 6]);
+
+        const auto result = Demangler::demangleAll(input);
+        QCOMPARE(result.size(), input.size());
+        Demangler demangler;
+        for (int i = 0; i < input.size(); ++i) {
+            QCOMPARE(result.fullName(i), Demangler::demangleFull(input.at(i)));
+            QCOMPARE(result.nameParts(i), demangler.demangle(input.at(i)));
+        }
+
+        QCOMPARE(Demangler::demangleAll(QVector<const char*>()).size(), 0);
+    }
+    void testSpanDemanglerCorpus()
+    {
+        const auto &corpus = symbolCorpus();
+        QVERIFY(corpus.size() > 1000);
+
+        // a reused instance must produce the same results as a fresh one, and the same full names as libiberty
+        SpanDemangler sd;
+        for (const auto &name : corpus) {
+            sd.demangle(name.constData(), SpanDemangler::NameParts | SpanDemangler::FullName);
+            const auto parts = sd.parts();
+            const auto fullName = sd.fullName();
+
+            SpanDemangler fresh;
+            fresh.demangle(name.constData(), SpanDemangler::NameParts | SpanDemangler::FullName);
+            QCOMPARE(parts, fresh.parts());
+            QCOMPARE(fullName, fresh.fullName());
+
+            // only requesting one output must not change it
+            sd.demangle(name.constData(), SpanDemangler::FullName);
+            QCOMPARE(sd.partCount(), 0);
+            QCOMPARE(sd.fullName(), fullName);
+
+            const auto reference = cplus_demangle_v3(name.constData(), DemangleOptions);
+            QCOMPARE(fullName, reference ? QByteArray(reference) : name);
+            free(reference);
+        }
+    }
+
+    void benchmarkDemangle_data()
+    {
+        QTest::addColumn<int>("outputs"); // 0 for the libiberty baseline
+        QTest::newRow("libiberty full name") << 0;
+        QTest::newRow("full name") << (int)SpanDemangler::FullName;
+        QTest::newRow("name parts") << (int)SpanDemangler::NameParts;
+        QTest::newRow("name parts and full name") << (int)(SpanDemangler::NameParts | SpanDemangler::FullName);
+    }
+
+    void benchmarkDemangle()
+    {
+        QFETCH(int, outputs);
+        const auto &corpus = symbolCorpus();
+
+        if (outputs == 0) {
+            // what libiberty alone costs, parsing and printing into a reused buffer
+            std::vector<char> buffer;
+            QBENCHMARK {
+                for (const auto &name : corpus) {
+                    void *memory = nullptr;
+                    const auto component = cplus_demangle_v3_components(name.constData(), DemangleOptions, &memory);
+                    buffer.clear();
+                    if (component)
+                        cplus_demangle_print_callback(DemangleOptions, component, appendToBuffer, &buffer);
+                    free(memory);
+                }
+            }
+            return;
+        }
+
+        SpanDemangler sd;
+        QBENCHMARK {
+            for (const auto &name : corpus)
+                sd.demangle(name.constData(), outputs);
+        }
+    }
 };
 
 QTEST_MAIN(DemanglerTest)
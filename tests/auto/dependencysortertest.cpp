@@ -0,0 +1,161 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <optimizers/dependencysorter.h>
+
+#include <checks/ldsimulator.h>
+#include <elf/elffile.h>
+#include <elf/elffileset.h>
+#include <elf/elfsymboltablesection.h>
+
+#include <QtTest/qtest.h>
+#include <QObject>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include <algorithm>
+
+static QVector<QByteArray> neededLibraries(const QString &fileName)
+{
+    ElfFile f(fileName);
+    if (!f.open(QFile::ReadOnly) || !f.isValid() || !f.dynamicSection())
+        return {};
+    return f.dynamicSection()->neededLibraries();
+}
+
+struct Simulation {
+    uint64_t probes = 0;
+    QVector<QByteArray> bindings;
+};
+
+// probes of the entire lookup scope and which file each lookup binds to
+static Simulation simulate(const QString &fileName)
+{
+    ElfFileSet set;
+    set.addFile(fileName);
+    LDSimulator sim;
+    sim.simulateFileSet(&set);
+
+    Simulation s;
+    s.probes = sim.totalProbes();
+    for (int i = 0; i < sim.size(); ++i) {
+        foreach (const auto entry, sim.result(i).bindings) {
+            QByteArray binding = QFileInfo(sim.file(i)->fileName()).fileName().toUtf8() + ':';
+            if (entry)
+                binding += QFileInfo(entry->symbolTable()->file()->fileName()).fileName().toUtf8() + ':' + entry->name();
+            s.bindings.push_back(binding);
+        }
+    }
+    std::sort(s.bindings.begin(), s.bindings.end());
+    return s;
+}
+
+class DependencySorterTest : public QObject
+{
+    Q_OBJECT
+private:
+    // the executable with its libraries next to it, so the test can modify them
+    QString copyTarget(const QTemporaryDir &dir)
+    {
+        for (const auto &name : { "dt-needed-user", "libdt-needed-a.so", "libdt-needed-b.so", "libdt-needed-c.so" }) {
+            const auto fileName = dir.path() + QLatin1Char('/') + QLatin1String(name);
+            if (!QFile::copy(QLatin1String(BINDIR) + QLatin1String(name), fileName))
+                return {};
+            QFile::setPermissions(fileName, QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner);
+        }
+        return dir.path() + QLatin1String("/dt-needed-user");
+    }
+
+private slots:
+    void testDryRun()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const auto fileName = copyTarget(dir);
+        QVERIFY(!fileName.isEmpty());
+
+        QFile f(fileName);
+        QVERIFY(f.open(QFile::ReadOnly));
+        const auto before = f.readAll();
+        f.close();
+
+        {
+            ElfFileSet set;
+            set.addFile(fileName);
+            QVERIFY(set.size() >= 4);
+            DependencySorter sorter;
+            sorter.setDryRun(true);
+            sorter.sortDtNeeded(&set);
+        }
+
+        QVERIFY(f.open(QFile::ReadOnly));
+        QCOMPARE(f.readAll(), before);
+    }
+
+    void testSort()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const auto fileName = copyTarget(dir);
+        QVERIFY(!fileName.isEmpty());
+
+        const auto neededBefore = neededLibraries(fileName);
+        QCOMPARE(neededBefore.size(), 4);
+        QVERIFY(neededBefore.indexOf("libdt-needed-b.so") > neededBefore.indexOf("libdt-needed-a.so"));
+        const auto before = simulate(fileName);
+
+        {
+            ElfFileSet set;
+            set.addFile(fileName);
+            DependencySorter sorter;
+            sorter.sortDtNeeded(&set);
+        }
+
+        // same entries, and the heavily used library moved in front of the rarely used one
+        auto neededAfter = neededLibraries(fileName);
+        QVERIFY(neededAfter != neededBefore);
+        QVERIFY(neededAfter.indexOf("libdt-needed-b.so") < neededAfter.indexOf("libdt-needed-a.so"));
+        auto sortedBefore = neededBefore;
+        auto sortedAfter = neededAfter;
+        std::sort(sortedBefore.begin(), sortedBefore.end());
+        std::sort(sortedAfter.begin(), sortedAfter.end());
+        QCOMPARE(sortedAfter, sortedBefore);
+
+        // common() has to keep binding to dt-needed-a
+        QVERIFY(neededAfter.indexOf("libdt-needed-a.so") < neededAfter.indexOf("libdt-needed-c.so"));
+        const auto after = simulate(fileName);
+        QCOMPARE(after.bindings, before.bindings);
+        QVERIFY(after.bindings.contains("dt-needed-user:libdt-needed-a.so:common"));
+        QVERIFY(after.probes < before.probes);
+
+        // sorting again must not make things worse
+        {
+            ElfFileSet set;
+            set.addFile(fileName);
+            DependencySorter sorter;
+            sorter.setProcessAllFiles(true);
+            sorter.sortDtNeeded(&set);
+        }
+        const auto again = simulate(fileName);
+        QCOMPARE(again.bindings, before.bindings);
+        QVERIFY(again.probes <= after.probes);
+    }
+};
+
+QTEST_MAIN(DependencySorterTest)
+
+#include "dependencysortertest.moc"
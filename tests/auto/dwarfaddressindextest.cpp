@@ -0,0 +1,159 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <dwarf/dwarfaddressindex.h>
+#include <dwarf/dwarfcudie.h>
+#include <dwarf/dwarfdie.h>
+#include <dwarf/dwarfinfo.h>
+#include <elf/elffile.h>
+
+#include <QtTest/qtest.h>
+#include <QObject>
+#include <QSet>
+
+#include <dwarf.h>
+
+static bool isAncestorOrSelf(const DwarfDie *ancestor, DwarfDie *die)
+{
+    for (; die; die = die->parentDie()) {
+        if (die == ancestor)
+            return true;
+    }
+    return false;
+}
+
+class DwarfAddressIndexTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testLookup_data()
+    {
+        QTest::addColumn<QString>("binary");
+        QTest::newRow("single-executable") << QStringLiteral(BINDIR "single-executable");
+        QTest::newRow("structures") << QStringLiteral(BINDIR "structures");
+        QTest::newRow("inlined-functions") << QStringLiteral(BINDIR "inlined-functions");
+    }
+
+    void testLookup()
+    {
+        QFETCH(QString, binary);
+        ElfFile f(binary);
+        QVERIFY(f.open(QFile::ReadOnly));
+        QVERIFY(f.dwarfInfo());
+        const auto index = f.dwarfInfo()->addressIndex();
+        QVERIFY(index);
+        QVERIFY(!index->isEmpty());
+
+        foreach (auto cu, f.dwarfInfo()->compilationUnits()) {
+            for (int i = 0; i < cu->dieCount(); ++i) {
+                const auto die = cu->dieAt(i);
+                if (die->tag() != DW_TAG_subprogram && die->tag() != DW_TAG_inlined_subroutine)
+                    continue;
+                const auto lowPC = die->attributeUnsigned(DW_AT_low_pc);
+                if (lowPC == 0 || !die->hasAttribute(DW_AT_high_pc))
+                    continue;
+
+                QCOMPARE(index->compilationUnitForAddress(lowPC), cu);
+
+                // the innermost DIE can be nested further, or an identical function folded into this one
+                const auto innermost = index->dieForAddress(lowPC);
+                QVERIFY(innermost);
+                QVERIFY(isAncestorOrSelf(die, innermost) || innermost->attributeUnsigned(DW_AT_low_pc) == lowPC);
+
+                if (die->tag() == DW_TAG_subprogram) {
+                    const auto subprogram = index->subprogramForAddress(lowPC);
+                    QVERIFY(subprogram);
+                    QVERIFY(subprogram == die || subprogram->attributeUnsigned(DW_AT_low_pc) == lowPC);
+                }
+            }
+        }
+
+        QVERIFY(!index->dieForAddress(0));
+        QVERIFY(!index->compilationUnitForAddress(~0ull));
+    }
+
+    void testInlinedSubroutines()
+    {
+        ElfFile f(QStringLiteral(BINDIR "inlined-functions"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        QVERIFY(f.dwarfInfo());
+        const auto index = f.dwarfInfo()->addressIndex();
+
+        DwarfDie *main = nullptr;
+        foreach (auto cu, f.dwarfInfo()->compilationUnits()) {
+            foreach (auto die, cu->children()) {
+                if (die->tag() == DW_TAG_subprogram && die->name() == "main" && die->hasAttribute(DW_AT_low_pc))
+                    main = die;
+            }
+        }
+        QVERIFY(main);
+        const auto lowPC = main->attributeUnsigned(DW_AT_low_pc);
+        auto highPC = main->attributeUnsigned(DW_AT_high_pc);
+        if (highPC < lowPC)
+            highPC += lowPC;
+        QVERIFY(lowPC < highPC);
+
+        QSet<DwarfDie*> inlined;
+        for (auto addr = lowPC; addr < highPC; ++addr) {
+            QCOMPARE(index->subprogramForAddress(addr), main);
+            const auto die = index->dieForAddress(addr);
+            QVERIFY(isAncestorOrSelf(main, die));
+            if (die->tag() == DW_TAG_inlined_subroutine)
+                inlined.insert(die);
+        }
+        QVERIFY(!inlined.isEmpty());
+    }
+
+    void testSplitDwarf()
+    {
+        ElfFile f(QStringLiteral(BINDIR "split-dwarf"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        QVERIFY(f.dwarfInfo());
+        const auto index = f.dwarfInfo()->addressIndex();
+
+        int subprogramCount = 0;
+        foreach (auto cu, f.dwarfInfo()->compilationUnits()) {
+            if (!cu->hasAttribute(DW_AT_dwo_name) && !cu->hasAttribute(DW_AT_GNU_dwo_name)) {
+                QVERIFY(!cu->splitUnit());
+                continue;
+            }
+            const auto splitUnit = cu->splitUnit();
+            QVERIFY(splitUnit);
+            QCOMPARE(cu->splitUnit(), splitUnit);
+            QVERIFY(splitUnit->dwarfInfo() != f.dwarfInfo());
+            QVERIFY(!splitUnit->splitUnit());
+
+            for (int i = 0; i < splitUnit->dieCount(); ++i) {
+                const auto die = splitUnit->dieAt(i);
+                if (die->tag() != DW_TAG_subprogram || !die->hasAttribute(DW_AT_low_pc))
+                    continue;
+                ++subprogramCount;
+                const auto lowPC = die->attributeUnsigned(DW_AT_low_pc);
+                QCOMPARE(index->compilationUnitForAddress(lowPC), cu);
+                const auto subprogram = index->subprogramForAddress(lowPC);
+                QVERIFY(subprogram);
+                QCOMPARE(subprogram->compilationUnit(), splitUnit);
+                QVERIFY(subprogram == die || subprogram->attributeUnsigned(DW_AT_low_pc) == lowPC);
+            }
+        }
+        QVERIFY(subprogramCount > 0);
+    }
+};
+
+QTEST_MAIN(DwarfAddressIndexTest)
+
+#include "dwarfaddressindextest.moc"
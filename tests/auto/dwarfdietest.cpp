@@ -20,12 +20,15 @@
 #include <dwarf/dwarfinfo.h>
 #include <dwarf/dwarfranges.h>
 #include <dwarf/dwarfaddressranges.h>
+#include <dwarf/dwarfline.h>
 
 #include <QtTest/qtest.h>
 #include <QObject>
 
 #include <dwarf.h>
 
+#include <limits>
+
 class DwarfDieTest : public QObject
 {
     Q_OBJECT
@@ -51,6 +54,99 @@ private slots:
         QVERIFY(cu->attributes().size() > 0);
     }
 
+    void testChildren()
+    {
+        ElfFile f(QStringLiteral(BINDIR "structures"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        QVERIFY(f.dwarfInfo());
+
+        foreach (auto cu, f.dwarfInfo()->compilationUnits()) {
+            QCOMPARE(cu->dieAt(0), cu);
+            QVERIFY(cu->dieCount() > 0);
+            int count = 1;
+            QVector<DwarfDie*> dieQueue = cu->children().toVector();
+            while (!dieQueue.isEmpty()) {
+                const auto die = dieQueue.takeFirst();
+                ++count;
+                QCOMPARE(die->compilationUnit(), cu);
+                QCOMPARE(cu->dieForOffset(die->offset()), die);
+                QCOMPARE(f.dwarfInfo()->dieAtOffset(die->offset()), die);
+
+                const auto siblings = die->parentDie()->children();
+                const auto index = siblings.indexOf(die);
+                QVERIFY(index >= 0);
+                QCOMPARE(siblings.at(index), die);
+                QCOMPARE(die->nextSibling(), index + 1 < siblings.size() ? siblings.at(index + 1) : nullptr);
+
+                const auto children = die->children();
+                QCOMPARE(children.isEmpty(), children.size() == 0);
+                foreach (auto child, children)
+                    QCOMPARE(child->parentDie(), die);
+                dieQueue += children.toVector();
+            }
+            QCOMPARE(count, cu->dieCount());
+        }
+    }
+
+    void testDieAtOffset()
+    {
+        ElfFile f(QStringLiteral(BINDIR "structures"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        QVERIFY(f.dwarfInfo());
+
+        const auto cus = f.dwarfInfo()->compilationUnits();
+        QVERIFY(!cus.isEmpty());
+        QCOMPARE(f.dwarfInfo()->dieAtOffset(0), static_cast<DwarfDie*>(nullptr));
+        QCOMPARE(f.dwarfInfo()->dieAtOffset(std::numeric_limits<Dwarf_Off>::max()), static_cast<DwarfDie*>(nullptr));
+
+        for (int i = 0; i < cus.size(); ++i) {
+            const auto cu = cus.at(i);
+            QVERIFY(cu->containsOffset(cu->offset()));
+            QVERIFY(!cu->containsOffset(cu->offset() - 1));
+            QCOMPARE(cu->dieForOffset(cu->offset() - 1), static_cast<DwarfDie*>(nullptr));
+            if (i + 1 < cus.size()) {
+                QVERIFY(!cu->containsOffset(cus.at(i + 1)->offset()));
+                QCOMPARE(cu->dieAtOffset(cus.at(i + 1)->offset()), cus.at(i + 1));
+            }
+
+            // references resolve within the unit
+            for (int j = 1; j < cu->dieCount(); ++j) {
+                const auto die = cu->dieAt(j);
+                QVERIFY(cu->containsOffset(die->offset()));
+                QCOMPARE(cu->dieAtOffset(die->offset()), die);
+                QCOMPARE(die->dieAtOffset(cu->offset()), cu);
+            }
+        }
+    }
+
+    void testTypedAttributes()
+    {
+        ElfFile f(QStringLiteral(BINDIR "structures"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        QVERIFY(f.dwarfInfo());
+
+        foreach (auto cu, f.dwarfInfo()->compilationUnits()) {
+            for (int i = 0; i < cu->dieCount(); ++i) {
+                const auto die = cu->dieAt(i);
+                foreach (const auto at, die->attributes())
+                    QVERIFY(die->hasAttribute(at));
+                QVERIFY(!die->hasAttribute(DW_AT_lo_user));
+
+                QCOMPARE(die->attributeDie(DW_AT_type), die->attribute(DW_AT_type).value<DwarfDie*>());
+                QCOMPARE(die->attributeFlag(DW_AT_declaration), die->attribute(DW_AT_declaration).toBool());
+                QCOMPARE(die->attributeFlag(DW_AT_external), die->attribute(DW_AT_external).toBool());
+                QCOMPARE(die->attributeUnsigned(DW_AT_byte_size), die->attribute(DW_AT_byte_size).toULongLong());
+                QCOMPARE(die->attributeUnsigned(DW_AT_decl_line), die->attribute(DW_AT_decl_line).toULongLong());
+                QCOMPARE(QByteArray(die->attributeString(DW_AT_name)), die->attribute(DW_AT_name).toByteArray());
+                QCOMPARE(die->attributeString(DW_AT_type), static_cast<const char*>(nullptr));
+                QCOMPARE(die->attributeUnsigned(DW_AT_name, 42), 42ull);
+            }
+            // natively scanned DIEs are decoded on demand, only the unit DIE itself comes from libdwarf
+            if (f.dwarfInfo()->scanner()->isValid())
+                QVERIFY(cu->attributeCacheCount() <= 1);
+        }
+    }
+
     void testAttribute_AT_ranges()
     {
         ElfFile f(QStringLiteral(BINDIR "single-executable"));
@@ -90,7 +186,7 @@ private slots:
         std::copy(cus.constBegin(), cus.constEnd(), dieQueue.begin());
         while (!dieQueue.isEmpty()) {
             const auto die = dieQueue.takeFirst();
-            dieQueue += die->children();
+            dieQueue += die->children().toVector();
 
             const auto lowPC = die->attribute(DW_AT_low_pc).toULongLong();
             if (lowPC <= 0)
@@ -102,13 +198,49 @@ private slots:
                 cuDie = cuDie->parentDie();
             QCOMPARE(cuDie, lookupCU);
 
-            if (die->tag() == DW_TAG_compile_unit)
+            if (die->tag() != DW_TAG_subprogram)
                 continue;
 
             const auto lookupDie = f.dwarfInfo()->addressRanges()->dieForAddress(lowPC);
+            QVERIFY(lookupDie);
             QVERIFY(die == lookupDie || lowPC == lookupDie->attribute(DW_AT_low_pc).toULongLong());
         }
     }
+
+    void testLineTable()
+    {
+        ElfFile f(QStringLiteral(BINDIR "inlined-functions"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        QVERIFY(f.dwarfInfo());
+
+        foreach (auto cu, f.dwarfInfo()->compilationUnits()) {
+            foreach (auto die, cu->children()) {
+                if (die->tag() != DW_TAG_subprogram || !die->hasAttribute(DW_AT_low_pc))
+                    continue;
+                const auto lowPC = die->attributeUnsigned(DW_AT_low_pc);
+                auto highPC = die->attributeUnsigned(DW_AT_high_pc);
+                if (highPC < lowPC)
+                    highPC += lowPC;
+
+                QVector<Dwarf_Addr> addrs;
+                for (auto addr = lowPC; addr < highPC; ++addr)
+                    addrs.push_back(addr);
+                const auto lines = cu->linesForAddresses(addrs);
+                QCOMPARE(lines.size(), addrs.size());
+                QCOMPARE(f.dwarfInfo()->linesForAddresses(addrs), lines);
+
+                for (int i = 0; i < addrs.size(); ++i) {
+                    const auto line = cu->lineForAddress(addrs.at(i));
+                    QVERIFY(!line.isNull());
+                    QVERIFY(line.address() <= addrs.at(i));
+                    QVERIFY(line.line() > 0);
+                    QCOMPARE(lines.at(i), line);
+                    QCOMPARE(cu->lineForAddress(line.address()), line);
+                }
+            }
+            QVERIFY(cu->lineForAddress(0).isNull());
+        }
+    }
 };
 
 QTEST_MAIN(DwarfDieTest)
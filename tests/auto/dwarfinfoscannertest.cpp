@@ -0,0 +1,287 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <dwarf/dwarfcudie.h>
+#include <dwarf/dwarfinfo.h>
+#include <dwarf/dwarfinfoscanner.h>
+#include <elf/elffile.h>
+#include <elf/elfsymboltablesection.h>
+#include <elf/elfsymboltableentry.h>
+
+#include <QtTest/qtest.h>
+#include <QObject>
+
+#include <dwarf.h>
+#include <elf.h>
+
+#include <cstring>
+
+static void flattenTree(DwarfDie *die, QVector<DwarfDie*> &dies)
+{
+    dies.push_back(die);
+    foreach (auto child, die->children())
+        flattenTree(child, dies);
+}
+
+/** What libdwarf decodes for a DIE, bypassing the native scanner used by DwarfDie. */
+struct LibdwarfDie
+{
+    uint64_t offset = 0;
+    uint16_t tag = 0;
+    QByteArray name;
+    uint64_t lowPC = 0;
+    uint64_t highPC = 0;
+};
+
+static void flattenLibdwarfTree(Dwarf_Debug dbg, Dwarf_Die die, QVector<LibdwarfDie> &dies)
+{
+    LibdwarfDie d;
+    Dwarf_Off offset = 0;
+    dwarf_dieoffset(die, &offset, nullptr);
+    d.offset = offset;
+    Dwarf_Half tag = 0;
+    dwarf_tag(die, &tag, nullptr);
+    d.tag = tag;
+    char *name = nullptr;
+    if (dwarf_diename(die, &name, nullptr) == DW_DLV_OK)
+        d.name = name;
+    Dwarf_Addr lowPC = 0, highPC = 0;
+    Dwarf_Half form = 0;
+    enum Dwarf_Form_Class formClass = DW_FORM_CLASS_UNKNOWN;
+    if (dwarf_lowpc(die, &lowPC, nullptr) == DW_DLV_OK && dwarf_highpc_b(die, &highPC, &form, &formClass, nullptr) == DW_DLV_OK) {
+        d.lowPC = lowPC;
+        d.highPC = formClass == DW_FORM_CLASS_CONSTANT ? lowPC + highPC : highPC;
+    }
+    dies.push_back(d);
+
+    Dwarf_Die child = nullptr;
+    if (dwarf_child(die, &child, nullptr) != DW_DLV_OK)
+        return;
+    while (child) {
+        flattenLibdwarfTree(dbg, child, dies);
+        Dwarf_Die sibling = nullptr;
+        const auto res = dwarf_siblingof_b(dbg, child, true, &sibling, nullptr);
+        dwarf_dealloc(dbg, child, DW_DLA_DIE);
+        child = res == DW_DLV_OK ? sibling : nullptr;
+    }
+}
+
+class DwarfInfoScannerTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testScanUnits_data()
+    {
+        QTest::addColumn<QString>("executable");
+        QTest::newRow("single-executable") << QStringLiteral(BINDIR "single-executable");
+        QTest::newRow("structures") << QStringLiteral(BINDIR "structures");
+        QTest::newRow("elf-dissector") << QStringLiteral(BINDIR "elf-dissector");
+    }
+
+    void testScanUnits()
+    {
+        QFETCH(QString, executable);
+
+        ElfFile f(executable);
+        QVERIFY(f.open(QFile::ReadOnly));
+        QVERIFY(f.dwarfInfo());
+
+        const auto scanner = f.dwarfInfo()->scanner();
+        QVERIFY(scanner);
+        QVERIFY(scanner->isValid());
+        const auto cus = f.dwarfInfo()->compilationUnits();
+        QCOMPARE(scanner->unitCount(), cus.size());
+
+        QVector<DwarfDieRecord> records;
+        for (int i = 0; i < cus.size(); ++i) {
+            const auto &unit = scanner->unit(i);
+            QCOMPARE(unit.dieOffset, cus.at(i)->offset());
+            QCOMPARE(scanner->indexOfUnit(unit.offset), i);
+            QCOMPARE(scanner->indexOfUnit(unit.endOffset - 1), i);
+            QVERIFY(scanner->scanUnit(i, &records));
+
+            // must match what libdwarf sees, in the same order
+            QVector<DwarfDie*> dies;
+            flattenTree(cus.at(i), dies);
+            QCOMPARE(records.size(), dies.size());
+            for (int j = 0; j < records.size(); ++j) {
+                const auto &record = records.at(j);
+                const auto die = dies.at(j);
+                QCOMPARE(record.offset, die->offset());
+                QCOMPARE(record.tag, die->tag());
+
+                if (die->parentDie())
+                    QCOMPARE(records.at(record.parent).offset, die->parentDie()->offset());
+                else
+                    QCOMPARE(record.parent, (uint32_t)DwarfDieRecord::InvalidIndex);
+                const auto children = die->children();
+                if (children.isEmpty())
+                    QCOMPARE(record.firstChild, (uint32_t)DwarfDieRecord::InvalidIndex);
+                else
+                    QCOMPARE(records.at(record.firstChild).offset, children.first()->offset());
+
+                DwarfFormValue value;
+                if (scanner->findAttribute(unit, record, DW_AT_name, &value)) {
+                    const auto name = scanner->readString(unit, value);
+                    if (name)
+                        QCOMPARE(QByteArray(name), die->attribute(DW_AT_name).toByteArray());
+                }
+                uint64_t ref = 0;
+                if (scanner->findAttribute(unit, record, DW_AT_type, &value) && scanner->readReference(unit, value, &ref))
+                    QCOMPARE(ref, die->attribute(DW_AT_type).value<DwarfDie*>()->offset());
+            }
+        }
+    }
+
+    void testScanSplitUnits_data()
+    {
+        QTest::addColumn<QString>("executable");
+        QTest::addColumn<bool>("isPackage");
+        QTest::newRow("split-dwarf") << QStringLiteral(BINDIR "split-dwarf") << false;
+        QTest::newRow("split-dwarf-package") << QStringLiteral(BINDIR "split-dwarf-package") << true;
+    }
+
+    void testScanSplitUnits()
+    {
+        QFETCH(QString, executable);
+        QFETCH(bool, isPackage);
+        if (!QFile::exists(executable))
+            QSKIP("dwp not available");
+
+        ElfFile f(executable);
+        QVERIFY(f.open(QFile::ReadOnly));
+        QVERIFY(f.dwarfInfo());
+        const auto skeletonScanner = f.dwarfInfo()->scanner();
+        QVERIFY(skeletonScanner->isValid());
+
+        int unitCount = 0;
+        int packageUnitCount = 0;
+        int rangesCount = 0;
+        QVector<DwarfDieRecord> records;
+        foreach (auto skeleton, f.dwarfInfo()->compilationUnits()) {
+            const auto splitUnit = skeleton->splitUnit();
+            if (!splitUnit)
+                continue;
+            ++unitCount;
+            const auto info = splitUnit->dwarfInfo();
+            QCOMPARE(info->elfFile()->fileName().endsWith(QLatin1String(".dwp")), isPackage);
+
+            const auto scanner = info->scanner();
+            QVERIFY(scanner->isValid());
+            const auto unitIndex = scanner->indexOfUnit(splitUnit->offset());
+            QVERIFY(unitIndex >= 0);
+            const auto &unit = scanner->unit(unitIndex);
+            QCOMPARE(unit.dieOffset, uint64_t(splitUnit->offset()));
+            const auto skeletonIndex = skeletonScanner->indexOfUnit(skeleton->offset());
+            QVERIFY(skeletonIndex >= 0);
+            QVERIFY(unit.dwoId != 0);
+            QCOMPARE(unit.dwoId, skeletonScanner->unit(skeletonIndex).dwoId);
+            QCOMPARE(scanner->indexOfDwoId(unit.dwoId), unitIndex);
+            QVERIFY(scanner->scanUnit(unitIndex, &records));
+
+            QVector<LibdwarfDie> dies;
+            {
+                const auto lock = info->lockDwarfHandle();
+                const auto dbg = info->dwarfHandle();
+                Dwarf_Die die = nullptr;
+                QCOMPARE(dwarf_offdie_b(dbg, splitUnit->offset(), true, &die, nullptr), (int)DW_DLV_OK);
+
+                // section contributions as read from the unit index
+                Dwarf_Debug_Fission_Per_CU fission;
+                memset(&fission, 0, sizeof(fission));
+                if (dwarf_get_debugfission_for_die(die, &fission, nullptr) == DW_DLV_OK) {
+                    ++packageUnitCount;
+                    uint64_t dwoId = 0;
+                    memcpy(&dwoId, fission.pcu_hash.signature, sizeof(dwoId));
+                    QCOMPARE(dwoId, unit.dwoId);
+                    QCOMPARE(unit.offset, uint64_t(fission.pcu_offset[DW_SECT_INFO]));
+                    QCOMPARE(unit.abbreviationOffset, uint64_t(fission.pcu_offset[DW_SECT_ABBREV]));
+                    QCOMPARE(unit.strOffsetsBase, uint64_t(fission.pcu_offset[DW_SECT_STR_OFFSETS] + (unit.format.version >= 5 ? 2 * unit.format.offsetSize : 0)));
+                }
+
+                flattenLibdwarfTree(dbg, die, dies);
+            }
+
+            // DIE structure depends on the abbreviation contribution, names on the string offsets base
+            QCOMPARE(records.size(), dies.size());
+            for (int i = 0; i < records.size(); ++i) {
+                const auto &record = records.at(i);
+                const auto &die = dies.at(i);
+                QCOMPARE(record.offset, die.offset);
+                QCOMPARE(record.tag, die.tag);
+
+                DwarfFormValue value;
+                if (scanner->findAttribute(unit, record, DW_AT_name, &value))
+                    QCOMPARE(QByteArray(scanner->readString(unit, value)), die.name);
+                else
+                    QVERIFY(die.name.isEmpty());
+
+                QVector<DwarfAddressRange> ranges;
+                QVERIFY(scanner->readRanges(unit, record, &ranges));
+                if (die.lowPC < die.highPC) {
+                    QCOMPARE(ranges.size(), 1);
+                    QCOMPARE(ranges.at(0).begin, die.lowPC);
+                    QCOMPARE(ranges.at(0).end, die.highPC);
+                }
+                if (!scanner->findAttribute(unit, record, DW_AT_ranges, &value) || ranges.isEmpty())
+                    continue;
+
+                // libdwarf doesn't decode split range lists, but they have to lie within the enclosing function
+                ++rangesCount;
+                auto parent = record.parent;
+                while (parent != DwarfDieRecord::InvalidIndex && dies.at(parent).lowPC >= dies.at(parent).highPC)
+                    parent = records.at(parent).parent;
+                QVERIFY(parent != DwarfDieRecord::InvalidIndex);
+                for (const auto &range : ranges) {
+                    QVERIFY(range.begin >= dies.at(parent).lowPC);
+                    QVERIFY(range.end <= dies.at(parent).highPC);
+                }
+            }
+        }
+        QVERIFY(unitCount > 0);
+        QVERIFY(rangesCount > 0);
+        QCOMPARE(packageUnitCount, isPackage ? unitCount : 0);
+        if (isPackage)
+            QVERIFY(unitCount > 1);
+    }
+
+    void testDieForMangledSymbol()
+    {
+        ElfFile f(QStringLiteral(BINDIR "structures"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        QVERIFY(f.dwarfInfo());
+        const auto symtab = f.symbolTable();
+        QVERIFY(symtab);
+
+        int hits = 0;
+        for (uint32_t i = 0; i < symtab->header()->entryCount(); ++i) {
+            const auto entry = symtab->entry(i);
+            if (entry->type() != STT_FUNC || !QByteArray(entry->name()).startsWith("_Z"))
+                continue;
+            const auto die = f.dwarfInfo()->dieForMangledSymbol(entry->name());
+            if (!die)
+                continue;
+            QCOMPARE(die->attribute(DW_AT_linkage_name).toByteArray(), QByteArray(entry->name()));
+            ++hits;
+        }
+        QVERIFY(hits > 0);
+    }
+};
+
+QTEST_MAIN(DwarfInfoScannerTest)
+
+#include "dwarfinfoscannertest.moc"
@@ -0,0 +1,84 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <dwarf/dwarfdie.h>
+#include <dwarf/dwarfinfo.h>
+#include <dwarf/dwarfnameindex.h>
+#include <elf/elffile.h>
+#include <elf/elfsymboltablesection.h>
+#include <elf/elfsymboltableentry.h>
+
+#include <QtTest/qtest.h>
+#include <QObject>
+
+#include <dwarf.h>
+#include <elf.h>
+
+class DwarfNameIndexTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testLookup()
+    {
+        ElfFile f(QStringLiteral(BINDIR "structures-pubnames"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        QVERIFY(f.dwarfInfo());
+        const auto index = f.dwarfInfo()->nameIndex();
+        QVERIFY(index);
+        QVERIFY(index->type() != DwarfNameIndex::NoIndex);
+
+        const auto entries = index->lookup("main");
+        QVERIFY(!entries.isEmpty());
+        foreach (const auto &entry, entries) {
+            const auto die = f.dwarfInfo()->dieAtOffset(entry.offset);
+            QVERIFY(die);
+            if (entry.isUnit)
+                QVERIFY(die->isCompilationUnit());
+            else
+                QCOMPARE(die->name(), QByteArray("main"));
+        }
+
+        QVERIFY(index->lookup("this name does not exist").isEmpty());
+    }
+
+    void testDieForMangledSymbol()
+    {
+        ElfFile f(QStringLiteral(BINDIR "structures-pubnames"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        QVERIFY(f.dwarfInfo());
+        const auto symtab = f.symbolTable();
+        QVERIFY(symtab);
+
+        int hits = 0;
+        for (uint32_t i = 0; i < symtab->header()->entryCount(); ++i) {
+            const auto entry = symtab->entry(i);
+            if (entry->type() != STT_FUNC || !QByteArray(entry->name()).startsWith("_Z"))
+                continue;
+            const auto die = f.dwarfInfo()->dieForMangledSymbol(entry->name());
+            if (!die)
+                continue;
+            QCOMPARE(die->attribute(DW_AT_linkage_name).toByteArray(), QByteArray(entry->name()));
+            ++hits;
+        }
+        QVERIFY(hits > 0);
+        QVERIFY(!f.dwarfInfo()->dieForMangledSymbol("_ZN17DoesNotExist3fooEv"));
+    }
+};
+
+QTEST_MAIN(DwarfNameIndexTest)
+
+#include "dwarfnameindextest.moc"
@@ -22,6 +22,8 @@
 
 #include <elf.h>
 
+#include <algorithm>
+
 class ElfFileSetTest : public QObject
 {
     Q_OBJECT
@@ -73,6 +75,23 @@ private slots:
         }
         QVERIFY(foundQtCore);
     }
+
+    void testLookupScopeOverride()
+    {
+        ElfFileSet f;
+        f.addFile(QStringLiteral(BINDIR "elf-dissector"));
+        QVERIFY(f.size() > 2);
+
+        auto needed = f.file(0)->dynamicSection()->neededLibraries();
+        QVERIFY(needed.size() > 1);
+        std::reverse(needed.begin(), needed.end());
+
+        const auto scope = f.lookupScope({ { f.file(0), needed } });
+        QCOMPARE(scope.size(), f.size());
+        QCOMPARE(scope.at(0), f.file(0));
+        for (int i = 0; i < needed.size() && i + 1 < scope.size(); ++i)
+            QCOMPARE(scope.at(i + 1)->dynamicSection()->soName(), needed.at(i));
+    }
 };
 
 QTEST_MAIN(ElfFileSetTest)
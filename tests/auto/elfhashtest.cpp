@@ -89,10 +89,23 @@ private slots:
         QVERIFY(hashSection->symbolIndex() < symTab->header()->entryCount());
         QCOMPARE((uint64_t)hashSection->chainCount(), symTab->header()->entryCount() - hashSection->symbolIndex());
 
+        ElfHashSection::LookupStatistics stats;
         for (uint32_t i = hashSection->symbolIndex(); i < symTab->header()->entryCount(); ++i) {
             const auto entry = symTab->entry(i);
             QCOMPARE(hashSection->lookup(entry->name()), entry);
+            QCOMPARE(hashSection->lookup(entry->name(), &stats), entry);
         }
+        // every defined symbol passes the bloom filter and needs at least one compare
+        QCOMPARE(stats.lookups, (uint64_t)hashSection->chainCount());
+        QCOMPARE(stats.bloomRejections, (uint64_t)0);
+        QCOMPARE(stats.bucketHits, stats.lookups);
+        QVERIFY(stats.stringCompares >= stats.lookups);
+        QVERIFY(stats.chainSteps >= stats.stringCompares);
+
+        ElfHashSection::LookupStatistics missStats;
+        QVERIFY(!hashSection->lookup("_ZN22ThisSymbolDoesNotExistEv", &missStats));
+        QCOMPARE(missStats.lookups, (uint64_t)1);
+        QVERIFY(missStats.bloomRejections + missStats.bucketHits <= 1);
 
         const auto hist = hashSection->histogram();
         const uint32_t sum = std::accumulate(hist.begin(), hist.end(), 0);
@@ -0,0 +1,185 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <elf/elffileset.h>
+#include <elf/elfheader.h>
+#include <elf/elfrelocationsimulator.h>
+#include <elf/elfsymboltablesection.h>
+
+#include <QtTest/qtest.h>
+#include <QObject>
+
+#include <elf.h>
+#include <cstring>
+#include <limits>
+
+class ElfRelocationSimulatorTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testLookupScope()
+    {
+        ElfFileSet set;
+        set.addFile(QStringLiteral(BINDIR "elf-dissector"));
+        QVERIFY(set.size() > 1);
+
+        const auto scope = set.lookupScope();
+        QCOMPARE(scope.size(), set.size());
+        QCOMPARE(scope.at(0), set.file(0));
+        // direct dependencies come first
+        const auto needed = set.file(0)->dynamicSection()->neededLibraries();
+        for (int i = 0; i < needed.size() && i + 1 < scope.size(); ++i)
+            QCOMPARE(scope.at(i + 1)->dynamicSection()->soName(), needed.at(i));
+    }
+
+    void testResolveAll_data()
+    {
+        QTest::addColumn<QString>("executable");
+        QTest::newRow("single-executable") << QStringLiteral(BINDIR "single-executable");
+        QTest::newRow("virtual-methods") << QStringLiteral(BINDIR "virtual-methods");
+        QTest::newRow("elf-dissector") << QStringLiteral(BINDIR "elf-dissector");
+    }
+
+    void testResolveAll()
+    {
+        QFETCH(QString, executable);
+
+        ElfFileSet set;
+        set.addFile(executable);
+        QVERIFY(set.size() > 1);
+
+        ElfRelocationSimulator sim(&set);
+        QCOMPARE(sim.unresolvedRelocationCount(set.file(0)), 0);
+
+        // every library is mapped at a distinct address
+        for (int i = 0; i < set.size(); ++i) {
+            const auto file = set.file(i);
+            const auto symtab = file->symbolTable();
+            if (!symtab)
+                continue;
+            for (uint32_t j = 0; j < symtab->header()->entryCount(); ++j) {
+                const auto entry = symtab->entry(j);
+                if (entry->type() != STT_FUNC || entry->sectionIndex() == SHN_UNDEF || entry->size() == 0)
+                    continue;
+                QCOMPARE(sim.fileForAddress(sim.baseAddress(file) + entry->value()), file);
+                break;
+            }
+        }
+    }
+
+    void testVTable()
+    {
+        ElfFileSet set;
+        set.addFile(QStringLiteral(BINDIR "virtual-methods"));
+        QVERIFY(set.size() > 1);
+        const auto file = set.file(0);
+        const auto symtab = file->symbolTable();
+        QVERIFY(symtab);
+
+        ElfSymbolTableEntry *vtable = nullptr;
+        for (uint32_t i = 0; i < symtab->header()->entryCount(); ++i) {
+            if (strcmp(symtab->entry(i)->name(), "_ZTV7Derived") == 0)
+                vtable = symtab->entry(i);
+        }
+        QVERIFY(vtable);
+
+        ElfRelocationSimulator sim(&set);
+        const auto addrSize = file->addressSize();
+        const auto typeInfo = sim.symbolForAddress(sim.pointerValue(file, vtable->value() + addrSize));
+        QVERIFY(typeInfo);
+        QCOMPARE(typeInfo->name(), "_ZTI7Derived");
+        const auto pure = sim.symbolForAddress(sim.pointerValue(file, vtable->value() + 2 * addrSize));
+        QVERIFY(pure);
+        QCOMPARE(pure->name(), "_ZN7Derived4pureEv");
+        const auto baseOnly = sim.symbolForAddress(sim.pointerValue(file, vtable->value() + 3 * addrSize));
+        QVERIFY(baseOnly);
+        QCOMPARE(baseOnly->name(), "_ZN4Base8baseOnlyEv");
+
+        // moving the executable moves the relocated pointers along for PIC
+        if (file->header()->type() == ET_DYN) {
+            const auto before = sim.pointerValue(file, vtable->value() + 2 * addrSize);
+            sim.setBaseAddress(file, sim.baseAddress(file) + 0x100000);
+            QCOMPARE(sim.pointerValue(file, vtable->value() + 2 * addrSize), before + 0x100000);
+        }
+    }
+
+    void testSymbolVersions()
+    {
+        ElfFileSet set;
+        set.addFile(QStringLiteral(BINDIR "versioned-symbols-user"));
+        QVERIFY(set.size() > 1);
+        const auto exe = set.file(0);
+        ElfFile *lib = nullptr;
+        for (int i = 0; i < set.size(); ++i) {
+            if (set.file(i)->displayName().contains(QLatin1String("libversioned-symbols")))
+                lib = set.file(i);
+        }
+        QVERIFY(lib);
+
+        ElfSymbolTableEntry *ptr = nullptr, *function1 = nullptr, *function2 = nullptr;
+        for (uint32_t i = 0; i < exe->symbolTable()->header()->entryCount(); ++i) {
+            if (strcmp(exe->symbolTable()->entry(i)->name(), "functionPtr") == 0)
+                ptr = exe->symbolTable()->entry(i);
+        }
+        for (uint32_t i = 0; i < lib->symbolTable()->header()->entryCount(); ++i) {
+            const auto entry = lib->symbolTable()->entry(i);
+            if (strcmp(entry->name(), "function1") == 0)
+                function1 = entry;
+            else if (strcmp(entry->name(), "function2") == 0)
+                function2 = entry;
+        }
+        QVERIFY(ptr);
+        QVERIFY(function1);
+        QVERIFY(function2);
+
+        ElfRelocationSimulator sim(&set);
+        QCOMPARE(sim.unresolvedRelocationCount(exe), 0);
+        bool ok = false;
+        QCOMPARE(sim.pointerValue(exe, ptr->value(), &ok), sim.baseAddress(lib) + function1->value());
+        QVERIFY(ok);
+
+        // unversioned lookups find the default version
+        const auto def = sim.resolveSymbol("function");
+        QVERIFY(def);
+        QCOMPARE(def->value(), function2->value());
+    }
+
+    void testInvalidFile()
+    {
+        ElfFileSet set;
+        set.addFile(QStringLiteral(BINDIR "single-executable"));
+        ElfFile other(QStringLiteral(BINDIR "structures"));
+        QVERIFY(other.open(QFile::ReadOnly));
+
+        ElfRelocationSimulator sim(&set);
+        QVERIFY(sim.contains(set.file(0)));
+        QVERIFY(!sim.contains(&other));
+        QCOMPARE(sim.unresolvedRelocationCount(&other), -1);
+        QVERIFY(!sim.setBaseAddress(&other, 0x100000));
+
+        bool ok = true;
+        QCOMPARE(sim.pointerValue(&other, 0, &ok), static_cast<uint64_t>(0));
+        QVERIFY(!ok);
+        // not mapped
+        sim.pointerValue(set.file(0), std::numeric_limits<uint64_t>::max() - 64, &ok);
+        QVERIFY(!ok);
+    }
+};
+
+QTEST_MAIN(ElfRelocationSimulatorTest)
+
+#include "elfrelocationsimulatortest.moc"
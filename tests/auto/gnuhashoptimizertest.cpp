@@ -0,0 +1,216 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <optimizers/gnuhashoptimizer.h>
+
+#include <elf/elffile.h>
+#include <elf/elffileset.h>
+#include <elf/elfgnuhashsection.h>
+#include <elf/elfgnusymbolversiontable.h>
+#include <elf/elfrelocationentry.h>
+#include <elf/elfrelocationsection.h>
+#include <elf/elfsymboltablesection.h>
+#include <elf/elfsysvhashsection.h>
+
+#include <QtTest/qtest.h>
+#include <QObject>
+#include <QTemporaryDir>
+
+#include <elf.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <tuple>
+
+using SymbolInfo = std::tuple<QByteArray, uint64_t, uint64_t, uint8_t, uint8_t, uint16_t>;
+
+static SymbolInfo symbolInfo(ElfFile *file, ElfSymbolTableEntry *entry)
+{
+    if (!entry)
+        return {};
+    uint16_t version = 0;
+    const auto versionIndex = file->indexOfSection(SHT_GNU_versym);
+    if (versionIndex >= 0)
+        version = file->section<ElfGNUSymbolVersionTable>(versionIndex)->versionIndex(entry->index());
+    return std::make_tuple(QByteArray(entry->name()), entry->value(), entry->size(), entry->bindType(), entry->type(), version);
+}
+
+// everything observable through symbol lookup and relocations, independent of the .dynsym order
+struct Snapshot {
+    QVector<SymbolInfo> symbols;
+    QVector<SymbolInfo> gnuLookups;
+    QVector<SymbolInfo> sysvLookups;
+    QVector<QPair<uint64_t, QByteArray>> relocations;
+};
+
+static Snapshot snapshot(const QString &fileName)
+{
+    Snapshot s;
+    ElfFile f(fileName);
+    if (!f.open(QFile::ReadOnly) || !f.isValid())
+        return s;
+
+    const auto gnuHash = f.section<ElfGnuHashSection>(f.indexOfSection(SHT_GNU_HASH));
+    const auto sysvHashIndex = f.indexOfSection(SHT_HASH);
+    const auto sysvHash = sysvHashIndex >= 0 ? f.section<ElfSysvHashSection>(sysvHashIndex) : nullptr;
+    const auto symTab = gnuHash->linkedSection<ElfSymbolTableSection>();
+    for (uint32_t i = 0; i < symTab->header()->entryCount(); ++i) {
+        const auto entry = symTab->entry(i);
+        s.symbols.push_back(symbolInfo(&f, entry));
+        if (i < gnuHash->symbolIndex())
+            continue;
+        s.gnuLookups.push_back(symbolInfo(&f, gnuHash->lookup(entry->name())));
+        if (sysvHash)
+            s.sysvLookups.push_back(symbolInfo(&f, sysvHash->lookup(entry->name())));
+    }
+
+    for (int i = 0; i < f.sectionCount(); ++i) {
+        const auto relocs = f.section<ElfRelocationSection>(i);
+        if (!relocs)
+            continue;
+        for (uint32_t j = 0; j < relocs->header()->entryCount(); ++j) {
+            const auto entry = relocs->entry(j);
+            const auto sym = entry->symbol();
+            s.relocations.push_back(qMakePair(entry->offset(), sym ? QByteArray(sym->name()) : QByteArray()));
+        }
+    }
+    return s;
+}
+
+class GnuHashOptimizerTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testRebuild_data()
+    {
+        QTest::addColumn<QString>("library");
+        QTest::newRow("versioned-symbols") << QStringLiteral(BINDIR "libversioned-symbols.so");
+
+        ElfFileSet set;
+        set.addFile(QStringLiteral(BINDIR "elf-dissector"));
+        for (int i = 0; i < set.size(); ++i) {
+            if (set.file(i)->dynamicSection()->soName() == "libQt5Core.so.5")
+                QTest::newRow("QtCore") << set.file(i)->fileName();
+        }
+    }
+
+    void testRebuild()
+    {
+        QFETCH(QString, library);
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const auto fileName = dir.path() + QLatin1String("/lib.so");
+        QVERIFY(QFile::copy(library, fileName));
+        QVERIFY(QFile::setPermissions(fileName, QFile::ReadOwner | QFile::WriteOwner));
+
+        const auto before = snapshot(fileName);
+        QVERIFY(!before.gnuLookups.isEmpty());
+
+        GnuHashOptimizer::Parameters params;
+        GnuHashOptimizer::Parameters optimal;
+        {
+            ElfFile f(fileName);
+            QVERIFY(f.open(QFile::ReadOnly));
+            const auto gnuHash = f.section<ElfGnuHashSection>(f.indexOfSection(SHT_GNU_HASH));
+            QVERIFY(gnuHash);
+
+            // a smaller bucket count always fits, and forces a reordering of .dynsym
+            params = GnuHashOptimizer::parameters(gnuHash);
+            params.bucketCount = params.bucketCount / 2 + 1;
+            QVERIFY(GnuHashOptimizer::quality(gnuHash, params).size <= gnuHash->header()->size());
+
+            optimal = GnuHashOptimizer::optimalParameters(gnuHash);
+            QVERIFY(optimal.bucketCount > 0);
+            QVERIFY(optimal.maskWordsCount > 0);
+            QCOMPARE(optimal.maskWordsCount & (optimal.maskWordsCount - 1), 0u);
+            const auto q = GnuHashOptimizer::quality(gnuHash, optimal);
+            QVERIFY(q.bloomFalsePositiveRate >= 0.0 && q.bloomFalsePositiveRate < 0.1);
+            QVERIFY(q.averageChainLength >= 1.0);
+        }
+
+        QVERIFY(GnuHashOptimizer::rebuild(fileName, params));
+        auto after = snapshot(fileName);
+        QCOMPARE(after.gnuLookups, before.gnuLookups);
+        QCOMPARE(after.sysvLookups, before.sysvLookups);
+        QCOMPARE(after.relocations, before.relocations);
+        auto symbols = before.symbols;
+        std::sort(symbols.begin(), symbols.end());
+        std::sort(after.symbols.begin(), after.symbols.end());
+        QCOMPARE(after.symbols, symbols);
+
+        // rebuild again with the optimal parameters if those fit, starting from a different order
+        if (GnuHashOptimizer::rebuild(fileName, optimal)) {
+            after = snapshot(fileName);
+            QCOMPARE(after.gnuLookups, before.gnuLookups);
+            QCOMPARE(after.sysvLookups, before.sysvLookups);
+            QCOMPARE(after.relocations, before.relocations);
+        }
+
+        ElfFile f(fileName);
+        QVERIFY(f.open(QFile::ReadOnly));
+        QVERIFY(f.isValid());
+        const auto gnuHash = f.section<ElfGnuHashSection>(f.indexOfSection(SHT_GNU_HASH));
+        QVERIFY(gnuHash);
+        const auto hist = gnuHash->histogram();
+        QCOMPARE(std::accumulate(hist.begin(), hist.end(), 0u), gnuHash->bucketCount());
+    }
+
+    void testRefuseSignificantOrder()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const auto fileName = dir.path() + QLatin1String("/lib.so");
+        QVERIFY(QFile::copy(QStringLiteral(BINDIR "libversioned-symbols.so"), fileName));
+        QVERIFY(QFile::setPermissions(fileName, QFile::ReadOwner | QFile::WriteOwner));
+
+        GnuHashOptimizer::Parameters params;
+        {
+            ElfFile f(fileName);
+            QVERIFY(f.open(QFile::ReadOnly));
+            QVERIFY(GnuHashOptimizer::canReorderSymbols(&f));
+            params = GnuHashOptimizer::parameters(f.section<ElfGnuHashSection>(f.indexOfSection(SHT_GNU_HASH)));
+            params.bucketCount = params.bucketCount / 2 + 1;
+        }
+
+        // pretend this is a MIPS library, whose GOT depends on the .dynsym order
+        QFile file(fileName);
+        QVERIFY(file.open(QFile::ReadWrite));
+        QVERIFY(file.seek(offsetof(Elf64_Ehdr, e_machine)));
+        const uint16_t machine = EM_MIPS;
+        QCOMPARE(file.write(reinterpret_cast<const char*>(&machine), sizeof(machine)), (qint64)sizeof(machine));
+        QVERIFY(file.seek(0));
+        const auto before = file.readAll();
+        file.close();
+
+        {
+            ElfFile f(fileName);
+            QVERIFY(f.open(QFile::ReadOnly));
+            QVERIFY(f.isValid());
+            QVERIFY(!GnuHashOptimizer::canReorderSymbols(&f));
+        }
+        QVERIFY(!GnuHashOptimizer::rebuild(fileName, params));
+
+        QVERIFY(file.open(QFile::ReadOnly));
+        QCOMPARE(file.readAll(), before);
+    }
+};
+
+QTEST_MAIN(GnuHashOptimizerTest)
+
+#include "gnuhashoptimizertest.moc"
@@ -0,0 +1,98 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <checks/ldbenchmark.h>
+
+#include <QtTest/qtest.h>
+#include <QObject>
+
+#include <algorithm>
+
+class LDBenchmarkTest : public QObject
+{
+    Q_OBJECT
+private:
+    static void comparePercentile(const LDBenchmark::Percentile &p, double value, double lower, double upper)
+    {
+        QCOMPARE(p.value, value);
+        QCOMPARE(p.lower, lower);
+        QCOMPARE(p.upper, upper);
+    }
+
+    static QVector<double> uniformSamples()
+    {
+        QVector<double> samples;
+        for (int i = 1; i <= 100; ++i)
+            samples.push_back(i);
+        return samples;
+    }
+
+private slots:
+    void testPercentile()
+    {
+        const auto samples = uniformSamples();
+        // nearest rank, bounded by the ranks n*q -/+ 1.96 * sqrt(n*q*(1-q))
+        comparePercentile(LDBenchmark::percentile(samples, 0.5), 50.0, 40.0, 60.0);
+        comparePercentile(LDBenchmark::percentile(samples, 0.9), 90.0, 84.0, 96.0);
+        // the upper bound is clamped to the largest sample
+        comparePercentile(LDBenchmark::percentile(samples, 0.99), 99.0, 97.0, 100.0);
+
+        comparePercentile(LDBenchmark::percentile({}, 0.5), 0.0, 0.0, 0.0);
+        comparePercentile(LDBenchmark::percentile({ 42.0 }, 0.99), 42.0, 42.0, 42.0);
+    }
+
+    void testStatistics()
+    {
+        auto samples = uniformSamples();
+        std::reverse(samples.begin(), samples.end());
+        auto stats = LDBenchmark::computeStatistics(samples);
+        QCOMPARE(stats.sampleCount, 100);
+        QCOMPARE(stats.outlierCount, 0);
+        comparePercentile(stats.p50, 50.0, 40.0, 60.0);
+        comparePercentile(stats.p90, 90.0, 84.0, 96.0);
+        comparePercentile(stats.p99, 99.0, 97.0, 100.0);
+
+        // modified z-score above 3.5 on either side, the remaining distribution is unchanged
+        samples.push_back(1000.0);
+        samples.push_front(-500.0);
+        samples.push_back(2000.0);
+        stats = LDBenchmark::computeStatistics(samples);
+        QCOMPARE(stats.sampleCount, 100);
+        QCOMPARE(stats.outlierCount, 3);
+        comparePercentile(stats.p50, 50.0, 40.0, 60.0);
+        comparePercentile(stats.p90, 90.0, 84.0, 96.0);
+        comparePercentile(stats.p99, 99.0, 97.0, 100.0);
+
+        // no spread means nothing can be rejected
+        samples = QVector<double>(10, 5.0);
+        samples.push_back(6.0);
+        stats = LDBenchmark::computeStatistics(samples);
+        QCOMPARE(stats.sampleCount, 11);
+        QCOMPARE(stats.outlierCount, 0);
+        comparePercentile(stats.p50, 5.0, 5.0, 5.0);
+        comparePercentile(stats.p99, 6.0, 5.0, 6.0);
+
+        stats = LDBenchmark::computeStatistics({});
+        QCOMPARE(stats.sampleCount, 0);
+        QCOMPARE(stats.outlierCount, 0);
+        comparePercentile(stats.p50, 0.0, 0.0, 0.0);
+    }
+};
+
+QTEST_MAIN(LDBenchmarkTest)
+
+#include "ldbenchmarktest.moc"
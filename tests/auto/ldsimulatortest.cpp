@@ -0,0 +1,101 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <checks/ldsimulator.h>
+
+#include <elf/elffileset.h>
+
+#include <QtTest/qtest.h>
+#include <QObject>
+
+class LDSimulatorTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testSimulate_data()
+    {
+        QTest::addColumn<QString>("executable");
+        QTest::newRow("single-executable") << QStringLiteral(BINDIR "single-executable");
+        QTest::newRow("elf-dissector") << QStringLiteral(BINDIR "elf-dissector");
+    }
+
+    void testSimulate()
+    {
+        QFETCH(QString, executable);
+
+        ElfFileSet set;
+        set.addFile(executable);
+        QVERIFY(set.size() > 1);
+
+        LDSimulator sim;
+        sim.simulateFileSet(&set);
+        QCOMPARE(sim.size(), set.size());
+        QCOMPARE(sim.file(0), set.file(0));
+
+        uint64_t incurred = 0;
+        uint64_t imposed = 0;
+        double cost = 0.0;
+        for (int i = 0; i < sim.size(); ++i) {
+            const auto &res = sim.result(i);
+            QVERIFY(res.symbolRelocations <= res.relocations);
+            QVERIFY(res.lookups + res.cachedLookups <= res.symbolRelocations);
+            QVERIFY(res.unresolvedLookups <= res.lookups);
+            // every lookup probes at least one file, and no file twice
+            QVERIFY(res.incurred.lookups >= (uint64_t)res.lookups);
+            QVERIFY(res.incurred.lookups <= (uint64_t)res.lookups * sim.size());
+            QVERIFY(res.incurred.bloomRejections + res.incurred.bucketHits <= res.incurred.lookups);
+            QVERIFY(res.cost >= 0.0);
+            QCOMPARE(res.bindings.size(), res.lookups);
+            QCOMPARE((int)res.bindings.count(nullptr), res.unresolvedLookups);
+            incurred += res.incurred.chainSteps;
+            imposed += res.imposed.chainSteps;
+            cost += res.cost;
+        }
+        QCOMPARE(incurred, imposed);
+        QCOMPARE(sim.totalCost(), cost);
+
+        // the executable imports at least something from its dependencies
+        QVERIFY(sim.result(0).lookups > 0);
+        QCOMPARE(sim.result(0).unresolvedLookups, 0);
+        QVERIFY(sim.totalCost() > 0.0);
+    }
+
+    void testCostModel()
+    {
+        ElfFileSet set;
+        set.addFile(QStringLiteral(BINDIR "single-executable"));
+        QVERIFY(set.size() > 1);
+
+        LDSimulator::CostModel model;
+        model.relocation = 1.0;
+        model.lookup = 0.0;
+        model.probe = 0.0;
+        model.bucketHit = 0.0;
+        model.chainStep = 0.0;
+        model.stringCompare = 0.0;
+
+        LDSimulator sim;
+        sim.setCostModel(model);
+        sim.simulateFileSet(&set);
+        for (int i = 0; i < sim.size(); ++i)
+            QCOMPARE(sim.result(i).cost, (double)sim.result(i).relocations);
+    }
+};
+
+QTEST_MAIN(LDSimulatorTest)
+
+#include "ldsimulatortest.moc"
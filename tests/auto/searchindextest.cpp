@@ -0,0 +1,110 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <search/searchindex.h>
+#include <elf/elffile.h>
+#include <elf/elffileset.h>
+#include <elf/elfsymboltableentry.h>
+
+#include <QtTest/qtest.h>
+#include <QObject>
+#include <QRegularExpression>
+
+class SearchIndexTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testSubstringSearch()
+    {
+        ElfFileSet set;
+        set.addFile(QStringLiteral(BINDIR "single-executable"));
+        QVERIFY(set.size() > 1);
+
+        SearchIndex index;
+        index.addFileSet(&set);
+        QVERIFY(index.size() > 0);
+
+        auto hits = index.find(QByteArray("main"));
+        QVERIFY(!hits.isEmpty());
+        QCOMPARE(hits.at(0).text, QByteArray("main")); // exact match ranks first
+        QCOMPARE(hits.at(0).type, SearchIndex::Symbol);
+        QCOMPARE(static_cast<ElfSymbolTableEntry*>(hits.at(0).payload)->name(), "main");
+
+        const auto upperHits = index.find(QByteArray("MAIN"));
+        QCOMPARE(upperHits.size(), hits.size());
+
+        hits = index.find(QByteArray(".text"));
+        QVERIFY(!hits.isEmpty());
+        QCOMPARE(hits.at(0).type, SearchIndex::Section);
+
+        // short queries bypass the trigram lookup, and stop after enough hits
+        QVERIFY(!index.find(QByteArray("ma")).isEmpty());
+        hits = index.find(QByteArray("a"), 2);
+        QVERIFY(!hits.isEmpty());
+        QVERIFY(hits.size() <= 2);
+        QVERIFY(index.find(QByteArray("this symbol does not exist")).isEmpty());
+    }
+
+    void testRegExpSearch()
+    {
+        ElfFileSet set;
+        set.addFile(QStringLiteral(BINDIR "single-executable"));
+
+        SearchIndex index;
+        index.addFileSet(&set);
+
+        auto hits = index.find(QRegularExpression(QStringLiteral("^ma.n$")));
+        QVERIFY(!hits.isEmpty());
+        QCOMPARE(hits.at(0).text, QByteArray("main"));
+
+        QVERIFY(index.find(QRegularExpression(QStringLiteral("^main(_not_there)?$"))).size() >= 1);
+        // optional multi-byte characters must not leave partial UTF-8 sequences in the required literals
+        QVERIFY(index.find(QRegularExpression(QString::fromUtf8("^main\xc3\xa9?$"))).size() >= 1);
+        QVERIFY(index.find(QRegularExpression(QString::fromUtf8("^mai\xe2\x82\xac*n$"))).size() >= 1);
+        QVERIFY(index.find(QRegularExpression(QStringLiteral("(invalid"))).isEmpty());
+        hits = index.find(QRegularExpression(QStringLiteral("^.")), 2);
+        QVERIFY(!hits.isEmpty());
+        QVERIFY(hits.size() <= 2);
+    }
+
+    void testDependencies()
+    {
+        ElfFileSet set;
+        set.addFile(QStringLiteral(BINDIR "qtstructures"));
+
+        SearchIndex index;
+        index.addFileSet(&set);
+
+        auto hits = index.find(QByteArray("libQt5Core"), 1);
+        QCOMPARE(hits.size(), 1);
+        QCOMPARE(hits.at(0).type, SearchIndex::File);
+        QVERIFY(static_cast<ElfFile*>(hits.at(0).payload)->dynamicSection());
+
+        // demangled names are searchable, but each symbol is reported once only
+        hits = index.find(QRegularExpression(QStringLiteral("QCoreApplication::(exec|instance)")));
+        QVERIFY(!hits.isEmpty());
+        for (int i = 0; i < hits.size(); ++i) {
+            QVERIFY(hits.at(i).text.contains("QCoreApplication::"));
+            for (int j = 0; j < i; ++j)
+                QVERIFY(hits.at(i).payload != hits.at(j).payload);
+        }
+    }
+};
+
+QTEST_MAIN(SearchIndexTest)
+
+#include "searchindextest.moc"
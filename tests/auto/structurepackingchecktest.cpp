@@ -0,0 +1,63 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <checks/structurepackingcheck.h>
+#include <elf/elffile.h>
+#include <elf/elffileset.h>
+
+#include <QtTest/qtest.h>
+#include <QObject>
+
+#include <iostream>
+#include <sstream>
+
+/** Runs the check on all units of @p fileName, returning the printed report. */
+static QByteArray checkAll(const QString &fileName)
+{
+    ElfFileSet fileSet;
+    fileSet.addFile(fileName);
+    if (fileSet.size() == 0 || !fileSet.file(0)->dwarfInfo())
+        return {};
+    StructurePackingCheck check;
+    check.setElfFileSet(&fileSet);
+
+    std::ostringstream out;
+    const auto coutBuffer = std::cout.rdbuf(out.rdbuf());
+    // a single thread reports in unit order
+    check.checkAll(fileSet.file(0)->dwarfInfo(), 1);
+    std::cout.rdbuf(coutBuffer);
+    return QByteArray::fromStdString(out.str());
+}
+
+class StructurePackingCheckTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testSplitDwarf()
+    {
+        const auto report = checkAll(QStringLiteral(BINDIR "structures"));
+        QVERIFY(report.contains("struct NonPackedNumbers"));
+        QVERIFY(!report.contains("struct PackedNumbers"));
+
+        // the split units are checked instead of their skeletons, with the same result
+        QCOMPARE(checkAll(QStringLiteral(BINDIR "structures-split")), report);
+    }
+};
+
+QTEST_MAIN(StructurePackingCheckTest)
+
+#include "structurepackingchecktest.moc"
@@ -0,0 +1,204 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <dwarf/dwarfcudie.h>
+#include <dwarf/dwarfdie.h>
+#include <dwarf/dwarfinfo.h>
+#include <dwarf/dwarfline.h>
+#include <elf/elffile.h>
+#include <elf/elfsymboltableentry.h>
+#include <elf/elfsymboltablesection.h>
+
+#include <QtTest/qtest.h>
+#include <QObject>
+#include <QProcess>
+
+#include <dwarf.h>
+
+static QByteArray symbolize(const QStringList &args, const QByteArray &input)
+{
+    QProcess proc;
+    proc.start(QStringLiteral(BINDIR "elf-symbolize"), QStringList(args) << QStringLiteral(BINDIR "inlined-functions"));
+    if (!proc.waitForStarted())
+        return {};
+    proc.write(input);
+    proc.closeWriteChannel();
+    if (!proc.waitForFinished() || proc.exitStatus() != QProcess::NormalExit || proc.exitCode() != 0)
+        return {};
+    return proc.readAllStandardOutput();
+}
+
+static QByteArray hex(uint64_t value)
+{
+    return "0x" + QByteArray::number(quint64(value), 16);
+}
+
+class SymbolizeTest : public QObject
+{
+    Q_OBJECT
+private:
+    struct ExpectedFrame
+    {
+        QByteArray function;
+        QByteArray file;
+        uint64_t line;
+        uint64_t column;
+    };
+
+    ElfFile m_file{QStringLiteral(BINDIR "inlined-functions")};
+    uint64_t m_addr = 0;
+    QByteArray m_symbol;
+    uint64_t m_symbolOffset = 0;
+    QVector<ExpectedFrame> m_frames;
+
+private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_file.open(QFile::ReadOnly));
+        QVERIFY(m_file.dwarfInfo());
+        QVERIFY(m_file.symbolTable());
+
+        // square() inlined into sumOfSquares() inlined into main()
+        DwarfDie *die = nullptr;
+        DwarfCuDie *cu = nullptr;
+        foreach (auto unit, m_file.dwarfInfo()->compilationUnits()) {
+            for (int i = 0; i < unit->dieCount() && !die; ++i) {
+                const auto d = unit->dieAt(i);
+                if (d->tag() == DW_TAG_inlined_subroutine && d->parentDie()->tag() == DW_TAG_inlined_subroutine && d->hasAttribute(DW_AT_low_pc)) {
+                    die = d;
+                    cu = unit;
+                }
+            }
+        }
+        QVERIFY(die);
+        const auto outer = die->parentDie();
+        QVERIFY(outer->parentDie());
+        QCOMPARE(outer->parentDie()->tag(), (Dwarf_Half)DW_TAG_subprogram);
+
+        m_addr = die->attributeUnsigned(DW_AT_low_pc);
+        const auto entry = m_file.symbolTable()->entryContainingValue(m_addr);
+        QVERIFY(entry);
+        QCOMPARE(QByteArray(entry->name()), QByteArray("main"));
+        m_symbol = entry->name();
+        m_symbolOffset = m_addr - entry->value();
+
+        const auto line = cu->lineForAddress(m_addr);
+        QVERIFY(!line.isNull());
+        const auto callFile = [](DwarfDie *d) { return d->attribute(DW_AT_call_file).toString().toUtf8(); };
+        m_frames.push_back({ "square", cu->sourceFileForLine(line).toUtf8(), line.line(), uint64_t(line.column()) });
+        m_frames.push_back({ "sumOfSquares", callFile(die), die->attributeUnsigned(DW_AT_call_line), die->attributeUnsigned(DW_AT_call_column) });
+        m_frames.push_back({ "main", callFile(outer), outer->attributeUnsigned(DW_AT_call_line), outer->attributeUnsigned(DW_AT_call_column) });
+        foreach (const auto &frame, m_frames) {
+            QVERIFY(frame.file.endsWith("inlined-functions.c"));
+            QVERIFY(frame.line > 0);
+        }
+    }
+
+    void testTsv()
+    {
+        QByteArray expected;
+        for (int i = 0; i < m_frames.size(); ++i) {
+            const auto &frame = m_frames.at(i);
+            expected += "inlined-functions\t" + hex(m_addr) + '\t' + m_symbol + '\t' + hex(m_symbolOffset) + '\t'
+                + QByteArray::number(i) + '\t' + frame.function + '\t' + frame.file + '\t'
+                + QByteArray::number(quint64(frame.line)) + '\t' + QByteArray::number(quint64(frame.column)) + '\n';
+        }
+        QCOMPARE(symbolize({}, "inlined-functions+" + hex(m_addr) + '\n'), expected);
+        QCOMPARE(symbolize({}, "inlined-functions " + hex(m_addr) + '\n'), expected);
+        QCOMPARE(symbolize({}, "inlined-functions\t" + QByteArray::number(quint64(m_addr), 16) + '\n'), expected);
+
+        // without inlines only the outermost function remains, at the innermost location
+        auto outermost = "inlined-functions\t" + hex(m_addr) + '\t' + m_symbol + '\t' + hex(m_symbolOffset) + "\t0\tmain\t"
+            + m_frames.at(0).file + '\t' + QByteArray::number(quint64(m_frames.at(0).line)) + '\t' + QByteArray::number(quint64(m_frames.at(0).column)) + '\n';
+        QCOMPARE(symbolize({ QStringLiteral("--no-inlines") }, "inlined-functions+" + hex(m_addr) + '\n'), outermost);
+    }
+
+    void testParseRequest()
+    {
+        // bare offsets refer to the first file, with an empty module column
+        auto output = symbolize({}, hex(m_addr) + '\n');
+        QCOMPARE(output.count('\n'), m_frames.size());
+        QVERIFY(output.startsWith('\t' + hex(m_addr) + '\t' + m_symbol + '\t'));
+
+        // module names may contain '+', unknown modules and garbage still produce one row each
+        output = symbolize({}, "libstdc++.so.6+0x10\n"
+                               "garbage\n"
+                               "# comment\n"
+                               "\n"
+                               "libstdc++.so.6 0x1g\n");
+        QCOMPARE(output, QByteArray("libstdc++.so.6\t0x10\t??\t0x0\t0\t??\t??\t0\t0\n"
+                                    "\t0x0\t??\t0x0\t0\t??\t??\t0\t0\n"
+                                    "libstdc++.so.6\t0x0\t??\t0x0\t0\t??\t??\t0\t0\n"));
+    }
+
+    void testJson()
+    {
+        QByteArray expected = "{\"module\":\"inlined-functions\",\"offset\":\"" + hex(m_addr) + "\",\"symbol\":\"" + m_symbol
+            + "\",\"symbolOffset\":\"" + hex(m_symbolOffset) + "\",\"frames\":[";
+        for (int i = 0; i < m_frames.size(); ++i) {
+            const auto &frame = m_frames.at(i);
+            if (i > 0)
+                expected += ',';
+            expected += "{\"function\":\"" + frame.function + "\",\"file\":\"" + frame.file + "\",\"line\":"
+                + QByteArray::number(quint64(frame.line)) + ",\"column\":" + QByteArray::number(quint64(frame.column)) + '}';
+        }
+        expected += "]}\n";
+        QCOMPARE(symbolize({ QStringLiteral("--format"), QStringLiteral("json") }, "inlined-functions+" + hex(m_addr) + '\n'), expected);
+
+        // quotes, backslashes and control characters are escaped, empty values are null
+        QCOMPARE(symbolize({ QStringLiteral("-f"), QStringLiteral("json") }, "a\"b\\c\x01" "d\te+0x10\ngarbage\n"),
+                 QByteArray("{\"module\":\"a\\\"b\\\\c\\u0001d\\te\",\"offset\":\"0x10\",\"symbol\":null,\"symbolOffset\":\"0x0\",\"frames\":[]}\n"
+                            "{\"module\":null,\"offset\":\"0x0\",\"symbol\":null,\"symbolOffset\":\"0x0\",\"frames\":[]}\n"));
+    }
+
+    void testBatchOrder()
+    {
+        // requests are sorted internally, output has to follow the input order nevertheless
+        const QVector<QByteArray> requests = {
+            "inlined-functions+" + hex(m_addr + 2),
+            "libstdc++.so.6+0x10",
+            "inlined-functions+" + hex(m_addr),
+            "garbage",
+            hex(m_addr + 1),
+            "inlined-functions+" + hex(m_addr),
+            "libstdc++.so.6+0x8",
+        };
+        QByteArray input;
+        foreach (const auto &request, requests)
+            input += request + '\n';
+
+        const auto reference = symbolize({ QStringLiteral("-f"), QStringLiteral("json") }, input);
+        const auto lines = reference.split('\n');
+        QCOMPARE(lines.size(), requests.size() + 1);
+        QCOMPARE(lines.at(0).left(lines.at(0).indexOf(",\"symbol\"")), "{\"module\":\"inlined-functions\",\"offset\":\"" + hex(m_addr + 2) + '"');
+        QVERIFY(lines.at(1).startsWith("{\"module\":\"libstdc++.so.6\",\"offset\":\"0x10\""));
+        QVERIFY(lines.at(2).startsWith("{\"module\":\"inlined-functions\",\"offset\":\"" + hex(m_addr) + '"'));
+        QVERIFY(lines.at(3).startsWith("{\"module\":null,\"offset\":\"0x0\""));
+        QVERIFY(lines.at(4).startsWith("{\"module\":null,\"offset\":\"" + hex(m_addr + 1) + '"'));
+        QCOMPARE(lines.at(5), lines.at(2));
+        QVERIFY(lines.at(6).startsWith("{\"module\":\"libstdc++.so.6\",\"offset\":\"0x8\""));
+
+        for (const auto batchSize : { 1, 2, 3 }) {
+            QCOMPARE(symbolize({ QStringLiteral("-f"), QStringLiteral("json"), QStringLiteral("-b"), QString::number(batchSize) }, input), reference);
+            QCOMPARE(symbolize({ QStringLiteral("-b"), QString::number(batchSize) }, input), symbolize({}, input));
+        }
+    }
+};
+
+QTEST_MAIN(SymbolizeTest)
+
+#include "symbolizetest.moc"
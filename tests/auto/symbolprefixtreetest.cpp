@@ -0,0 +1,119 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <demangle/symbolprefixtree.h>
+#include <elf/elffile.h>
+#include <elf/elfsymboltablesection.h>
+#include <elf/elfsymboltableentry.h>
+
+#include <QtTest/qtest.h>
+#include <QObject>
+
+class SymbolPrefixTreeTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testTree_data()
+    {
+        QTest::addColumn<QString>("executable");
+        QTest::newRow("single-executable") << QStringLiteral(BINDIR "single-executable");
+        QTest::newRow("structures") << QStringLiteral(BINDIR "structures");
+        QTest::newRow("elf-dissector") << QStringLiteral(BINDIR "elf-dissector");
+    }
+
+    void testTree()
+    {
+        QFETCH(QString, executable);
+
+        ElfFile f(executable);
+        QVERIFY(f.open(QFile::ReadOnly));
+        QVERIFY(f.isValid());
+
+        const auto tree = f.symbolPrefixTree();
+        QVERIFY(tree);
+        QCOMPARE(tree, f.symbolPrefixTree());
+        QVERIFY(tree->nodeCount() > 1);
+        QCOMPARE(tree->parent(SymbolPrefixTree::RootNode), -1);
+        QVERIFY(tree->nameParts(SymbolPrefixTree::RootNode).isEmpty());
+
+        // root aggregates all sized symbols
+        const auto symtab = f.symbolTable();
+        QVERIFY(symtab);
+        uint64_t totalSize = 0;
+        int symbolCount = 0;
+        for (uint32_t i = 0; i < symtab->header()->entryCount(); ++i) {
+            const auto entry = symtab->entry(i);
+            if (entry->size() == 0 || entry->sectionIndex() == 0 || entry->sectionIndex() >= f.sectionCount())
+                continue;
+            totalSize += entry->size();
+            ++symbolCount;
+        }
+        QCOMPARE(tree->statistics(SymbolPrefixTree::RootNode).size, totalSize);
+        QCOMPARE(tree->statistics(SymbolPrefixTree::RootNode).symbolCount, symbolCount);
+
+        for (int node = 0; node < tree->nodeCount(); ++node) {
+            const auto stats = tree->statistics(node);
+
+            // children never exceed their parent, and are sorted by name
+            uint64_t childSize = 0;
+            int childSymbols = 0;
+            for (int i = 0; i < tree->childCount(node); ++i) {
+                const auto child = tree->child(node, i);
+                QCOMPARE(tree->parent(child), node);
+                QVERIFY(!tree->nameParts(child).isEmpty());
+                if (i > 0)
+                    QVERIFY(tree->nameParts(tree->child(node, i - 1)).first() < tree->nameParts(child).first());
+                childSize += tree->statistics(child).size;
+                childSymbols += tree->statistics(child).symbolCount;
+            }
+            QVERIFY(childSize <= stats.size);
+            QVERIFY(childSymbols <= stats.symbolCount);
+            if (node != SymbolPrefixTree::RootNode && childSymbols == stats.symbolCount)
+                QVERIFY(tree->childCount(node) != 1); // would have been compressed
+
+            // section breakdown adds up to the total
+            SymbolPrefixTree::Statistics sectionSum;
+            for (const auto sectionIndex : tree->sections(node)) {
+                const auto sectionStats = tree->statistics(node, sectionIndex);
+                QVERIFY(sectionStats.symbolCount > 0);
+                sectionSum.size += sectionStats.size;
+                sectionSum.symbolCount += sectionStats.symbolCount;
+                sectionSum.relocationCount += sectionStats.relocationCount;
+            }
+            QCOMPARE(sectionSum.size, stats.size);
+            QCOMPARE(sectionSum.symbolCount, stats.symbolCount);
+            QCOMPARE(sectionSum.relocationCount, stats.relocationCount);
+            QCOMPARE(tree->statistics(node, 0).symbolCount, 0);
+
+            // lookup by path
+            QVector<QByteArray> path;
+            for (int n = node; n != SymbolPrefixTree::RootNode; n = tree->parent(n))
+                path = tree->nameParts(n) + path;
+            QCOMPARE(tree->find(path), node);
+            if (tree->nameParts(node).size() > 1) {
+                path.removeLast();
+                QCOMPARE(tree->find(path), node);
+            }
+        }
+
+        QCOMPARE(tree->find({ QByteArray("this does not exist") }), -1);
+    }
+};
+
+QTEST_MAIN(SymbolPrefixTreeTest)
+
+#include "symbolprefixtreetest.moc"
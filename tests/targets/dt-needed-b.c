@@ -0,0 +1,26 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/* provides most of what the user needs, sorting this first saves the most lookups */
+int b0() { return 0; }
+int b1() { return 1; }
+int b2() { return 2; }
+int b3() { return 3; }
+int b4() { return 4; }
+int b5() { return 5; }
+int b6() { return 6; }
+int b7() { return 7; }
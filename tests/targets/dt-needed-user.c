@@ -0,0 +1,34 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+extern int common();
+extern int a();
+extern int b0();
+extern int b1();
+extern int b2();
+extern int b3();
+extern int b4();
+extern int b5();
+extern int b6();
+extern int b7();
+extern int c();
+
+/* linked against dt-needed-a, dt-needed-c and dt-needed-b, in that order */
+int main()
+{
+    return common() + a() + b0() + b1() + b2() + b3() + b4() + b5() + b6() + b7() + c();
+}
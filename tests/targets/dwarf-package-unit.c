@@ -0,0 +1,30 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/* second unit of split-dwarf-package, linked first so the other one gets non-zero section contributions */
+static inline int twice(int i)
+{
+    return 2 * i;
+}
+
+int sumOfTwice(int n)
+{
+    int sum = 0;
+    for (int i = 0; i < n; ++i)
+        sum += twice(i) + (i % 2 ? twice(i + 1) : 0);
+    return sum;
+}
@@ -0,0 +1,34 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+static inline int square(int i)
+{
+    return i * i;
+}
+
+static inline int sumOfSquares(int n)
+{
+    int sum = 0;
+    for (int i = 0; i < n; ++i)
+        sum += square(i) + (i % 3 ? square(i + 1) : 0);
+    return sum;
+}
+
+int main(int argc, __attribute__((unused)) char **argv)
+{
+    return sumOfSquares(argc) + square(argc + 1);
+}
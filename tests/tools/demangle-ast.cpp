@@ -24,9 +24,20 @@
 
 #include <demangle.h>
 
+#include <demangle/spandemangler.h>
+#include <elf/elffile.h>
+#include <elf/elffileset.h>
+#include <elf/elfsymboltableentry.h>
+#include <elf/elfsymboltablesection.h>
+
 #include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <vector>
 
 using namespace std;
 
@@ -445,10 +456,104 @@ static int handleNameComponent(demangle_component* component)
     return sourceNode;
 }
 
+// mangled names from the symbol tables of an ELF file and its dependencies, or from a file with one name per line
+static QVector<QByteArray> readNames(const char *fileName)
+{
+    QVector<QByteArray> names;
+    ElfFileSet fileSet;
+    fileSet.addFile(QString::fromLocal8Bit(fileName));
+    for (int i = 0; i < fileSet.size(); ++i) {
+        const auto symtab = fileSet.file(i)->symbolTable();
+        if (!symtab)
+            continue;
+        for (uint32_t j = 0; j < symtab->header()->entryCount(); ++j) {
+            const QByteArray name(symtab->entry(j)->name());
+            if (name.startsWith("_Z"))
+                names.push_back(name);
+        }
+    }
+    if (fileSet.size() > 0)
+        return names;
+
+    QFile f(QString::fromLocal8Bit(fileName));
+    if (!f.open(QFile::ReadOnly))
+        return names;
+    while (!f.atEnd()) {
+        const auto line = f.readLine().trimmed();
+        if (!line.isEmpty())
+            names.push_back(line);
+    }
+    return names;
+}
+
+static void appendToBuffer(const char *str, size_t size, void *opaque)
+{
+    auto buffer = static_cast<std::vector<char>*>(opaque);
+    buffer->insert(buffer->end(), str, str + size);
+}
+
+// throughput of SpanDemangler compared to libiberty alone
+static int benchmark(const char *fileName)
+{
+    const auto names = readNames(fileName);
+    if (names.isEmpty()) {
+        cerr << "no mangled names found in " << fileName << endl;
+        return 1;
+    }
+
+    static const int Iterations = 10;
+    static const int Options = DMGL_PARAMS | DMGL_ANSI | DMGL_TYPES | DMGL_VERBOSE;
+    QElapsedTimer timer;
+
+    // parsing and printing into a reused buffer, the lower bound for producing the full name
+    timer.start();
+    std::vector<char> buffer;
+    for (int i = 0; i < Iterations; ++i) {
+        for (const auto &name : names) {
+            void *memory = nullptr;
+            const auto component = cplus_demangle_v3_components(name.constData(), Options, &memory);
+            buffer.clear();
+            if (component)
+                cplus_demangle_print_callback(Options, component, appendToBuffer, &buffer);
+            free(memory);
+        }
+    }
+    const auto libibertyTime = std::max<qint64>(1, timer.nsecsElapsed());
+
+    const auto spanDemanglerTime = [&names](int outputs) {
+        QElapsedTimer timer;
+        timer.start();
+        SpanDemangler spanDemangler;
+        for (int i = 0; i < Iterations; ++i) {
+            for (const auto &name : names)
+                spanDemangler.demangle(name.constData(), outputs);
+        }
+        return std::max<qint64>(1, timer.nsecsElapsed());
+    };
+    const auto fullNameTime = spanDemanglerTime(SpanDemangler::FullName);
+    const auto namePartsTime = spanDemanglerTime(SpanDemangler::NameParts);
+
+    const auto count = names.size() * Iterations;
+    const auto print = [count](const char *label, qint64 time) {
+        cout << label << time / count << " ns/symbol, " << count * 1000000000ll / time << " symbols/s" << endl;
+    };
+    cout << names.size() << " symbols" << endl;
+    print("libiberty:                  ", libibertyTime);
+    print("SpanDemangler (full name):  ", fullNameTime);
+    print("SpanDemangler (name parts): ", namePartsTime);
+    return 0;
+}
+
 int main(int argc, char** argv)
 {
-    if (argc < 2)
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <mangled name>" << endl;
+        cerr << "       " << argv[0] << " --benchmark <ELF file, or file with one mangled name per line>" << endl;
         return 1;
+    }
+
+    if (strcmp(argv[1], "--benchmark") == 0)
+        return argc < 3 ? 1 : benchmark(argv[2]);
 
     void *memory = nullptr;
     demangle_component *component = cplus_demangle_v3_components(argv[1], DMGL_PARAMS | DMGL_ANSI | DMGL_TYPES | DMGL_VERBOSE, &memory);
@@ -0,0 +1,288 @@
+/*
+    Copyright (C) 2026 Volker Krause <vkrause@kde.org>
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU Library General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or (at your
+    option) any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+    License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Measures the heap memory actually used by the DIE tables and the decoded attributes
+// during a full traversal of all compilation units, including what libdwarf allocates,
+// and how many DIEs needed an attribute cache. The same traversal is run on the previous
+// DIE layout as a baseline, rebuilt here from plain libdwarf calls as that code no longer exists.
+
+#include <dwarf/dwarfcudie.h>
+#include <dwarf/dwarfinfo.h>
+#include <elf/elffile.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QVariant>
+#include <QVector>
+
+#include <dwarf.h>
+#include <libdwarf.h>
+#include <malloc.h>
+
+#include <iostream>
+
+using namespace std;
+
+static int64_t heapUsage()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return mallinfo2().uordblks;
+#else
+    return mallinfo().uordblks;
+#endif
+}
+
+static void printPhase(const char *label, int64_t heap, uint64_t dieCount, qint64 time)
+{
+    cout << label << heap << " bytes (" << (dieCount ? (double)heap / dieCount : 0.0) << " per DIE, " << time << "ms)" << endl;
+}
+
+// the previous DIE layout: one heap node with its own libdwarf handle and child vector per DIE
+struct BaselineDie
+{
+    Dwarf_Die die = nullptr;
+    BaselineDie *parent = nullptr;
+    QVector<BaselineDie*> children;
+};
+
+// attribute decoding as previously done on every access, leaving the attribute handles to libdwarf
+static QVariant baselineAttribute(Dwarf_Die die, Dwarf_Half attributeType)
+{
+    Dwarf_Attribute attr;
+    if (dwarf_attr(die, attributeType, &attr, nullptr) != DW_DLV_OK)
+        return {};
+    Dwarf_Half formType;
+    if (dwarf_whatform(attr, &formType, nullptr) != DW_DLV_OK)
+        return {};
+
+    switch (formType) {
+        case DW_FORM_data1:
+        case DW_FORM_data2:
+        case DW_FORM_data4:
+        case DW_FORM_data8:
+        case DW_FORM_udata:
+        {
+            Dwarf_Unsigned n = 0;
+            dwarf_formudata(attr, &n, nullptr);
+            return static_cast<qulonglong>(n);
+        }
+        case DW_FORM_sdata:
+        {
+            Dwarf_Signed n = 0;
+            dwarf_formsdata(attr, &n, nullptr);
+            return static_cast<qlonglong>(n);
+        }
+        case DW_FORM_string:
+        case DW_FORM_strp:
+        case DW_FORM_line_strp:
+        case DW_FORM_strx:
+        case DW_FORM_strx1:
+        case DW_FORM_strx2:
+        case DW_FORM_strx3:
+        case DW_FORM_strx4:
+        {
+            char *str = nullptr;
+            if (dwarf_formstring(attr, &str, nullptr) != DW_DLV_OK)
+                return {};
+            return QByteArray(str);
+        }
+        case DW_FORM_flag:
+        case DW_FORM_flag_present:
+        {
+            Dwarf_Bool b = 0;
+            dwarf_formflag(attr, &b, nullptr);
+            return b ? true : false;
+        }
+        case DW_FORM_ref1:
+        case DW_FORM_ref2:
+        case DW_FORM_ref4:
+        case DW_FORM_ref8:
+        case DW_FORM_sec_offset:
+        {
+            Dwarf_Off offset = 0;
+            dwarf_global_formref(attr, &offset, nullptr);
+            return static_cast<qulonglong>(offset);
+        }
+        case DW_FORM_addr:
+        {
+            Dwarf_Addr addr = 0;
+            dwarf_formaddr(attr, &addr, nullptr);
+            return static_cast<qulonglong>(addr);
+        }
+        case DW_FORM_exprloc:
+        {
+            Dwarf_Unsigned len = 0;
+            Dwarf_Ptr block = nullptr;
+            dwarf_formexprloc(attr, &len, &block, nullptr);
+            return QByteArray(static_cast<const char*>(block), len);
+        }
+    }
+    return {};
+}
+
+struct Measurement
+{
+    int64_t heap = 0;
+    qint64 time = 0;
+    uint64_t dieCount = 0;
+    uint64_t attributeCount = 0;
+};
+
+// opening the file, and the full traversal on the previous layout
+// attributes inherited via DW_AT_abstract_origin/DW_AT_specification aren't followed, so this is a lower bound
+static Measurement measureBaseline(const QString &fileName)
+{
+    Measurement m;
+    QElapsedTimer timer;
+    timer.start();
+    const auto heapBefore = heapUsage();
+    ElfFile file(fileName);
+    if (!file.open(QFile::ReadOnly) || !file.dwarfInfo())
+        return m;
+    const auto info = file.dwarfInfo();
+    const auto dbg = info->dwarfHandle();
+    const auto lock = info->lockDwarfHandle();
+
+    QVector<BaselineDie*> dies;
+    QVector<BaselineDie*> dieQueue;
+    Dwarf_Unsigned nextHeader = 0;
+    while (dwarf_next_cu_header(dbg, nullptr, nullptr, nullptr, nullptr, &nextHeader, nullptr) == DW_DLV_OK) {
+        Dwarf_Die cuDie = nullptr;
+        if (dwarf_siblingof_b(dbg, nullptr, true, &cuDie, nullptr) != DW_DLV_OK)
+            break;
+        dies.push_back(new BaselineDie);
+        dies.last()->die = cuDie;
+        dieQueue.push_back(dies.last());
+        while (!dieQueue.isEmpty()) {
+            const auto die = dieQueue.takeLast();
+            char *name = nullptr;
+            if (dwarf_diename(die->die, &name, nullptr) == DW_DLV_OK)
+                dwarf_dealloc(dbg, name, DW_DLA_STRING);
+
+            Dwarf_Attribute *attrList = nullptr;
+            Dwarf_Signed attrCount = 0;
+            if (dwarf_attrlist(die->die, &attrList, &attrCount, nullptr) == DW_DLV_OK) {
+                QVector<Dwarf_Half> attrs;
+                for (int i = 0; i < attrCount; ++i) {
+                    Dwarf_Half attrType;
+                    if (dwarf_whatattr(attrList[i], &attrType, nullptr) == DW_DLV_OK)
+                        attrs.push_back(attrType);
+                }
+                dwarf_dealloc(dbg, attrList, DW_DLA_LIST);
+                foreach (const auto at, attrs) {
+                    baselineAttribute(die->die, at);
+                    ++m.attributeCount;
+                }
+            }
+
+            Dwarf_Die childDie = nullptr;
+            auto res = dwarf_child(die->die, &childDie, nullptr);
+            while (res == DW_DLV_OK) {
+                auto child = new BaselineDie;
+                child->die = childDie;
+                child->parent = die;
+                die->children.push_back(child);
+                dies.push_back(child);
+                dieQueue.push_back(child);
+                res = dwarf_siblingof_b(dbg, childDie, true, &childDie, nullptr);
+            }
+        }
+        dieQueue.squeeze();
+    }
+    m.heap = heapUsage() - heapBefore - dies.capacity() * sizeof(BaselineDie*);
+    m.time = timer.elapsed();
+    m.dieCount = dies.size();
+
+    foreach (auto die, dies)
+        dwarf_dealloc(dbg, die->die, DW_DLA_DIE);
+    qDeleteAll(dies);
+    return m;
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    if (app.arguments().size() != 2) {
+        cerr << "Usage: dwarf-memory <elf>" << endl;
+        return 1;
+    }
+
+    const auto baseline = measureBaseline(app.arguments().at(1));
+
+    QElapsedTimer timer;
+    timer.start();
+    auto heapBefore = heapUsage();
+    ElfFile file(app.arguments().at(1));
+    if (!file.open(QFile::ReadOnly) || !file.dwarfInfo()) {
+        cerr << "No DWARF information found." << endl;
+        return 1;
+    }
+    const auto info = file.dwarfInfo();
+    const auto cus = info->compilationUnits();
+    const auto unitHeap = heapUsage() - heapBefore;
+    const auto unitTime = timer.elapsed();
+
+    timer.restart();
+    heapBefore = heapUsage();
+    uint64_t dieCount = 0;
+    foreach (auto cu, cus)
+        dieCount += cu->dieCount();
+    const auto tableHeap = heapUsage() - heapBefore;
+    const auto tableTime = timer.elapsed();
+
+    // what a full view of the tree costs: the children of every DIE, and all of its attributes
+    timer.restart();
+    heapBefore = heapUsage();
+    uint64_t attributeCount = 0;
+    QVector<DwarfDie*> dieQueue;
+    foreach (auto cu, cus) {
+        dieQueue.push_back(cu);
+        while (!dieQueue.isEmpty()) {
+            const auto die = dieQueue.takeLast();
+            die->attributeString(DW_AT_name);
+            foreach (const auto at, die->attributes()) {
+                die->attribute(at);
+                ++attributeCount;
+            }
+            foreach (auto child, die->children())
+                dieQueue.push_back(child);
+        }
+        dieQueue.squeeze();
+    }
+    const auto traversalHeap = heapUsage() - heapBefore;
+    const auto traversalTime = timer.elapsed();
+
+    // only DIEs that can't be decoded natively should need these
+    int cacheCount = 0;
+    foreach (auto cu, cus)
+        cacheCount += cu->attributeCacheCount();
+
+    cout << "compilation units: " << cus.size() << endl;
+    cout << "DIEs:              " << dieCount << endl;
+    cout << "attributes:        " << attributeCount << endl;
+    cout << "attribute caches:  " << cacheCount << endl;
+    printPhase("units:             ", unitHeap, dieCount, unitTime);
+    printPhase("DIE tables:        ", tableHeap, dieCount, tableTime);
+    printPhase("traversal:         ", traversalHeap, dieCount, traversalTime);
+    printPhase("total:             ", unitHeap + tableHeap + traversalHeap, dieCount, unitTime + tableTime + traversalTime);
+    cout << "baseline DIEs:     " << baseline.dieCount << endl;
+    cout << "baseline attrs:    " << baseline.attributeCount << endl;
+    printPhase("baseline total:    ", baseline.heap, baseline.dieCount, baseline.time);
+    if (baseline.heap > 0)
+        cout << "heap vs. baseline: " << (double)(unitHeap + tableHeap + traversalHeap) / baseline.heap << endl;
+    return 0;
+}